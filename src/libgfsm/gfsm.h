@@ -44,11 +44,15 @@ G_BEGIN_DECLS
 #include <gfsmVersion.h>
 #include <gfsmError.h>
 #include <gfsmUtils.h>
+#include <gfsmThreads.h>
 #include <gfsmEnum.h>
 #include <gfsmSet.h>
 #include <gfsmWeightMap.h>
 #include <gfsmBitVector.h>
+#include <gfsmHeap.h>
 #include <gfsmAlphabet.h>
+#include <gfsmMappedAlphabet.h>
+#include <gfsmTokenizer.h>
 #include <gfsmSemiring.h>
 #include <gfsmArc.h>
 #include <gfsmState.h>
@@ -63,14 +67,19 @@ G_BEGIN_DECLS
 #include <gfsmAlgebra.h>
 #include <gfsmArith.h>
 #include <gfsmEncode.h>
+#include <gfsmMatcher.h>
+#include <gfsmView.h>
 #include <gfsmLookup.h>
 #include <gfsmPaths.h>
+#include <gfsmRTN.h>
 #include <gfsmTrain.h>
 #include <gfsmTrie.h>
 #include <gfsmScanner.h>
 #include <gfsmRegexCompiler.h>
 #include <gfsmIndexed.h>
 #include <gfsmIndexedIO.h>
+#include <gfsmPacked.h>
+#include <gfsmPackedIO.h>
 G_END_DECLS
 
 #endif /* _GFSM_H */
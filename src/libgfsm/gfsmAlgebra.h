@@ -30,6 +30,8 @@
 
 #include <gfsmCompound.h>
 #include <gfsmArcIndex.h>
+#include <gfsmIndexed.h>
+#include <gfsmView.h>
 
 /*======================================================================
  * Methods: algebra
@@ -87,23 +89,46 @@ gfsmAutomaton *gfsm_automaton_complement(gfsmAutomaton *fsm);
  * \note Destructively alters \a fsm.
  *
  * \param fsm Acceptor
- * \param alph Alphabet with respect to which to compute complement.
+ * \param alph Alphabet with respect to which to compute complement,
+ *   or NULL for the lower alphabet of \a fsm itself.
  * \returns \a fsm
  */
 gfsmAutomaton *gfsm_automaton_complement_full(gfsmAutomaton *fsm, gfsmAlphabet *alph);
 
+/** Compute the lower-side complement of \a fsm with respect to any alphabet,
+ * using implicit arcs as for gfsm_automaton_complete_implicit().
+ * The result is only meaningful to operations which honor implicit arcs (see gfsmMatcher.h).
+ * \note Destructively alters \a fsm.
+ *
+ * \param fsm Acceptor
+ * \returns \a fsm
+ */
+gfsmAutomaton *gfsm_automaton_complement_implicit(gfsmAutomaton *fsm);
+
 /** Complete the lower side of automaton \a fsm with respect to the alphabet \a alph
  * by directing "missing" arcs to the (new) state with id \a *sink.
  * \note Destructively alters \a fsm.
  *
  * \param fsm Acceptor
- * \param alpha Alphabet with respect to which \a fsm is to be completed
+ * \param alpha Alphabet with respect to which \a fsm is to be completed,
+ *   or NULL for the lower alphabet of \a fsm itself
  * \param sinkp Pointer to a variable which on completion contains the Id of a (new) non-final sink state
  * \returns \a fsm
  */
 gfsmAutomaton *gfsm_automaton_complete(gfsmAutomaton    *fsm,
 				       gfsmAlphabet     *alph,
 				       gfsmStateId      *sinkp);
+
+/** Complete the lower side of automaton \a fsm with respect to any alphabet
+ * by adding a single ::gfsmRho arc to the (new) sink state \a *sink for each state,
+ * and a ::gfsmSigma loop on the sink, instead of one arc per missing label.
+ * \note Destructively alters \a fsm.
+ *
+ * \param fsm Acceptor
+ * \param sinkp Pointer to a variable which on completion contains the Id of a (new) non-final sink state
+ * \returns \a fsm
+ */
+gfsmAutomaton *gfsm_automaton_complete_implicit(gfsmAutomaton *fsm, gfsmStateId *sinkp);
 //@}
 
 //------------------------------
@@ -148,6 +173,16 @@ gfsmAutomaton *gfsm_automaton_compose_full(gfsmAutomaton *fsm1,
 					   gfsmAutomaton *composition,
 					   gfsmComposeStateEnum *spenum);
 
+/** Like gfsm_automaton_compose_full(), but reads the indexed transducer \a xfsm2 in place.
+ *  The arcs of \a xfsm2 are used directly if it is sorted primarily on lower labels,
+ *  otherwise a temporary sorted copy of its arc table is made.
+ *  \returns \a composition
+ */
+gfsmAutomaton *gfsm_automaton_compose_indexed_full(gfsmAutomaton *fsm1,
+						   gfsmIndexedAutomaton *xfsm2,
+						   gfsmAutomaton *composition,
+						   gfsmComposeStateEnum *spenum);
+
 typedef guint32 gfsmComposeFlags; /**< flags for gfsm_automaton_compose_visit_state_() */
 
 /** \brief Enum type for low-level flags to gfsm_automaton_compose_visit_state_() */
@@ -159,12 +194,13 @@ typedef enum {
 /** Guts for gfsm_automaton_compose() \returns (new) StateId for \a sp */
 void gfsm_automaton_compose_visit_(gfsmStateId       qid,
 				   gfsmAutomaton    *fsm1,
-				   gfsmAutomaton    *fsm2,
+				   gfsmAutomatonView *view2,  //-- read-only view of fsm2
 				   gfsmAutomaton    *fsm,
 				   gfsmComposeStateEnum *spenum,
 				   GArray               *spenumr, //-- GArray of gfsmComposeState
 				   GQueue 	        *queue,   //-- queue of gfsmStateId
-				   gfsmComposeFlags  flags);
+				   gfsmArcTableIndex    *tabx1,   //-- arcs of fsm1, sorted on upper, or NULL if fsm1 is upper-sorted
+				   gfsmArcTableIndex    *tabx2);  //-- arcs of fsm2, sorted on lower, or NULL if fsm2 is a lower-sorted gfsmAutomaton
 //@}
 
 //------------------------------
@@ -189,6 +225,18 @@ gfsmAutomaton *gfsm_automaton_n_concat(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2,
  */
 gfsmAutomaton *gfsm_automaton_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2);
 
+/** Append each of the \a n_fsms automata \a fsms onto the end of \a fsm1, in order.
+ *  Builds the result in a single pass: state storage for \a fsm1 is allocated only once,
+ *  and each operand is adopted directly at its final state offset.
+ *  \note Destructively alters \a fsm1.
+ *
+ * \param fsm1 Automaton
+ * \param fsms array of \a n_fsms automata (NULL or root-less elements are ignored)
+ * \param n_fsms number of elements in \a fsms
+ * \returns \a fsm1
+ */
+gfsmAutomaton *gfsm_automaton_concat_n(gfsmAutomaton *fsm1, gfsmAutomaton **fsms, guint n_fsms);
+
 /* Final-state pre-traversal utility for \a concat(fsm,fsm2).
  *
  *  \note Assumes \a fsm->root_id has been temporarily set to the translated gfsmStateId
@@ -206,6 +254,12 @@ gfsmAutomaton *gfsm_automaton_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2);
 ///\name gfsmConnect.c: Co-Accessibility & Pruning
 //@{
 
+/** Minimum number of states for which gfsm_automaton_connect_fw() and gfsm_automaton_connect_bw()
+ *  use a multi-threaded breadth-first traversal, if more than one thread is available
+ *  (see gfsm_threads_get_default()).
+ */
+extern const gfsmStateId gfsmConnectParallelMinStates;
+
 /** Remove non-coaccessible states from \a fsm.
  * Calls gfsm_automaton_connect_fw() and gfsm_automaton_connect_bw()
  * \note Destructively alters \a fsm
@@ -235,8 +289,8 @@ gfsmAutomaton *gfsm_automaton_connect_fw(gfsmAutomaton *fsm, gfsmBitVector *visi
  * \param fsm Automaton
  * \param rarcs
  *   Reverse arc-index as returned by gfsm_automaton_reverse_arc_index().
- *   If passed as NULL, gfsm_automaton_reverse_arc_index() will be called
- *   on a temporary arc index.
+ *   If passed as NULL, a temporary compact ::gfsmReverseStateIndex
+ *   will be used instead.
  * \param finalizable
  *   Bit-vector for traversal.  Should have all bits set to zero.
  *   If passed as NULL, a new bit-vector will be created and freed.
@@ -290,6 +344,13 @@ gfsmAutomaton *gfsm_automaton_determinize(gfsmAutomaton *fsm);
  */
 gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton *dfa);
 
+/** Like gfsm_automaton_determinize_full(), but reads the indexed automaton \a xnfa in place.
+ *  \param xnfa non-deterministic indexed acceptor
+ *  \param dfa  deterministic acceptor to be constructed, or \c NULL to create a new automaton
+ *  \returns \a dfa
+ */
+gfsmAutomaton *gfsm_indexed_automaton_determinize_full(gfsmIndexedAutomaton *xnfa, gfsmAutomaton *dfa);
+
 /** Alias for gfsm_automaton_determinize() */
 #define gfsm_automaton_determinise(fsm) gfsm_automaton_determinize(fsm)
 
@@ -316,7 +377,12 @@ gfsmAutomaton *gfsm_automaton_difference(gfsmAutomaton *fsm1, gfsmAutomaton *fsm
 
 /** Compute difference of acceptors (\a fsm1 - \a fsm2) into acceptor \a diff-
  *
- *  \note Really just an alias for intersect_full(fsm1,complement(clone(fsm2)),diff).
+ *  If \a fsm2 is deterministic and epsilon-free (and has no implicit arcs),
+ *  the product (\a fsm1 x \a fsm2) is walked directly, and missing arcs in \a fsm2
+ *  lead to an implicit non-final sink; no complement is ever built.
+ *
+ *  \note Otherwise just an alias for intersect_full(fsm1,complement(clone(fsm2)),diff),
+ *    where the complement is computed by gfsm_automaton_complement_implicit().
  *
  *  \param fsm1 Acceptor
  *  \param fsm2 Acceptor
@@ -329,6 +395,14 @@ gfsmAutomaton *gfsm_automaton_difference_full(gfsmAutomaton *fsm1,
 					      gfsmAutomaton *fsm2,
 					      gfsmAutomaton *diff);
 
+/** Like gfsm_automaton_difference_full(), but reads the indexed acceptor \a xfsm2 in place.
+ *  \note If \a xfsm2 is not deterministic and epsilon-free, its complement is still
+ *    built as an ordinary ::gfsmAutomaton.
+ *  \returns (possibly new) difference automaton \a diff
+ */
+gfsmAutomaton *gfsm_automaton_difference_indexed_full(gfsmAutomaton *fsm1,
+						      gfsmIndexedAutomaton *xfsm2,
+						      gfsmAutomaton *diff);
 //@}
 
 //------------------------------
@@ -359,15 +433,27 @@ gfsmAutomaton *gfsm_automaton_intersect_full(gfsmAutomaton *fsm1,
 					     gfsmAutomaton *intersect,
 					     gfsmStatePairEnum *spenum);
 
+/** Like gfsm_automaton_intersect_full(), but reads the indexed acceptor \a xfsm2 in place.
+ *  \returns \a intersect.
+ */
+gfsmAutomaton *gfsm_automaton_intersect_indexed_full(gfsmAutomaton *fsm1,
+						     gfsmIndexedAutomaton *xfsm2,
+						     gfsmAutomaton *intersect,
+						     gfsmStatePairEnum *spenum);
+
 /** Guts for gfsm_automaton_intersect()
+ *  \param view2 read-only view of the second operand
+ *  \param tabx1 arcs of \a fsm1, sorted on lower label, or NULL to walk the arc lists of \a fsm1 (which must be lower-sorted)
+ *  \param tabx2 arcs of \a view2, sorted on lower label, or NULL to walk the arc lists of a lower-sorted ::gfsmAutomaton
  *  \returns (new) ::gfsmStateId for \a sp
  */
 gfsmStateId gfsm_automaton_intersect_visit_(gfsmStatePair  sp,
 					    gfsmAutomaton *fsm1,
-					    gfsmAutomaton *fsm2,
+					    gfsmAutomatonView *view2,
 					    gfsmAutomaton *fsm,
 					    gfsmStatePairEnum *spenum,
-					    gfsmComposeFlags   flags);
+					    gfsmArcTableIndex *tabx1,
+					    gfsmArcTableIndex *tabx2);
 //@}
 
 //------------------------------
@@ -540,6 +626,26 @@ gfsmAutomaton *gfsm_automaton_reverse(gfsmAutomaton *fsm);
  */
 gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm);
 
+/** Remove epsilon arcs from \a fsm by per-state epsilon-closure.
+ * - Destructively alters \a fsm.
+ * - Alternative to gfsm_automaton_rmepsilon() which computes the epsilon-closure
+ *   of each state independently by single-source shortest-distance (Mohri, 2002)
+ *   and rebuilds that state's non-epsilon arcs from it.
+ * - States are processed in parallel if more than one thread is available
+ *   (see gfsm_threads_get_default()).
+ * - Boolean and tropical semirings use specialized closure computations.
+ *
+ * \warning negative-cost epsilon cycles in \a fsm will cause an infinite loop!
+ *
+ * \sa M. Mohri (2002), "Generic Epsilon-Removal and Input Epsilon-Normalization
+ *  Algorithms for Weighted Transducers." <em>International Journal of Foundations
+ *  of Computer Science</em> 13(1):129-143.
+ *
+ * \param fsm Automaton
+ * \returns \a fsm
+ */
+gfsmAutomaton *gfsm_automaton_rmepsilon_closure(gfsmAutomaton *fsm);
+
 //@}
 
 //------------------------------
@@ -550,6 +656,7 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm);
  * \note Destructively alters \a fsm.
  *
  * \param fsm Automaton
+ * \param abet Alphabet, or NULL for a single implicit ::gfsmSigma arc matching any label
  * \returns \a fsm
  */
 gfsmAutomaton *gfsm_automaton_sigma(gfsmAutomaton *fsm, gfsmAlphabet *abet);
@@ -566,6 +673,37 @@ gfsmAutomaton *gfsm_automaton_sigma(gfsmAutomaton *fsm, gfsmAlphabet *abet);
  *  \returns \a fsm1
  */
 gfsmAutomaton *gfsm_automaton_union(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2);
+
+/** Add the languages or relations of each of the \a n_fsms automata \a fsms to \a fsm1.
+ *  State storage for \a fsm1 is allocated only once, each input is copied only once,
+ *  and a single new root state is created with one epsilon arc to each input root
+ *  (and to the old root of \a fsm1, if any).
+ *  \note Destructively alters \a fsm1
+ *
+ *  \param fsm1 Automaton
+ *  \param fsms array of \a n_fsms automata (NULL or root-less elements are ignored)
+ *  \param n_fsms number of elements in \a fsms
+ *  \returns \a fsm1
+ */
+gfsmAutomaton *gfsm_automaton_union_n(gfsmAutomaton *fsm1, gfsmAutomaton **fsms, guint n_fsms);
+
+/** Add the languages or relations of each of the \a n_fsms automata \a fsms to \a fsm1
+ *  by merging common prefixes, rather than by epsilon arcs from a new root.
+ *
+ *  Input arcs are merged with existing arcs of \a fsm1 having the same labels and weight,
+ *  as long as the target state in \a fsm1 has no other incoming arcs (i.e. lies on the
+ *  prefix tree of \a fsm1); the remainder of each input is copied.  For acyclic
+ *  epsilon-free string automata, this yields a prefix tree (trie); suffixes may
+ *  subsequently be shared with gfsm_automaton_minimize().  Final weights of merged
+ *  states are combined with gfsm_sr_plus().
+ *  \note Destructively alters \a fsm1
+ *
+ *  \param fsm1 Automaton
+ *  \param fsms array of \a n_fsms automata (NULL or root-less elements are ignored)
+ *  \param n_fsms number of elements in \a fsms
+ *  \returns \a fsm1
+ */
+gfsmAutomaton *gfsm_automaton_union_trie_n(gfsmAutomaton *fsm1, gfsmAutomaton **fsms, guint n_fsms);
 //@}
 
 /** \file gfsmAlgebra.h
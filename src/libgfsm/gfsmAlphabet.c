@@ -21,6 +21,7 @@
  *=============================================================================*/
 
 #include <gfsmAlphabet.h>
+#include <gfsmMappedAlphabet.h>
 #include <gfsmSet.h>
 #include <gfsmUtils.h>
 #include <gfsmError.h>
@@ -264,6 +265,31 @@ void gfsm_alphabet_free(gfsmAlphabet *a)
  * Methods: Utilties
  */
 
+/*--------------------------------------------------------------
+ * reserve()
+ */
+void gfsm_alphabet_reserve(gfsmAlphabet *a, gfsmLabelVal n_labels)
+{
+  GPtrArray *l2k, *l2k_new;
+  guint      i;
+  switch (a->type) {
+  case gfsmATPointer:
+  case gfsmATString:
+  case gfsmATUser:
+    //-- GPtrArray has no reserve(): swap in a pre-sized copy
+    l2k = ((gfsmPointerAlphabet*)a)->labels2keys;
+    if (n_labels == gfsmNoLabel || n_labels <= l2k->len) break;
+    l2k_new = g_ptr_array_sized_new(n_labels);
+    for (i=0; i < l2k->len; i++) g_ptr_array_add(l2k_new, g_ptr_array_index(l2k,i));
+    g_ptr_array_free(l2k, TRUE);
+    ((gfsmPointerAlphabet*)a)->labels2keys = l2k_new;
+    break;
+
+  default:
+    break;
+  }
+}
+
 /*--------------------------------------------------------------
  * gfsm_alphabet_foreach()
  */
@@ -658,61 +684,80 @@ void gfsm_alphabet_key2string(gfsmAlphabet *a, gpointer key, GString *gstr)
 }
 
 /*--------------------------------------------------------------
- * load_handle()
+ * load_insert_()
+ *  + pointer alphabets need only a single hash lookup here
  */
-gboolean gfsm_alphabet_load_handle (gfsmAlphabet *a, gfsmIOHandle *ioh, GFSM_UNUSED gfsmError **errp)
+static
+void gfsm_alphabet_load_insert_(gfsmAlphabet *a, gpointer key, gfsmLabelVal label)
 {
-  int c;
-  gpointer    key;
-  gfsmLabelVal label;
-  GString *s_key = g_string_new("");
-  GString *s_lab = g_string_new("");
-
-  //if (!myname) myname = "gfsm_string_alphabet_load_file()";
-
-  do {
-    g_string_truncate(s_key,0);
-    g_string_truncate(s_lab,0);
-
-    //-- read data fields into temp strings
-    for (c=gfsmio_getc(ioh); !gfsmio_eof(ioh) && isspace((char)c); c=gfsmio_getc(ioh)) ;
-    if (gfsmio_eof(ioh)) break;
-
-    for (g_string_append_c(s_key,c), c=gfsmio_getc(ioh);
-	 !gfsmio_eof(ioh) && !isspace((char)c);
-	 c=gfsmio_getc(ioh))
-      {
-	g_string_append_c(s_key,c);
-      }
-
-    for ( ; !gfsmio_eof(ioh) && isspace((char)c); c=gfsmio_getc(ioh)) ;
-    if (gfsmio_eof(ioh)) break;
-
-    for (g_string_append_c(s_lab,c), c=gfsmio_getc(ioh);
-	 !gfsmio_eof(ioh) && !isspace((char)c);
-	 c=gfsmio_getc(ioh))
-      {
-	g_string_append_c(s_lab,c);
-      }
-
-    for ( ; (char)c != '\n' && !gfsmio_eof(ioh); c=gfsmio_getc(ioh) ) ;
+  gpointer k, l;
+  switch (a->type) {
+  case gfsmATPointer:
+  case gfsmATString:
+    if (g_hash_table_lookup_extended(((gfsmPointerAlphabet*)a)->keys2labels, key, &k, &l)) {
+      if ((gfsmLabelVal)GPOINTER_TO_UINT(l) == label) return;
+      gfsm_alphabet_remove_key(a, key);
+    }
+    gfsm_alphabet_insert(a, key, label);
+    break;
 
-    //-- get actual key and label
-    key   = gfsm_alphabet_string2key(a,s_key);
-    label = strtol(s_lab->str, NULL, 10);
+  default:
     if (gfsm_alphabet_find_label(a,key) != label) {
       gfsm_alphabet_remove_key(a, key);
       gfsm_alphabet_insert(a, key, label);
     }
-  } while (!gfsmio_eof(ioh));
+    break;
+  }
+}
+
+/*--------------------------------------------------------------
+ * load_handle()
+ */
+gboolean gfsm_alphabet_load_handle (gfsmAlphabet *a, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  return gfsm_alphabet_load_handle_full(a, ioh, 0, errp);
+}
+
+/*--------------------------------------------------------------
+ * load_handle_full()
+ */
+gboolean gfsm_alphabet_load_handle_full (gfsmAlphabet *a, gfsmIOHandle *ioh, gfsmLabelVal n_hint, GFSM_UNUSED gfsmError **errp)
+{
+  char        *buf=NULL, *s_key, *p;
+  size_t       bufsize=0;
+  gpointer     key;
+  gfsmLabelVal label;
+  gboolean     is_pointer = (a->type==gfsmATPointer || a->type==gfsmATString);
+  GString     *gs_key = is_pointer ? NULL : g_string_new("");
+
+  if (n_hint > 0) gfsm_alphabet_reserve(a, n_hint);
+  while (gfsmio_getline(ioh, &buf, &bufsize) != GFSMIO_EOF) {
+    //-- tokenize line in place: KEY WHITESPACE LABEL [WHITESPACE ...]
+    for (p=buf; *p && isspace((unsigned char)*p); p++) ;
+    if (!*p) continue;
+    for (s_key=p; *p && !isspace((unsigned char)*p); p++) ;
+    if (!*p) continue;
+    *p++ = '\0';
+    for ( ; *p && isspace((unsigned char)*p); p++) ;
+    if (!*p) continue;
+    label = strtol(p, NULL, 10);
+
+    //-- get actual key (string-keyed alphabets use the line buffer directly)
+    if (is_pointer) {
+      key = s_key;
+    } else {
+      g_string_assign(gs_key, s_key);
+      key = gfsm_alphabet_string2key(a, gs_key);
+    }
+    gfsm_alphabet_load_insert_(a, key, label);
+  }
 
   //-- cleanup
-  g_string_free(s_key,TRUE);
-  g_string_free(s_lab,TRUE);
+  if (buf) free(buf);
+  if (gs_key) g_string_free(gs_key,TRUE);
   return TRUE;
 }
 
-
 /*--------------------------------------------------------------
  * load_file()
  */
@@ -727,13 +772,51 @@ gboolean gfsm_alphabet_load_file (gfsmAlphabet *a, FILE *f, gfsmError **errp)
   return rc;
 }
 
+/*--------------------------------------------------------------
+ * count_lines_()
+ *  + returns number of lines in an uncompressed file, or 0 if unknown
+ */
+static
+gfsmLabelVal gfsm_alphabet_count_lines_(const gchar *filename)
+{
+  GMappedFile *mfile = g_mapped_file_new(filename, FALSE, NULL);
+  const gchar *data, *p, *end;
+  gfsmLabelVal n = 0;
+  gsize        len;
+
+  if (!mfile) return 0;
+  data = g_mapped_file_get_contents(mfile);
+  len  = g_mapped_file_get_length(mfile);
+  if (len > 0 && !(len >= 2 && (guchar)data[0]==0x1f && (guchar)data[1]==0x8b)) {
+    //-- not gzip-compressed: count newlines
+    for (p=data, end=data+len; p < end && (p=memchr(p,'\n',end-p)) != NULL; p++) ++n;
+    if (data[len-1] != '\n') ++n;
+  }
+  g_mapped_file_unref(mfile);
+  return n;
+}
+
 /*--------------------------------------------------------------
  * load_filename()
  */
 gboolean gfsm_alphabet_load_filename (gfsmAlphabet *a, const gchar *filename, gfsmError **errp)
 {
-  gfsmIOHandle *ioh = gfsmio_new_filename(filename, "rb", -1, errp);
-  gboolean rc = ioh && !(*errp) && gfsm_alphabet_load_handle(a, ioh, errp);
+  gfsmIOHandle *ioh;
+  gfsmLabelVal n_hint = 0;
+  gboolean rc;
+
+  if (strcmp(filename,"-") != 0 && gfsm_mapped_alphabet_file_check(filename)) {
+    //-- binary alphabet file
+    gfsmMappedAlphabet *ma = gfsm_mapped_alphabet_open(filename, errp);
+    if (!ma) return FALSE;
+    gfsm_mapped_alphabet_to_alphabet(ma, a);
+    gfsm_mapped_alphabet_close(ma);
+    return TRUE;
+  }
+
+  if (strcmp(filename,"-") != 0) n_hint = gfsm_alphabet_count_lines_(filename);
+  ioh = gfsmio_new_filename(filename, "rb", -1, errp);
+  rc  = ioh && !(*errp) && gfsm_alphabet_load_handle_full(a, ioh, n_hint, errp);
   if (ioh) {
     gfsmio_close(ioh);
     gfsmio_handle_free(ioh);
@@ -230,6 +230,11 @@ gboolean gfsm_alphabet_foreach_remove_func (gfsmAlphabet *a,
 
 /** Free all memory allocated by a gfsmAlphabet */
 void gfsm_alphabet_free(gfsmAlphabet *a);
+
+/** Size hint: pre-allocate storage for labels < \a n_labels.
+ *  Currently only affects the label-to-key table of pointer, string, and user alphabets.
+ */
+void gfsm_alphabet_reserve(gfsmAlphabet *a, gfsmLabelVal n_labels);
 //@}
 
 /*======================================================================
@@ -337,14 +342,25 @@ gpointer gfsm_alphabet_string2key(gfsmAlphabet *a, GString *gstr);
 /** Convert a key to a constant string, used by save() */
 void gfsm_alphabet_key2string(gfsmAlphabet *a, gpointer key, GString *gstr);
 
-
-/** Load a string alphabet from a stream.  Returns true on success */
+/** Load a string alphabet from a stream.  Returns true on success.
+ *  Input is read line-wise; each line is split in place into a key and a label field.
+ */
 gboolean gfsm_alphabet_load_handle (gfsmAlphabet *a, gfsmIOHandle *ioh, gfsmError **errp);
 
+/** Load a string alphabet from a stream, pre-sizing \a a with gfsm_alphabet_reserve().
+ *  \param n_hint expected number of entries (e.g. input line count), or 0 if unknown
+ *  \returns true on success
+ */
+gboolean gfsm_alphabet_load_handle_full (gfsmAlphabet *a, gfsmIOHandle *ioh, gfsmLabelVal n_hint, gfsmError **errp);
+
 /** Load a string alphabet from a stream.  Returns true on success */
 gboolean gfsm_alphabet_load_file (gfsmAlphabet *a, FILE *f, gfsmError **errp);
 
-/** Load a string alphabet from a named file */
+/** Load a string alphabet from a named file.
+ *  Binary alphabet files written by gfsm_alphabet_save_bin_filename() are detected
+ *  and bulk-loaded; see gfsmMappedAlphabet.h.
+ *  For uncompressed text files, the line count is used as a size hint.
+ */
 gboolean gfsm_alphabet_load_filename (gfsmAlphabet *a, const gchar *filename, gfsmError **errp);
 
 
@@ -23,12 +23,18 @@
 
 #include <gfsmArcIndex.h>
 #include <gfsmArcIter.h>
+#include <string.h>
 
 //-- no-inline definitions
 #ifndef GFSM_INLINE_ENABLED
 # include <gfsmArcIndex.hi>
 #endif
 
+/*======================================================================
+ * Constants
+ */
+const guint gfsmArcRangeGallopRatio = 8;
+
 /*======================================================================
  * gfsmReverseArcIndex
  */
@@ -76,6 +82,57 @@ void gfsm_reverse_arc_index_free(gfsmReverseArcIndex *rarcs, gboolean free_lists
 }
 
 
+/*======================================================================
+ * gfsmReverseStateIndex
+ */
+
+/*--------------------------------------------------------------
+ * automaton_to_reverse_state_index()
+ */
+gfsmReverseStateIndex *gfsm_automaton_to_reverse_state_index(gfsmAutomaton *fsm, gfsmReverseStateIndex *rsi)
+{
+  gfsmStateId qid, n_states = gfsm_automaton_n_states(fsm);
+  guint      *first, total;
+  gfsmArcIter ai;
+
+  if (!rsi) rsi = gfsm_reverse_state_index_new();
+  g_array_set_size(rsi->first, n_states+1);
+  first = (guint*)rsi->first->data;
+  memset(first, 0, (n_states+1)*sizeof(guint));
+
+  //-- pass 1: count in-degree of each target (shifted by one)
+  for (qid=0; qid < n_states; qid++) {
+    for (gfsm_arciter_open(&ai,fsm,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      gfsmStateId qto = gfsm_arciter_arc(&ai)->target;
+      if (qto < n_states) ++first[qto+1];
+    }
+    gfsm_arciter_close(&ai);
+  }
+
+  //-- prefix sums: first[q] is now the start of the range for q
+  for (qid=0, total=0; qid < n_states; qid++) {
+    total += first[qid+1];
+    first[qid+1] = total;
+  }
+  g_array_set_size(rsi->sources, total);
+
+  //-- pass 2: fill, using first[q] as insertion cursor for q; then shift the offsets back into place
+  for (qid=0; qid < n_states; qid++) {
+    for (gfsm_arciter_open(&ai,fsm,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      gfsmStateId qto = gfsm_arciter_arc(&ai)->target;
+      if (qto < n_states) g_array_index(rsi->sources,gfsmStateId,first[qto]++) = qid;
+    }
+    gfsm_arciter_close(&ai);
+  }
+  for (qid=n_states; qid > 0; qid--) {
+    first[qid] = first[qid-1];
+  }
+  first[0] = 0;
+
+  return rsi;
+}
+
+
 
 /*======================================================================
  * gfsmWeightVector
@@ -116,7 +173,7 @@ gboolean gfsm_weight_vector_write_bin_handle(gfsmWeightVector *wv, gfsmIOHandle
 		"could not store weight vector length");
     return FALSE;
   }
-  if (!gfsmio_write(ioh,wv->data,wv->len*sizeof(gfsmWeight))) {
+  if (wv->len > 0 && !gfsmio_write(ioh,wv->data,wv->len*sizeof(gfsmWeight))) {
     g_set_error(errp, g_quark_from_static_string("gfsm"),                                  //-- domain
 		g_quark_from_static_string("weight_vector_write_bin_handle:weights"), //-- code
 		"could not store weight vector data");
@@ -139,7 +196,7 @@ gboolean gfsm_weight_vector_read_bin_handle(gfsmWeightVector *wv, gfsmIOHandle *
     return FALSE;
   }
   gfsm_weight_vector_resize(wv,len);
-  if (!gfsmio_read(ioh, wv->data, len*sizeof(gfsmWeight))) {
+  if (len > 0 && !gfsmio_read(ioh, wv->data, len*sizeof(gfsmWeight))) {
     g_set_error(errp,
 		g_quark_from_static_string("gfsm"),                                     //-- domain
 		g_quark_from_static_string("weight_vector_read_bin_handle:data"),  //-- code
@@ -320,11 +377,8 @@ gfsmArcTableIndex *gfsm_automaton_to_arc_table_index(gfsmAutomaton *fsm, gfsmArc
   gfsmArc **firstp;
 
   //-- maybe allocate
-  if (!tabx) {
-    tabx = gfsm_arc_table_index_sized_new(n_states, n_arcs);
-  } else {
-    gfsm_arc_table_index_resize(tabx, n_states, n_arcs);
-  }
+  if (!tabx) tabx = gfsm_arc_table_index_sized_new(n_states, n_arcs);
+  gfsm_arc_table_index_resize(tabx, n_states, n_arcs);
 
   //-- populate tabx->arcs
   gfsm_automaton_to_arc_table(fsm,tabx->tab);
@@ -415,6 +469,36 @@ gboolean gfsm_arc_table_index_read_bin_handle(gfsmArcTableIndex *tabx, gfsmIOHan
   return TRUE;
 }
 
+/*======================================================================
+ * Cached automaton arc indices
+ */
+
+/*--------------------------------------------------------------
+ * automaton_get_arc_index()
+ */
+gfsmArcTableIndex *gfsm_automaton_get_arc_index(gfsmAutomaton *fsm, gfsmLabelSide which)
+{
+  gfsmArcTableIndex **tabxp = (which==gfsmLSUpper ? &fsm->index_upper : &fsm->index_lower);
+  gfsmArcComp         c0    = (which==gfsmLSUpper ? gfsmACUpper : gfsmACLower);
+  gfsmArcComp         c1    = (which==gfsmLSUpper ? gfsmACLower : gfsmACUpper);
+
+  fsm->flags.is_indexed = 1;
+  if (*tabxp) return *tabxp;
+
+  *tabxp = gfsm_automaton_to_arc_table_index(fsm,NULL);
+  if (gfsm_acmask_nth(fsm->flags.sort_mode,0) != c0 || gfsm_acmask_nth(fsm->flags.sort_mode,1) != c1)
+    gfsm_arc_table_index_sort_bymask(*tabxp, gfsm_acmask_new(c0,0)|gfsm_acmask_new(c1,1), NULL);
+
+  return *tabxp;
+}
+
+/*--------------------------------------------------------------
+ * automaton_lookup_arc_index()
+ */
+gfsmArcTableIndex *gfsm_automaton_lookup_arc_index(gfsmAutomaton *fsm, gfsmLabelSide which)
+{
+  return fsm->flags.is_indexed ? gfsm_automaton_get_arc_index(fsm,which) : NULL;
+}
 
 /*======================================================================
  * gfsmArcLabelIndex [GONE]
@@ -88,6 +88,53 @@ void gfsm_reverse_arc_index_free(gfsmReverseArcIndex *rarcs, gboolean free_lists
 //@}
 
 
+/*======================================================================
+ * gfsmReverseStateIndex
+ */
+///\name gfsmReverseStateIndex
+//@{
+
+/// Compact (CSR-style) reverse adjacency index over state IDs
+/** The predecessors of state \a q are the ::gfsmStateId values
+ *  <tt>sources[first[q]]</tt>, ..., <tt>sources[first[q+1]-1]</tt>.
+ *  There is one entry per arc, so parallel arcs yield duplicate entries.
+ *  Unlike a ::gfsmReverseArcIndex, no per-arc list nodes are allocated,
+ *  and no arc data is shared with the source automaton.
+ */
+typedef struct {
+  GArray *first;    /**< GArray of guint: offsets into \a sources, indexed by target ::gfsmStateId (length n_states+1) */
+  GArray *sources;  /**< GArray of ::gfsmStateId: source states of all arcs, grouped by target state */
+} gfsmReverseStateIndex;
+
+/** Create and return a new (empty) ::gfsmReverseStateIndex
+ * \note
+ *   Caller is responsible for freeing the returned index when it is no longer needed.
+ */
+GFSM_INLINE
+gfsmReverseStateIndex *gfsm_reverse_state_index_new(void);
+
+/** Populate a ::gfsmReverseStateIndex for \a fsm in two counting passes over its arcs.
+ * \param fsm source automaton
+ * \param rsi index to populate, or NULL to create a new index
+ * \returns \a rsi if non-NULL, otherwise a new ::gfsmReverseStateIndex for \a fsm.
+ */
+gfsmReverseStateIndex *gfsm_automaton_to_reverse_state_index(gfsmAutomaton *fsm, gfsmReverseStateIndex *rsi);
+
+/** Get a pointer to the first predecessor of \a qid in \a rsi; see gfsm_reverse_state_index_end() */
+GFSM_INLINE
+gfsmStateId *gfsm_reverse_state_index_begin(gfsmReverseStateIndex *rsi, gfsmStateId qid);
+
+/** Get a pointer just past the last predecessor of \a qid in \a rsi */
+GFSM_INLINE
+gfsmStateId *gfsm_reverse_state_index_end(gfsmReverseStateIndex *rsi, gfsmStateId qid);
+
+/** Free a ::gfsmReverseStateIndex */
+GFSM_INLINE
+void gfsm_reverse_state_index_free(gfsmReverseStateIndex *rsi);
+
+//@}
+
+
 /*======================================================================
  * gfsmFinalWeightIndex
  */
@@ -387,7 +434,7 @@ gfsmArc *gfsm_arc_ptr_table_seek_bymask(gfsmArcPtrTable *ptab, const gfsmArc *ke
 //@{
 
 /// Basic type for dedicated arc storage state-based arc index
-typedef struct {
+typedef struct gfsmArcTableIndex_ {
   gfsmArcTable *tab;              /**< arc table, sorted by (source,...) */
   GPtrArray    *first;            /**< \a first[q] is address of first element of \a arcs->data for state \a q (a ::gfsmArc*) */
 } gfsmArcTableIndex;
@@ -466,6 +513,36 @@ gboolean gfsm_arc_table_index_read_bin_handle(gfsmArcTableIndex *tabx, gfsmIOHan
 
 //@}
 
+/*======================================================================
+ * Cached automaton arc indices
+ */
+///\name Cached automaton arc indices
+//@{
+
+/** Get the cached arc index of \a fsm for label side \a which,
+ *  building it first if it is missing or has been invalidated by a modification of \a fsm.
+ *  Sets \a fsm->flags.is_indexed, so that both indices are maintained from now on
+ *  and stored with \a fsm by gfsm_automaton_save_bin_handle().
+ * \param fsm automaton to index
+ * \param which
+ *   ::gfsmLSUpper for an index sorted on (upper,lower),
+ *   otherwise an index sorted on (lower,upper)
+ * \returns
+ *   index owned by \a fsm, valid until the next modification of \a fsm
+ * \note
+ *   \li Not thread-safe: build the indices before sharing \a fsm among threads.
+ *   \li Code which modifies arcs directly must call gfsm_automaton_touch() to invalidate the index.
+ */
+gfsmArcTableIndex *gfsm_automaton_get_arc_index(gfsmAutomaton *fsm, gfsmLabelSide which);
+
+/** Get the cached arc index of \a fsm for label side \a which if \a fsm->flags.is_indexed is set
+ *  (see gfsm_automaton_get_arc_index()), otherwise NULL.
+ *  Used by algorithms to consult indices only for automata which maintain them.
+ */
+gfsmArcTableIndex *gfsm_automaton_lookup_arc_index(gfsmAutomaton *fsm, gfsmLabelSide which);
+
+//@}
+
 /*======================================================================
  * gfsmArcRange
  */
@@ -498,6 +575,43 @@ gfsmArc *gfsm_arcrange_arc(gfsmArcRange *range);
 GFSM_INLINE
 void gfsm_arcrange_next(gfsmArcRange *range);
 
+/** Get number of arcs remaining in a ::gfsmArcRange */
+GFSM_INLINE
+guint gfsm_arcrange_size(gfsmArcRange *range);
+
+/** Minimum size ratio between two sorted ::gfsmArcRange objects for which
+ *  matchers should use gfsm_arcrange_gallop_lower() and gfsm_arcrange_gallop_upper()
+ *  on the larger range instead of a linear merge.
+ */
+extern const guint gfsmArcRangeGallopRatio;
+
+/** Advance \a range linearly to the first arc with lower label >= \a lab.
+ *  \a range must be sorted primarily by lower label.
+ */
+GFSM_INLINE
+void gfsm_arcrange_seek_lower(gfsmArcRange *range, gfsmLabelVal lab);
+
+/** Advance \a range linearly to the first arc with upper label >= \a lab.
+ *  \a range must be sorted primarily by upper label.
+ */
+GFSM_INLINE
+void gfsm_arcrange_seek_upper(gfsmArcRange *range, gfsmLabelVal lab);
+
+/** Advance \a range to the first arc with lower label >= \a lab by
+ *  galloping (exponential) search followed by binary search;
+ *  costs O(log(d)) for a distance of d arcs.
+ *  \a range must be sorted primarily by lower label.
+ */
+GFSM_INLINE
+void gfsm_arcrange_gallop_lower(gfsmArcRange *range, gfsmLabelVal lab);
+
+/** Advance \a range to the first arc with upper label >= \a lab by
+ *  galloping (exponential) search followed by binary search.
+ *  \a range must be sorted primarily by upper label.
+ */
+GFSM_INLINE
+void gfsm_arcrange_gallop_upper(gfsmArcRange *range, gfsmLabelVal lab);
+
 //@}
 
 /*======================================================================
@@ -28,6 +28,12 @@
 # include <gfsmArcList.hi>
 #endif
 
+/*======================================================================
+ * Constants
+ */
+const guint gfsmArcPoolMinChunkSize = 256;
+const guint gfsmArcPoolMaxChunkSize = 65536;
+
 /*======================================================================
  * Methods: Arc lists
  */
@@ -228,3 +234,140 @@ gfsmArcList* gfsm_arclist_reverse(gfsmArcList *al)
   }
   return prev;
 }
+
+
+/*======================================================================
+ * Methods: Arc List: Node Pools
+ */
+
+/*--------------------------------------------------------------
+ * arc_pool_new()
+ */
+gfsmArcPool *gfsm_arc_pool_new(void)
+{
+  gfsmArcPool *pool = gfsm_slice_new0(gfsmArcPool);
+  pool->chunk_size  = gfsmArcPoolMinChunkSize;
+  return pool;
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_clear()
+ */
+void gfsm_arc_pool_clear(gfsmArcPool *pool)
+{
+  GSList *l;
+  if (!pool) return;
+  for (l=pool->chunks; l != NULL; l=l->next) { g_free(l->data); }
+  g_slist_free(pool->chunks);
+  pool->chunks     = NULL;
+  pool->free_nodes = NULL;
+  pool->cur        = NULL;
+  pool->end        = NULL;
+  pool->chunk_size = gfsmArcPoolMinChunkSize;
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_free()
+ */
+void gfsm_arc_pool_free(gfsmArcPool *pool)
+{
+  if (!pool) return;
+  gfsm_arc_pool_clear(pool);
+  gfsm_slice_free(gfsmArcPool,pool);
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_alloc_chunk()
+ */
+gfsmArcList *gfsm_arc_pool_alloc_chunk(gfsmArcPool *pool, guint n_nodes)
+{
+  gfsmArcList *chunk;
+  if (n_nodes < 1) n_nodes = 1;
+
+  //-- recycle the unused tail of the current chunk
+  for ( ; pool->cur < pool->end; pool->cur++) {
+    pool->cur->next  = pool->free_nodes;
+    pool->free_nodes = pool->cur;
+  }
+
+  chunk        = g_new(gfsmArcList, n_nodes);
+  pool->chunks = g_slist_prepend(pool->chunks, chunk);
+  pool->cur    = chunk+1;
+  pool->end    = chunk+n_nodes;
+  if (pool->chunk_size < gfsmArcPoolMaxChunkSize) pool->chunk_size *= 2;
+  return chunk;
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_reserve()
+ */
+void gfsm_arc_pool_reserve(gfsmArcPool *pool, guint n_nodes)
+{
+  if (!pool || (gsize)(pool->end - pool->cur) >= n_nodes) return;
+  pool->cur = gfsm_arc_pool_alloc_chunk(pool, n_nodes); //-- don't consume the first node
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_merge()
+ */
+void gfsm_arc_pool_merge(gfsmArcPool *dst, gfsmArcPool *src)
+{
+  //-- recycle the unused tail of src's current chunk
+  for ( ; src->cur < src->end; src->cur++) {
+    src->cur->next  = src->free_nodes;
+    src->free_nodes = src->cur;
+  }
+
+  //-- steal chunks
+  dst->chunks = g_slist_concat(src->chunks, dst->chunks);
+  src->chunks = NULL;
+
+  //-- steal released nodes
+  if (src->free_nodes) {
+    gfsmArcList *tail = src->free_nodes;
+    while (tail->next != NULL) { tail = tail->next; }
+    tail->next       = dst->free_nodes;
+    dst->free_nodes  = src->free_nodes;
+    src->free_nodes  = NULL;
+  }
+
+  src->cur = src->end = NULL;
+  src->chunk_size = gfsmArcPoolMinChunkSize;
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_release_list()
+ */
+void gfsm_arc_pool_release_list(gfsmArcPool *pool, gfsmArcList *al)
+{
+  gfsmArcList *tail;
+  if (!pool) {
+    gfsm_arclist_free(al);
+    return;
+  }
+  if (!al) return;
+  for (tail=al; tail->next != NULL; tail=tail->next) ;
+  tail->next       = pool->free_nodes;
+  pool->free_nodes = al;
+}
+
+/*--------------------------------------------------------------
+ * arc_pool_clone_list()
+ */
+gfsmArcList *gfsm_arc_pool_clone_list(gfsmArcPool *pool, gfsmArcList *src)
+{
+  gfsmArcList *dst=NULL, *prev=NULL;
+  for ( ; src != NULL; src=src->next) {
+    gfsmArcList *nod = gfsm_arc_pool_node_new(pool,
+					      src->arc.source,
+					      src->arc.target,
+					      src->arc.lower,
+					      src->arc.upper,
+					      src->arc.weight,
+					      NULL);
+    if (prev) prev->next = nod;
+    else      dst        = nod;
+    prev = nod;
+  }
+  return dst;
+}
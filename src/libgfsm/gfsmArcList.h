@@ -199,6 +199,85 @@ gfsmArcList *gfsm_arclist_sort_with_data(gfsmArcList *al, GCompareDataFunc cmpfu
 gfsmArcList *gfsm_arclist_sort_real (gfsmArcList *list, GFunc compare_func, gpointer user_data);
 
 
+//@}
+
+/*======================================================================
+ * Arc List: Node Pools
+ */
+///\name Arc List: Node Pools
+//@{
+
+/** \brief Arena for ::gfsmArcListNode allocation.
+ *  \detail
+ *   Nodes are carved from large chunks, and released nodes are kept on a free list
+ *   for re-use.  All nodes are returned to the system at once by gfsm_arc_pool_clear()
+ *   or gfsm_arc_pool_free().  Nodes allocated from a pool must never be passed
+ *   to gfsm_arclist_free() or gfsm_arclist_free_1(), and vice versa.
+ *  \warning a single pool must not be accessed concurrently by multiple threads
+ *  \see gfsm_automaton_use_arc_pool()
+ */
+typedef struct gfsmArcPool_ {
+  GSList      *chunks;      /**< allocated chunks (most recent first) */
+  gfsmArcList *free_nodes;  /**< released nodes, linked by their \a next field */
+  gfsmArcList *cur;         /**< next unused node of the most recent chunk */
+  gfsmArcList *end;         /**< end of the most recent chunk */
+  guint        chunk_size;  /**< number of nodes in the next chunk to be allocated */
+} gfsmArcPool;
+
+/** Number of nodes in the first chunk of a new ::gfsmArcPool */
+extern const guint gfsmArcPoolMinChunkSize;
+
+/** Maximum number of nodes in a single ::gfsmArcPool chunk allocated on demand;
+ *  chunk sizes double from ::gfsmArcPoolMinChunkSize up to this value.
+ */
+extern const guint gfsmArcPoolMaxChunkSize;
+
+/** Create and return a new empty ::gfsmArcPool */
+gfsmArcPool *gfsm_arc_pool_new(void);
+
+/** Release all nodes and chunks of \a pool, leaving it empty but usable */
+void gfsm_arc_pool_clear(gfsmArcPool *pool);
+
+/** Destroy \a pool, releasing all nodes allocated from it */
+void gfsm_arc_pool_free(gfsmArcPool *pool);
+
+/** Ensure that at least \a n_nodes nodes can be allocated from \a pool without
+ *  further chunk allocations.
+ */
+void gfsm_arc_pool_reserve(gfsmArcPool *pool, guint n_nodes);
+
+/** Transfer all chunks and released nodes of \a src to \a dst.
+ *  Nodes allocated from \a src are thereafter owned by \a dst, and \a src is left empty.
+ */
+void gfsm_arc_pool_merge(gfsmArcPool *dst, gfsmArcPool *src);
+
+/** Low-level guts for gfsm_arc_pool_alloc(): allocate a new chunk and return its first node */
+gfsmArcList *gfsm_arc_pool_alloc_chunk(gfsmArcPool *pool, guint n_nodes);
+
+/** Allocate a single uninitialized node from \a pool, or using gfsm_slice_new() if \a pool is \c NULL */
+GFSM_INLINE
+gfsmArcList *gfsm_arc_pool_alloc(gfsmArcPool *pool);
+
+/** Release a single node \a nod to \a pool, or using gfsm_arclist_free_1() if \a pool is \c NULL */
+GFSM_INLINE
+void gfsm_arc_pool_release(gfsmArcPool *pool, gfsmArcList *nod);
+
+/** Release all nodes of the arc-list \a al to \a pool, or using gfsm_arclist_free() if \a pool is \c NULL */
+void gfsm_arc_pool_release_list(gfsmArcPool *pool, gfsmArcList *al);
+
+/** As for gfsm_arclist_new_full(), but allocates from \a pool (may be \c NULL) */
+GFSM_INLINE
+gfsmArcList *gfsm_arc_pool_node_new(gfsmArcPool  *pool,
+				    gfsmStateId  src,
+				    gfsmStateId  dst,
+				    gfsmLabelVal lo,
+				    gfsmLabelVal hi,
+				    gfsmWeight   wt,
+				    gfsmArcList  *nxt);
+
+/** As for gfsm_arclist_clone(), but allocates from \a pool (may be \c NULL) */
+gfsmArcList *gfsm_arc_pool_clone_list(gfsmArcPool *pool, gfsmArcList *src);
+
 //@}
 
 //-- inline definitions
@@ -48,6 +48,7 @@ gfsmAutomaton *gfsm_automaton_arith(gfsmAutomaton    *fsm,
 
     if (fsm->flags.sort_mode == gfsmASMWeight)
       fsm->flags.sort_mode = gfsmASMNone; //-- arc-weights may be destructively altered
+    gfsm_automaton_touch(fsm);
 
     for (qid=0; qid < fsm->states->len; qid++) {
       gfsmArcIter ai;
@@ -86,6 +87,7 @@ gfsmAutomaton *gfsm_automaton_arith_state(gfsmAutomaton    *fsm,
 
     if (fsm->flags.sort_mode == gfsmASMWeight)
       fsm->flags.sort_mode = gfsmASMNone; //-- arc-weights may be destructively altered
+    gfsm_automaton_touch(fsm);
 
     for (gfsm_arciter_open(&ai,fsm,qid), gfsm_arciter_seek_both(&ai,lo,hi);
 	 gfsm_arciter_ok(&ai);
@@ -22,6 +22,7 @@
 
 #include <gfsmAutomaton.h>
 #include <gfsmArcIter.h>
+#include <gfsmArcIndex.h>
 #include <gfsmStateSort.h>
 #include <gfsmUtils.h>
 #include <gfsmBitVector.h>
@@ -42,8 +43,9 @@ const gfsmAutomatonFlags gfsmAutomatonDefaultFlags =
     TRUE,        //-- is_weighted:1
     //0,           //-- sort_mode_old__:4
     FALSE,       //-- is_deterministic:1
-    0,           //-- unused:29 (was: 25)
-    gfsmASMNone  //-- sort_mode
+    gfsmASMNone, //-- sort_mode:24
+    FALSE,       //-- is_indexed:1
+    0            //-- unused:4
   };
 
 //const gfsmSRType gfsmAutomatonDefaultSRType = gfsmSRTReal;
@@ -61,13 +63,16 @@ gfsmAutomaton *gfsm_automaton_copy(gfsmAutomaton *dst, gfsmAutomaton *src)
   gfsm_automaton_clear(dst);
   gfsm_automaton_copy_shallow(dst,src);
   dst->root_id = src->root_id;                    //-- since copy_shallow() no longer does this!
+  dst->flags.is_indexed = src->flags.is_indexed;
+  if (src->index_lower) dst->index_lower = gfsm_arc_table_index_clone(src->index_lower);
+  if (src->index_upper) dst->index_upper = gfsm_arc_table_index_clone(src->index_upper);
   gfsm_automaton_reserve(dst,src->states->len);
   gfsm_weightmap_copy(dst->finals, src->finals);
   //
   for (qid=0; qid < src->states->len; qid++) {
     const gfsmState *src_s = gfsm_automaton_find_state_const(src,qid);
           gfsmState *dst_s = gfsm_automaton_find_state(dst,qid);
-    gfsm_state_copy(dst_s, src_s);
+    gfsm_state_copy_full(dst_s, src_s, dst->arc_pool);
   }
   return dst;
 }
@@ -79,10 +84,16 @@ void gfsm_automaton_clear(gfsmAutomaton *fsm)
 {
   gfsmStateId i;
   if (!fsm) return;
-  for (i=0; fsm->states && i < fsm->states->len; i++) {
-    gfsmState *st = gfsm_automaton_find_state(fsm,i);
-    if (!st || !st->is_valid) continue;
-    gfsm_state_clear(st);
+  gfsm_automaton_invalidate_indices(fsm);
+  if (fsm->arc_pool) {
+    //-- pooled arcs: drop whole chunks
+    gfsm_arc_pool_clear(fsm->arc_pool);
+  } else {
+    for (i=0; fsm->states && i < fsm->states->len; i++) {
+      gfsmState *st = gfsm_automaton_find_state(fsm,i);
+      if (!st || !st->is_valid) continue;
+      gfsm_state_clear(st);
+    }
   }
   if (fsm->states) g_array_set_size(fsm->states,0);
   if (fsm->finals) gfsm_set_clear(fsm->finals);
@@ -91,6 +102,29 @@ void gfsm_automaton_clear(gfsmAutomaton *fsm)
 }
 
 
+/*--------------------------------------------------------------
+ * use_arc_pool()
+ */
+void gfsm_automaton_use_arc_pool(gfsmAutomaton *fsm, gboolean use_pool)
+{
+  gfsmArcPool *old_pool = fsm->arc_pool;
+  gfsmStateId  qid;
+  if ((old_pool != NULL) == (use_pool != FALSE)) return;
+
+  //-- move existing arcs (order-preserving)
+  fsm->arc_pool = use_pool ? gfsm_arc_pool_new() : NULL;
+  if (fsm->arc_pool) gfsm_arc_pool_reserve(fsm->arc_pool, gfsm_automaton_n_arcs(fsm));
+  for (qid=0; qid < fsm->states->len; qid++) {
+    gfsmState   *qp = gfsm_automaton_find_state(fsm,qid);
+    gfsmArcList *al;
+    if (!qp->is_valid || !qp->arcs) continue;
+    al       = qp->arcs;
+    qp->arcs = gfsm_arc_pool_clone_list(fsm->arc_pool, al);
+    if (!old_pool) gfsm_arclist_free(al);
+  }
+  if (old_pool) gfsm_arc_pool_free(old_pool);
+}
+
 //======================================================================
 // API: Automaton Semiring
 
@@ -245,6 +279,7 @@ void gfsm_automaton_renumber_states_full(gfsmAutomaton *fsm, GArray *old2new, gf
 void gfsm_automaton_truncate_invalid_states(gfsmAutomaton *fsm)
 {
   gfsmState *s;
+  gfsm_automaton_touch(fsm);
   for (s = gfsm_automaton_find_state(fsm, fsm->states->len-1); s && s>(gfsmState*)fsm->states->data && !s->is_valid; s--) {
     --fsm->states->len;
   }
@@ -260,6 +295,7 @@ void gfsm_automaton_truncate_invalid_states(gfsmAutomaton *fsm)
 void gfsm_automaton_arcsort_full(gfsmAutomaton *fsm, GCompareDataFunc cmpfunc, gpointer data)
 {
   gfsmStateId qid;
+  gfsm_automaton_touch(fsm);
   for (qid=0; qid < fsm->states->len; qid++) {
     gfsmState *qp = gfsm_automaton_find_state(fsm,qid);
     if (!qp || !qp->is_valid) continue;
@@ -285,13 +321,14 @@ gfsmAutomaton *gfsm_automaton_arcuniq(gfsmAutomaton *fsm)
 #endif
 
   //-- ye olde loope
+  gfsm_automaton_touch(fsm);
   for (qid=0; qid < fsm->states->len; qid++) {
     qptr = gfsm_automaton_open_state(fsm,qid);
     for (al0=qptr->arcs; al0 != NULL; al0=al0->next) {
       for (al1=al0->next; al1!=NULL && al1->arc.lower==al0->arc.lower && al1->arc.upper==al0->arc.upper && al1->arc.target==al0->arc.target; al1=al0->next) {
 	al0->arc.weight = gfsm_sr_plus(fsm->sr, al0->arc.weight, al1->arc.weight);
 	al0->next       = al1->next;
-	gfsm_arclist_free_1(al1);
+	gfsm_arc_pool_release(fsm->arc_pool, al1);
       }
     }
     gfsm_automaton_close_state(fsm,qptr);
@@ -300,3 +337,27 @@ gfsmAutomaton *gfsm_automaton_arcuniq(gfsmAutomaton *fsm)
   //-- return
   return fsm;
 }
+
+/*======================================================================
+ * Methods: Cached Arc Indices
+ */
+
+/*--------------------------------------------------------------
+ * invalidate_indices()
+ */
+void gfsm_automaton_invalidate_indices(gfsmAutomaton *fsm)
+{
+  if (fsm->index_lower) gfsm_arc_table_index_free(fsm->index_lower);
+  if (fsm->index_upper) gfsm_arc_table_index_free(fsm->index_upper);
+  fsm->index_lower = NULL;
+  fsm->index_upper = NULL;
+}
+
+/*--------------------------------------------------------------
+ * clear_indices()
+ */
+void gfsm_automaton_clear_indices(gfsmAutomaton *fsm)
+{
+  gfsm_automaton_invalidate_indices(fsm);
+  fsm->flags.is_indexed = 0;
+}
@@ -47,7 +47,8 @@ typedef struct {
   guint32 is_weighted       : 1;       /**< whether this automaton is weighted */
   guint32 is_deterministic  : 1;       /**< whether fsm is known to be deterministic */
   guint32 sort_mode         : 24;      /**< new-style sort mode (a ::gfsmArcCompMask) */
-  guint32 unused            : 5;       /**< reserved */
+  guint32 is_indexed        : 1;       /**< whether lower- and upper-label arc indices are maintained (see gfsm_automaton_get_arc_index()) */
+  guint32 unused            : 4;       /**< reserved */
 } gfsmAutomatonFlags;
 
 /** \brief "Heavy" automaton type
@@ -61,6 +62,11 @@ typedef struct {
   GArray             *states;    /**< vector of automaton states */
   gfsmWeightMap      *finals;    /**< map from final state-Ids to final weights */
   gfsmStateId         root_id;   /**< ID of root node, or gfsmNoState if not defined */
+  //-- cached arc indices (see gfsmArcIndex.h)
+  struct gfsmArcTableIndex_ *index_lower; /**< arcs sorted by (lower,upper), or NULL if not (yet) built */
+  struct gfsmArcTableIndex_ *index_upper; /**< arcs sorted by (upper,lower), or NULL if not (yet) built */
+  //-- arc node allocation (see gfsm_automaton_use_arc_pool())
+  gfsmArcPool        *arc_pool;  /**< pool owning all arc nodes, or NULL if nodes are allocated individually */
 } gfsmAutomaton;
 
 /*======================================================================
@@ -125,6 +131,21 @@ void gfsm_automaton_clear(gfsmAutomaton *fsm);
 /** Destroy an automaton: all associated states and arcs will be freed. */
 GFSM_INLINE
 void gfsm_automaton_free(gfsmAutomaton *fsm);
+
+/** Enable or disable pooled arc-node allocation for \a fsm.
+ *  \param fsm automaton to modify
+ *  \param use_pool whether arc nodes of \a fsm should be allocated from a private ::gfsmArcPool
+ *  \details
+ *   Pooled automata allocate their arc nodes in large chunks, recycle nodes released
+ *   by destructive operations such as gfsm_automaton_arcuniq() and gfsm_automaton_rmepsilon(),
+ *   and release all chunks at once on gfsm_automaton_clear() and gfsm_automaton_free().
+ *   Existing arcs are moved to resp. from the pool, so this may be called at any time.
+ *   Automata created with gfsm_automaton_shadow() inherit the setting of their source.
+ *  \warning
+ *   Arc nodes of a pooled automaton must be released with gfsm_arc_pool_release()
+ *   resp. gfsm_arc_pool_release_list() on \a fsm->arc_pool, and never with gfsm_arclist_free().
+ */
+void gfsm_automaton_use_arc_pool(gfsmAutomaton *fsm, gboolean use_pool);
 //@}
 
 
@@ -526,11 +547,15 @@ void gfsm_automaton_add_arc_node(gfsmAutomaton *fsm,
 				 gfsmState     *sp,
 				 gfsmArcList   *node);
 
-/** Remove an arc (pointer), without freeing it */
+/** Remove an arc (pointer), without freeing it.
+ *  If \a fsm->arc_pool is non-NULL, the removed node must be released with gfsm_arc_pool_release().
+ */
 GFSM_INLINE
 void gfsm_automaton_remove_arc_ptr(gfsmAutomaton *fsm, gfsmArc *a);
 
-/** Remove an arc node (without freeing it) */
+/** Remove an arc node (without freeing it).
+ *  If \a fsm->arc_pool is non-NULL, the removed node must be released with gfsm_arc_pool_release().
+ */
 GFSM_INLINE
 void gfsm_automaton_remove_arc_node(gfsmAutomaton *fsm, gfsmState *sp, gfsmArcList *node);
 
@@ -570,6 +595,28 @@ gfsmAutomaton* gfsm_automaton_arcuniq(gfsmAutomaton *fsm);
 
 //@}
 
+/*======================================================================*/
+/// \name API: Cached Arc Indices
+//@{
+
+/** Mark the arcs of \a fsm as modified, discarding any cached arc indices.
+ *  All state- and arc-modifying methods call this implicitly; code which
+ *  modifies arcs directly through ::gfsmArc or ::gfsmState pointers must call it itself.
+ *  See gfsm_automaton_get_arc_index().
+ */
+GFSM_INLINE
+void gfsm_automaton_touch(gfsmAutomaton *fsm);
+
+/** Free any cached arc indices of \a fsm.
+ *  If \a fsm->flags.is_indexed is set, they will be rebuilt on demand.
+ */
+void gfsm_automaton_invalidate_indices(gfsmAutomaton *fsm);
+
+/** Free any cached arc indices of \a fsm and stop maintaining them (clears \a fsm->flags.is_indexed) */
+void gfsm_automaton_clear_indices(gfsmAutomaton *fsm);
+
+//@}
+
 //-- inline definitions
 #ifdef GFSM_INLINE_ENABLED
 # include <gfsmAutomaton.hi>
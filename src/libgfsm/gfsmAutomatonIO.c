@@ -26,15 +26,22 @@
 
 #include <gfsmAutomatonIO.h>
 #include <gfsmArcIter.h>
+#include <gfsmArcIndex.h>
 #include <gfsmUtils.h>
+#include <gfsmThreads.h>
+#include <gfsmCompound.h>
 //#include <gfsmCompat.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
 #include <errno.h>
 
+#ifdef GFSM_ZLIB_ENABLED
+# include <zlib.h>
+#endif
 
 
 /*======================================================================
@@ -47,6 +54,31 @@ const gfsmVersionInfo gfsm_version_bincompat_min_store =
     10  // micro //--8
   };
 
+const gfsmVersionInfo gfsm_version_bincompat_min_store_indexed =
+  {
+    0, // major
+    0, // minor
+    21  // micro: first version which reads cached arc indices
+  };
+
+const gfsmVersionInfo gfsm_version_bincompat_min_store_blocked =
+  {
+    0, // major
+    0, // minor
+    21  // micro
+  };
+
+const gfsmVersionInfo gfsm_version_bincompat_min_store_varint =
+  {
+    0, // major
+    0, // minor
+    22  // micro: first version which reads variable-length records
+  };
+
+const guint gfsmAutomatonDefaultBlockStates = 16384;
+
+const gsize gfsmAutomatonCompileChunkSize = 8388608;
+
 const gfsmVersionInfo gfsm_version_bincompat_min_check =
   {
     0, // major
@@ -133,6 +165,7 @@ gboolean gfsm_automaton_load_bin_header(gfsmAutomatonHeader *hdr, gfsmIOHandle *
     hdr->flags.is_transducer    = flags_009.is_transducer;
     hdr->flags.is_weighted      = flags_009.is_weighted;
     hdr->flags.is_deterministic = flags_009.is_deterministic_009;
+    hdr->flags.is_indexed       = 0;
     hdr->flags.unused           = flags_009.unused_009;
     switch (flags_009.sort_mode_009) {
     case gfsmASMLower_009: hdr->flags.sort_mode = gfsmASMLower; break;
@@ -151,10 +184,40 @@ gboolean gfsm_automaton_load_bin_header(gfsmAutomatonHeader *hdr, gfsmIOHandle *
 }
 
 /*--------------------------------------------------------------
- * load_bin_handle_0_0_8()
- *   + supports stored file versions v0.0.8 -- CURRENT
+ * load_bin_arc_index_()
+ *   + reads a cached arc index stored by save_bin_handle() into *tabxp
  */
-gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp)
+static
+gboolean gfsm_automaton_load_bin_arc_index_(gfsmAutomaton *fsm, gfsmArcTableIndex **tabxp, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  gfsmArcTableIndex *tabx = gfsm_arc_table_index_new();
+  if (!gfsm_arc_table_index_read_bin_handle(tabx, ioh, errp)) {
+    gfsm_arc_table_index_free(tabx);
+    return FALSE;
+  }
+  if (tabx->first->len != fsm->states->len+1) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                         //-- domain
+		g_quark_from_static_string("automaton_load_bin:arc_index"), //-- code
+		"stored arc index has %u states, expected %u", tabx->first->len-1, fsm->states->len);
+    gfsm_arc_table_index_free(tabx);
+    return FALSE;
+  }
+  *tabxp = tabx;
+  return TRUE;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_states_()
+ *   + reads stored states [qmin,qmax) in v0.0.8 format from ioh
+ *   + if finals is non-NULL, final weights are appended to it as gfsmStateWeightPair
+ *     rather than inserted into fsm->finals (for use by concurrent block readers)
+ *   + arc nodes are allocated from pool (may be NULL)
+ *   + states must already be allocated
+ */
+static
+gboolean gfsm_automaton_load_bin_states_(gfsmAutomaton *fsm, gfsmStateId qmin, gfsmStateId qmax,
+					 gfsmIOHandle *ioh, GArray *finals, gfsmArcPool *pool, gfsmError **errp)
 {
   gfsmStateId     id;
   guint           arci;
@@ -164,16 +227,8 @@ gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAuto
   gboolean         rc = TRUE;
   gfsmWeight       w;
 
-  //-- allocate states
-  gfsm_automaton_reserve(fsm, hdr->n_states);
-
-  //-- set automaton-global properties
-  fsm->flags   = hdr->flags;
-  gfsm_automaton_set_semiring_type(fsm, hdr->srtype);
-  fsm->root_id = hdr->root_id;
-
   //------ load states (one-by-one)
-  for (id=0; rc && id < hdr->n_states; id++) {
+  for (id=qmin; rc && id < qmax; id++) {
     if (!gfsmio_read(ioh, &s_state, sizeof(gfsmStoredState))) {
       g_set_error(errp,
 		  g_quark_from_static_string("gfsm"),                     //-- domain
@@ -185,7 +240,7 @@ gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAuto
 
     if (!s_state.is_valid) continue;
 
-    st           = gfsm_automaton_find_state(fsm,id);
+    st           = &g_array_index(fsm->states,gfsmState,id);
     st->is_valid = TRUE;
 
     if (s_state.is_final) {
@@ -201,7 +256,12 @@ gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAuto
 
       //-- set final weight
       st->is_final = TRUE;
-      gfsm_weightmap_insert(fsm->finals,GINT_TO_POINTER(id),w);
+      if (finals) {
+	gfsmStateWeightPair swp = { id, w };
+	g_array_append_val(finals, swp);
+      } else {
+	gfsm_weightmap_insert(fsm->finals,GINT_TO_POINTER(id),w);
+      }
     } else {
       st->is_final = FALSE;
     }
@@ -219,12 +279,13 @@ gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAuto
       }
       if (!rc) break;
 
-      st->arcs = gfsm_arclist_new_full(id,
-				       s_arc.target,
-				       s_arc.lower,
-				       s_arc.upper,
-				       s_arc.weight,
-				       st->arcs);
+      st->arcs = gfsm_arc_pool_node_new(pool,
+					id,
+					s_arc.target,
+					s_arc.lower,
+					s_arc.upper,
+					s_arc.weight,
+					st->arcs);
     }
 
     //-- reverse arc-list for sorted automata
@@ -234,6 +295,419 @@ gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAuto
   return rc;
 }
 
+/*--------------------------------------------------------------
+ * varint utilities (gfsmBCVarint)
+ */
+
+//-- maximum number of bytes in an encoded varint
+#define GFSM_VARINT_MAX 10
+
+//-- maximum number of bytes in an encoded gfsmBCVarint arc
+#define GFSM_VARINT_ARC_MAX (3*GFSM_VARINT_MAX + sizeof(gfsmWeight))
+
+//-- zig-zag encoding of a signed difference: small magnitudes map to small codes
+static inline
+guint64 gfsm_zigzag_encode_(gint64 d)
+{ return ((guint64)d << 1) ^ (guint64)(d >> 63); }
+
+static inline
+gint64 gfsm_zigzag_decode_(guint64 z)
+{ return (gint64)(z >> 1) ^ -(gint64)(z & 1); }
+
+//-- write varint v to p, returns pointer past written data
+static inline
+guint8 *gfsm_varint_put_(guint8 *p, guint64 v)
+{
+  while (v >= 0x80) {
+    *p++ = (guint8)(v | 0x80);
+    v  >>= 7;
+  }
+  *p++ = (guint8)v;
+  return p;
+}
+
+//-- read varint from [*pp,end) into *vp, returns FALSE on overrun
+static inline
+gboolean gfsm_varint_get_(const guint8 **pp, const guint8 *end, guint64 *vp)
+{
+  const guint8 *p = *pp;
+  guint64       v = 0;
+  guint         shift;
+  for (shift=0; p < end && shift < 64; shift += 7) {
+    guint8 b = *p++;
+    v |= (guint64)(b & 0x7f) << shift;
+    if (!(b & 0x80)) {
+      *pp = p;
+      *vp = v;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_states_varint_()
+ *   + decodes stored states [qmin,qmax) in gfsmBCVarint format from buf[0..len-1],
+ *     which must be used up exactly
+ *   + finals and pool are handled as for load_bin_states_()
+ */
+static
+gboolean gfsm_automaton_load_bin_states_varint_(gfsmAutomaton *fsm, gfsmStateId qmin, gfsmStateId qmax,
+						const guint8 *buf, gsize len, GArray *finals, gfsmArcPool *pool,
+						gfsmError **errp)
+{
+  const guint8 *p = buf, *end = buf+len;
+  gfsmWeight    one = fsm->sr->one, w;
+  gfsmStateId   id;
+  guint64       v, lo, hi;
+  guint         arci, n_arcs;
+  gfsmState    *st;
+
+  for (id=qmin; id < qmax; id++) {
+    if (!gfsm_varint_get_(&p,end,&v)) {
+      g_set_error(errp,
+		  g_quark_from_static_string("gfsm"),                     //-- domain
+		  g_quark_from_static_string("automaton_load_bin:state"), //-- code
+		  "could not read stored state %d", id);
+      return FALSE;
+    }
+    if (!(v & 1)) continue;
+
+    st           = &g_array_index(fsm->states,gfsmState,id);
+    st->is_valid = TRUE;
+    st->is_final = (v >> 1) & 1;
+    n_arcs       = (guint)(v >> 3);
+
+    if (st->is_final) {
+      //-- read final weight
+      if (v & 4) {
+	w = one;
+      } else if ((gsize)(end-p) >= sizeof(gfsmWeight)) {
+	memcpy(&w, p, sizeof(gfsmWeight));
+	p += sizeof(gfsmWeight);
+      } else {
+	g_set_error(errp,
+		    g_quark_from_static_string("gfsm"),                                  //-- domain
+		    g_quark_from_static_string("automaton_load_bin:state:final_weight"), //-- code
+		    "could not read final weight for stored state %d", id);
+	return FALSE;
+      }
+      if (finals) {
+	gfsmStateWeightPair swp = { id, w };
+	g_array_append_val(finals, swp);
+      } else {
+	gfsm_weightmap_insert(fsm->finals,GINT_TO_POINTER(id),w);
+      }
+    }
+
+    //-- read arcs
+    st->arcs = NULL;
+    for (arci=0; arci < n_arcs; arci++) {
+      if (!gfsm_varint_get_(&p,end,&v)
+	  || !gfsm_varint_get_(&p,end,&lo)
+	  || !gfsm_varint_get_(&p,end,&hi)
+	  || (!(v & 1) && (gsize)(end-p) < sizeof(gfsmWeight)))
+	{
+	  g_set_error(errp, g_quark_from_static_string("gfsm"),                   //-- domain
+		      g_quark_from_static_string("automaton_load_bin:state:arc"), //-- code
+		      "could not read stored arcs for state %d", id);
+	  return FALSE;
+	}
+      if (v & 1) {
+	w = one;
+      } else {
+	memcpy(&w, p, sizeof(gfsmWeight));
+	p += sizeof(gfsmWeight);
+      }
+      st->arcs = gfsm_arc_pool_node_new(pool,
+					id,
+					(gfsmStateId)((gint64)id + gfsm_zigzag_decode_(v >> 1)),
+					(gfsmLabelVal)lo,
+					(gfsmLabelVal)hi,
+					w,
+					st->arcs);
+    }
+
+    //-- reverse arc-list for sorted automata (as for load_bin_states_())
+    if (fsm->flags.sort_mode != gfsmASMNone) st->arcs = gfsm_arclist_reverse(st->arcs);
+  }
+
+  if (p != end) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                      //-- domain
+		g_quark_from_static_string("automaton_load_bin:states"), //-- code
+		"trailing garbage after stored states");
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_varint_()
+ *   + reads unblocked gfsmBCVarint state data: guint64 byte length followed by encoded states
+ */
+static
+gboolean gfsm_automaton_load_bin_varint_(gfsmAutomatonHeader *hdr, gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  guint64   len;
+  guint8   *buf;
+  gboolean  rc;
+
+  if (!gfsmio_read(ioh, &len, sizeof(guint64)) || len > G_MAXSIZE) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                      //-- domain
+		g_quark_from_static_string("automaton_load_bin:states"), //-- code
+		"could not read stored state data length");
+    return FALSE;
+  }
+  buf = (guint8*)g_malloc(len > 0 ? (gsize)len : 1);
+  if (len > 0 && !gfsmio_read(ioh, buf, (gsize)len)) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                      //-- domain
+		g_quark_from_static_string("automaton_load_bin:states"), //-- code
+		"could not read stored state data");
+    rc = FALSE;
+  } else {
+    rc = gfsm_automaton_load_bin_states_varint_(fsm, 0, hdr->n_states, buf, (gsize)len, NULL, fsm->arc_pool, errp);
+  }
+  g_free(buf);
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_blocks_*()
+ *   + reads blocked state data (since v0.0.21)
+ */
+
+/// shared data for parallel block decoding
+typedef struct {
+  gfsmAutomaton   *fsm;     ///< automaton being loaded
+  gfsmStoredBlock *blocks;  ///< [b] : stored block descriptors
+  gfsmStateId     *first;   ///< [b] : first state of block b
+  GString        **data;    ///< [b] : stored (compressed) data for block b
+  GArray         **finals;  ///< [b] : final (state,weight) pairs read from block b
+  gfsmArcPool    **pools;   ///< [b] : arc nodes allocated for block b (pooled automata only)
+  gfsmError      **errs;    ///< [b] : error for block b, if any
+  gfsmBinCoding    coding;  ///< state record coding
+} gfsmLoadBlocksData_;
+
+//-- decode blocks [begin,end)
+static
+void gfsm_automaton_load_bin_blocks_worker_(guint begin, guint end, guint thread_id, gfsmLoadBlocksData_ *lbd)
+{
+  guint b;
+  for (b=begin; b < end; b++) {
+    gfsmStoredBlock *blk = &lbd->blocks[b];
+    GString         *raw = lbd->data[b];
+    gfsmPosGString   pgs;
+    gfsmIOHandle    *ioh;
+
+    if (blk->z_len != blk->raw_len) {
+      //-- inflate
+#ifdef GFSM_ZLIB_ENABLED
+      uLongf raw_len = blk->raw_len;
+      raw = g_string_sized_new(blk->raw_len);
+      g_string_set_size(raw, blk->raw_len);
+      if (uncompress((Bytef*)raw->str, &raw_len, (const Bytef*)lbd->data[b]->str, blk->z_len) != Z_OK
+	  || raw_len != blk->raw_len)
+	{
+	  g_set_error(&lbd->errs[b],
+		      g_quark_from_static_string("gfsm"),                            //-- domain
+		      g_quark_from_static_string("automaton_load_bin:block:inflate"), //-- code
+		      "could not decompress stored block %u", b);
+	  g_string_free(raw,TRUE);
+	  continue;
+	}
+#else
+      g_set_error(&lbd->errs[b],
+		  g_quark_from_static_string("gfsm"),                            //-- domain
+		  g_quark_from_static_string("automaton_load_bin:block:inflate"), //-- code
+		  "stored block %u is compressed, but zlib support is disabled", b);
+      continue;
+#endif /* GFSM_ZLIB_ENABLED */
+    }
+
+    //-- decode
+    lbd->finals[b] = g_array_new(FALSE,FALSE,sizeof(gfsmStateWeightPair));
+    if (lbd->fsm->arc_pool) lbd->pools[b] = gfsm_arc_pool_new();
+    if (lbd->coding == gfsmBCVarint) {
+      gfsm_automaton_load_bin_states_varint_(lbd->fsm, lbd->first[b], lbd->first[b]+blk->n_states,
+					     (const guint8*)raw->str, raw->len, lbd->finals[b], lbd->pools[b],
+					     &lbd->errs[b]);
+      if (raw != lbd->data[b]) g_string_free(raw,TRUE);
+      continue;
+    }
+    pgs.gs  = raw;
+    pgs.pos = 0;
+    ioh     = gfsmio_new_gstring(&pgs);
+    if (gfsm_automaton_load_bin_states_(lbd->fsm, lbd->first[b], lbd->first[b]+blk->n_states,
+					ioh, lbd->finals[b], lbd->pools[b], &lbd->errs[b])
+	&& pgs.pos != raw->len)
+      {
+	g_set_error(&lbd->errs[b],
+		    g_quark_from_static_string("gfsm"),                         //-- domain
+		    g_quark_from_static_string("automaton_load_bin:block:size"), //-- code
+		    "trailing garbage in stored block %u", b);
+      }
+    gfsmio_handle_free(ioh);
+    if (raw != lbd->data[b]) g_string_free(raw,TRUE);
+  }
+}
+
+//-- read block table & data, decode blocks in parallel, and insert final weights
+static
+gboolean gfsm_automaton_load_bin_blocks_(gfsmAutomatonHeader *hdr, gfsmAutomaton *fsm, gfsmBinCoding coding,
+					 gfsmIOHandle *ioh, gfsmError **errp)
+{
+  gfsmLoadBlocksData_ lbd;
+  guint               b, n_blocks = hdr->n_blocks;
+  gfsmStateId         n_states = 0;
+  gboolean            rc = TRUE;
+
+  //-- sanity check: every stored block holds at least one state
+  if (n_blocks > hdr->n_states) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                          //-- domain
+		g_quark_from_static_string("automaton_load_bin:block_table"), //-- code
+		"bad block count %u for %u stored states", n_blocks, hdr->n_states);
+    return FALSE;
+  }
+
+  lbd.fsm    = fsm;
+  lbd.coding = coding;
+  lbd.blocks = g_new0(gfsmStoredBlock, n_blocks);
+  lbd.first  = g_new0(gfsmStateId, n_blocks);
+  lbd.data   = g_new0(GString*, n_blocks);
+  lbd.finals = g_new0(GArray*, n_blocks);
+  lbd.pools  = g_new0(gfsmArcPool*, n_blocks);
+  lbd.errs   = g_new0(gfsmError*, n_blocks);
+
+  //-- read & check block table
+  if (!gfsmio_read(ioh, lbd.blocks, n_blocks*sizeof(gfsmStoredBlock))) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                          //-- domain
+		g_quark_from_static_string("automaton_load_bin:block_table"), //-- code
+		"could not read block table");
+    rc = FALSE;
+  }
+  for (b=0; rc && b < n_blocks; b++) {
+    lbd.first[b] = n_states;
+    n_states    += lbd.blocks[b].n_states;
+    if (lbd.blocks[b].n_states == 0 || n_states < lbd.first[b] || n_states > hdr->n_states
+	|| lbd.blocks[b].z_len > lbd.blocks[b].raw_len)
+    {
+      g_set_error(errp,
+		  g_quark_from_static_string("gfsm"),                          //-- domain
+		  g_quark_from_static_string("automaton_load_bin:block_table"), //-- code
+		  "bad block table entry for block %u", b);
+      rc = FALSE;
+    }
+  }
+  if (rc && n_states != hdr->n_states) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),                          //-- domain
+		g_quark_from_static_string("automaton_load_bin:block_table"), //-- code
+		"block table covers %u states, expected %u", n_states, hdr->n_states);
+    rc = FALSE;
+  }
+
+  //-- read stored block data
+  for (b=0; rc && b < n_blocks; b++) {
+    lbd.data[b] = g_string_sized_new(lbd.blocks[b].z_len);
+    g_string_set_size(lbd.data[b], lbd.blocks[b].z_len);
+    if (lbd.blocks[b].z_len > 0 && !gfsmio_read(ioh, lbd.data[b]->str, lbd.blocks[b].z_len)) {
+      g_set_error(errp,
+		  g_quark_from_static_string("gfsm"),                    //-- domain
+		  g_quark_from_static_string("automaton_load_bin:block"), //-- code
+		  "could not read stored block %u", b);
+      rc = FALSE;
+    }
+  }
+
+  //-- decode blocks (parallel)
+  if (rc) {
+    gfsm_parallel_for(n_blocks, 0, 1, (gfsmParallelFunc)gfsm_automaton_load_bin_blocks_worker_, &lbd);
+  }
+
+  //-- collect final weights, arc nodes & errors (sequential)
+  for (b=0; b < n_blocks; b++) {
+    if (lbd.pools[b]) {
+      gfsm_arc_pool_merge(fsm->arc_pool, lbd.pools[b]);
+      gfsm_arc_pool_free(lbd.pools[b]);
+    }
+    if (rc && lbd.errs[b]) {
+      g_propagate_error(errp, lbd.errs[b]);
+      lbd.errs[b] = NULL;
+      rc = FALSE;
+    }
+    if (rc && lbd.finals[b]) {
+      guint i;
+      for (i=0; i < lbd.finals[b]->len; i++) {
+	gfsmStateWeightPair *swp = &g_array_index(lbd.finals[b],gfsmStateWeightPair,i);
+	gfsm_weightmap_insert(fsm->finals,GINT_TO_POINTER(swp->id),swp->w);
+      }
+    }
+    if (lbd.errs[b])   g_error_free(lbd.errs[b]);
+    if (lbd.finals[b]) g_array_free(lbd.finals[b],TRUE);
+    if (lbd.data[b])   g_string_free(lbd.data[b],TRUE);
+  }
+
+  g_free(lbd.blocks);
+  g_free(lbd.first);
+  g_free(lbd.data);
+  g_free(lbd.finals);
+  g_free(lbd.pools);
+  g_free(lbd.errs);
+
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_handle_0_0_8()
+ *   + supports stored file versions v0.0.8 -- CURRENT
+ */
+gboolean gfsm_automaton_load_bin_handle_0_0_8(gfsmAutomatonHeader *hdr, gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  gboolean      rc;
+  gfsmBinCoding coding = gfsmBCFixed;
+
+  //-- check state record coding (reserved in files older than v0.0.22)
+  if (gfsm_version_ge(hdr->version, gfsm_version_bincompat_min_store_varint)) {
+    coding = (gfsmBinCoding)hdr->arc_coding;
+    if (coding != gfsmBCFixed && coding != gfsmBCVarint) {
+      g_set_error(errp,
+		  g_quark_from_static_string("gfsm"),                      //-- domain
+		  g_quark_from_static_string("automaton_load_bin:coding"), //-- code
+		  "unknown stored record coding %u", hdr->arc_coding);
+      return FALSE;
+    }
+  }
+
+  //-- allocate states
+  gfsm_automaton_reserve(fsm, hdr->n_states);
+
+  //-- set automaton-global properties
+  fsm->flags   = hdr->flags;
+  gfsm_automaton_set_semiring_type(fsm, hdr->srtype);
+  fsm->root_id = hdr->root_id;
+
+  //------ load states
+  if (hdr->n_blocks > 0 && gfsm_version_ge(hdr->version, gfsm_version_bincompat_min_store_blocked))
+    rc = gfsm_automaton_load_bin_blocks_(hdr, fsm, coding, ioh, errp);
+  else if (coding == gfsmBCVarint)
+    rc = gfsm_automaton_load_bin_varint_(hdr, fsm, ioh, errp);
+  else
+    rc = gfsm_automaton_load_bin_states_(fsm, 0, hdr->n_states, ioh, NULL, fsm->arc_pool, errp);
+
+  //------ load arc indices (maybe)
+  if (rc && (hdr->arc_indices & 1))
+    rc = gfsm_automaton_load_bin_arc_index_(fsm, &fsm->index_lower, ioh, errp);
+  if (rc && (hdr->arc_indices & 2))
+    rc = gfsm_automaton_load_bin_arc_index_(fsm, &fsm->index_upper, ioh, errp);
+
+  return rc;
+}
+
 
 /*--------------------------------------------------------------
  * load_bin_handle_0_0_7()
@@ -255,6 +729,7 @@ gboolean gfsm_automaton_load_bin_handle_0_0_7(gfsmAutomatonHeader *hdr, gfsmAuto
   gfsmStoredState_007 s_state;
   gfsmState       *st;
   gboolean         rc = TRUE;
+  gfsmArcPool     *pool = fsm->arc_pool;
 
   //-- allocate states
   gfsm_automaton_reserve(fsm, hdr->n_states);
@@ -263,6 +738,7 @@ gboolean gfsm_automaton_load_bin_handle_0_0_7(gfsmAutomatonHeader *hdr, gfsmAuto
   fsm->flags   = hdr->flags;
   gfsm_semiring_init(fsm->sr, hdr->srtype);
   fsm->root_id = hdr->root_id;
+  gfsm_arc_pool_reserve(pool, hdr->n_arcs_007);
 
   //------ load states (one-by-one)
   for (id=0; rc && id < hdr->n_states; id++) {
@@ -309,12 +785,13 @@ gboolean gfsm_automaton_load_bin_handle_0_0_7(gfsmAutomatonHeader *hdr, gfsmAuto
 	break;
       }
 
-      st->arcs = gfsm_arclist_new_full(id,
-				       s_arc.target,
-				       s_arc.lower,
-				       s_arc.upper,
-				       s_arc.weight,
-				       st->arcs);
+      st->arcs = gfsm_arc_pool_node_new(pool,
+					id,
+					s_arc.target,
+					s_arc.lower,
+					s_arc.upper,
+					s_arc.weight,
+					st->arcs);
     }
 
     //-- reverse arc-list for sorted automata
@@ -396,11 +873,38 @@ gboolean gfsm_automaton_load_bin_gstring(gfsmAutomaton *fsm, GString *gs, gfsmEr
  */
 
 /*--------------------------------------------------------------
- * save_bin_handle()
+ * save_bin_header_init_()
+ *   + initializes a stored header for fsm, (re-)building arc indices if required
  */
-gboolean gfsm_automaton_save_bin_handle(gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp)
+static
+void gfsm_automaton_save_bin_header_init_(gfsmAutomaton *fsm, gfsmAutomatonHeader *hdr)
+{
+  memset(hdr, 0, sizeof(gfsmAutomatonHeader));
+  strcpy(hdr->magic, gfsm_header_magic);
+  hdr->version     = gfsm_version;
+  hdr->version_min = gfsm_version_bincompat_min_store;
+  hdr->flags       = fsm->flags;
+  hdr->root_id     = fsm->root_id;
+  hdr->n_states    = gfsm_automaton_n_states(fsm);
+  //hdr->n_arcs_007= gfsm_automaton_n_arcs(fsm);
+  hdr->srtype      = gfsm_automaton_get_semiring(fsm)->type;
+  if (fsm->flags.is_indexed) {
+    //-- (re-)build cached arc indices
+    gfsm_automaton_get_arc_index(fsm, gfsmLSLower);
+    gfsm_automaton_get_arc_index(fsm, gfsmLSUpper);
+    hdr->arc_indices = 3;
+    hdr->version_min = gfsm_version_bincompat_min_store_indexed;
+  }
+}
+
+/*--------------------------------------------------------------
+ * save_bin_states_()
+ *   + writes states [qmin,qmax) in v0.0.8 format to ioh
+ *   + read-only on fsm: safe to call concurrently for disjoint state ranges
+ */
+static
+gboolean gfsm_automaton_save_bin_states_(gfsmAutomaton *fsm, gfsmStateId qmin, gfsmStateId qmax, gfsmIOHandle *ioh, gfsmError **errp)
 {
-  gfsmAutomatonHeader hdr;
   gfsmStateId         id;
   gfsmState           *st;
   gfsmStoredState     sst;
@@ -409,30 +913,11 @@ gboolean gfsm_automaton_save_bin_handle(gfsmAutomaton *fsm, gfsmIOHandle *ioh, g
   gfsmArcIter         ai;
   gboolean            rc = TRUE;
 
-  //-- create header
-  memset(&hdr, 0, sizeof(gfsmAutomatonHeader));
-  strcpy(hdr.magic, gfsm_header_magic);
-  hdr.version     = gfsm_version;
-  hdr.version_min = gfsm_version_bincompat_min_store;
-  hdr.flags       = fsm->flags;
-  hdr.root_id     = fsm->root_id;
-  hdr.n_states    = gfsm_automaton_n_states(fsm);
-  //hdr.n_arcs_007= gfsm_automaton_n_arcs(fsm);
-  hdr.srtype      = gfsm_automaton_get_semiring(fsm)->type;
-
-  //-- write header
-  if (!gfsmio_write(ioh, &hdr, sizeof(gfsmAutomatonHeader))) {
-    g_set_error(errp, g_quark_from_static_string("gfsm"),                      //-- domain
-		      g_quark_from_static_string("automaton_save_bin:header"), //-- code
-		      "could not store header");
-    return FALSE;
-  }
-
   //-- zero stored state (allow zlib compression to work better for any 'unused' members)
   memset(&sst, 0, sizeof(gfsmStoredState));
 
   //-- write states
-  for (id=0; rc && id < hdr.n_states; id++) {
+  for (id=qmin; rc && id < qmax; id++) {
     //-- store basic state information
     st           = &g_array_index(fsm->states, gfsmState, id);
     sst.is_valid = st->is_valid;
@@ -477,6 +962,274 @@ gboolean gfsm_automaton_save_bin_handle(gfsmAutomaton *fsm, gfsmIOHandle *ioh, g
   return rc;
 }
 
+/*--------------------------------------------------------------
+ * save_bin_states_varint_()
+ *   + appends states [qmin,qmax) in gfsmBCVarint format to gs
+ *   + read-only on fsm: safe to call concurrently for disjoint state ranges
+ */
+static
+void gfsm_automaton_save_bin_states_varint_(gfsmAutomaton *fsm, gfsmStateId qmin, gfsmStateId qmax, GString *gs)
+{
+  gfsmWeight   one = fsm->sr->one, w;
+  gfsmStateId  id;
+  gfsmState   *st;
+  gfsmArcIter  ai;
+  guint        n_arcs;
+  gsize        pos;
+  guint8      *p;
+
+  for (id=qmin; id < qmax; id++) {
+    st = &g_array_index(fsm->states, gfsmState, id);
+    if (!st->is_valid) {
+      g_string_append_c(gs, 0);
+      continue;
+    }
+
+    //-- reserve worst-case space for this state
+    n_arcs = gfsm_state_out_degree(st);
+    pos    = gs->len;
+    g_string_set_size(gs, pos + GFSM_VARINT_MAX + sizeof(gfsmWeight) + (gsize)n_arcs*GFSM_VARINT_ARC_MAX);
+    p      = (guint8*)gs->str + pos;
+
+    //-- state record & final weight (maybe)
+    w = st->is_final ? gfsm_automaton_get_final_weight(fsm,id) : one;
+    p = gfsm_varint_put_(p, ((guint64)n_arcs << 3)
+			 | ((st->is_final && w == one) ? 4 : 0)
+			 | (st->is_final ? 2 : 0)
+			 | 1);
+    if (st->is_final && w != one) {
+      memcpy(p, &w, sizeof(gfsmWeight));
+      p += sizeof(gfsmWeight);
+    }
+
+    //-- arcs
+    for (gfsm_arciter_open_ptr(&ai,fsm,st); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      gfsmArc *a = gfsm_arciter_arc(&ai);
+      p = gfsm_varint_put_(p, (gfsm_zigzag_encode_((gint64)a->target - (gint64)id) << 1) | (a->weight == one ? 1 : 0));
+      p = gfsm_varint_put_(p, a->lower);
+      p = gfsm_varint_put_(p, a->upper);
+      if (a->weight != one) {
+	memcpy(p, &a->weight, sizeof(gfsmWeight));
+	p += sizeof(gfsmWeight);
+      }
+    }
+
+    g_string_set_size(gs, p - (guint8*)gs->str);
+  }
+}
+
+/*--------------------------------------------------------------
+ * save_bin_handle()
+ */
+gboolean gfsm_automaton_save_bin_handle(gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  return gfsm_automaton_save_bin_handle_full(fsm, ioh, gfsmBCFixed, errp);
+}
+
+/*--------------------------------------------------------------
+ * save_bin_handle_full()
+ */
+gboolean gfsm_automaton_save_bin_handle_full(gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmBinCoding coding, gfsmError **errp)
+{
+  gfsmAutomatonHeader hdr;
+  gboolean            rc = TRUE;
+
+  //-- create header
+  gfsm_automaton_save_bin_header_init_(fsm, &hdr);
+  if (coding == gfsmBCVarint) {
+    hdr.arc_coding = coding;
+    if (gfsm_version_less(hdr.version_min, gfsm_version_bincompat_min_store_varint))
+      hdr.version_min = gfsm_version_bincompat_min_store_varint;
+  }
+
+  //-- write header
+  if (!gfsmio_write(ioh, &hdr, sizeof(gfsmAutomatonHeader))) {
+    g_set_error(errp, g_quark_from_static_string("gfsm"),                      //-- domain
+		      g_quark_from_static_string("automaton_save_bin:header"), //-- code
+		      "could not store header");
+    return FALSE;
+  }
+
+  //-- write states
+  if (coding == gfsmBCVarint) {
+    GString *gs  = g_string_new("");
+    guint64  len;
+    gfsm_automaton_save_bin_states_varint_(fsm, 0, hdr.n_states, gs);
+    len = gs->len;
+    if (!gfsmio_write(ioh, &len, sizeof(guint64)) || (len > 0 && !gfsmio_write(ioh, gs->str, gs->len))) {
+      g_set_error(errp, g_quark_from_static_string("gfsm"),                      //-- domain
+		  g_quark_from_static_string("automaton_save_bin:states"), //-- code
+		  "could not store states");
+      rc = FALSE;
+    }
+    g_string_free(gs,TRUE);
+  }
+  else {
+    rc = gfsm_automaton_save_bin_states_(fsm, 0, hdr.n_states, ioh, errp);
+  }
+
+  //-- store arc indices (maybe)
+  if (rc && hdr.arc_indices) {
+    rc = (gfsm_arc_table_index_write_bin_handle(fsm->index_lower, ioh, errp)
+	  && gfsm_arc_table_index_write_bin_handle(fsm->index_upper, ioh, errp));
+  }
+
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * save_bin_blocks_*()
+ *   + blocked binary output (since v0.0.21)
+ */
+
+/// shared data for parallel block encoding
+typedef struct {
+  gfsmAutomaton   *fsm;          ///< automaton being stored
+  gfsmStoredBlock *blocks;       ///< [b] : stored block descriptors
+  GString        **data;         ///< [b] : stored (compressed) data for block b
+  gfsmError      **errs;         ///< [b] : error for block b, if any
+  guint            block_states; ///< states per block
+  int              zlevel;       ///< zlib compression level
+  gfsmBinCoding    coding;       ///< state record coding
+} gfsmSaveBlocksData_;
+
+//-- encode blocks [begin,end)
+static
+void gfsm_automaton_save_bin_blocks_worker_(guint begin, guint end, guint thread_id, gfsmSaveBlocksData_ *sbd)
+{
+  gfsmStateId n_states = gfsm_automaton_n_states(sbd->fsm);
+  guint b;
+  for (b=begin; b < end; b++) {
+    gfsmStateId      qmin = b*sbd->block_states;
+    gfsmStateId      qmax = qmin + sbd->block_states;
+    gfsmStoredBlock *blk  = &sbd->blocks[b];
+    gfsmPosGString   pgs;
+    gfsmIOHandle    *ioh;
+    if (qmax > n_states) qmax = n_states;
+
+    //-- serialize
+    pgs.gs  = g_string_new("");
+    pgs.pos = 0;
+    if (sbd->coding == gfsmBCVarint) {
+      gfsm_automaton_save_bin_states_varint_(sbd->fsm, qmin, qmax, pgs.gs);
+    } else {
+      ioh = gfsmio_new_gstring(&pgs);
+      gfsm_automaton_save_bin_states_(sbd->fsm, qmin, qmax, ioh, &sbd->errs[b]);
+      gfsmio_handle_free(ioh);
+    }
+    if (pgs.gs->len > G_MAXUINT32) {
+      g_set_error(&sbd->errs[b],
+		  g_quark_from_static_string("gfsm"),                         //-- domain
+		  g_quark_from_static_string("automaton_save_bin:block:size"), //-- code
+		  "stored block %u is too large", b);
+    }
+
+    blk->n_states = qmax-qmin;
+    blk->raw_len  = pgs.gs->len;
+    blk->z_len    = pgs.gs->len;
+    sbd->data[b]  = pgs.gs;
+
+#ifdef GFSM_ZLIB_ENABLED
+    //-- deflate (keep raw data unless it gets smaller)
+    if (sbd->zlevel != 0 && !sbd->errs[b]) {
+      uLongf   z_len = compressBound(pgs.gs->len);
+      GString *zs    = g_string_sized_new(z_len);
+      g_string_set_size(zs, z_len);
+      if (compress2((Bytef*)zs->str, &z_len, (const Bytef*)pgs.gs->str, pgs.gs->len,
+		    sbd->zlevel < 0 ? Z_DEFAULT_COMPRESSION : sbd->zlevel) == Z_OK
+	  && z_len < pgs.gs->len)
+	{
+	  g_string_set_size(zs, z_len);
+	  blk->z_len   = z_len;
+	  sbd->data[b] = zs;
+	  g_string_free(pgs.gs,TRUE);
+	}
+      else {
+	g_string_free(zs,TRUE);
+      }
+    }
+#endif /* GFSM_ZLIB_ENABLED */
+  }
+}
+
+/*--------------------------------------------------------------
+ * save_bin_handle_blocked()
+ */
+gboolean gfsm_automaton_save_bin_handle_blocked(gfsmAutomaton *fsm, gfsmIOHandle *ioh, int zlevel, guint block_states, guint n_threads,
+						gfsmBinCoding coding, gfsmError **errp)
+{
+  gfsmAutomatonHeader hdr;
+  gfsmSaveBlocksData_ sbd;
+  guint               b;
+  gboolean            rc = TRUE;
+
+  //-- create header
+  gfsm_automaton_save_bin_header_init_(fsm, &hdr);
+  if (block_states == 0) block_states = gfsmAutomatonDefaultBlockStates;
+  hdr.n_blocks = (hdr.n_states + block_states - 1) / block_states;
+  if (hdr.n_blocks > 0) {
+    hdr.arc_coding  = coding;
+    if (gfsm_version_less(hdr.version_min, gfsm_version_bincompat_min_store_blocked))
+      hdr.version_min = gfsm_version_bincompat_min_store_blocked;
+    if (coding == gfsmBCVarint && gfsm_version_less(hdr.version_min, gfsm_version_bincompat_min_store_varint))
+      hdr.version_min = gfsm_version_bincompat_min_store_varint;
+  }
+
+  //-- encode blocks (parallel)
+  sbd.fsm          = fsm;
+  sbd.blocks       = g_new0(gfsmStoredBlock, hdr.n_blocks);
+  sbd.data         = g_new0(GString*, hdr.n_blocks);
+  sbd.errs         = g_new0(gfsmError*, hdr.n_blocks);
+  sbd.block_states = block_states;
+  sbd.zlevel       = zlevel;
+  sbd.coding       = coding;
+  gfsm_parallel_for(hdr.n_blocks, n_threads, 1, (gfsmParallelFunc)gfsm_automaton_save_bin_blocks_worker_, &sbd);
+  for (b=0; rc && b < hdr.n_blocks; b++) {
+    if (sbd.errs[b]) {
+      g_propagate_error(errp, sbd.errs[b]);
+      sbd.errs[b] = NULL;
+      rc = FALSE;
+    }
+  }
+
+  //-- write header & block table
+  if (rc && (!gfsmio_write(ioh, &hdr, sizeof(gfsmAutomatonHeader))
+	     || (hdr.n_blocks > 0 && !gfsmio_write(ioh, sbd.blocks, hdr.n_blocks*sizeof(gfsmStoredBlock)))))
+    {
+      g_set_error(errp, g_quark_from_static_string("gfsm"),                      //-- domain
+		  g_quark_from_static_string("automaton_save_bin:header"), //-- code
+		  "could not store header");
+      rc = FALSE;
+    }
+
+  //-- write block data
+  for (b=0; rc && b < hdr.n_blocks; b++) {
+    if (sbd.data[b]->len > 0 && !gfsmio_write(ioh, sbd.data[b]->str, sbd.data[b]->len)) {
+      g_set_error(errp, g_quark_from_static_string("gfsm"),                    //-- domain
+		  g_quark_from_static_string("automaton_save_bin:block"), //-- code
+		  "could not store block %u", b);
+      rc = FALSE;
+    }
+  }
+
+  //-- store arc indices (maybe)
+  if (rc && hdr.arc_indices) {
+    rc = (gfsm_arc_table_index_write_bin_handle(fsm->index_lower, ioh, errp)
+	  && gfsm_arc_table_index_write_bin_handle(fsm->index_upper, ioh, errp));
+  }
+
+  //-- cleanup
+  for (b=0; b < hdr.n_blocks; b++) {
+    if (sbd.errs[b]) g_error_free(sbd.errs[b]);
+    if (sbd.data[b]) g_string_free(sbd.data[b],TRUE);
+  }
+  g_free(sbd.blocks);
+  g_free(sbd.data);
+  g_free(sbd.errs);
+
+  return rc;
+}
+
 /*--------------------------------------------------------------
  * save_bin_file()
  */
@@ -508,9 +1261,31 @@ gboolean gfsm_automaton_save_bin_filename_nc(gfsmAutomaton *fsm, const gchar *fi
  * save_bin_filename()
  */
 gboolean gfsm_automaton_save_bin_filename(gfsmAutomaton *fsm, const gchar *filename, int zlevel, gfsmError **errp)
+{
+  return gfsm_automaton_save_bin_filename_full(fsm, filename, zlevel, gfsmBCFixed, errp);
+}
+
+/*--------------------------------------------------------------
+ * save_bin_filename_full()
+ */
+gboolean gfsm_automaton_save_bin_filename_full(gfsmAutomaton *fsm, const gchar *filename, int zlevel, gfsmBinCoding coding, gfsmError **errp)
 {
   gfsmIOHandle *ioh = gfsmio_new_filename(filename, "wb", zlevel, errp);
-  gboolean rc = ioh && !(*errp) && gfsm_automaton_save_bin_handle(fsm, ioh, errp);
+  gboolean rc = ioh && !(*errp) && gfsm_automaton_save_bin_handle_full(fsm, ioh, coding, errp);
+  if (ioh) {
+    gfsmio_close(ioh);
+    gfsmio_handle_free(ioh);
+  }
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * save_bin_filename_blocked()
+ */
+gboolean gfsm_automaton_save_bin_filename_blocked(gfsmAutomaton *fsm, const gchar *filename, int zlevel, gfsmBinCoding coding, gfsmError **errp)
+{
+  gfsmIOHandle *ioh = gfsmio_new_filename(filename, "wb", 0, errp);
+  gboolean rc = ioh && !(*errp) && gfsm_automaton_save_bin_handle_blocked(fsm, ioh, zlevel, 0, 0, coding, errp);
   if (ioh) {
     gfsmio_close(ioh);
     gfsmio_handle_free(ioh);
@@ -538,6 +1313,162 @@ gboolean gfsm_automaton_save_bin_gstring(gfsmAutomaton *fsm, GString *gs, gfsmEr
  * Methods: Text I/O: compile()
  */
 
+/*--------------------------------------------------------------
+ * compile_*_()
+ *   + chunked text parsing: each chunk is split into pieces at line boundaries,
+ *     pieces are tokenized and converted in parallel, and the resulting line records
+ *     are applied to the automaton sequentially in input order
+ */
+
+//-- approximate number of bytes per piece for parallel parsing
+#define GFSM_COMPILE_PIECE_SIZE 262144
+
+/// parsed text line
+typedef struct {
+  guint        line;      ///< line index relative to the start of the piece
+  guint        nfields;   ///< number of fields on the line
+  gchar       *field[5];  ///< NUL-terminated fields (pointers into the chunk buffer)
+  gfsmStateId  q1;        ///< source state (numeric input only)
+  gfsmWeight   w;         ///< final weight
+  gfsmArcList *node;      ///< new arc node for arc lines, with numeric fields already converted
+} gfsmCompileLine_;
+
+/// shared data for parallel text parsing
+typedef struct {
+  gchar       *buf;           ///< chunk buffer
+  gsize       *bounds;        ///< [i] : offset of piece i; bounds[n_pieces] is the chunk length
+  GArray     **lines;         ///< [i] : gfsmCompileLine_ records parsed from piece i
+  guint       *n_lines;       ///< [i] : number of text lines in piece i
+  gfsmArcPool **pools;        ///< [i] : arc nodes allocated for piece i, or NULL if fsm is not pooled
+  gboolean     is_transducer; ///< whether to parse upper labels
+  gboolean     sym_states;    ///< whether states are resolved by alphabet lookup
+  gboolean     sym_lo;        ///< whether lower labels are resolved by alphabet lookup
+  gboolean     sym_hi;        ///< whether upper labels are resolved by alphabet lookup
+  gfsmWeight   one;           ///< default arc weight
+} gfsmCompileData_;
+
+//-- strtol(s,NULL,10) with a fast path for short all-digit strings
+static inline
+guint32 gfsm_compile_strtol_(const gchar *s)
+{
+  const gchar *p;
+  guint32      v = 0;
+  for (p=s; *p >= '0' && *p <= '9' && p-s < 9; p++)
+    v = 10*v + (guint32)(*p - '0');
+  if (*p == '\0' && p != s) return v;
+  return (guint32)strtol(s,NULL,10);
+}
+
+//-- strtod(s,NULL) with an exact fast path for short plain decimals ([-]digits[.digits])
+static inline
+gdouble gfsm_compile_strtod_(const gchar *s)
+{
+  static const gdouble pow10[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+				   1e10, 1e11, 1e12, 1e13, 1e14, 1e15 };
+  const gchar *p = s;
+  guint64      m = 0;
+  guint        n_digits = 0, n_frac = 0;
+  gboolean     neg = (*p == '-');
+  if (neg) p++;
+  for ( ; *p >= '0' && *p <= '9'; p++, n_digits++) m = 10*m + (guint64)(*p - '0');
+  if (*p == '.') {
+    for (p++; *p >= '0' && *p <= '9'; p++, n_digits++, n_frac++) m = 10*m + (guint64)(*p - '0');
+  }
+  if (*p != '\0' || n_digits == 0 || n_digits > 15) return strtod(s,NULL);
+  //-- m < 2^53 and 10^n_frac are exact, so the quotient is correctly rounded (as for strtod())
+  return neg ? -((gdouble)m / pow10[n_frac]) : ((gdouble)m / pow10[n_frac]);
+}
+
+//-- alphabet lookup for a single field, inserting new labels
+static inline
+gfsmLabelVal gfsm_compile_lookup_(gfsmAlphabet *a, GString *gs, const gchar *s)
+{
+  gpointer     key;
+  gfsmLabelVal lab;
+  g_string_assign(gs,s);
+  key = gfsm_alphabet_string2key(a, gs);
+  if ((lab = gfsm_alphabet_find_label(a,key)) == gfsmNoLabel)
+    lab = gfsm_alphabet_get_label(a, key);
+  return lab;
+}
+
+//-- tokenize and convert pieces [begin,end)
+static
+void gfsm_automaton_compile_worker_(guint begin, guint end, GFSM_UNUSED guint thread_id, gfsmCompileData_ *cd)
+{
+  guint i;
+  for (i=begin; i < end; i++) {
+    gchar            *p   = cd->buf + cd->bounds[i];
+    gchar            *eop = cd->buf + cd->bounds[i+1];
+    gchar            *eol, *b1, *b2, *b3, *b4, *b5, *e;
+    GArray           *lines = g_array_new(FALSE,FALSE,sizeof(gfsmCompileLine_));
+    gfsmCompileLine_  rec;
+    guint             n_lines;
+    gfsmArcPool      *pool = cd->pools ? (cd->pools[i] = gfsm_arc_pool_new()) : NULL;
+
+    for (n_lines=0; p < eop; n_lines++, p = eol+1) {
+      if (!(eol = memchr(p, '\n', eop-p))) eol = eop;
+      *eol = '\0';
+
+      //-- split fields (as for gfsm_automaton_compile_handle() v0.0.20)
+      for (b1 = p ; *b1 &&  isspace(*b1); b1++) { *b1 = '\0'; }
+      for (b2 = b1; *b2 && !isspace(*b2); b2++) ;
+      for (       ; *b2 &&  isspace(*b2); b2++) { *b2 = '\0'; }
+      if (b2 == b1) continue; //-- empty line
+      rec.nfields = 1;
+
+      for (b3 = b2; *b3 && !isspace(*b3); b3++) ;
+      for (       ; *b3 &&  isspace(*b3); b3++) { *b3 = '\0'; }
+      if (b3 != b2) rec.nfields = 2;
+
+      for (b4 = b3; *b4 && !isspace(*b4); b4++) ;
+      for (       ; *b4 &&  isspace(*b4); b4++) { *b4 = '\0'; }
+      if (b4 != b3) rec.nfields = 3;
+
+      for (b5 = b4; *b5 && !isspace(*b5); b5++) ;
+      for (       ; *b5 &&  isspace(*b5); b5++) { *b5 = '\0'; }
+      if (b5 != b4) rec.nfields = 4;
+
+      for (e = b5; *e && !isspace(*e); e++) ;
+      if (e != b5) rec.nfields = 5;
+      *e = '\0';
+
+      rec.line     = n_lines;
+      rec.field[0] = b1;
+      rec.field[1] = b2;
+      rec.field[2] = b3;
+      rec.field[3] = b4;
+      rec.field[4] = b5;
+      rec.q1   = cd->sym_states ? 0 : gfsm_compile_strtol_(b1);
+      rec.w    = cd->one;
+      rec.node = NULL;
+
+      //-- numeric conversion
+      if (rec.nfields == 2) {
+	rec.w = gfsm_compile_strtod_(b2);
+      }
+      else if (rec.nfields >= 3) {
+	gfsmArc *a;
+	rec.node  = gfsm_arc_pool_node_new(pool, rec.q1, 0, 0, 0, cd->one, NULL);
+	a         = &rec.node->arc;
+	if (!cd->sym_states) a->target = gfsm_compile_strtol_(b2);
+	if (!cd->sym_lo)     a->lower  = gfsm_compile_strtol_(b3);
+	if (cd->is_transducer) {
+	  if (rec.nfields > 3 && !cd->sym_hi) a->upper  = gfsm_compile_strtol_(b4);
+	  if (rec.nfields >= 5)               a->weight = gfsm_compile_strtod_(b5);
+	}
+	else if (rec.nfields >= 4) {
+	  a->weight = gfsm_compile_strtod_(b4);
+	}
+      }
+      g_array_append_val(lines, rec);
+    }
+
+    cd->lines[i]   = lines;
+    cd->n_lines[i] = n_lines;
+  }
+}
+
 /*--------------------------------------------------------------
  * compile_handle()
  */
@@ -548,123 +1479,152 @@ gboolean gfsm_automaton_compile_handle (gfsmAutomaton *fsm,
 					gfsmAlphabet  *state_alphabet,
 					GFSM_UNUSED gfsmError **errp)
 {
-  gfsmStateId q1, q2;
-  gfsmLabelId lo, hi;
-  gfsmWeight  w;
-  char       *buf = NULL;
-  size_t      buflen = 0;
-  guint       lineno = 1;
-  char       *b1, *b2, *b3, *b4, *b5, *end;
-  GString    *gs = g_string_new("");
-  gpointer    key;
-  gboolean    rc = TRUE;
-
-  /*extern int getline(char **, size_t *, FILE *);*/
-  for (lineno=1; rc && gfsmio_getline(ioh,&buf,&buflen) > 0; ++lineno) {
-    b1 = b2 = b3 = b4 = b5 = end = NULL;
-    short int nfields = 0;
-
-    //-- get pointers to initial elements of the line
-    for (b1 = buf; b1 && *b1 &&  isspace(*b1); b1++) { *b1 = '\0'; }
-
-    for (b2 = b1 ; b2 && *b2 && !isspace(*b2); b2++) ;
-    for (        ; b2 && *b2 &&  isspace(*b2); b2++) { *b2 = '\0'; }
-    if (b2 != b1) nfields = 1;
+  gfsmCompileData_ cd;
+  gsize            cap = gfsmAutomatonCompileChunkSize, have = 0, want, split, n;
+  guint            lineno = 0, n_arcs = 0, n_pieces, i, j;
+  gboolean         eof = FALSE;
+  GArray          *bounds = g_array_new(FALSE,FALSE,sizeof(gsize));
+  GString         *gs = g_string_new("");
+  gfsmStateId      q1;
+  gfsmState       *qp1;
+
+  cd.buf           = (gchar*)g_malloc(cap+1);
+  cd.is_transducer = fsm->flags.is_transducer;
+  cd.sym_states    = state_alphabet != NULL;
+  cd.sym_lo        = lo_alphabet != NULL;
+  cd.sym_hi        = hi_alphabet != NULL;
+  cd.one           = fsm->sr->one;
+
+  while (!eof) {
+    //-- fill buffer
+    want  = cap - have;
+    n     = gfsmio_read_partial(ioh, cd.buf+have, want);
+    have += n;
+    eof   = (n < want);
+
+    //-- find end of last complete line
+    if (eof) split = have;
     else {
-      //-- empty line
-      continue;
-    }
-
-    for (b3 = b2 ; b3 && *b3 && !isspace(*b3); b3++) ;
-    for (        ; b3 && *b3 &&  isspace(*b3); b3++) { *b3 = '\0'; }
-    if (b3 != b2) nfields = 2;
-
-    for (b4 = b3 ; b4 && *b4 && !isspace(*b4); b4++) ;
-    for (        ; b4 && *b4 &&  isspace(*b4); b4++) { *b4 = '\0'; }
-    if (b4 != b3) nfields = 3;
-
-    for (b5 = b4 ; b5 && *b5 && !isspace(*b5); b5++) ;
-    for (        ; b5 && *b5 &&  isspace(*b5); b5++) { *b5 = '\0'; }
-    if (b5 != b4) nfields = 4;
-
-    for (end = b5; end && *end && !isspace(*end); end++) ;
-    if (end) *end = '\0';
-    if (end != b5) nfields = 5;
-
-    //---- q1: source state
-    if (state_alphabet) {
-      g_string_assign(gs,b1);
-      key = gfsm_alphabet_string2key(state_alphabet, gs);
-      if ((q1 = gfsm_alphabet_find_label(state_alphabet,key)) == gfsmNoLabel)
-	q1 = gfsm_alphabet_get_label(state_alphabet, key);
-    } else q1 = strtol(b1,NULL,10);
-    if (fsm->root_id == gfsmNoState) fsm->root_id = q1;
-
-    //-- weightless final state?
-    if (nfields == 1) {
-      gfsm_automaton_set_final_state(fsm,q1,TRUE);
-      continue;
+      for (split=have; split > 0 && cd.buf[split-1] != '\n'; split--) ;
+      if (split == 0) {
+	//-- line longer than buffer: grow
+	cap *= 2;
+	cd.buf = (gchar*)g_realloc(cd.buf, cap+1);
+	continue;
+      }
     }
-    //-- weighted final state?
-    else if (nfields == 2) {
-      w = strtod(b2,NULL);
-      gfsm_automaton_set_final_state_full(fsm,q1,TRUE,w);
-      continue;
+    cd.buf[have] = '\0';
+
+    //-- split into pieces at line boundaries
+    g_array_set_size(bounds, 0);
+    for (n=0; n < split; ) {
+      gchar *nl;
+      g_array_append_val(bounds, n);
+      if (split-n <= GFSM_COMPILE_PIECE_SIZE) break;
+      nl = memchr(cd.buf + n + GFSM_COMPILE_PIECE_SIZE - 1, '\n', split - n - GFSM_COMPILE_PIECE_SIZE + 1);
+      n  = nl ? (gsize)(nl - cd.buf) + 1 : split;
     }
+    n_pieces = bounds->len;
+    g_array_append_val(bounds, split);
+
+    //-- parse pieces (parallel)
+    cd.bounds  = (gsize*)bounds->data;
+    cd.lines   = g_new0(GArray*, n_pieces);
+    cd.n_lines = g_new0(guint, n_pieces);
+    cd.pools   = fsm->arc_pool ? g_new0(gfsmArcPool*, n_pieces) : NULL;
+    gfsm_parallel_for(n_pieces, 0, 1, (gfsmParallelFunc)gfsm_automaton_compile_worker_, &cd);
+
+    //-- apply parsed lines (sequential, in input order)
+    for (i=0; i < n_pieces; i++) {
+      for (j=0; j < cd.lines[i]->len; j++) {
+	gfsmCompileLine_ *rec = &g_array_index(cd.lines[i], gfsmCompileLine_, j);
+	gfsmArc          *a;
+
+	//---- q1: source state
+	q1 = state_alphabet ? gfsm_compile_lookup_(state_alphabet, gs, rec->field[0]) : rec->q1;
+	if (fsm->root_id == gfsmNoState) fsm->root_id = q1;
+
+	//-- final state?
+	if (rec->nfields == 1) {
+	  gfsm_automaton_set_final_state(fsm,q1,TRUE);
+	  continue;
+	}
+	else if (rec->nfields == 2) {
+	  gfsm_automaton_set_final_state_full(fsm,q1,TRUE,rec->w);
+	  continue;
+	}
 
-    //---- q2: sink state
-    if (state_alphabet) {
-      g_string_assign(gs,b2);
-      key = gfsm_alphabet_string2key(state_alphabet, gs);
-      if ((q2 = gfsm_alphabet_find_label(state_alphabet,key)) == gfsmNoLabel)
-	q2 = gfsm_alphabet_get_label(state_alphabet, key);
-    } else q2 = strtol(b2,NULL,10);
-
-    //---- lo: lower label
-    if (lo_alphabet) {
-      g_string_assign(gs,b3);
-      key = gfsm_alphabet_string2key(lo_alphabet, gs);
-      if ((lo = gfsm_alphabet_find_label(lo_alphabet,key)) == gfsmNoLabel)
-	lo = gfsm_alphabet_get_label(lo_alphabet, key);
-    } else lo = strtol(b3,NULL,10);
-
-    //---- hi: upper label
-    if (fsm->flags.is_transducer) {
-      if (nfields > 3) {
-	if (hi_alphabet) {
-	  g_string_assign(gs,b4);
-	  key = gfsm_alphabet_string2key(hi_alphabet, gs);
-	  if ((hi = gfsm_alphabet_find_label(hi_alphabet,key)) == gfsmNoLabel)
-	    hi = gfsm_alphabet_get_label(hi_alphabet, key);
+	//---- q2, lo: resolve symbolic fields
+	a = &rec->node->arc;
+	if (state_alphabet) {
+	  a->source = q1;
+	  a->target = gfsm_compile_lookup_(state_alphabet, gs, rec->field[1]);
 	}
-	else hi = strtol(b4,NULL,10);
-      }
-      else {
-	g_printerr("gfsm: Warning: no upper label given for transducer at line %u - using lower label\n",
-		   lineno);
-	hi = lo;
+	if (lo_alphabet) a->lower = gfsm_compile_lookup_(lo_alphabet, gs, rec->field[2]);
+
+	//---- hi: upper label
+	if (fsm->flags.is_transducer) {
+	  if (rec->nfields > 3) {
+	    if (hi_alphabet) a->upper = gfsm_compile_lookup_(hi_alphabet, gs, rec->field[3]);
+	  }
+	  else {
+	    g_printerr("gfsm: Warning: no upper label given for transducer at line %u - using lower label\n",
+		       lineno + rec->line + 1);
+	    a->upper = a->lower;
+	  }
+	}
+	else {
+	  //-- not a transducer
+	  a->upper = a->lower;
+	  if (rec->nfields > 4) {
+	    g_printerr("gfsm: Warning: ignoring extra fields in acceptor file at line %u\n",
+		       lineno + rec->line + 1);
+	  }
+	}
+
+	//-- link arc (unsorted: see below)
+	gfsm_automaton_ensure_state(fsm,a->target);
+	qp1             = gfsm_automaton_get_state(fsm,q1);
+	rec->node->next = qp1->arcs;
+	qp1->arcs       = rec->node;
+	++n_arcs;
       }
-    }
-    else {
-      //-- not a transducer
-      hi = lo;
-      if (nfields > 4) {
-	g_printerr("gfsm: Warning: ignoring extra fields in acceptor file at line %u\n", lineno);
+      lineno += cd.n_lines[i];
+      g_array_free(cd.lines[i],TRUE);
+      if (cd.pools) {
+	gfsm_arc_pool_merge(fsm->arc_pool, cd.pools[i]);
+	gfsm_arc_pool_free(cd.pools[i]);
       }
     }
+    g_free(cd.lines);
+    g_free(cd.n_lines);
+    g_free(cd.pools);
 
-    //-- w: arc weight
-    if      ( fsm->flags.is_transducer && nfields >= 5) { w = strtod(b5,NULL); }
-    else if (!fsm->flags.is_transducer && nfields >= 4) { w = strtod(b4,NULL); }
-    else                                                { w = fsm->sr->one; }
+    //-- keep incomplete final line for the next chunk
+    memmove(cd.buf, cd.buf+split, have-split);
+    have -= split;
+  }
 
-    gfsm_automaton_add_arc(fsm,q1,q2,lo,hi,w);
+  //-- finalize arcs: sort once per state instead of sorted insertion per arc
+  if (n_arcs > 0) {
+    fsm->flags.is_deterministic = FALSE;
+    gfsm_automaton_touch(fsm);
+    if (fsm->flags.sort_mode != gfsmASMNone) {
+      gfsmArcCompData acdata = { fsm->flags.sort_mode, fsm->sr, NULL, NULL };
+      gfsmStateId     qid;
+      for (qid=0; qid < fsm->states->len; qid++) {
+	gfsmState *qp = gfsm_automaton_open_state(fsm,qid);
+	if (qp->is_valid && qp->arcs && qp->arcs->next)
+	  qp->arcs = gfsm_arclist_sort(qp->arcs, &acdata);
+      }
+    }
   }
 
-  if (buf) free(buf);
+  g_free(cd.buf);
+  g_array_free(bounds,TRUE);
   g_string_free(gs,TRUE);
 
-  return rc;
+  return TRUE;
 }
 
 /*--------------------------------------------------------------
@@ -734,102 +1694,279 @@ gboolean gfsm_automaton_compile_gstring_full (gfsmAutomaton *fsm,
  */
 
 /*--------------------------------------------------------------
- * print_handle()
+ * print_*_()
+ *   + blocks of states are formatted into per-block buffers (in parallel),
+ *     which are written in order
  */
-gboolean gfsm_automaton_print_handle (gfsmAutomaton *fsm,
-				      gfsmIOHandle  *ioh,
-				      gfsmAlphabet  *lo_alphabet,
-				      gfsmAlphabet  *hi_alphabet,
-				      gfsmAlphabet  *state_alphabet,
-				      GFSM_UNUSED gfsmError **errp)
+
+//-- number of states per formatted block
+#define GFSM_PRINT_BLOCK_STATES 4096
+
+//-- maximum number of blocks formatted at once
+#define GFSM_PRINT_WINDOW_BLOCKS 64
+
+/// shared data for parallel printing
+typedef struct {
+  gfsmAutomaton *fsm;            ///< automaton being printed
+  gfsmAlphabet  *lo_alphabet;    ///< lower labels (or NULL)
+  gfsmAlphabet  *hi_alphabet;    ///< upper labels (or NULL)
+  gfsmAlphabet  *state_alphabet; ///< state labels (or NULL)
+  guint          first;          ///< index of the first state of block 0 (relative to root_id)
+  GString      **out;            ///< [b] : formatted text for block b
+  GString      **warn;           ///< [b] : warnings for block b (or NULL)
+} gfsmPrintData_;
+
+//-- append decimal representation of v to gs
+static inline
+void gfsm_print_uint_(GString *gs, guint v)
 {
-  guint i;
-  GString *gs = g_string_new("");
-  gboolean rc = TRUE;
+  gchar  buf[16];
+  gchar *p = buf + sizeof(buf);
+  do {
+    *--p = (gchar)('0' + v % 10);
+    v   /= 10;
+  } while (v);
+  g_string_append_len(gs, p, buf+sizeof(buf)-p);
+}
 
-  //-- sanity check
-  if (fsm->root_id == gfsmNoState) {
-    g_printerr("gfsm: Warning: cowardly refusing to print() unrooted automaton\n");
-    return TRUE;
+//-- append w to gs as for printf("%g",w), with a fast path for fixed-point notation
+static inline
+void gfsm_print_weight_(GString *gs, gfsmWeight w)
+{
+  static const gdouble pow10[] = { 1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+  gdouble v = w, a = v < 0 ? -v : v, n;
+  gchar   buf[32], *p = buf;
+  gint    x, k, i;
+  guint   digits;
+
+  if (v == 0) {
+    g_string_append(gs, signbit(v) ? "-0" : "0");
+    return;
+  }
+  if (!(a >= 1.0001e-4 && a < 999999.0)) {
+    //-- exponent notation, inf, nan: use the C library
+    g_string_append_printf(gs, "%g", v);
+    return;
   }
 
-  for (i=0; rc && i < fsm->states->len; i++) {
-    guint        id = (fsm->root_id + i) % fsm->states->len;
-    gfsmState   *st = gfsm_automaton_find_state(fsm,id);
-    gfsmArcIter  ai;
-    gpointer     key;
-    if (!st || !st->is_valid) continue;
+  //-- x: decimal exponent; scale to 6 significant digits and round (half-even, as printf())
+  for (x=-4; x < 5 && a >= pow10[x+5]; x++) ;
+  k = 5-x;
+  n = rint(a * pow10[k+4]);
+  if (n >= 1e6) {
+    g_string_append_printf(gs, "%g", v);
+    return;
+  }
+  digits = (guint)n;
 
-    for (gfsm_arciter_open_ptr(&ai,fsm,st); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
-      gfsmArc *a = gfsm_arciter_arc(&ai);
+  //-- strip trailing zeros of the fraction
+  for ( ; k > 0 && digits % 10 == 0; k--) digits /= 10;
 
-      //-- source state
-      if (state_alphabet && (key=gfsm_alphabet_find_key(state_alphabet,id)) != gfsmNoKey) {
-	gfsm_alphabet_key2string(state_alphabet,key,gs);
-	gfsmio_puts(ioh, gs->str);
-      } else {
-	if (state_alphabet) g_printerr("Warning: no label defined for state '%u'!\n", id);
-	gfsmio_printf(ioh, "%u", id);
-      }
-      gfsmio_putc(ioh, '\t');
+  //-- emit [-]int[.frac]
+  if (v < 0) *p++ = '-';
+  if (x < 0) {
+    *p++ = '0';
+    *p++ = '.';
+    for (i=-1; i > x; i--) *p++ = '0';
+  }
+  {
+    gchar  dbuf[8], *d = dbuf + sizeof(dbuf);
+    gint   n_digits;
+    do { *--d = (gchar)('0' + digits % 10); digits /= 10; } while (digits);
+    n_digits = dbuf + sizeof(dbuf) - d;
+    for (i=0; i < n_digits; i++) {
+      if (x >= 0 && i == n_digits-k) *p++ = '.';
+      *p++ = d[i];
+    }
+  }
+  g_string_append_len(gs, buf, p-buf);
+}
 
-      //-- sink state
-      if (state_alphabet && (key=gfsm_alphabet_find_key(state_alphabet,a->target)) != gfsmNoKey) {
-	gfsm_alphabet_key2string(state_alphabet,key,gs);
-	gfsmio_puts(ioh,gs->str);
-      } else {
-	if (state_alphabet) g_printerr("Warning: no label defined for state '%u'!\n", a->target);
-	gfsmio_printf(ioh, "%u", a->target);
+//-- append string for state or label id from alphabet a (or id itself), returns FALSE if a has no key for id
+static inline
+gboolean gfsm_print_label_(GString *gs, gfsmAlphabet *a, guint id, GString *tmp)
+{
+  gpointer key;
+  if (a) {
+    switch (a->type) {
+    case gfsmATPointer:
+    case gfsmATString:
+      //-- keys are the label strings themselves
+      if (id < ((gfsmPointerAlphabet*)a)->labels2keys->len
+	  && (key = g_ptr_array_index(((gfsmPointerAlphabet*)a)->labels2keys,id)) != gfsmNoKey)
+	{
+	  g_string_append(gs, (const gchar*)key);
+	  return TRUE;
+	}
+      break;
+
+    case gfsmATUser:
+      if ((key = gfsm_alphabet_find_key(a,id)) != gfsmNoKey) {
+	gfsm_alphabet_key2string(a,key,tmp);
+	g_string_append_len(gs, tmp->str, tmp->len);
+	return TRUE;
       }
-      gfsmio_putc(ioh,'\t');
+      break;
 
-      //-- lower label
-      if (lo_alphabet && (key=gfsm_alphabet_find_key(lo_alphabet,a->lower)) != gfsmNoKey) {
-	gfsm_alphabet_key2string(lo_alphabet,key,gs);
-	gfsmio_puts(ioh, gs->str);
-      } else {
-	if (lo_alphabet) g_printerr("Warning: no lower label defined for Id '%u'!\n", a->lower);
-	gfsmio_printf(ioh, "%u", a->lower);
+    default:
+      //-- numeric keys
+      if ((key = gfsm_alphabet_find_key(a,id)) != gfsmNoKey) {
+	gfsm_print_uint_(gs, GPOINTER_TO_UINT(key));
+	return TRUE;
       }
+      break;
+    }
+  }
+  gfsm_print_uint_(gs, id);
+  return a == NULL;
+}
 
-      //-- upper label
-      if (fsm->flags.is_transducer) {
-	gfsmio_putc(ioh, '\t');
-	if (hi_alphabet && (key=gfsm_alphabet_find_key(hi_alphabet,a->upper)) != gfsmNoKey) {
-	  gfsm_alphabet_key2string(hi_alphabet,key,gs);
-	  gfsmio_puts(ioh, gs->str);
-	} else {
-	  if (hi_alphabet) g_printerr("Warning: no upper label defined for Id '%u'!\n", a->upper);
-	  gfsmio_printf(ioh, "%u", a->upper);
+//-- format blocks [begin,end)
+static
+void gfsm_automaton_print_worker_(guint begin, guint end, GFSM_UNUSED guint thread_id, gfsmPrintData_ *pd)
+{
+  gfsmAutomaton *fsm  = pd->fsm;
+  guint          n_states = fsm->states->len;
+  GString       *tmp  = g_string_new("");
+  guint          b, i, imax;
+
+  for (b=begin; b < end; b++) {
+    GString *out  = g_string_sized_new(64*GFSM_PRINT_BLOCK_STATES);
+    GString *warn = NULL;
+
+    i    = pd->first + b*GFSM_PRINT_BLOCK_STATES;
+    imax = i + GFSM_PRINT_BLOCK_STATES;
+    if (imax > n_states) imax = n_states;
+
+    for ( ; i < imax; i++) {
+      guint        id = (fsm->root_id + i) % n_states;
+      gfsmState   *st = gfsm_automaton_find_state(fsm,id);
+      gfsmArcIter  ai;
+      if (!st || !st->is_valid) continue;
+
+      for (gfsm_arciter_open_ptr(&ai,fsm,st); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+	gfsmArc *a = gfsm_arciter_arc(&ai);
+
+	//-- source state
+	if (!gfsm_print_label_(out, pd->state_alphabet, id, tmp) && pd->state_alphabet) {
+	  if (!warn) warn = g_string_new("");
+	  g_string_append_printf(warn, "Warning: no label defined for state '%u'!\n", id);
+	}
+	g_string_append_c(out, '\t');
+
+	//-- sink state
+	if (!gfsm_print_label_(out, pd->state_alphabet, a->target, tmp) && pd->state_alphabet) {
+	  if (!warn) warn = g_string_new("");
+	  g_string_append_printf(warn, "Warning: no label defined for state '%u'!\n", a->target);
+	}
+	g_string_append_c(out, '\t');
+
+	//-- lower label
+	if (!gfsm_print_label_(out, pd->lo_alphabet, a->lower, tmp) && pd->lo_alphabet) {
+	  if (!warn) warn = g_string_new("");
+	  g_string_append_printf(warn, "Warning: no lower label defined for Id '%u'!\n", a->lower);
+	}
+
+	//-- upper label
+	if (fsm->flags.is_transducer) {
+	  g_string_append_c(out, '\t');
+	  if (!gfsm_print_label_(out, pd->hi_alphabet, a->upper, tmp) && pd->hi_alphabet) {
+	    if (!warn) warn = g_string_new("");
+	    g_string_append_printf(warn, "Warning: no upper label defined for Id '%u'!\n", a->upper);
+	  }
+	}
+
+	//-- weight
+	if (fsm->flags.is_weighted) { // && a->weight != fsm->sr->one
+	  g_string_append_c(out, '\t');
+	  gfsm_print_weight_(out, a->weight);
 	}
-      }
 
-      //-- weight
-      if (fsm->flags.is_weighted) { // && a->weight != fsm->sr->one
-	gfsmio_printf(ioh, "\t%g", a->weight);
+	g_string_append_c(out, '\n');
       }
 
-      gfsmio_putc(ioh, '\n');
+      //-- final? (no warning for missing state labels)
+      if (gfsm_state_is_final(st)) {
+	gfsm_print_label_(out, pd->state_alphabet, id, tmp);
+	if (fsm->flags.is_weighted) {
+	  g_string_append_c(out, '\t');
+	  gfsm_print_weight_(out, gfsm_automaton_get_final_weight(fsm,id));
+	}
+	g_string_append_c(out, '\n');
+      }
     }
 
-    //-- final?
-    if (gfsm_state_is_final(st)) {
-      if (state_alphabet && (key=gfsm_alphabet_find_key(state_alphabet,id)) != NULL) {
-	gfsm_alphabet_key2string(state_alphabet,key,gs);
-	gfsmio_puts(ioh, gs->str);
-      } else {
-	gfsmio_printf(ioh, "%u", id);
+    pd->out[b]  = out;
+    pd->warn[b] = warn;
+  }
+
+  g_string_free(tmp,TRUE);
+}
+
+/*--------------------------------------------------------------
+ * print_handle()
+ */
+gboolean gfsm_automaton_print_handle (gfsmAutomaton *fsm,
+				      gfsmIOHandle  *ioh,
+				      gfsmAlphabet  *lo_alphabet,
+				      gfsmAlphabet  *hi_alphabet,
+				      gfsmAlphabet  *state_alphabet,
+				      gfsmError     **errp)
+{
+  gfsmPrintData_ pd;
+  guint          n_blocks, n_window, n_threads = 0, b;
+  gboolean       rc = TRUE;
+
+  //-- sanity check
+  if (fsm->root_id == gfsmNoState) {
+    g_printerr("gfsm: Warning: cowardly refusing to print() unrooted automaton\n");
+    return TRUE;
+  }
+
+  //-- user alphabets may not be safe for concurrent lookup
+  if ((lo_alphabet    && lo_alphabet->type    == gfsmATUser)
+      || (hi_alphabet    && hi_alphabet->type    == gfsmATUser)
+      || (state_alphabet && state_alphabet->type == gfsmATUser))
+    n_threads = 1;
+
+  pd.fsm            = fsm;
+  pd.lo_alphabet    = lo_alphabet;
+  pd.hi_alphabet    = hi_alphabet;
+  pd.state_alphabet = state_alphabet;
+  pd.out            = g_new0(GString*, GFSM_PRINT_WINDOW_BLOCKS);
+  pd.warn           = g_new0(GString*, GFSM_PRINT_WINDOW_BLOCKS);
+
+  n_blocks = (fsm->states->len + GFSM_PRINT_BLOCK_STATES - 1) / GFSM_PRINT_BLOCK_STATES;
+  for (pd.first=0; n_blocks > 0; n_blocks -= n_window) {
+    n_window = n_blocks < GFSM_PRINT_WINDOW_BLOCKS ? n_blocks : GFSM_PRINT_WINDOW_BLOCKS;
+
+    //-- format (parallel)
+    gfsm_parallel_for(n_window, n_threads, 1, (gfsmParallelFunc)gfsm_automaton_print_worker_, &pd);
+
+    //-- write (in order)
+    for (b=0; b < n_window; b++) {
+      if (pd.warn[b]) {
+	g_printerr("%s", pd.warn[b]->str);
+	g_string_free(pd.warn[b],TRUE);
+	pd.warn[b] = NULL;
       }
-      if (fsm->flags.is_weighted) {
-	gfsmio_printf(ioh, "\t%g", gfsm_automaton_get_final_weight(fsm,id));
+      if (rc && pd.out[b]->len > 0 && !gfsmio_write(ioh, pd.out[b]->str, pd.out[b]->len)) {
+	g_set_error(errp,
+		    g_quark_from_static_string("gfsm"),                   //-- domain
+		    g_quark_from_static_string("automaton_print:write"), //-- code
+		    "could not write text output");
+	rc = FALSE;
       }
-      gfsmio_putc(ioh, '\n');
+      g_string_free(pd.out[b],TRUE);
+      pd.out[b] = NULL;
     }
+    pd.first += n_window*GFSM_PRINT_BLOCK_STATES;
   }
 
   //-- cleanup
-  g_string_free(gs,TRUE);
-  
+  g_free(pd.out);
+  g_free(pd.warn);
+
   return rc;
 }
 
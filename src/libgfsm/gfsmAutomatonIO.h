@@ -37,6 +37,16 @@
 /*======================================================================
  * Types
  */
+/// Encoding of stored states and arcs in binary files
+typedef enum {
+  gfsmBCFixed  = 0,  /**< fixed-size ::gfsmStoredState and ::gfsmStoredArc records */
+  gfsmBCVarint = 1   /**< variable-length records (since v0.0.22): for each state, a varint
+		      *   <tt>(n_arcs&lt;&lt;3)|(final_is_one&lt;&lt;2)|(is_final&lt;&lt;1)|is_valid</tt>,
+		      *   the final weight if it is not the semiring one, and for each arc, a varint
+		      *   <tt>(zigzag(target-source)&lt;&lt;1)|weight_is_one</tt>, varint lower and upper
+		      *   labels, and the arc weight if it is not the semiring one */
+} gfsmBinCoding;
+
 /// Header info for binary files
 typedef struct {
   gchar              magic[16];    /**< magic header string "gfsm_automaton" */
@@ -47,9 +57,9 @@ typedef struct {
   gfsmStateId        n_states;     /**< number of stored states */
   gfsmStateId        n_arcs_007;   /**< number of stored arcs (v0.0.2 .. v0.0.7) */
   guint32            srtype;       /**< semiring type (cast to gfsmSRType) */
-  guint32            unused1;      /**< reserved */
-  guint32            unused2;      /**< reserved */
-  guint32            unused3;      /**< reserved */
+  guint32            n_blocks;     /**< number of independently compressed state blocks, 0 for unblocked files (since v0.0.21) */
+  guint32            arc_indices;  /**< arc indices stored after the states (bit 0: lower, bit 1: upper; since v0.0.21) */
+  guint32            arc_coding;   /**< encoding of stored states and arcs (cast to ::gfsmBinCoding; since v0.0.22) */
 } gfsmAutomatonHeader;
 
 /// Type for a stored state
@@ -61,6 +71,14 @@ typedef struct {
 } gfsmStoredState;
 
 
+/// Type for a stored block descriptor (blocked binary files, since v0.0.21)
+typedef struct {
+  gfsmStateId n_states;  /**< number of states stored in this block */
+  guint32     raw_len;   /**< length in bytes of the block's stored states, as for an unblocked file */
+  guint32     z_len;     /**< length in bytes of the stored block data (== raw_len iff stored uncompressed) */
+  guint32     unused;    /**< reserved */
+} gfsmStoredBlock;
+
 /// Type for a stored arc (no 'source' field)
 //typedef gfsmArc gfsmStoredArc;
 typedef struct {
@@ -82,6 +100,21 @@ extern const gchar gfsm_header_magic[16];
 /** Minimum libgfsm version required for loading files stored by this version of libgfsm */
 extern const gfsmVersionInfo gfsm_version_bincompat_min_store;
 
+/** Minimum libgfsm version required for loading files with stored arc indices */
+extern const gfsmVersionInfo gfsm_version_bincompat_min_store_indexed;
+
+/** Minimum libgfsm version required for loading blocked files stored by gfsm_automaton_save_bin_handle_blocked() */
+extern const gfsmVersionInfo gfsm_version_bincompat_min_store_blocked;
+
+/** Minimum libgfsm version required for loading files with ::gfsmBCVarint state records */
+extern const gfsmVersionInfo gfsm_version_bincompat_min_store_varint;
+
+/** Default number of states per block for gfsm_automaton_save_bin_handle_blocked() */
+extern const guint gfsmAutomatonDefaultBlockStates;
+
+/** Number of bytes of text read at once by gfsm_automaton_compile_handle() (grown as needed for longer lines) */
+extern const gsize gfsmAutomatonCompileChunkSize;
+
 /** Minimum libgfsm version whose binary files this version of libgfsm can read */
 extern const gfsmVersionInfo gfsm_version_bincompat_min_check;
 
@@ -94,7 +127,10 @@ extern const gfsmVersionInfo gfsm_version_bincompat_min_check;
  *  Returns TRUE iff the header looks valid. */
 gboolean gfsm_automaton_load_header(gfsmAutomatonHeader *hdr, gfsmIOHandle *ioh, gfsmError **errp);
 
-/** Load an automaton from a named binary file (implicitly clear()s \a fsm) */
+/** Load an automaton from a named binary file (implicitly clear()s \a fsm).
+ *  Blocked files are detected from the stored header, and their blocks are
+ *  decompressed and decoded using up to gfsm_threads_get_default() threads.
+ */
 gboolean gfsm_automaton_load_bin_handle(gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp);
 
 /** Load an automaton from a stored binary file (implicitly clear()s \a fsm) */
@@ -107,9 +143,33 @@ gboolean gfsm_automaton_load_bin_filename(gfsmAutomaton *fsm, const gchar *filen
 gboolean gfsm_automaton_load_bin_gstring(gfsmAutomaton *fsm, GString *gs, gfsmError **errp);
 
 
-/** Store an automaton in binary form to a gfsmIOHandle* */
+/** Store an automaton in binary form to a gfsmIOHandle*, using ::gfsmBCFixed record coding */
 gboolean gfsm_automaton_save_bin_handle(gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmError **errp);
 
+/** Store an automaton in binary form to a gfsmIOHandle* using state and arc record coding \a coding.
+ *  ::gfsmBCVarint files are usually considerably smaller than ::gfsmBCFixed ones,
+ *  but require libgfsm v0.0.22 or later.
+ */
+gboolean gfsm_automaton_save_bin_handle_full(gfsmAutomaton *fsm, gfsmIOHandle *ioh, gfsmBinCoding coding, gfsmError **errp);
+
+/** Store an automaton in blocked binary form to a gfsmIOHandle*.
+ *  States are split into consecutive blocks of \a block_states states, each of which is
+ *  compressed independently with zlib, so that blocks can be compressed and decompressed
+ *  in parallel.  The stored file consists of the header, a table of ::gfsmStoredBlock
+ *  descriptors (the offset of each block's data is the sum of the \a z_len members
+ *  of its predecessors), the block data, and any stored arc indices.
+ *  Since blocks are already compressed, \a ioh itself should not be.
+ *  \param fsm automaton to store
+ *  \param ioh output handle
+ *  \param zlevel zlib compression level for blocks: -1 for default, 0 for none;
+ *         ignored (blocks are stored uncompressed) if gfsm was built without zlib
+ *  \param block_states number of states per block, or 0 for ::gfsmAutomatonDefaultBlockStates
+ *  \param n_threads maximum number of compression threads, or 0 for gfsm_threads_get_default()
+ *  \param coding state and arc record coding used within each block
+ *  \param errp error return
+ */
+gboolean gfsm_automaton_save_bin_handle_blocked(gfsmAutomaton *fsm, gfsmIOHandle *ioh, int zlevel, guint block_states, guint n_threads, gfsmBinCoding coding, gfsmError **errp);
+
 /** Store an automaton in binary form to a file */
 gboolean gfsm_automaton_save_bin_file(gfsmAutomaton *fsm, FILE *f, gfsmError **errp);
 
@@ -122,6 +182,16 @@ gboolean gfsm_automaton_save_bin_filename_nc(gfsmAutomaton *fsm, const gchar *fi
  */
 gboolean gfsm_automaton_save_bin_filename(gfsmAutomaton *fsm, const gchar *filename, int zlevel, gfsmError **errp);
 
+/** Store an automaton to a named binary file, possibly compressing, using record coding \a coding.
+ *  \a zlevel is as for gfsm_automaton_save_bin_filename().
+ */
+gboolean gfsm_automaton_save_bin_filename_full(gfsmAutomaton *fsm, const gchar *filename, int zlevel, gfsmBinCoding coding, gfsmError **errp);
+
+/** Store an automaton to a named file in blocked binary form, using default block size and thread count.
+ *  \a zlevel and \a coding are as for gfsm_automaton_save_bin_handle_blocked().
+ */
+gboolean gfsm_automaton_save_bin_filename_blocked(gfsmAutomaton *fsm, const gchar *filename, int zlevel, gfsmBinCoding coding, gfsmError **errp);
+
 /** Append an uncompressed binary automaton to an in-memory buffer */
 gboolean gfsm_automaton_save_bin_gstring(gfsmAutomaton *fsm, GString *gs, gfsmError **errp);
 
@@ -133,7 +203,12 @@ gboolean gfsm_automaton_save_bin_gstring(gfsmAutomaton *fsm, GString *gs, gfsmEr
 /// \name Automaton Methods: Text I/O
 //@{
 
-/** Load an automaton in Ma-Bell-compatible text-format from a gfsmIOHandle*  */
+/** Load an automaton in Ma-Bell-compatible text-format from a gfsmIOHandle*.
+ *  Input is read in chunks of ::gfsmAutomatonCompileChunkSize bytes, which are parsed
+ *  using up to gfsm_threads_get_default() threads.  Alphabet lookups and automaton
+ *  construction are sequential and in input order, so the result does not depend on the
+ *  number of threads.
+ */
 gboolean gfsm_automaton_compile_handle (gfsmAutomaton *fsm,
 					gfsmIOHandle  *ioh,
 					gfsmAlphabet  *lo_alphabet,
@@ -177,7 +252,10 @@ gboolean gfsm_automaton_compile_gstring_full (gfsmAutomaton *fsm,
 
 /*-----------------------*/
 
-/** Print an automaton in Ma-Bell-compatible text-format to a gfsmIOHandle* */
+/** Print an automaton in Ma-Bell-compatible text-format to a gfsmIOHandle*.
+ *  Blocks of states are formatted into memory buffers using up to gfsm_threads_get_default()
+ *  threads (one thread if any alphabet is a ::gfsmATUser alphabet), and written in order.
+ */
 gboolean gfsm_automaton_print_handle (gfsmAutomaton *fsm,
 				      gfsmIOHandle  *ioh,
 				      gfsmAlphabet  *lo_alphabet,
@@ -36,6 +36,9 @@
 /// bit vector type: really just a wrapper for GArray
 typedef GArray gfsmBitVector;
 
+/// "no such bit" return value for gfsm_bitvector_find_next_set()
+#define gfsmBitVectorNone ((guint)-1)
+
 /*======================================================================
  * Utilities
  */
@@ -109,6 +112,54 @@ void gfsm_bitvector_set(gfsmBitVector *bv, guint i, gboolean v);
 
 //@}
 
+/*======================================================================
+ * Bulk Operations
+ *  + word-parallel (64 bits at a time) in portable C; no explicit SIMD path
+ *    (see gfsmBitVector.c)
+ */
+///\name Bulk Operations
+//@{
+
+/** Set \a dst to the bitwise conjunction of \a dst and \a src.
+ *  Bits of \a dst beyond the end of \a src are cleared.
+ *  \returns altered \a dst
+ */
+gfsmBitVector *gfsm_bitvector_and(gfsmBitVector *dst, gfsmBitVector *src);
+
+/** Set \a dst to the bitwise disjunction of \a dst and \a src, growing \a dst if required.
+ *  \returns altered \a dst
+ */
+gfsmBitVector *gfsm_bitvector_or(gfsmBitVector *dst, gfsmBitVector *src);
+
+/** Clear all bits of \a dst which are set in \a src.
+ *  \returns altered \a dst
+ */
+gfsmBitVector *gfsm_bitvector_andnot(gfsmBitVector *dst, gfsmBitVector *src);
+
+/** Invert all bits of \a bv (up to gfsm_bitvector_size()).
+ *  \returns altered \a bv
+ */
+gfsmBitVector *gfsm_bitvector_not(gfsmBitVector *bv);
+
+/** Get the number of set bits in \a bv */
+guint gfsm_bitvector_popcount(gfsmBitVector *bv);
+
+/** Get the index of the first set bit in \a bv at or after index \a i,
+ *  or ::gfsmBitVectorNone if there is none.
+ *  Set bits can be enumerated in ascending order with:
+ *  \code
+ *  for (i=gfsm_bitvector_find_next_set(bv,0); i != gfsmBitVectorNone; i=gfsm_bitvector_find_next_set(bv,i+1)) { ... }
+ *  \endcode
+ */
+guint gfsm_bitvector_find_next_set(gfsmBitVector *bv, guint i);
+
+/** Get the index of the first unset bit in \a bv at or after index \a i.
+ *  Bits beyond the end of \a bv count as unset, so the result is at most max(\a i,gfsm_bitvector_size(\a bv)).
+ */
+guint gfsm_bitvector_find_next_unset(gfsmBitVector *bv, guint i);
+
+//@}
+
 /*======================================================================
  * I/O
  */
@@ -36,6 +36,12 @@ const gfsmLabelId gfsmEpsilon1 = (gfsmLabelId)-2;
 
 const gfsmLabelId gfsmEpsilon2 = (gfsmLabelId)-3;
 
+const gfsmLabelId gfsmSigma = (gfsmLabelId)-4;
+
+const gfsmLabelId gfsmRho = (gfsmLabelId)-5;
+
+const gfsmLabelId gfsmPhi = (gfsmLabelId)-6;
+
 const gfsmStateId gfsmNoState = (gfsmStateId)-1;
 
 const gfsmWeight gfsmNoWeight = 0;
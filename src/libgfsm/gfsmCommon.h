@@ -81,6 +81,20 @@ extern const gfsmLabelId gfsmEpsilon1;
 /** Constant label for pseudo-epsilon moves in 2nd argument to compose() */
 extern const gfsmLabelId gfsmEpsilon2;
 
+/** Constant label for implicit "any symbol" arcs (65532): match any non-epsilon label.
+ *  \see gfsmMatcher.h */
+extern const gfsmLabelId gfsmSigma;
+
+/** Constant label for implicit "any other symbol" arcs (65531): match any non-epsilon label
+ *  for which the source state has no explicit arc.
+ *  \see gfsmMatcher.h */
+extern const gfsmLabelId gfsmRho;
+
+/** Constant label for implicit failure arcs (65530): followed without consuming any input
+ *  if nothing else matches at the source state.
+ *  \see gfsmMatcher.h */
+extern const gfsmLabelId gfsmPhi;
+
 /** Constant indicating missing alphabet key */
 extern const gpointer    gfsmNoKey;
 
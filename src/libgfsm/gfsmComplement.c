@@ -33,13 +33,12 @@
  */
 
 /*--------------------------------------------------------------
- * complete()
+ * complete_sink_()
+ *  + prepare fsm for completion: determinize, sort on lower labels, add a sink state
  */
-gfsmAutomaton *gfsm_automaton_complete(gfsmAutomaton *fsm, gfsmAlphabet *alph, gfsmStateId *sinkp)
+static
+gfsmStateId gfsm_automaton_complete_sink_(gfsmAutomaton *fsm)
 {
-  gfsmStateId  id, sinkid;
-  GPtrArray    *alabels;
-
   if (!fsm->flags.is_deterministic) fsm = gfsm_automaton_determinize(fsm);
   if (gfsm_acmask_nth(fsm->flags.sort_mode,0) != gfsmACLower) {
     gfsm_automaton_arcsort(fsm,gfsmACLower);
@@ -48,7 +47,25 @@ gfsmAutomaton *gfsm_automaton_complete(gfsmAutomaton *fsm, gfsmAlphabet *alph, g
   fsm->flags.sort_mode = gfsmASMNone;
 
   //-- add sink-id
-  sinkid = gfsm_automaton_add_state(fsm);
+  return gfsm_automaton_add_state(fsm);
+}
+
+/*--------------------------------------------------------------
+ * complete()
+ */
+gfsmAutomaton *gfsm_automaton_complete(gfsmAutomaton *fsm, gfsmAlphabet *alph, gfsmStateId *sinkp)
+{
+  gfsmStateId  id, sinkid;
+  GPtrArray    *alabels;
+  gfsmAlphabet *alph_own = NULL;
+
+  //-- no alphabet: use the lower alphabet of fsm itself
+  if (alph == NULL) {
+    alph = alph_own = gfsm_identity_alphabet_new();
+    gfsm_automaton_get_alphabet(fsm, gfsmLSLower, alph);
+  }
+
+  sinkid = gfsm_automaton_complete_sink_(fsm);
   if (sinkp) *sinkp = sinkid;
 
   //-- get alphabet label-vector
@@ -93,25 +110,60 @@ gfsmAutomaton *gfsm_automaton_complete(gfsmAutomaton *fsm, gfsmAlphabet *alph, g
   //-- cleanup
   //g_array_free(alabels,TRUE);
   g_ptr_array_free(alabels,TRUE);
+  if (alph_own) gfsm_alphabet_free(alph_own);
 
   return fsm;
 }
 
 /*--------------------------------------------------------------
- * complement_full()
+ * complete_implicit()
+ *  + route all labels without an explicit arc to the sink with a single rho arc per state
  */
-gfsmAutomaton *gfsm_automaton_complement_full(gfsmAutomaton *fsm, gfsmAlphabet *alph)
+gfsmAutomaton *gfsm_automaton_complete_implicit(gfsmAutomaton *fsm, gfsmStateId *sinkp)
 {
-  gfsmStateId id, sink_id;
-  gfsm_automaton_complete(fsm, alph, &sink_id);
+  gfsmStateId id, sinkid = gfsm_automaton_complete_sink_(fsm);
+  gfsmArcIter ai;
+
+  if (sinkp) *sinkp = sinkid;
+  for (id = 0; id < sinkid; id++) {
+    gboolean complete = FALSE;
+    if (!gfsm_automaton_has_state(fsm,id)) continue;
+    for (gfsm_arciter_open(&ai,fsm,id); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      gfsmLabelVal lo = gfsm_arciter_arc(&ai)->lower;
+      if (lo == gfsmRho || lo == gfsmSigma) { complete = TRUE; break; }
+    }
+    gfsm_arciter_close(&ai);
+    if (!complete) gfsm_automaton_add_arc(fsm, id, sinkid, gfsmRho, gfsmRho, fsm->sr->one);
+  }
+  gfsm_automaton_add_arc(fsm, sinkid, sinkid, gfsmSigma, gfsmSigma, fsm->sr->one);
 
-  //-- flip final states (no weights here)
+  //-- mark fsm as (still) deterministic
+  fsm->flags.is_deterministic = TRUE;
+  return fsm;
+}
+
+/*--------------------------------------------------------------
+ * complement_finals_()
+ *  + flip final states (no weights here)
+ */
+static
+void gfsm_automaton_complement_finals_(gfsmAutomaton *fsm)
+{
+  gfsmStateId id;
   for (id = 0; id < fsm->states->len; id++) {
     gfsmState  *s = gfsm_automaton_find_state(fsm,id);
     if (!s || !s->is_valid) continue;
     gfsm_automaton_set_final_state(fsm, id, !s->is_final);
   }
+}
 
+/*--------------------------------------------------------------
+ * complement_full()
+ */
+gfsmAutomaton *gfsm_automaton_complement_full(gfsmAutomaton *fsm, gfsmAlphabet *alph)
+{
+  gfsm_automaton_complete(fsm, alph, NULL);
+  gfsm_automaton_complement_finals_(fsm);
   return fsm;
 }
 
@@ -120,9 +172,15 @@ gfsmAutomaton *gfsm_automaton_complement_full(gfsmAutomaton *fsm, gfsmAlphabet *
  */
 gfsmAutomaton *gfsm_automaton_complement(gfsmAutomaton *fsm)
 {
-  gfsmAlphabet *alph = gfsm_identity_alphabet_new();
-  gfsm_automaton_get_alphabet(fsm, gfsmLSLower, alph);
-  gfsm_automaton_complement_full(fsm,alph);
-  gfsm_alphabet_free(alph);
+  return gfsm_automaton_complement_full(fsm,NULL);
+}
+
+/*--------------------------------------------------------------
+ * complement_implicit()
+ */
+gfsmAutomaton *gfsm_automaton_complement_implicit(gfsmAutomaton *fsm)
+{
+  gfsm_automaton_complete_implicit(fsm, NULL);
+  gfsm_automaton_complement_finals_(fsm);
   return fsm;
 }
@@ -27,6 +27,8 @@
 #include <gfsmEnum.h>
 #include <gfsmUtils.h>
 #include <gfsmCompound.h>
+#include <gfsmMatcher.h>
+#include <gfsmView.h>
 
 /*======================================================================
  * Methods: algebra: compose
@@ -67,31 +69,32 @@ gfsmStateId gfsm_compose_qid_(gfsmAutomaton *fsm, gfsmComposeState sp, GQueue *q
 #endif
 void gfsm_automaton_compose_visit_(gfsmStateId	      qid,
 				   gfsmAutomaton     *fsm1,
-				   gfsmAutomaton     *fsm2,
+				   gfsmAutomatonView *view2,
 				   gfsmAutomaton     *fsm,
 				   gfsmComposeStateEnum *spenum,
 				   GArray               *spenumr,
 				   GQueue               *queue,
-				   gfsmComposeFlags      flags)
+				   gfsmArcTableIndex    *tabx1,
+				   gfsmArcTableIndex    *tabx2)
 {
-  gfsmState   *q1, *q2;
+  gfsmState   *q1;
   gfsmComposeState sp = g_array_index(spenumr,gfsmComposeState,qid);
   gfsmStateId qid2;
-  gfsmArcList *al1, *al2, *ai1, *ai2;
-  gfsmArcList *ai1_noneps, *ai2_noneps, *ai2_continue;
-  gfsmArc     *a1,*a2;
+  gfsmWeight  fw2;
+  gfsmViewArcIter c1, c2, c1eps, c2eps, e1, e2, e1max, e2max;
+  gfsmArc     *a1, *a2;
+  gboolean    gallop1, gallop2;
 
 #ifdef GFSM_DEBUG_COMPOSE_VISIT
   fprintf(stderr, "compose(): visit : (q%u,f%u,q%u) => q%d\n", sp.id1, sp.idf, sp.id2,
 	  (int)(qid==gfsmEnumNone ? -1 : qid));
 #endif
 
-  //-- get state pointers for input automata
+  //-- get state pointer for fsm1
   q1 = gfsm_automaton_find_state(fsm1,sp.id1);
-  q2 = gfsm_automaton_find_state(fsm2,sp.id2);
 
   //-- sanity check
-  if ( !(q1 && q2 && q1->is_valid && q2->is_valid) ) {
+  if ( !(q1 && q1->is_valid && gfsm_view_has_state(view2,sp.id2)) ) {
 #ifdef GFSM_DEBUG_COMPOSE_VISIT
     fprintf(stderr, "compose(): BAD   : (q%u,f%u,q%u)     XXXXX\n", sp.id1, sp.idf, sp.id2);
 #endif
@@ -103,42 +106,35 @@ void gfsm_automaton_compose_visit_(gfsmStateId	      qid,
 #endif
 
   //-- check for final states
-  if (q1->is_final && q2->is_final) {
+  if (q1->is_final && gfsm_view_lookup_final(view2,sp.id2,&fw2)) {
     gfsm_automaton_set_final_state_full(fsm,qid,TRUE,
 					gfsm_sr_times(fsm->sr,
 						      gfsm_automaton_get_final_weight(fsm1,sp.id1),
-						      gfsm_automaton_get_final_weight(fsm2,sp.id2)));
+						      fw2));
   }
 
   //-------------------------------------------
   // recurse on outgoing arcs
 
   //--------------------------------
-  // recurse: arcs: sort
-
-  //-- arcs: sort arclists: fsm1
-  if (flags&gfsmCFEfsm1NeedsArcSort) {
-    gfsmArcCompData sortdata = { gfsmACUpper,NULL,NULL,NULL };
-    al1 = gfsm_arclist_sort(gfsm_arclist_clone(q1->arcs), &sortdata);
-  }
-  else { al1 = q1->arcs; }
-
-  //-- arcs: sort arclists: fsm2
-  if (flags&gfsmCFEfsm2NeedsArcSort) {
-    gfsmArcCompData sortdata = { gfsmACLower,NULL,NULL,NULL };
-    al2 = gfsm_arclist_sort(gfsm_arclist_clone(q2->arcs), &sortdata);
-  }
-  else { al2 = q2->arcs; }
+  // recurse: arcs: open iterators & split off (initial) epsilon arcs
+  //  + NULL tables: walk the (already sorted) arc lists of fsm1 and/or fsm2 directly
+  if (tabx1) gfsm_view_arciter_open_table(&c1, tabx1, sp.id1);
+  else       gfsm_view_arciter_open_arclist(&c1, q1->arcs);
+  if (tabx2) gfsm_view_arciter_open_table(&c2, tabx2, sp.id2);
+  else       gfsm_view_arciter_open(&c2, view2, sp.id2);
+  c1eps = c1;
+  c2eps = c2;
+  gfsm_view_arciter_seek_upper(&c1, gfsmEpsilon+1, FALSE);
+  gfsm_view_arciter_seek_lower(&c2, gfsmEpsilon+1, FALSE);
 
   //--------------------------------
   // recusrse: arcs: handle epsilons
-  for (ai1_noneps=al1; ai1_noneps!=NULL && ai1_noneps->arc.upper==gfsmEpsilon; ai1_noneps=ai1_noneps->next) {;}
-  for (ai2_noneps=al2; ai2_noneps!=NULL && ai2_noneps->arc.lower==gfsmEpsilon; ai2_noneps=ai2_noneps->next) {;}
 
   //-- (eps,NULL): case fsm1(q1 --a:eps(~eps2)--> q1b), filter:({0,2} --eps2:eps2--> 2), fsm2(q2 --(NULL~eps2:eps)--> q2)
   if (sp.idf != 1) {
-    for (ai1=al1; ai1!=ai1_noneps; ai1=ai1->next) {
-      a1   = &(ai1->arc);
+    for (e1=c1eps; e1.arc != c1.arc; gfsm_view_arciter_next(&e1)) {
+      a1 = e1.arc;
 #ifdef GFSM_DEBUG_COMPOSE_VISIT
       fprintf(stderr,
 	      "compose(): MATCH[e,NULL]: (q%u --%d:eps(e2)--> q%u) ~ ({0,2}--(e2:e2)-->2) ~ (q%u --(NULL~e2:eps)--> q%u) ***\n",
@@ -152,8 +148,8 @@ void gfsm_automaton_compose_visit_(gfsmStateId	      qid,
   }
   //-- (NULL,eps): case fsm1(q1 --(NULL~eps:eps1)--> q1), filter:({0,1} --eps1:eps1--> 1), fsm2(q2 --eps(~eps1):b--> q2b)
   if (sp.idf != 2) {
-    for (ai2=al2; ai2!=ai2_noneps; ai2=ai2->next) {
-      a2   = &(ai2->arc);
+    for (e2=c2eps; e2.arc != c2.arc; gfsm_view_arciter_next(&e2)) {
+      a2 = e2.arc;
 #ifdef GFSM_DEBUG_COMPOSE_VISIT
       fprintf(stderr,
 	      "compose(): MATHC[NULL,e]: (q%u --(NULL~eps:e1)--> q%u) ~ ({0,1}--(e1:e1)-->1) ~ (q%u --eps(e1):%d--> q%u) ***\n",
@@ -167,10 +163,10 @@ void gfsm_automaton_compose_visit_(gfsmStateId	      qid,
   }
   //-- (eps,eps): case fsm1(q1 --a:eps(~eps2)--> q1b), filter:({0} --eps2:eps1--> 0), fsm2(q2 --eps:b--> q2b)
   if (sp.idf == 0) {
-    for (ai1=al1; ai1!=ai1_noneps; ai1=ai1->next) {
-      a1 = &(ai1->arc);
-      for (ai2=al2; ai2!=ai2_noneps; ai2=ai2->next) {
-	a2   = &(ai2->arc);
+    for (e1=c1eps; e1.arc != c1.arc; gfsm_view_arciter_next(&e1)) {
+      a1 = e1.arc;
+      for (e2=c2eps; e2.arc != c2.arc; gfsm_view_arciter_next(&e2)) {
+	a2 = e2.arc;
 #ifdef GFSM_DEBUG_COMPOSE_VISIT
 	fprintf(stderr,
 		"compose(): MATCH[e,e]: (q%u --%d:eps(e2)--> q%u) ~ ({0}--(e2:e1)-->0) ~ (q%u --eps(e1):%d--> q%u) ***\n",
@@ -186,62 +182,103 @@ void gfsm_automaton_compose_visit_(gfsmStateId	      qid,
   }
 
   //--------------------------------
-  // recurse: arcs: non-eps: iterate
-  for (ai1=ai1_noneps, ai2_continue=ai2_noneps; ai1!=NULL; ai1=ai1->next) {
-    a1 = &(ai1->arc);
-
-    for (ai2=ai2_continue; ai2!=NULL; ai2=ai2->next) {
-      a2 = &(ai2->arc);
+  // recurse: arcs: non-eps: implicit (sigma,rho,phi) arcs on fsm2: match each run of fsm1 labels separately
+  if (gfsm_view_arciter_has_implicit(&c2)) {
+    GArray *matches = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+    guint   mi;
+    while (gfsm_view_arciter_ok(&c1)) {
+      gfsmLabelVal lab = c1.arc->upper;
+      for (e1max=c1; e1max.arc && e1max.arc->upper==lab; gfsm_view_arciter_next(&e1max)) ;
+      g_array_set_size(matches,0);
+      if (tabx2) gfsm_matcher_match_table(tabx2, fsm->sr, sp.id2, lab, matches);
+      else       gfsm_view_match(view2, sp.id2, lab, matches);
+      for (e1=c1; e1.arc != e1max.arc; gfsm_view_arciter_next(&e1)) {
+	a1 = e1.arc;
+	for (mi=0; mi < matches->len; mi++) {
+	  gfsmArcMatch *m = &g_array_index(matches,gfsmArcMatch,mi);
+	  qid2 = gfsm_compose_qid_(fsm, (gfsmComposeState){a1->target, m->target, 0}, queue,spenum,spenumr);
+	  if (qid2 != gfsmNoState)
+	    gfsm_automaton_add_arc(fsm, qid, qid2, a1->lower, m->upper,
+				   gfsm_sr_times(fsm1->sr, a1->weight, m->weight));
+	}
+      }
+      c1 = e1max;
+    }
+    g_array_free(matches,TRUE);
+    return;
+  }
 
-#ifdef GFSM_DEBUG_COMPOSE_VISIT
-      fprintf(stderr,
-	      "compose(): check[x,x]: (q%u --%d:%d--> q%u) ~ ({0,1,2}--(x:x)-->0) ~ (q%u --%d:%d--> q%u)\n",
-	      sp.id1, a1->lower, a1->upper, a1->target,
-	      sp.id2, a2->lower, a2->upper, a2->target);
-#endif
+  //--------------------------------
+  // recurse: arcs: non-eps: sort-merge join on (a1->upper == a2->lower)
+  //  + gallop through a contiguous side if it is much larger than the other side;
+  //    arc lists on the other side are only counted as far as that comparison needs
+  gallop1 = gallop2 = FALSE;
+  if (tabx1 || tabx2) {
+    guint n1 = tabx1 ? gfsm_view_arciter_size(&c1) : 0;
+    guint n2 = tabx2 ? gfsm_view_arciter_size(&c2) : 0;
+    if (!tabx1) n1 = gfsm_view_arciter_size_max(&c1, n2/gfsmArcRangeGallopRatio + 1);
+    if (!tabx2) n2 = gfsm_view_arciter_size_max(&c2, n1/gfsmArcRangeGallopRatio + 1);
+    gallop1 = tabx1 && n1 > gfsmArcRangeGallopRatio * n2;
+    gallop2 = tabx2 && n2 > gfsmArcRangeGallopRatio * n1;
+  }
+  while (gfsm_view_arciter_ok(&c1) && gfsm_view_arciter_ok(&c2)) {
+    gfsmLabelVal lab = c1.arc->upper;
 
-      if      (a2->lower < a1->upper) { ai2_continue=ai2->next; continue; }
-      else if (a2->lower > a1->upper) { break; }
+    if (c2.arc->lower < lab) {
+      gfsm_view_arciter_seek_lower(&c2, lab, gallop2);
+      continue;
+    }
+    else if (c2.arc->lower > lab) {
+      gfsm_view_arciter_seek_upper(&c1, c2.arc->lower, gallop1);
+      continue;
+    }
 
+    //-- matching runs: (a1 in c1..e1max) x (a2 in c2..e2max)
+    for (e1max=c1; e1max.arc && e1max.arc->upper==lab; gfsm_view_arciter_next(&e1max)) ;
+    for (e2max=c2; e2max.arc && e2max.arc->lower==lab; gfsm_view_arciter_next(&e2max)) ;
+    for (e1=c1; e1.arc != e1max.arc; gfsm_view_arciter_next(&e1)) {
+      a1 = e1.arc;
+      for (e2=c2; e2.arc != e2max.arc; gfsm_view_arciter_next(&e2)) {
+	a2 = e2.arc;
 #ifdef GFSM_DEBUG_COMPOSE_VISIT
-      fprintf(stderr,
-	      "compose(): MATCH[x,x]: (q%u --%d:%d--> q%u) ~ ({0,1,2}--(x:x)-->0) ~ (q%u --%d:%d--> q%u) ***\n",
-	      sp.id1, a1->lower, a1->upper, a1->target,
-	      sp.id2, a2->lower, a2->upper, a2->target);
+	fprintf(stderr,
+		"compose(): MATCH[x,x]: (q%u --%d:%d--> q%u) ~ ({0,1,2}--(x:x)-->0) ~ (q%u --%d:%d--> q%u) ***\n",
+		sp.id1, a1->lower, a1->upper, a1->target,
+		sp.id2, a2->lower, a2->upper, a2->target);
 #endif
 
-      //-- non-eps: case fsm1:(q1 --a:b--> q1'), fsm2:(q2 --b:c-->  q2')
-      qid2 = gfsm_compose_qid_(fsm, (gfsmComposeState){a1->target, a2->target, 0}, queue,spenum,spenumr);
-      if (qid2 != gfsmNoState)
-	gfsm_automaton_add_arc(fsm, qid, qid2, a1->lower, a2->upper,
-			       gfsm_sr_times(fsm1->sr, a1->weight, a2->weight));
+	//-- non-eps: case fsm1:(q1 --a:b--> q1'), fsm2:(q2 --b:c-->  q2')
+	qid2 = gfsm_compose_qid_(fsm, (gfsmComposeState){a1->target, a2->target, 0}, queue,spenum,spenumr);
+	if (qid2 != gfsmNoState)
+	  gfsm_automaton_add_arc(fsm, qid, qid2, a1->lower, a2->upper,
+				 gfsm_sr_times(fsm1->sr, a1->weight, a2->weight));
+      }
     }
+    c1 = e1max;
+    c2 = e2max;
   }
 
-  //-- maybe cleanup temporary arc-lists
-  if (flags&gfsmCFEfsm1NeedsArcSort) gfsm_arclist_free(al1);
-  if (flags&gfsmCFEfsm2NeedsArcSort) gfsm_arclist_free(al2);
-
   return;
 }
 
 /*--------------------------------------------------------------
- * compose_full()
+ * compose_view_full_()
+ *  + guts for compose_full() and compose_indexed_full(): fsm2 is only read, via view2
  */
 //#define GFSM_DEBUG_COMPOSE
 #ifdef GFSM_DEBUG_COMPOSE
 # include <gfsmAutomatonIO.h>
 #endif
-gfsmAutomaton *gfsm_automaton_compose_full(gfsmAutomaton *fsm1,
-					   gfsmAutomaton *fsm2,
-					   gfsmAutomaton *composition,
-					   gfsmComposeStateEnum *spenum
-					   )
+static
+gfsmAutomaton *gfsm_automaton_compose_view_full_(gfsmAutomaton *fsm1,
+						 gfsmAutomatonView *view2,
+						 gfsmAutomaton *composition,
+						 gfsmComposeStateEnum *spenum)
 {
   gboolean          spenum_is_temp;
   gfsmComposeState  rootpair;
   gfsmStateId       rootid = 0;
-  gfsmComposeFlags  flags = 0;
+  gfsmArcTableIndex *tabx1, *tabx2;
   GQueue	   *queue = NULL;
   GArray           *spenumr = NULL;
 #ifdef GFSM_DEBUG_COMPOSE
@@ -269,16 +306,22 @@ gfsmAutomaton *gfsm_automaton_compose_full(gfsmAutomaton *fsm1,
   spenumr = g_array_sized_new(FALSE,FALSE,sizeof(gfsmComposeState),gfsmAutomatonDefaultSize);
   spenumr->len = 1;
 
-  //-- setup: flags
-  if (gfsm_acmask_nth(fsm1->flags.sort_mode,0) != gfsmACUpper) flags |= gfsmCFEfsm1NeedsArcSort;
-  if (gfsm_acmask_nth(fsm2->flags.sort_mode,0) != gfsmACLower) flags |= gfsmCFEfsm2NeedsArcSort;
+  //-- setup: sorted arc storage: cached index, else the arc lists themselves if already
+  //   sorted on the join side (tabx==NULL), else a temporary sorted copy
+  if (!(tabx1 = gfsm_automaton_lookup_arc_index(fsm1,gfsmLSUpper))
+      && gfsm_acmask_nth(fsm1->flags.sort_mode,0) != gfsmACUpper)
+    {
+      tabx1 = gfsm_automaton_to_arc_table_index(fsm1,NULL);
+      gfsm_arc_table_index_sort_bymask(tabx1, gfsmACUpper, NULL);
+    }
+  tabx2 = gfsm_view_lower_arc_table(view2, gfsmACLower);
 
   //-- setup: queue
   queue = g_queue_new();
 
   //-- guts: recursively visit states depth-first from root
   rootpair.id1 = fsm1->root_id;
-  rootpair.id2 = fsm2->root_id;
+  rootpair.id2 = view2->root_id;
   rootpair.idf = 0;
   gfsm_automaton_ensure_state(composition,rootid);
   gfsm_enum_insert_full(spenum, &rootpair, rootid);
@@ -287,7 +330,7 @@ gfsmAutomaton *gfsm_automaton_compose_full(gfsmAutomaton *fsm1,
 
   while (!g_queue_is_empty(queue)) {
     gfsmStateId qid = GPOINTER_TO_UINT(g_queue_pop_head(queue));
-    gfsm_automaton_compose_visit_(qid, fsm1,fsm2,composition, spenum,spenumr,queue, flags);
+    gfsm_automaton_compose_visit_(qid, fsm1,view2,composition, spenum,spenumr,queue, tabx1,tabx2);
   }
 
   //-- finalize: set new root state
@@ -300,6 +343,33 @@ gfsmAutomaton *gfsm_automaton_compose_full(gfsmAutomaton *fsm1,
   if (spenum_is_temp) gfsm_enum_free(spenum);
   g_array_free(spenumr,TRUE);
   g_queue_free(queue);
+  if (tabx1 && tabx1 != fsm1->index_upper) gfsm_arc_table_index_free(tabx1);
+  if (tabx2 && tabx2 != view2->index_lower) gfsm_arc_table_index_free(tabx2);
 
   return composition;
 }
+
+/*--------------------------------------------------------------
+ * compose_full()
+ */
+gfsmAutomaton *gfsm_automaton_compose_full(gfsmAutomaton *fsm1,
+					   gfsmAutomaton *fsm2,
+					   gfsmAutomaton *composition,
+					   gfsmComposeStateEnum *spenum
+					   )
+{
+  gfsmAutomatonView view2;
+  return gfsm_automaton_compose_view_full_(fsm1, gfsm_automaton_view(&view2,fsm2), composition, spenum);
+}
+
+/*--------------------------------------------------------------
+ * compose_indexed_full()
+ */
+gfsmAutomaton *gfsm_automaton_compose_indexed_full(gfsmAutomaton *fsm1,
+						   gfsmIndexedAutomaton *xfsm2,
+						   gfsmAutomaton *composition,
+						   gfsmComposeStateEnum *spenum)
+{
+  gfsmAutomatonView view2;
+  return gfsm_automaton_compose_view_full_(fsm1, gfsm_indexed_automaton_view(&view2,xfsm2), composition, spenum);
+}
@@ -47,45 +47,31 @@ gboolean gfsm_automaton_concat_final_func_(gfsmStateId id, gpointer pw, gfsmAuto
 }
 
 /*--------------------------------------------------------------
- * concat()
+ * concat_adopt_()
+ *  + appends @fsm2 onto @fsm1, whose states [@offset,@offset+@fsm2->states->len) must already be reserved
+ *  + @finals2 is the final-weight map to use for @fsm2 (may differ from @fsm2->finals if shared with @fsm1)
  */
-gfsmAutomaton *gfsm_automaton_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2)
+static
+void gfsm_automaton_concat_adopt_(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2, gfsmWeightMap *finals2, gfsmStateId offset)
 {
-  gfsmAutomaton *fsm2;
-  gfsmStateId    offset;
-  gfsmStateId    id2;
-  gfsmStateId    size2;
-  gfsmStateId    rootx;
-  gfsmWeightMap *finals2 = NULL;
-
-  //-- sanity check(s)
-  if (!_fsm2 || _fsm2->root_id == gfsmNoState) return fsm1;
-  if (_fsm2==fsm1) fsm2 = gfsm_automaton_clone(fsm1);
-  else             fsm2 = _fsm2;
-
-  if (fsm1->finals == fsm2->finals) {
-    finals2 = gfsm_weightmap_new(gfsm_uint_compare);
-    gfsm_weightmap_copy(finals2, fsm2->finals);
-  }
-
-  offset = fsm1->states->len;
-  size2  = fsm2->states->len;
-  gfsm_automaton_reserve(fsm1, offset + size2);
+  gfsmStateId id2;
+  gfsmStateId size2 = fsm2->states->len;
+  gfsmStateId rootx = fsm2->root_id + offset;
 
   //-- concatenative arcs
   if (fsm1->root_id != gfsmNoState) {
     //-- multiple final states: add epsilon arcs from old finals to mapped root2
     gfsmStateId root_tmp = fsm1->root_id;
-    rootx                = fsm2->root_id+offset;
     fsm1->root_id        = rootx;
     gfsm_automaton_finals_foreach(fsm1, (GTraverseFunc)gfsm_automaton_concat_final_func_, fsm1);
     fsm1->root_id        = root_tmp;
   } else /*if (fsm2->root_id != gfsmNoState)*/ {
-    fsm1->root_id = rootx = fsm2->root_id + offset;
+    fsm1->root_id = rootx;
   }
   gfsm_weightmap_clear(fsm1->finals);
 
-  //-- adopt states from fsm2 into fsm1
+  //-- adopt states from fsm2 into fsm1 (arcs are copied directly)
+  gfsm_automaton_touch(fsm1);
   for (id2 = 0; id2 < size2; id2++) {
     gfsmStateId      id1;
     const gfsmState *s2;
@@ -101,7 +87,7 @@ gfsmAutomaton *gfsm_automaton_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2)
     if (!s1 || !s2 || !s2->is_valid) continue;
 
     //-- copy state
-    gfsm_state_copy(s1,s2);
+    gfsm_state_copy_full(s1,s2,fsm1->arc_pool);
 
     //-- translate targets for adopted arcs
     for (gfsm_arciter_open_ptr(&ai,fsm1,s1); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai))
@@ -111,17 +97,38 @@ gfsmAutomaton *gfsm_automaton_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2)
       }
 
     //-- check for new final states: get weight & mark state is_final flag
-    if ( (finals2 && gfsm_weightmap_lookup(finals2, GUINT_TO_POINTER(id2), &s2fw))
-	 ||
-	 (!finals2 && gfsm_weightmap_lookup(fsm2->finals, GUINT_TO_POINTER(id2), &s2fw)) )
-      {
-	s1->is_final = TRUE;
-	gfsm_weightmap_insert(fsm1->finals, GUINT_TO_POINTER(id1), s2fw);
-      }
+    if (gfsm_weightmap_lookup(finals2, GUINT_TO_POINTER(id2), &s2fw)) {
+      s1->is_final = TRUE;
+      gfsm_weightmap_insert(fsm1->finals, GUINT_TO_POINTER(id1), s2fw);
+    }
   }
 
   //-- mark as unsorted
   fsm1->flags.sort_mode = gfsmASMNone;
+}
+
+/*--------------------------------------------------------------
+ * concat()
+ */
+gfsmAutomaton *gfsm_automaton_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2)
+{
+  gfsmAutomaton *fsm2;
+  gfsmStateId    offset;
+  gfsmWeightMap *finals2 = NULL;
+
+  //-- sanity check(s)
+  if (!_fsm2 || _fsm2->root_id == gfsmNoState) return fsm1;
+  if (_fsm2==fsm1) fsm2 = gfsm_automaton_clone(fsm1);
+  else             fsm2 = _fsm2;
+
+  if (fsm1->finals == fsm2->finals) {
+    finals2 = gfsm_weightmap_new(gfsm_uint_compare);
+    gfsm_weightmap_copy(finals2, fsm2->finals);
+  }
+
+  offset = fsm1->states->len;
+  gfsm_automaton_reserve(fsm1, offset + fsm2->states->len);
+  gfsm_automaton_concat_adopt_(fsm1, fsm2, (finals2 ? finals2 : fsm2->finals), offset);
 
   //-- cleanup
   if (finals2) gfsm_weightmap_free(finals2);
@@ -147,3 +154,38 @@ gfsmAutomaton *gfsm_automaton_n_concat(gfsmAutomaton *fsm1, gfsmAutomaton *_fsm2
 
   return fsm1;
 }
+
+/*--------------------------------------------------------------
+ * concat_n()
+ */
+gfsmAutomaton *gfsm_automaton_concat_n(gfsmAutomaton *fsm1, gfsmAutomaton **fsms, guint n_fsms)
+{
+  gfsmAutomaton *fsm1copy = NULL;
+  gfsmStateId    offset = fsm1->states->len, size = offset;
+  guint i;
+
+  //-- get total size; operands aliasing fsm1 refer to its original contents
+  for (i=0; i < n_fsms; i++) {
+    if (!fsms[i] || fsms[i]->root_id == gfsmNoState) continue;
+    if (fsms[i]==fsm1 && !fsm1copy) fsm1copy = gfsm_automaton_clone(fsm1);
+    size += fsms[i]->states->len;
+  }
+
+  //-- allocate state storage once, then adopt each operand at its final offset
+  gfsm_automaton_reserve(fsm1, size);
+  for (i=0; i < n_fsms; i++) {
+    gfsmAutomaton *fsm2 = (fsms[i]==fsm1 ? fsm1copy : fsms[i]);
+    gfsmWeightMap *finals2 = NULL;
+    if (!fsm2 || fsm2->root_id == gfsmNoState) continue;
+    if (fsm2->finals == fsm1->finals) {
+      finals2 = gfsm_weightmap_new(gfsm_uint_compare);
+      gfsm_weightmap_copy(finals2, fsm2->finals);
+    }
+    gfsm_automaton_concat_adopt_(fsm1, fsm2, (finals2 ? finals2 : fsm2->finals), offset);
+    offset += fsm2->states->len;
+    if (finals2) gfsm_weightmap_free(finals2);
+  }
+
+  if (fsm1copy) gfsm_automaton_free(fsm1copy);
+  return fsm1;
+}
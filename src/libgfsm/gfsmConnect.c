@@ -27,31 +27,166 @@
 #include <gfsmEnum.h>
 #include <gfsmUtils.h>
 #include <gfsmCompound.h>
+#include <gfsmThreads.h>
 
 /*======================================================================
- * Methods: algebra: connect
+ * Constants
+ */
+const gfsmStateId gfsmConnectParallelMinStates = 65536;
+
+//-- level-synchronous parallel traversal needs atomic test-and-set on bit-vector bytes
+#if defined(GFSM_THREADS_ENABLED) && defined(__GNUC__)
+# define GFSM_CONNECT_PARALLEL 1
+#endif
+
+/*======================================================================
+ * Utilities: traversal
  */
 
 /*--------------------------------------------------------------
- * connect()
+ * connect_push_()
+ *  + marks (id) in (visited) and pushes it onto (stack), if it is a valid unvisited state
  */
-gfsmAutomaton *gfsm_automaton_connect(gfsmAutomaton *fsm)
+static inline
+void gfsm_connect_push_(gfsmAutomaton *fsm, gfsmStateId id, gfsmBitVector *visited, GArray *stack)
 {
-  gfsmBitVector *wanted;
+  if (gfsm_bitvector_get(visited,id) || !gfsm_automaton_has_state(fsm,id)) return;
+  gfsm_bitvector_set(visited,id,1);
+  g_array_append_val(stack,id);
+}
 
-  //-- sanity check
-  if (!fsm || gfsm_automaton_n_states(fsm)==0) return fsm;
+/*--------------------------------------------------------------
+ * connect_dfs_()
+ *  + marks all states reachable from those on (stack) in (visited), using an explicit stack
+ *  + follows arcs backwards if (rsi) is non-NULL, otherwise forwards
+ */
+static
+void gfsm_connect_dfs_(gfsmAutomaton *fsm, GArray *stack, gfsmReverseStateIndex *rsi, gfsmBitVector *visited)
+{
+  while (stack->len > 0) {
+    gfsmStateId qid = g_array_index(stack,gfsmStateId,--stack->len);
+    if (rsi) {
+      gfsmStateId *pp, *pend;
+      for (pp=gfsm_reverse_state_index_begin(rsi,qid), pend=gfsm_reverse_state_index_end(rsi,qid); pp < pend; pp++) {
+	gfsm_connect_push_(fsm, *pp, visited, stack);
+      }
+    } else {
+      gfsmArcIter ai;
+      for (gfsm_arciter_open(&ai,fsm,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+	gfsm_connect_push_(fsm, gfsm_arciter_arc(&ai)->target, visited, stack);
+      }
+      gfsm_arciter_close(&ai);
+    }
+  }
+}
 
-  wanted = gfsm_bitvector_sized_new(fsm->states->len);
-  gfsm_automaton_connect_fw(fsm, wanted);
+#ifdef GFSM_CONNECT_PARALLEL
+/// shared data for gfsm_connect_bfs_parallel_()
+struct gfsm_connect_bfs_data_ {
+  gfsmAutomaton         *fsm;       //-- automaton being traversed
+  gfsmReverseStateIndex *rsi;       //-- reverse index for backward traversal, or NULL
+  gfsmBitVector         *visited;   //-- traversal record (pre-sized)
+  GArray                *frontier;  //-- current BFS level (gfsmStateId)
+  GArray               **next;      //-- per-thread next BFS levels (gfsmStateId)
+};
 
-  gfsm_bitvector_zero(wanted);
-  gfsm_automaton_connect_bw(fsm, NULL, wanted);
+/*--------------------------------------------------------------
+ * connect_bfs_visit_()
+ *  + atomically claims (id) in (visited); appends it to (next) if it was unclaimed
+ */
+static inline
+void gfsm_connect_bfs_visit_(struct gfsm_connect_bfs_data_ *data, gfsmStateId id, GArray *next)
+{
+  guint8 *byte, mask;
+  if (!gfsm_automaton_has_state(data->fsm,id)) return;
+  byte = &g_array_index(data->visited, guint8, gfsm_bitvector_bits2bytes_(id));
+  mask = (guint8)(1<<(id%8));
+  if (__atomic_load_n(byte,__ATOMIC_RELAXED) & mask) return;
+  if (__atomic_fetch_or(byte,mask,__ATOMIC_RELAXED) & mask) return;
+  g_array_append_val(next,id);
+}
 
-  gfsm_bitvector_free(wanted);
-  return fsm;
+/*--------------------------------------------------------------
+ * connect_bfs_chunk_()
+ *  + gfsmParallelFunc: expands frontier[begin..end)
+ */
+static
+void gfsm_connect_bfs_chunk_(guint begin, guint end, guint thread_id, struct gfsm_connect_bfs_data_ *data)
+{
+  GArray *next = data->next[thread_id];
+  guint   i;
+  for (i=begin; i < end; i++) {
+    gfsmStateId qid = g_array_index(data->frontier,gfsmStateId,i);
+    if (data->rsi) {
+      gfsmStateId *pp, *pend;
+      for (pp=gfsm_reverse_state_index_begin(data->rsi,qid), pend=gfsm_reverse_state_index_end(data->rsi,qid); pp < pend; pp++) {
+	gfsm_connect_bfs_visit_(data, *pp, next);
+      }
+    } else {
+      gfsmArcIter ai;
+      for (gfsm_arciter_open(&ai,data->fsm,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+	gfsm_connect_bfs_visit_(data, gfsm_arciter_arc(&ai)->target, next);
+      }
+      gfsm_arciter_close(&ai);
+    }
+  }
 }
 
+/*--------------------------------------------------------------
+ * connect_bfs_parallel_()
+ *  + level-synchronous multi-threaded variant of gfsm_connect_dfs_()
+ *  + states on (frontier) must already be marked in (visited)
+ */
+static
+void gfsm_connect_bfs_parallel_(gfsmAutomaton *fsm, GArray *frontier, gfsmReverseStateIndex *rsi, gfsmBitVector *visited, guint n_threads)
+{
+  struct gfsm_connect_bfs_data_ data = { fsm, rsi, visited, frontier, NULL };
+  guint i;
+
+  data.next = g_new(GArray*, n_threads);
+  for (i=0; i < n_threads; i++) {
+    data.next[i] = g_array_new(FALSE,FALSE,sizeof(gfsmStateId));
+  }
+
+  while (frontier->len > 0) {
+    guint n_used = gfsm_parallel_for(frontier->len, n_threads, 0, (gfsmParallelFunc)gfsm_connect_bfs_chunk_, &data);
+
+    //-- next level := concatenation of per-thread results
+    frontier->len = 0;
+    for (i=0; i < n_used; i++) {
+      g_array_append_vals(frontier, data.next[i]->data, data.next[i]->len);
+      data.next[i]->len = 0;
+    }
+  }
+
+  for (i=0; i < n_threads; i++) {
+    g_array_free(data.next[i],TRUE);
+  }
+  g_free(data.next);
+}
+#endif /* GFSM_CONNECT_PARALLEL */
+
+/*--------------------------------------------------------------
+ * connect_traverse_()
+ *  + marks all states reachable from those on (stack) in (visited)
+ *  + dispatches to the parallel variant for large automata if threads are enabled
+ */
+static
+void gfsm_connect_traverse_(gfsmAutomaton *fsm, GArray *stack, gfsmReverseStateIndex *rsi, gfsmBitVector *visited)
+{
+#ifdef GFSM_CONNECT_PARALLEL
+  guint n_threads = gfsm_threads_get_default();
+  if (n_threads > 1 && gfsm_automaton_n_states(fsm) >= gfsmConnectParallelMinStates) {
+    gfsm_connect_bfs_parallel_(fsm, stack, rsi, visited, n_threads);
+    return;
+  }
+#endif
+  gfsm_connect_dfs_(fsm, stack, rsi, visited);
+}
+
+/*======================================================================
+ * Methods: algebra: connect
+ */
 
 /*--------------------------------------------------------------
  * connect_fw_visit_state()
@@ -61,23 +196,16 @@ void gfsm_connect_fw_visit_state(gfsmAutomaton *fsm,
 				 gfsmStateId    id,
 				 gfsmBitVector *visited)
 {
-  gfsmState *s;
-  gfsmArcIter ai;
+  GArray *stack = g_array_sized_new(FALSE,FALSE,sizeof(gfsmStateId),64);
 
-  //-- already visited
-  if (gfsm_bitvector_get(visited,id)) return;
+  //-- pre-size traversal record, so that parallel traversal need not grow it
+  if (gfsm_bitvector_size(visited) < fsm->states->len)
+    gfsm_bitvector_resize(visited, fsm->states->len);
 
-  s = gfsm_automaton_find_state(fsm,id);
-  if (!s || !s->is_valid) return;                    //-- ignore invalid states
-
-  //-- mark node as visited on this path
-  gfsm_bitvector_set(visited,id,1);
-
-  //-- visit targets of outgoing arcs
-  for (gfsm_arciter_open_ptr(&ai,fsm,s); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
-    gfsm_connect_fw_visit_state(fsm, gfsm_arciter_arc(&ai)->target, visited);
-  }
+  gfsm_connect_push_(fsm, id, visited, stack);
+  gfsm_connect_traverse_(fsm, stack, NULL, visited);
 
+  g_array_free(stack,TRUE);
   return;
 }
 
@@ -113,31 +241,61 @@ gfsmAutomaton *gfsm_automaton_connect_fw(gfsmAutomaton *fsm, gfsmBitVector *visi
  */
 struct gfsm_connect_bw_data_ {
   gfsmAutomaton *fsm;
-  GPtrArray     *rarcs;
   gfsmBitVector *finalizable;
+  GArray        *stack;
 };
 
-gboolean gfsm_connect_bw_visit_state(gfsmStateId id,
-				     gpointer    pw,
-				     struct      gfsm_connect_bw_data_ *data)
+static
+gboolean gfsm_connect_bw_push_final_(gpointer id_p, GFSM_UNUSED gpointer pw, struct gfsm_connect_bw_data_ *data)
+{
+  gfsm_connect_push_(data->fsm, GPOINTER_TO_UINT(id_p), data->finalizable, data->stack);
+  return FALSE; //-- continue traversal
+}
+
+/*--------------------------------------------------------------
+ * connect_bw_rarcs_()
+ *  + backward traversal over a user-supplied (list-based) gfsmReverseArcIndex
+ */
+static
+void gfsm_connect_bw_rarcs_(gfsmAutomaton *fsm, GArray *stack, gfsmReverseArcIndex *rarcs, gfsmBitVector *finalizable)
+{
+  while (stack->len > 0) {
+    gfsmStateId qid = g_array_index(stack,gfsmStateId,--stack->len);
+    GSList     *rl;
+    for (rl=g_ptr_array_index(rarcs,qid); rl != NULL; rl=rl->next) {
+      gfsm_connect_push_(fsm, ((gfsmArc*)rl->data)->source, finalizable, stack);
+    }
+  }
+}
+
+/*--------------------------------------------------------------
+ * connect_bw_mark_()
+ *  + marks all states from which some final state is reachable in (finalizable), which is grown if required
+ *  + states already marked in (finalizable) are neither re-visited nor traversed through
+ */
+static
+void gfsm_connect_bw_mark_(gfsmAutomaton *fsm, gfsmReverseArcIndex *rarcs, gfsmBitVector *finalizable)
 {
-  GSList *rl;
+  struct gfsm_connect_bw_data_ data = {fsm,finalizable,NULL};
 
-  //-- already visited
-  if (gfsm_bitvector_get(data->finalizable,id)     //-- already visited?
-      || !gfsm_automaton_has_state(data->fsm, id)) //-- bad state?
-    return FALSE;                                  //-----> continue traversal
+  //-- traversal record
+  if (gfsm_bitvector_size(finalizable) < fsm->states->len)
+    gfsm_bitvector_resize(finalizable, fsm->states->len);
 
-  //-- mark state as finalizable
-  gfsm_bitvector_set(data->finalizable,id,1);
+  //-- seed traversal with final states
+  data.stack = g_array_sized_new(FALSE,FALSE,sizeof(gfsmStateId),gfsm_automaton_n_final_states(fsm));
+  gfsm_automaton_finals_foreach(fsm, (GTraverseFunc)gfsm_connect_bw_push_final_, &data);
 
-  //-- visit sources of incoming arcs
-  for (rl=g_ptr_array_index(data->rarcs,id); rl != NULL; rl=rl->next) {
-    gfsmArc *arc = (gfsmArc*)rl->data;
-    gfsm_connect_bw_visit_state(arc->source,pw,data);
+  //-- traverse
+  if (rarcs != NULL) {
+    gfsm_connect_bw_rarcs_(fsm, data.stack, rarcs, finalizable);
+  } else {
+    gfsmReverseStateIndex *rsi = gfsm_automaton_to_reverse_state_index(fsm,NULL);
+    gfsm_connect_traverse_(fsm, data.stack, rsi, finalizable);
+    gfsm_reverse_state_index_free(rsi);
   }
 
-  return FALSE; //-- continue traversal
+  g_array_free(data.stack,TRUE);
 }
 
 /*--------------------------------------------------------------
@@ -147,38 +305,59 @@ gfsmAutomaton *gfsm_automaton_connect_bw(gfsmAutomaton       *fsm,
 					 gfsmReverseArcIndex *rarcs,
 					 gfsmBitVector       *finalizable)
 {
-  gboolean rarcs_is_temp = FALSE;
   gboolean finalizable_is_temp = FALSE;
-  struct gfsm_connect_bw_data_ data = {fsm,rarcs,finalizable};
 
   //-- sanity check(s)
   if (!fsm || gfsm_automaton_n_final_states(fsm)==0)
     return gfsm_automaton_prune_states(fsm,NULL);
 
-  //-- reverse arc-index
-  if (rarcs==NULL) {
-    rarcs = data.rarcs = gfsm_automaton_reverse_arc_index(fsm,NULL);
-    rarcs_is_temp = TRUE;
-  }
-
   //-- traversal record
   if (finalizable==NULL) {
-    finalizable = data.finalizable = gfsm_bitvector_sized_new(fsm->states->len);
+    finalizable = gfsm_bitvector_sized_new(fsm->states->len);
     finalizable_is_temp = TRUE;
   }
 
-  //-- traverse
-  gfsm_automaton_finals_foreach(fsm, (GTraverseFunc)gfsm_connect_bw_visit_state,  &data);
+  //-- traverse & prune
+  gfsm_connect_bw_mark_(fsm, rarcs, finalizable);
   gfsm_automaton_prune_states(fsm, finalizable);
 
   //-- cleanup
   if (finalizable_is_temp) gfsm_bitvector_free(finalizable);
-  if (rarcs_is_temp) gfsm_reverse_arc_index_free(rarcs,TRUE);
 
   return fsm;
 }
 
 
+/*--------------------------------------------------------------
+ * connect()
+ */
+gfsmAutomaton *gfsm_automaton_connect(gfsmAutomaton *fsm)
+{
+  gfsmBitVector *accessible, *wanted;
+
+  //-- sanity check(s)
+  if (!fsm || gfsm_automaton_n_states(fsm)==0) return fsm;
+  if (fsm->root_id == gfsmNoState || gfsm_automaton_n_final_states(fsm)==0)
+    return gfsm_automaton_prune_states(fsm,NULL);
+
+  //-- mark accessible states
+  accessible = gfsm_bitvector_sized_new(fsm->states->len);
+  gfsm_connect_fw_visit_state(fsm, fsm->root_id, accessible);
+
+  //-- mark co-accessible states, treating inaccessible states as already visited
+  //   so that the backward traversal never leaves the accessible sub-graph
+  wanted = gfsm_bitvector_not(gfsm_bitvector_or(gfsm_bitvector_new(), accessible));
+  gfsm_connect_bw_mark_(fsm, NULL, wanted);
+
+  //-- prune everything but accessible & co-accessible states in a single sweep
+  gfsm_automaton_prune_states(fsm, gfsm_bitvector_and(wanted, accessible));
+
+  gfsm_bitvector_free(accessible);
+  gfsm_bitvector_free(wanted);
+  return fsm;
+}
+
+
 /*--------------------------------------------------------------
  * prune_states()
  */
@@ -187,23 +366,33 @@ gfsmAutomaton *gfsm_automaton_prune_states(gfsmAutomaton *fsm, gfsmBitVector *wa
   gfsmStateId id, maxwanted=gfsmNoState;
   gfsmArcIter ai;
 
-  for (id=0; id < fsm->states->len; id++) {
-    if (!wanted || !gfsm_bitvector_get(wanted,id)) {
-      //-- unwanted state: chuck it
+  if (!wanted) {
+    //-- nothing wanted: chuck everything
+    for (id=0; id < fsm->states->len; id++) {
+      gfsm_automaton_remove_state(fsm,id);
+    }
+  }
+  else {
+    //-- chuck unwanted states, skipping whole runs of wanted ones
+    for (id=gfsm_bitvector_find_next_unset(wanted,0); id < fsm->states->len; id=gfsm_bitvector_find_next_unset(wanted,id+1)) {
       gfsm_automaton_remove_state(fsm,id);
     }
-    else {
-      maxwanted = id;
-      //-- prune outgoing arcs to any unwanted states, too
-      for (gfsm_arciter_open(&ai, fsm, id); gfsm_arciter_ok(&ai); ) {
-	gfsmArc *arc = gfsm_arciter_arc(&ai);
-	if (!wanted || !gfsm_bitvector_get(wanted,arc->target)) {
-	  gfsm_arciter_remove(&ai);
-	} else {
-	  gfsm_arciter_next(&ai);
+
+    //-- prune outgoing arcs of wanted states to any unwanted states, too
+    for (id=gfsm_bitvector_find_next_set(wanted,0);
+	 id != gfsmBitVectorNone && id < fsm->states->len;
+	 id=gfsm_bitvector_find_next_set(wanted,id+1))
+      {
+	maxwanted = id;
+	for (gfsm_arciter_open(&ai, fsm, id); gfsm_arciter_ok(&ai); ) {
+	  gfsmArc *arc = gfsm_arciter_arc(&ai);
+	  if (!gfsm_bitvector_get(wanted,arc->target)) {
+	    gfsm_arciter_remove(&ai);
+	  } else {
+	    gfsm_arciter_next(&ai);
+	  }
 	}
       }
-    }
   }
 
   //-- update number of states
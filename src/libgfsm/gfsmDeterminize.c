@@ -28,6 +28,7 @@
 #include <gfsmUtils.h>
 #include <gfsmCompound.h>
 #include <gfsmEnum.h>
+#include <gfsmView.h>
 //#include <gfsmAlphabet.h>
 
 /*======================================================================
@@ -125,9 +126,12 @@ gfsmAutomaton *gfsm_automaton_determinize(gfsmAutomaton *nfa)
 }
 
 /*--------------------------------------------------------------
- * determinize_full()
+ * determinize_view_()
+ *  + guts for gfsm_automaton_determinize_full() and gfsm_indexed_automaton_determinize_full()
+ *  + dfa must be clear, with flags and semiring already set up
  */
-gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton *dfa)
+static
+gfsmAutomaton *gfsm_determinize_view_(gfsmAutomatonView *nfa, gfsmAutomaton *dfa)
 {
   //gfsmAlphabet   *ec2id; //-- (global) maps literal(equiv-class@nfa) <=> state-id@dfa
   gfsmEnum       *ec2id; //-- (global) maps literal(equiv-class@nfa) <=> state-id@dfa
@@ -138,22 +142,8 @@ gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton
   gfsmArcCompData acdata = {gfsmASMLower, nfa->sr, NULL, NULL};
   gfsmSemiring *sr;
   GArray *nfa_arcs = NULL;
- 
-  //-- sanity check(s)
-  if (!nfa) return NULL;
-  else if (nfa->flags.is_deterministic) {
-    if (dfa) gfsm_automaton_copy(dfa,nfa);
-    else     dfa = gfsm_automaton_clone(nfa);
-    return dfa;
-  }
+  gfsmWeight fw;
 
-  //-- initialization: dfa
-  if (!dfa) {
-    dfa = gfsm_automaton_shadow(nfa);
-  } else {
-    gfsm_automaton_clear(dfa);
-    gfsm_automaton_copy_shallow(dfa,nfa);
-  }
   //-- avoid "smart" arc-insertion
   dfa->flags.sort_mode = gfsmASMNone;
   sr = dfa->sr;
@@ -175,17 +165,16 @@ gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton
   gfsm_automaton_set_root(dfa, dfa_id);
 
   //-- initialization: root: final?
-  if (gfsm_automaton_state_is_final(nfa, nfa->root_id)) {
-    gfsm_automaton_set_final_state_full(dfa, dfa->root_id, TRUE, gfsm_automaton_get_final_weight(nfa, nfa->root_id));
+  if (gfsm_view_lookup_final(nfa, nfa->root_id, &fw)) {
+    gfsm_automaton_set_final_state_full(dfa, dfa->root_id, TRUE, fw);
   }
 
   //-- guts: queue processing
   queue = g_slist_prepend(queue, nfa_ec);
   while (queue != NULL) {
     GSList *head = queue;
-    gfsmState *qptr;
     guint eci;
-    gfsmArcIter ai;
+    gfsmViewArcIter vai;
     guint xi0,xi1, xi;
 
     //-- pop the queue
@@ -198,11 +187,10 @@ gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton
     g_array_set_size(nfa_arcs,0);
     for (eci=0; eci < nfa_ec->len; eci++) {
       wq   = &g_array_index(nfa_ec, gfsmStateWeightPair, eci);
-      qptr = gfsm_automaton_find_state(nfa,wq->id);
-      for (gfsm_arciter_open_ptr(&ai,nfa,qptr); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      for (gfsm_view_arciter_open(&vai,nfa,wq->id); gfsm_view_arciter_ok(&vai); gfsm_view_arciter_next(&vai)) {
 	gfsmResidualArc ra;
 	ra.wq = wq;
-	ra.a  = gfsm_arciter_arc(&ai);
+	ra.a  = gfsm_view_arciter_arc(&vai);
 	g_array_append_val(nfa_arcs,ra);
       }
     }
@@ -261,7 +249,7 @@ gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton
 	//-- is any qx element-state final in nfa?
 	for (qxi=0; qxi < qx->len; qxi++) {
 	  wq = &g_array_index(qx, gfsmStateWeightPair, qxi);
-	  if (gfsm_automaton_lookup_final(nfa, wq->id, &fw_i)) {
+	  if (gfsm_view_lookup_final(nfa, wq->id, &fw_i)) {
 	    fw_qx = gfsm_sr_plus(sr, fw_qx, gfsm_sr_times(sr, wq->w, fw_i));
 	  }
 	}
@@ -283,3 +271,57 @@ gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton
   return dfa;
 }
 
+/*--------------------------------------------------------------
+ * determinize_full()
+ */
+gfsmAutomaton *gfsm_automaton_determinize_full(gfsmAutomaton *nfa, gfsmAutomaton *dfa)
+{
+  gfsmAutomatonView view;
+
+  //-- sanity check(s)
+  if (!nfa) return NULL;
+  else if (nfa->flags.is_deterministic) {
+    if (dfa) gfsm_automaton_copy(dfa,nfa);
+    else     dfa = gfsm_automaton_clone(nfa);
+    return dfa;
+  }
+
+  //-- initialization: dfa
+  if (!dfa) {
+    dfa = gfsm_automaton_shadow(nfa);
+  } else {
+    gfsm_automaton_clear(dfa);
+    gfsm_automaton_copy_shallow(dfa,nfa);
+  }
+
+  return gfsm_determinize_view_(gfsm_automaton_view(&view,nfa), dfa);
+}
+
+/*--------------------------------------------------------------
+ * indexed_automaton_determinize_full()
+ */
+gfsmAutomaton *gfsm_indexed_automaton_determinize_full(gfsmIndexedAutomaton *xnfa, gfsmAutomaton *dfa)
+{
+  gfsmAutomatonView view;
+
+  //-- sanity check(s)
+  if (!xnfa) return NULL;
+  else if (xnfa->flags.is_deterministic) {
+    return gfsm_indexed_to_automaton(xnfa,dfa);
+  }
+
+  //-- initialization: dfa
+  if (!dfa) {
+    dfa = gfsm_automaton_new_full(xnfa->flags, xnfa->sr->type, gfsmAutomatonDefaultSize);
+  } else {
+    guint32 is_indexed = dfa->flags.is_indexed;
+    gfsm_automaton_clear(dfa);
+    dfa->flags            = xnfa->flags;
+    dfa->flags.is_indexed = is_indexed; //-- arc indices belong to dfa's topology
+  }
+  if (dfa->sr->type != xnfa->sr->type || xnfa->sr->type == gfsmSRTUser)
+    gfsm_automaton_set_semiring(dfa, xnfa->sr);
+
+  return gfsm_determinize_view_(gfsm_indexed_automaton_view(&view,xnfa), dfa);
+}
+
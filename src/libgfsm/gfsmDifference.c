@@ -27,6 +27,8 @@
 #include <gfsmEnum.h>
 #include <gfsmUtils.h>
 #include <gfsmCompound.h>
+#include <gfsmMatcher.h>
+#include <gfsmView.h>
 
 /*======================================================================
  * Methods: algebra: difference
@@ -44,22 +46,230 @@ gfsmAutomaton *gfsm_automaton_difference(gfsmAutomaton *fsm1, gfsmAutomaton *fsm
 }
 
 /*--------------------------------------------------------------
- * difference_full()
+ * difference_arc_table_index_()
+ *  + contiguous copy of the arcs of fsm, sorted on (lower,upper) as for intersect(): cached or temporary
  */
-gfsmAutomaton *gfsm_automaton_difference_full(gfsmAutomaton *fsm1,
-					      gfsmAutomaton *fsm2,
-					      gfsmAutomaton *diff)
+static
+gfsmArcTableIndex *gfsm_difference_arc_table_index_(gfsmAutomaton *fsm)
+{
+  gfsmArcTableIndex *tabx = gfsm_automaton_lookup_arc_index(fsm,gfsmLSLower);
+  if (tabx) return tabx;
+  tabx = gfsm_automaton_to_arc_table_index(fsm,NULL);
+  if (gfsm_acmask_nth(fsm->flags.sort_mode,0) != gfsmACLower)
+    gfsm_arc_table_index_sort_bymask(tabx, (gfsmACLower|(gfsmACUpper<<gfsmACShift)), NULL);
+  return tabx;
+}
+
+/*--------------------------------------------------------------
+ * difference_label_compare_()
+ */
+static
+gint gfsm_difference_label_compare_(gconstpointer ap, gconstpointer bp)
+{
+  gfsmLabelVal a = *((const gfsmLabelVal*)ap), b = *((const gfsmLabelVal*)bp);
+  return (a < b ? -1 : (a > b ? 1 : 0));
+}
+
+/*--------------------------------------------------------------
+ * difference_is_dfa_()
+ *  + check whether the automaton viewed by view is epsilon-free, deterministic, and free of implicit arcs
+ *  + checks the arcs in place, so no arc table is built for a non-deterministic automaton
+ */
+static
+gboolean gfsm_difference_is_dfa_(gfsmAutomatonView *view)
+{
+  gboolean     sorted = (gfsm_acmask_nth(view->flags.sort_mode,0) == gfsmACLower);
+  GArray      *labs = sorted ? NULL : g_array_new(FALSE, FALSE, sizeof(gfsmLabelVal));
+  gboolean     rc = TRUE;
+  gfsmStateId  qid, n_states = gfsm_view_n_states(view);
+  gfsmViewArcIter ai;
+  guint        i;
+
+  for (qid=0; rc && qid < n_states; qid++) {
+    gfsmLabelVal prev = gfsmNoLabel;
+    if (!gfsm_view_has_state(view,qid)) continue;
+    if (labs) g_array_set_size(labs,0);
+    for (gfsm_view_arciter_open(&ai,view,qid); gfsm_view_arciter_ok(&ai); gfsm_view_arciter_next(&ai)) {
+      gfsmLabelVal lo = gfsm_view_arciter_arc(&ai)->lower;
+      if (lo == gfsmEpsilon || gfsm_label_is_implicit(lo) || (sorted && lo == prev)) {
+	rc = FALSE;
+	break;
+      }
+      if (labs) g_array_append_val(labs,lo);
+      prev = lo;
+    }
+    gfsm_view_arciter_close(&ai);
+
+    //-- unsorted arc list: check for duplicate labels
+    if (rc && labs && labs->len > 1) {
+      g_array_sort(labs, gfsm_difference_label_compare_);
+      for (i=1; i < labs->len; i++) {
+	if (g_array_index(labs,gfsmLabelVal,i) == g_array_index(labs,gfsmLabelVal,i-1)) {
+	  rc = FALSE;
+	  break;
+	}
+      }
+    }
+  }
+
+  if (labs) g_array_free(labs,TRUE);
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * difference_visit_()
+ *  + sp.id2==gfsmNoState is the implicit (non-final) sink of fsm2
+ *  + tabx1, tabx2: arcs of fsm1, fsm2, sorted on lower label
+ */
+static
+gfsmStateId gfsm_automaton_difference_visit_(gfsmStatePair sp,
+					     gfsmAutomaton *fsm1,
+					     gfsmAutomatonView *view2,
+					     gfsmAutomaton *fsm,
+					     gfsmStatePairEnum *spenum,
+					     gfsmArcTableIndex *tabx1,
+					     gfsmArcTableIndex *tabx2)
+{
+  gfsmState    *q1;
+  gfsmStateId  qid = gfsm_enum_lookup(spenum,&sp);
+  gfsmStateId  qid2;
+  gfsmWeight   fw1, fw2;
+  gfsmArcRange r1, r2;
+  gfsmArc     *a1;
+
+  //-- ignore already-visited states
+  if (qid != gfsmEnumNone) return qid;
+
+  //-- get state pointers for input automata; (sp.id2==gfsmNoState) is the implicit sink of fsm2
+  q1 = gfsm_automaton_find_state(fsm1,sp.id1);
+  if (!q1 || !q1->is_valid) return gfsmNoState;
+  if (sp.id2 != gfsmNoState && !gfsm_view_has_state(view2,sp.id2)) sp.id2 = gfsmNoState;
+
+  //-- insert new state into output automaton
+  qid = gfsm_automaton_add_state(fsm);
+  gfsm_enum_insert_full(spenum,&sp,qid);
+
+  //-- check for final states: final in fsm1 but not in fsm2
+  if (gfsm_automaton_lookup_final(fsm1,sp.id1,&fw1)
+      && (sp.id2 == gfsmNoState || !gfsm_view_lookup_final(view2,sp.id2,&fw2)))
+    {
+      gfsm_automaton_set_final_state_full(fsm,qid,TRUE,fw1);
+    }
+
+  //-- arcs: fsm1 arcs are sorted on lower label, so fsm2 arcs can be searched incrementally
+  gfsm_arcrange_open_table_index(&r1, tabx1, sp.id1);
+  if (sp.id2 != gfsmNoState) {
+    gfsm_arcrange_open_table_index(&r2, tabx2, sp.id2);
+  } else {
+    r2.min = r2.max = NULL;
+  }
+
+  for (a1=r1.min; a1 < r1.max; a1++) {
+    //-- eps: case fsm1:(q1 --eps-->  q1'), fsm2:(q2)
+    if (a1->lower == gfsmEpsilon) {
+      qid2 = gfsm_automaton_difference_visit_((gfsmStatePair){a1->target,sp.id2},
+					      fsm1, view2, fsm, spenum, tabx1, tabx2);
+      if (qid2 != gfsmNoState)
+	gfsm_automaton_add_arc(fsm, qid, qid2, gfsmEpsilon, gfsmEpsilon, a1->weight);
+      continue;
+    }
+
+    //-- non-eps: find the (unique) matching arc in fsm2, if any
+    gfsm_arcrange_gallop_lower(&r2, a1->lower);
+    if (gfsm_arcrange_ok(&r2) && r2.min->lower == a1->lower) {
+      //-- match: case fsm1:(q1 --a-->  q1'), fsm2:(q2 --a--> q2')
+      qid2 = gfsm_automaton_difference_visit_((gfsmStatePair){a1->target,r2.min->target},
+					      fsm1, view2, fsm, spenum, tabx1, tabx2);
+      if (qid2 != gfsmNoState)
+	gfsm_automaton_add_arc(fsm, qid, qid2, a1->lower, a1->lower,
+			       gfsm_sr_times(fsm1->sr, a1->weight, r2.min->weight));
+    } else {
+      //-- no match: case fsm1:(q1 --a-->  q1'), fsm2:(q2 --a--> sink)
+      qid2 = gfsm_automaton_difference_visit_((gfsmStatePair){a1->target,gfsmNoState},
+					      fsm1, view2, fsm, spenum, tabx1, tabx2);
+      if (qid2 != gfsmNoState)
+	gfsm_automaton_add_arc(fsm, qid, qid2, a1->lower, a1->lower, a1->weight);
+    }
+  }
+
+  return qid;
+}
+
+/*--------------------------------------------------------------
+ * difference_view_full_()
+ *  + guts for difference_full() and difference_indexed_full(): fsm2 is only read, via view2
+ */
+static
+gfsmAutomaton *gfsm_automaton_difference_view_full_(gfsmAutomaton *fsm1,
+						     gfsmAutomatonView *view2,
+						     gfsmAutomaton *diff)
 {
-  gfsmAutomaton *not_fsm2;
-  gfsmAlphabet *alph1 = gfsm_identity_alphabet_new();
+  gfsmAutomaton     *not_fsm2;
+  gfsmArcTableIndex *tabx1, *tabx2;
+
+  //-- deterministic, epsilon-free fsm2: walk (fsm1 x fsm2) directly
+  if (gfsm_difference_is_dfa_(view2)) {
+    gfsmStatePairEnum *spenum = gfsm_statepair_enum_new();
+    gfsmStateId        rootid;
+
+    if (!diff) {
+      diff = gfsm_automaton_shadow(fsm1);
+    } else {
+      gfsm_automaton_clear(diff);
+      gfsm_automaton_copy_shallow(diff,fsm1);
+    }
+    diff->flags.sort_mode     = gfsmASMNone;
+    diff->flags.is_transducer = 0;
+
+    tabx1  = gfsm_difference_arc_table_index_(fsm1);
+    if (!(tabx2 = gfsm_view_lower_arc_table(view2, (gfsmACLower|(gfsmACUpper<<gfsmACShift)))))
+      tabx2 = gfsm_automaton_to_arc_table_index(view2->fsm,NULL);
+    rootid = gfsm_automaton_difference_visit_((gfsmStatePair){fsm1->root_id,view2->root_id},
+					      fsm1, view2, diff, spenum, tabx1, tabx2);
+    if (rootid != gfsmNoState) {
+      gfsm_automaton_set_root(diff, rootid);
+    } else {
+      diff->root_id = gfsmNoState;
+    }
 
-  gfsm_automaton_get_alphabet(fsm1, gfsmLSLower, alph1);
-  not_fsm2 = gfsm_automaton_clone(fsm2);
-  gfsm_automaton_complement_full(not_fsm2, alph1);
+    gfsm_enum_free(spenum);
+    if (tabx1 != fsm1->index_lower) gfsm_arc_table_index_free(tabx1);
+    if (tabx2 != view2->index_lower) gfsm_arc_table_index_free(tabx2);
+    return diff;
+  }
+
+  //-- general case
+  not_fsm2 = (view2->fsm
+	      ? gfsm_automaton_clone(view2->fsm)
+	      : gfsm_indexed_to_automaton(view2->xfsm,NULL));
+
+  //-- complement with implicit (rho) arcs, which intersect() matches against any label of fsm1
+  gfsm_automaton_complement_implicit(not_fsm2);
   diff = gfsm_automaton_intersect_full(fsm1, not_fsm2, diff, NULL);
 
   gfsm_automaton_free(not_fsm2);
-  gfsm_alphabet_free(alph1);
 
   return diff;
 }
+
+/*--------------------------------------------------------------
+ * difference_full()
+ */
+gfsmAutomaton *gfsm_automaton_difference_full(gfsmAutomaton *fsm1,
+					      gfsmAutomaton *fsm2,
+					      gfsmAutomaton *diff)
+{
+  gfsmAutomatonView view2;
+  return gfsm_automaton_difference_view_full_(fsm1, gfsm_automaton_view(&view2,fsm2), diff);
+}
+
+/*--------------------------------------------------------------
+ * difference_indexed_full()
+ */
+gfsmAutomaton *gfsm_automaton_difference_indexed_full(gfsmAutomaton *fsm1,
+						      gfsmIndexedAutomaton *xfsm2,
+						      gfsmAutomaton *diff)
+{
+  gfsmAutomatonView view2;
+  return gfsm_automaton_difference_view_full_(fsm1, gfsm_indexed_automaton_view(&view2,xfsm2), diff);
+}
@@ -22,6 +22,7 @@
 
 #include <gfsmEncode.h>
 #include <gfsmArcIter.h>
+#include <gfsmThreads.h>
 
 //-- no-inline definitions
 #ifndef GFSM_INLINE_ENABLED
@@ -32,18 +33,31 @@
  * gfsmArcLabel Methods
  */
 
+//--------------------------------------------------------------
+// + bit pattern of weight w for hashing: weights which compare equal (-0.0, +0.0)
+//   hash equally, and all NaNs are mapped to a single canonical NaN
+static inline guint32 gfsm_arclabel_weight_bits_(gfsmWeight w)
+{
+  union { gfsmWeight w; guint32 u; } wu;
+  if (w == 0)      wu.w = 0;
+  else if (w != w) return 0x7fc00000;
+  else             wu.w = w;
+  return wu.u;
+}
+
 //--------------------------------------------------------------
 guint gfsm_arclabel_hash(gfsmArcLabel *al)
 {
   //-- prime factors 4091,8179; see http://en.wikipedia.org/wiki/List_of_prime_numbers#Largest_primes_smaller_than_2n
   //   + glib hash table uses  4093,8191
-  return 4091*al->lo + 8179*al->hi + GPOINTER_TO_UINT(gfsm_weight2ptr(al->w));
+  return 4091*al->lo + 8179*al->hi + gfsm_arclabel_weight_bits_(al->w);
 }
 
 //--------------------------------------------------------------
 guint gfsm_arclabel_equal(const gfsmArcLabel *al1, const gfsmArcLabel *al2)
 {
-  return al1->lo==al2->lo && al1->hi==al2->hi && al1->w==al2->w;
+  return (al1->lo==al2->lo && al1->hi==al2->hi
+	  && gfsm_arclabel_weight_bits_(al1->w)==gfsm_arclabel_weight_bits_(al2->w));
 }
 
 /*======================================================================
@@ -70,7 +84,7 @@ gfsmAutomaton *gfsm_arclabel_key_to_fsm(gfsmArcLabelKey *key, gfsmAutomaton *fsm
   //-- copy labels (in order)
   for (lab=0; lab < pkey->labels2keys->len; lab++) {
     gfsmArcLabel *al = (gfsmArcLabel*)g_ptr_array_index(pkey->labels2keys, lab);
-    q0->arcs = gfsm_arclist_new_full(0,0, al->lo,al->hi,al->w, q0->arcs);
+    q0->arcs = gfsm_arc_pool_node_new(fsm->arc_pool, 0,0, al->lo,al->hi,al->w, q0->arcs);
   }
 
   //-- reverse arcs and set sort mode
@@ -108,72 +122,302 @@ gfsmArcLabelKey *gfsm_arclabel_fsm_to_key(gfsmAutomaton *fsm, gfsmArcLabelKey *k
 }
 
 /*======================================================================
- * Top-Level Methods
+ * Packed keys
  */
 const gfsmLabelVal gfsmEncodeFinal = 1;
 
+//--------------------------------------------------------------
+// + packed (lo,hi,w) key: arc labels are gfsmLabelId, so 64 bits suffice
+// + weights are normalized as for gfsm_arclabel_hash(), so packed keys compare as gfsm_arclabel_equal()
+static inline guint64 gfsm_arclabel_pack_(gfsmLabelId lo, gfsmLabelId hi, gfsmWeight w)
+{
+  return ((guint64)lo << 48) | ((guint64)hi << 32) | (guint64)gfsm_arclabel_weight_bits_(w);
+}
+
+//--------------------------------------------------------------
+static inline void gfsm_arclabel_unpack_(guint64 k, gfsmArcLabel *al)
+{
+  union { gfsmWeight w; guint32 u; } wu;
+  wu.u  = (guint32)k;
+  al->lo = (gfsmLabelId)(k >> 48);
+  al->hi = (gfsmLabelId)(k >> 32);
+  al->w  = wu.w;
+}
+
+//--------------------------------------------------------------
+static inline guint32 gfsm_arclabel_hash64_(guint64 k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return (guint32)k;
+}
+
+/// open-addressing (linear probing) map from packed keys to labels
+typedef struct {
+  guint64      *keys;    //-- [slot] : packed key
+  gfsmLabelVal *labels;  //-- [slot] : label, or gfsmNoLabel for empty slots
+  guint32       mask;    //-- number of slots - 1 (power of 2)
+  guint32       n;       //-- number of occupied slots
+} gfsmArcKeyTable_;
+
+//--------------------------------------------------------------
+static void gfsm_arckey_table_init_(gfsmArcKeyTable_ *t, guint32 size)
+{
+  guint32 i, n_slots = 16;
+  while (n_slots < 2*size) n_slots <<= 1;
+  t->keys   = g_new(guint64, n_slots);
+  t->labels = g_new(gfsmLabelVal, n_slots);
+  t->mask   = n_slots-1;
+  t->n      = 0;
+  for (i=0; i < n_slots; i++) t->labels[i] = gfsmNoLabel;
+}
+
+//--------------------------------------------------------------
+static void gfsm_arckey_table_clear_(gfsmArcKeyTable_ *t)
+{
+  g_free(t->keys);
+  g_free(t->labels);
+}
+
+//--------------------------------------------------------------
+// + returns slot for k: either holding k, or empty
+static inline guint32 gfsm_arckey_table_slot_(const gfsmArcKeyTable_ *t, guint64 k)
+{
+  guint32 i = gfsm_arclabel_hash64_(k) & t->mask;
+  while (t->labels[i] != gfsmNoLabel && t->keys[i] != k)
+    i = (i+1) & t->mask;
+  return i;
+}
+
+//--------------------------------------------------------------
+static inline gfsmLabelVal gfsm_arckey_table_lookup_(const gfsmArcKeyTable_ *t, guint64 k)
+{
+  return t->labels[gfsm_arckey_table_slot_(t,k)];
+}
+
+//--------------------------------------------------------------
+// + inserts (k,lab) if k is not yet present; returns label for k
+static gfsmLabelVal gfsm_arckey_table_insert_(gfsmArcKeyTable_ *t, guint64 k, gfsmLabelVal lab)
+{
+  guint32 i = gfsm_arckey_table_slot_(t,k);
+  if (t->labels[i] != gfsmNoLabel) return t->labels[i];
+
+  if (2*(t->n+1) > t->mask+1) {
+    //-- grow
+    gfsmArcKeyTable_ old = *t;
+    guint32 j;
+    gfsm_arckey_table_init_(t, 2*(old.mask+1));
+    for (j=0; j <= old.mask; j++) {
+      if (old.labels[j] == gfsmNoLabel) continue;
+      i = gfsm_arckey_table_slot_(t, old.keys[j]);
+      t->keys[i]   = old.keys[j];
+      t->labels[i] = old.labels[j];
+    }
+    t->n = old.n;
+    gfsm_arckey_table_clear_(&old);
+    i = gfsm_arckey_table_slot_(t,k);
+  }
+  t->keys[i]   = k;
+  t->labels[i] = lab;
+  t->n++;
+  return lab;
+}
+
+/*======================================================================
+ * Encoding & decoding guts
+ */
+
+/// shared data for parallel encoding & decoding
+typedef struct {
+  gfsmAutomaton    *fsm;
+  gboolean          labels;     //-- whether to (en|de)code labels
+  gboolean          weights;    //-- whether to (en|de)code weights
+  gfsmStateId       qf;         //-- dummy final state, or gfsmNoState
+  guint32           chunk_size; //-- (encode) states per chunk of chunk_keys
+  GArray          **chunk_keys; //-- (encode) [chunk] : new packed keys in order of first occurrence
+  gfsmArcKeyTable_  table;      //-- (encode) global key table
+  gfsmArcLabel    **labels2keys;//-- (decode) [lab] : key for lab, or NULL
+  guint32           n_labels;   //-- (decode) number of entries in labels2keys
+  guint8           *deferred;   //-- (decode) [qid] : whether qid must be decoded serially
+  guint            *nfdummy;    //-- (decode) [thread_id] : in-degree of the dummy final state
+} gfsmEncodeData_;
+
+//--------------------------------------------------------------
+static inline guint64 gfsm_encode_arc_key_(gfsmEncodeData_ *data, const gfsmArc *a)
+{
+  return gfsm_arclabel_pack_((data->labels ? (gfsmLabelId)(a->lower==0 ? 0 : (a->lower+1)) : 0),
+			     (gfsmLabelId)(a->upper==0 ? 0 : (a->upper+1)),
+			     (data->weights ? a->weight : gfsm_sr_one(data->fsm->sr)));
+}
+
+//--------------------------------------------------------------
+static inline gboolean gfsm_encode_final_key_(gfsmEncodeData_ *data, gfsmStateId qid, guint64 *kp)
+{
+  gfsmWeight wf;
+  if (!data->weights
+      || !gfsm_automaton_lookup_final(data->fsm, qid, &wf)
+      || wf == gfsm_sr_one(data->fsm->sr))
+    return FALSE;
+  *kp = gfsm_arclabel_pack_((data->labels ? gfsmEncodeFinal : gfsmEpsilon), gfsmEncodeFinal, wf);
+  return TRUE;
+}
+
+//--------------------------------------------------------------
+// + gfsmParallelFunc: collects keys of states [begin,end) which are not yet in data->table,
+//   in order of first occurrence, into data->chunk_keys[] (one list per chunk)
+static
+void gfsm_encode_collect_chunk_(guint begin, guint end, GFSM_UNUSED guint thread_id, gfsmEncodeData_ *data)
+{
+  gfsmArcKeyTable_ seen;
+  guint32 chunk;
+
+  gfsm_arckey_table_init_(&seen, 64);
+  for (chunk = begin/data->chunk_size; chunk*data->chunk_size < end; chunk++) {
+    GArray     *keys = g_array_new(FALSE,FALSE,sizeof(guint64));
+    gfsmStateId qid  = MAX(begin, chunk*data->chunk_size);
+    gfsmStateId qmax = MIN(end, (chunk+1)*data->chunk_size);
+
+    for ( ; qid < qmax; qid++) {
+      gfsmState   *q = gfsm_automaton_find_state(data->fsm,qid);
+      gfsmArcList *al;
+      guint64      k;
+      if (qid==data->qf || !q || !q->is_valid) continue;
+
+      for (al=q->arcs; al != NULL; al=al->next) {
+	k = gfsm_encode_arc_key_(data, &al->arc);
+	if (gfsm_arckey_table_lookup_(&data->table,k) == gfsmNoLabel
+	    && gfsm_arckey_table_lookup_(&seen,k) == gfsmNoLabel) {
+	  gfsm_arckey_table_insert_(&seen,k,0);
+	  g_array_append_val(keys,k);
+	}
+      }
+
+      if (gfsm_encode_final_key_(data,qid,&k)
+	  && gfsm_arckey_table_lookup_(&data->table,k) == gfsmNoLabel
+	  && gfsm_arckey_table_lookup_(&seen,k) == gfsmNoLabel) {
+	gfsm_arckey_table_insert_(&seen,k,0);
+	g_array_append_val(keys,k);
+      }
+    }
+    data->chunk_keys[chunk] = keys;
+  }
+  gfsm_arckey_table_clear_(&seen);
+}
+
+//--------------------------------------------------------------
+// + gfsmParallelFunc: replaces arc labels of states [begin,end) (read-only on data->table)
+static
+void gfsm_encode_arcs_chunk_(guint begin, guint end, GFSM_UNUSED guint thread_id, gfsmEncodeData_ *data)
+{
+  gfsmWeight  w0 = gfsm_sr_one(data->fsm->sr);
+  gfsmStateId qid;
+
+  for (qid=begin; qid < end; qid++) {
+    gfsmState   *q = gfsm_automaton_find_state(data->fsm,qid);
+    gfsmArcList *al;
+    if (qid==data->qf || !q || !q->is_valid) continue;
+
+    for (al=q->arcs; al != NULL; al=al->next) {
+      gfsmArc     *a  = &al->arc;
+      gfsmLabelVal lab = gfsm_arckey_table_lookup_(&data->table, gfsm_encode_arc_key_(data,a));
+      if (data->labels) a->lower = lab;
+      a->upper = lab;
+      if (data->weights) a->weight = w0;
+    }
+  }
+}
+
+/*======================================================================
+ * Top-Level Methods
+ */
+
 //--------------------------------------------------------------
 gfsmArcLabelKey *gfsm_automaton_encode(gfsmAutomaton *fsm, gfsmArcLabelKey *key, gboolean encode_labels, gboolean encode_weights)
 {
-  gfsmWeight   w0 = gfsm_sr_one(fsm->sr), wf;
-  gfsmStateId qid, qf=gfsmNoState;
-  gfsmArcIter ai;
+  gfsmPointerAlphabet *pkey;
+  gfsmEncodeData_ data;
+  gfsmWeight   w0 = gfsm_sr_one(fsm->sr);
+  gfsmStateId  qid, n_states;
   gfsmArcLabel al;
-  gfsmLabelVal lab, loFinal = (encode_labels ? gfsmEncodeFinal : gfsmEpsilon);
+  gfsmLabelVal lab, lab_min;
+  guint32      n_threads, n_chunks, c, i;
+  guint64      k;
 
   if (!key) {
     key = gfsm_arclabel_key_new();
   }
+  pkey = (gfsmPointerAlphabet*)key;
+  gfsm_automaton_touch(fsm);
 
-  //-- ensure epsilon-entry in key
-  gfsm_arclabel_set(&al, gfsmEpsilon,gfsmEpsilon,w0);
-  gfsm_alphabet_insert(key, &al, gfsmEpsilon);
+  //-- ensure epsilon-entry in key (re-inserting an existing entry would free it)
+  if (gfsm_alphabet_find_key(key, gfsmEpsilon) == NULL) {
+    gfsm_arclabel_set(&al, gfsmEpsilon,gfsmEpsilon,w0);
+    gfsm_alphabet_insert(key, &al, gfsmEpsilon);
+  }
 
   //-- ensure new final state in encoded fsm for weight-encoding
+  data.qf = gfsmNoState;
   if (encode_weights) {
-    qf = gfsm_automaton_add_state(fsm);
-    gfsm_automaton_set_final_state_full(fsm, qf, TRUE, w0);
+    data.qf = gfsm_automaton_add_state(fsm);
+    gfsm_automaton_set_final_state_full(fsm, data.qf, TRUE, w0);
   }
+  n_states     = gfsm_automaton_n_states(fsm);
+  data.fsm     = fsm;
+  data.labels  = encode_labels;
+  data.weights = encode_weights;
 
-  //-- encoding guts
-  for (qid=0; qid < gfsm_automaton_n_states(fsm); qid++) {
-    if (qid==qf || !gfsm_automaton_has_state(fsm,qid)) continue;
-
-    //-- encode arc-labels
-    for (gfsm_arciter_open(&ai, fsm,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
-      gfsmArc *a = gfsm_arciter_arc(&ai);
-
-      //-- build gfsmArcLabel key
-      if (encode_labels) {
-	//-- add 1 to non-epsilon labels to allow (0:1/W) keys to identify final weights
-	al.lo = a->lower==0 ? 0 : (a->lower+1);
-      }
-      al.hi = a->upper==0 ? 0 : (a->upper+1);
-      if (encode_weights) {
-	al.w = a->weight;
-      }
-
-      //-- ensure enumeration for current arc-key
-      lab = gfsm_alphabet_get_label(key, &al);
+  //-- load any existing key entries
+  gfsm_arckey_table_init_(&data.table, pkey->labels2keys->len + n_states);
+  for (lab=0; lab < pkey->labels2keys->len; lab++) {
+    gfsmArcLabel *alp = (gfsmArcLabel*)g_ptr_array_index(pkey->labels2keys,lab);
+    if (alp) gfsm_arckey_table_insert_(&data.table, gfsm_arclabel_pack_(alp->lo,alp->hi,alp->w), lab);
+  }
 
-      //-- modify automaton
-      if (encode_labels) a->lower = lab;
-      a->upper = lab;
-      if (encode_weights) a->weight = w0;
+  //-- collect new keys (in parallel, one list per chunk of states)
+  n_threads       = gfsm_threads_get_default();
+  data.chunk_size = MAX(1, n_states / (8*n_threads));
+  n_chunks        = (n_states + data.chunk_size - 1) / data.chunk_size;
+  data.chunk_keys = g_new0(GArray*, n_chunks);
+  gfsm_parallel_for(n_states, n_threads, data.chunk_size, (gfsmParallelFunc)gfsm_encode_collect_chunk_, &data);
+
+  //-- enumerate new keys in state order, as gfsm_alphabet_get_label() would
+  lab = lab_min = pkey->labels2keys->len;
+  for (c=0; c < n_chunks; c++) {
+    GArray *keys = data.chunk_keys[c];
+    if (!keys) continue;
+    for (i=0; i < keys->len; i++) {
+      if (gfsm_arckey_table_insert_(&data.table, g_array_index(keys,guint64,i), lab) == lab) ++lab;
     }
+    g_array_free(keys,TRUE);
+  }
+  g_free(data.chunk_keys);
+
+  //-- ... and add them to key
+  g_ptr_array_set_size(pkey->labels2keys, lab);
+  for (i=0; i <= data.table.mask; i++) {
+    if (data.table.labels[i] == gfsmNoLabel || data.table.labels[i] < lab_min) continue;
+    gfsm_arclabel_unpack_(data.table.keys[i], &al);
+    gfsm_alphabet_insert(key, &al, data.table.labels[i]);
+  }
 
-    //-- encode final weights
-    if (encode_weights && gfsm_automaton_lookup_final(fsm, qid, &wf) && wf != w0) {
-      //-- special entry-type *:1/W for final weights
-      gfsm_arclabel_set(&al, loFinal,gfsmEncodeFinal, wf);
-      lab = gfsm_alphabet_get_label(key, &al);
-      if (encode_labels)
-	gfsm_automaton_add_arc(fsm, qid,qf, lab,lab, w0);
-      else
-	gfsm_automaton_add_arc(fsm, qid,qf, loFinal,lab, w0);
-      gfsm_automaton_set_final_state(fsm,qid,FALSE);
-    }
+  //-- encode arcs (in parallel)
+  gfsm_parallel_for(n_states, n_threads, 0, (gfsmParallelFunc)gfsm_encode_arcs_chunk_, &data);
+
+  //-- encode final weights
+  for (qid=0; qid < n_states; qid++) {
+    if (qid==data.qf || !gfsm_automaton_has_state(fsm,qid) || !gfsm_encode_final_key_(&data,qid,&k)) continue;
+    //-- special entry-type *:1/W for final weights
+    lab = gfsm_arckey_table_lookup_(&data.table, k);
+    if (encode_labels)
+      gfsm_automaton_add_arc(fsm, qid,data.qf, lab,lab, w0);
+    else
+      gfsm_automaton_add_arc(fsm, qid,data.qf, gfsmEpsilon,lab, w0);
+    gfsm_automaton_set_final_state(fsm,qid,FALSE);
   }
+  gfsm_arckey_table_clear_(&data.table);
 
   //-- set flags
   if (encode_labels) fsm->flags.is_transducer = FALSE;
@@ -184,31 +428,105 @@ gfsmArcLabelKey *gfsm_automaton_encode(gfsmAutomaton *fsm, gfsmArcLabelKey *key,
   return key;
 }
 
+//--------------------------------------------------------------
+static inline gfsmArcLabel *gfsm_decode_find_(gfsmEncodeData_ *data, gfsmLabelVal lab)
+{
+  return lab < data->n_labels ? data->labels2keys[lab] : NULL;
+}
+
+//--------------------------------------------------------------
+// + whether arc a from qid is an encoded final-weight transition
+static inline gboolean gfsm_decode_is_final_(gfsmEncodeData_ *data, const gfsmArc *a, const gfsmArcLabel *al)
+{
+  return al && data->weights && (al->hi==gfsmEncodeFinal || (a->target==data->qf && al->lo<=gfsmEncodeFinal && al->hi==gfsmEpsilon));
+}
+
+//--------------------------------------------------------------
+// + decodes an ordinary arc
+static inline void gfsm_decode_arc_(gfsmEncodeData_ *data, gfsmArc *a, const gfsmArcLabel *al)
+{
+  if (data->labels) {
+    //-- subtract 1 from non-epsilon labels to allow (*:1/W) keys to identify final weights
+    a->lower = !al || al->lo==0 ? 0 : (al->lo-1);
+  }
+  a->upper = !al || al->hi==0 ? 0 : (al->hi-1);
+  if (data->weights) {
+    a->weight = al ? al->w : gfsm_sr_one(data->fsm->sr);
+  }
+}
+
+//--------------------------------------------------------------
+// + gfsmParallelFunc: decodes states [begin,end) without final-weight transitions;
+//   other states are marked in data->deferred[]
+static
+void gfsm_decode_chunk_(guint begin, guint end, guint thread_id, gfsmEncodeData_ *data)
+{
+  gfsmStateId qid;
+
+  for (qid=begin; qid < end; qid++) {
+    gfsmState   *q = gfsm_automaton_find_state(data->fsm,qid);
+    gfsmArcList *al;
+    if (!q || !q->is_valid) continue;
+
+    if (data->weights) {
+      for (al=q->arcs; al != NULL; al=al->next) {
+	if (gfsm_decode_is_final_(data, &al->arc, gfsm_decode_find_(data, al->arc.upper))) break;
+      }
+      if (al != NULL) {
+	data->deferred[qid] = 1;
+	continue;
+      }
+    }
+
+    for (al=q->arcs; al != NULL; al=al->next) {
+      gfsm_decode_arc_(data, &al->arc, gfsm_decode_find_(data, al->arc.upper));
+      if (al->arc.target == data->qf) ++data->nfdummy[thread_id];
+    }
+  }
+}
+
 //--------------------------------------------------------------
 gfsmAutomaton *gfsm_automaton_decode(gfsmAutomaton *fsm, gfsmArcLabelKey *key, gboolean decode_labels, gboolean decode_weights)
 {
-  gfsmWeight   w0 = gfsm_sr_one(fsm->sr);
-  gfsmStateId qid, qf=gfsmNoState, nfdummy=0;
+  gfsmEncodeData_ data;
+  gfsmStateId qid, n_states, nfdummy=0;
+  guint       n_threads, i;
   gfsmArcIter ai;
 
+  gfsm_automaton_touch(fsm);
+  n_states     = gfsm_automaton_n_states(fsm);
+  data.fsm     = fsm;
+  data.labels  = decode_labels;
+  data.weights = decode_weights;
+  data.labels2keys = (gfsmArcLabel**)((gfsmPointerAlphabet*)key)->labels2keys->pdata;
+  data.n_labels    = ((gfsmPointerAlphabet*)key)->labels2keys->len;
+
   //-- decoding: attempt to find dummy final state
-  if (decode_weights && gfsm_automaton_n_states(fsm) > 0) {
-    qf = gfsm_automaton_n_states(fsm)-1;
-    if (!gfsm_automaton_state_is_final(fsm,qf) || gfsm_automaton_out_degree(fsm,qf)!=0)
-      qf=gfsmNoState;
+  data.qf = gfsmNoState;
+  if (decode_weights && n_states > 0) {
+    data.qf = n_states-1;
+    if (!gfsm_automaton_state_is_final(fsm,data.qf) || gfsm_automaton_out_degree(fsm,data.qf)!=0)
+      data.qf=gfsmNoState;
   }
 
-  //-- decoding guts
-  for (qid=0; qid < gfsm_automaton_n_states(fsm); qid++) {
-    if (!gfsm_automaton_has_state(fsm,qid)) continue;
+  //-- decode ordinary states (in parallel)
+  n_threads     = gfsm_threads_get_default();
+  data.deferred = g_new0(guint8, n_states);
+  data.nfdummy  = g_new0(guint, n_threads);
+  gfsm_parallel_for(n_states, n_threads, 0, (gfsmParallelFunc)gfsm_decode_chunk_, &data);
+  for (i=0; i < n_threads; i++) nfdummy += data.nfdummy[i];
+
+  //-- decode states with final-weight transitions
+  for (qid=0; qid < n_states; qid++) {
+    if (!data.deferred[qid]) continue;
 
     for (gfsm_arciter_open(&ai, fsm,qid); gfsm_arciter_ok(&ai); ) {
       gfsmArc       *a = gfsm_arciter_arc(&ai);
-      gfsmArcLabel *al = (gfsmArcLabel*)gfsm_alphabet_find_key(key, a->upper);
+      gfsmArcLabel *al = gfsm_decode_find_(&data, a->upper);
 
-      if (al && decode_weights && (al->hi==gfsmEncodeFinal || (a->target==qf && al->lo<=gfsmEncodeFinal && al->hi==gfsmEpsilon))) {
+      if (gfsm_decode_is_final_(&data,a,al)) {
 	//-- decode: encoded final-weight transition
-	if (a->target==qf || (gfsm_automaton_state_is_final(fsm,a->target) && gfsm_automaton_out_degree(fsm,a->target)==0)) {
+	if (a->target==data.qf || (gfsm_automaton_state_is_final(fsm,a->target) && gfsm_automaton_out_degree(fsm,a->target)==0)) {
 	  //-- decode into final weight and remove dummy arc
 	  gfsm_automaton_set_final_state_full(fsm,qid,TRUE, gfsm_sr_plus(fsm->sr, gfsm_automaton_get_final_weight(fsm,qid), al->w));
 	  gfsm_arciter_remove(&ai);
@@ -222,27 +540,22 @@ gfsmAutomaton *gfsm_automaton_decode(gfsmAutomaton *fsm, gfsmArcLabelKey *key, g
       }
       else {
 	//-- decode: arc
-	if (decode_labels) {
-	  //-- subtract 1 from non-epsilon labels to allow (*:1/W) keys to identify final weights
-	  a->lower = !al || al->lo==0 ? 0 : (al->lo-1);
-	}
-	a->upper = !al || al->hi==0 ? 0 : (al->hi-1);
-	if (decode_weights) {
-	  a->weight = al ? al->w : w0;
-	}
+	gfsm_decode_arc_(&data,a,al);
       }
 
       //-- track adjusted in-degree of "dummy" final-state
-      if (a->target == qf) ++nfdummy;
+      if (a->target == data.qf) ++nfdummy;
 
       //-- increment arc iterator
       gfsm_arciter_next(&ai);
     }
   }
+  g_free(data.deferred);
+  g_free(data.nfdummy);
 
   //-- implicitly remove dummy final state, if any
-  if (qf != gfsmNoState && nfdummy==0) {
-    gfsm_automaton_remove_state(fsm,qf);
+  if (data.qf != gfsmNoState && nfdummy==0) {
+    gfsm_automaton_remove_state(fsm,data.qf);
   }
 
   //-- set flags
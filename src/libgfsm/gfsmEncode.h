@@ -76,7 +76,9 @@ void gfsm_arclabel_free(gfsmArcLabel *al);
 /** Hash function alias for ::gfsmArcLabel */
 guint gfsm_arclabel_hash(gfsmArcLabel *al);
 
-/** Equal function alias for ::gfsmArcLabel */
+/** Equal function alias for ::gfsmArcLabel.
+ *  Weights are compared numerically (-0.0 equals +0.0), and all NaN weights are considered equal.
+ */
 guint gfsm_arclabel_equal(const gfsmArcLabel *al1, const gfsmArcLabel *al2);
 
 //@}
@@ -0,0 +1,86 @@
+/*=============================================================================*\
+ * File: gfsmHeap.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: indexed d-ary heaps
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmConfig.h>
+#include <gfsmHeap.h>
+
+//-- no-inline definitions
+#ifndef GFSM_INLINE_ENABLED
+# include <gfsmHeap.hi>
+#endif
+
+/*======================================================================
+ * Low-level
+ */
+
+/*--------------------------------------------------------------
+ * sift_up_()
+ */
+void gfsm_heap_sift_up_(gfsmHeap *h, guint i)
+{
+  guint       *heap = (guint*)h->heap->data;
+  guint       *pos  = (guint*)h->pos->data;
+  gfsmHeapKey *keys = (gfsmHeapKey*)h->keys->data;
+  guint        id   = heap[i];
+  gfsmHeapKey  key  = keys[id];
+
+  //-- move parents down until we find the slot for id
+  while (i > 0) {
+    guint parent = (i-1) / h->arity;
+    if (keys[heap[parent]] <= key) break;
+    heap[i]      = heap[parent];
+    pos[heap[i]] = i+1;
+    i            = parent;
+  }
+  heap[i] = id;
+  pos[id] = i+1;
+}
+
+/*--------------------------------------------------------------
+ * sift_down_()
+ */
+void gfsm_heap_sift_down_(gfsmHeap *h, guint i)
+{
+  guint       *heap = (guint*)h->heap->data;
+  guint       *pos  = (guint*)h->pos->data;
+  gfsmHeapKey *keys = (gfsmHeapKey*)h->keys->data;
+  guint        n    = h->heap->len;
+  guint        id   = heap[i];
+  gfsmHeapKey  key  = keys[id];
+
+  //-- move smallest children up until we find the slot for id
+  for (;;) {
+    guint first = i*h->arity + 1, last, c, best;
+    if (first >= n) break;
+    last = first + h->arity;
+    if (last > n) last = n;
+    for (best=first, c=first+1; c < last; c++) {
+      if (keys[heap[c]] < keys[heap[best]]) best = c;
+    }
+    if (key <= keys[heap[best]]) break;
+    heap[i]      = heap[best];
+    pos[heap[i]] = i+1;
+    i            = best;
+  }
+  heap[i] = id;
+  pos[id] = i+1;
+}
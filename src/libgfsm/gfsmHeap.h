@@ -0,0 +1,142 @@
+/*=============================================================================*\
+ * File: gfsmHeap.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: indexed d-ary heaps
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmHeap.h
+ *  \brief Indexed d-ary min-heaps over dense integer IDs
+ */
+
+#ifndef _GFSM_HEAP_H
+#define _GFSM_HEAP_H
+
+#include <gfsmMem.h>
+
+/*======================================================================
+ * Types
+ */
+/// priority type for ::gfsmHeap: smaller keys are popped first
+typedef gdouble gfsmHeapKey;
+
+/** Indexed d-ary min-heap.
+ *  Elements are dense integer IDs (e.g. state or arc indices), each associated
+ *  with a ::gfsmHeapKey.  Since the heap position of each ID is stored in a
+ *  flat array, lookup and key updates need no auxiliary hash table.
+ */
+typedef struct {
+  guint   arity;  ///< number of children per heap node (>= 2)
+  GArray *heap;   ///< heap-ordered element IDs (guint)
+  GArray *keys;   ///< [id] : current key of id (gfsmHeapKey)
+  GArray *pos;    ///< [id] : 1 + heap position of id, or 0 if id is not enqueued (guint)
+} gfsmHeap;
+
+/// returned by gfsm_heap_peek() and gfsm_heap_pop() for empty heaps
+#define gfsmHeapNone ((guint)-1)
+
+/// default arity for gfsm_heap_new()
+#define gfsmHeapDefaultArity 4
+
+/*======================================================================
+ * Constructors etc.
+ */
+///\name Constructors etc.
+//@{
+
+/** Create and return a new empty ::gfsmHeap.
+ *  \param arity number of children per node; 0 for ::gfsmHeapDefaultArity
+ */
+GFSM_INLINE
+gfsmHeap *gfsm_heap_new(guint arity);
+
+/** Remove all elements from \a h */
+GFSM_INLINE
+void gfsm_heap_clear(gfsmHeap *h);
+
+/** Destroy a ::gfsmHeap */
+GFSM_INLINE
+void gfsm_heap_free(gfsmHeap *h);
+
+//@}
+
+/*======================================================================
+ * Accessors
+ */
+///\name Accessors
+//@{
+
+/** Get number of elements currently enqueued in \a h */
+GFSM_INLINE
+guint gfsm_heap_size(gfsmHeap *h);
+
+/** Check whether \a h is empty */
+GFSM_INLINE
+gboolean gfsm_heap_isempty(gfsmHeap *h);
+
+/** Check whether \a id is currently enqueued in \a h */
+GFSM_INLINE
+gboolean gfsm_heap_contains(gfsmHeap *h, guint id);
+
+/** Get the current key of enqueued element \a id (undefined if \a id is not enqueued) */
+GFSM_INLINE
+gfsmHeapKey gfsm_heap_key(gfsmHeap *h, guint id);
+
+/** Get the ID with the smallest key in \a h without removing it, or ::gfsmHeapNone if \a h is empty */
+GFSM_INLINE
+guint gfsm_heap_peek(gfsmHeap *h);
+
+//@}
+
+/*======================================================================
+ * Manipulators
+ */
+///\name Manipulators
+//@{
+
+/** Enqueue \a id with key \a key, or update its key if it is already enqueued.
+ *  \returns TRUE if \a id was newly inserted, FALSE if its key was updated
+ */
+GFSM_INLINE
+gboolean gfsm_heap_push(gfsmHeap *h, guint id, gfsmHeapKey key);
+
+/** Enqueue \a id with key \a key, or lower its key to \a key if it is already
+ *  enqueued with a larger key.
+ *  \returns TRUE if \a h was changed
+ */
+GFSM_INLINE
+gboolean gfsm_heap_decrease(gfsmHeap *h, guint id, gfsmHeapKey key);
+
+/** Remove and return the ID with the smallest key in \a h, or ::gfsmHeapNone if \a h is empty */
+GFSM_INLINE
+guint gfsm_heap_pop(gfsmHeap *h);
+
+/** Low-level: restore heap order upwards from heap position \a i */
+void gfsm_heap_sift_up_(gfsmHeap *h, guint i);
+
+/** Low-level: restore heap order downwards from heap position \a i */
+void gfsm_heap_sift_down_(gfsmHeap *h, guint i);
+
+//@}
+
+//-- inline definitions
+#ifdef GFSM_INLINE_ENABLED
+# include <gfsmHeap.hi>
+#endif
+
+#endif /* _GFSM_HEAP_H */
@@ -68,6 +68,7 @@ void gfsmio_close_zfile(gzFile zf);
 void gfsmio_flush_zfile(gzFile zf);
 gboolean gfsmio_eof_zfile(gzFile zf);
 gboolean gfsmio_read_zfile(gzFile zf, void *buf, size_t nbytes);
+ssize_t gfsmio_getdelim_zfile(gzFile zf, char **lineptr, size_t *n, int delim);
 gboolean gfsmio_write_zfile(gzFile zf, const void *buf, size_t nbytes);
 #endif
 
@@ -77,6 +78,7 @@ gboolean gfsmio_write_zfile(gzFile zf, const void *buf, size_t nbytes);
 void gfsmio_close_gstring(gfsmPosGString *pgs);
 gboolean gfsmio_eof_gstring(gfsmPosGString *pgs);
 gboolean gfsmio_read_gstring(gfsmPosGString *pgs, void *buf, size_t nbytes);
+ssize_t gfsmio_getdelim_gstring(gfsmPosGString *pgs, char **lineptr, size_t *n, int delim);
 gboolean gfsmio_write_gstring(gfsmPosGString *pgs, const void *buf, size_t nbytes);
 
 /*======================================================================
@@ -113,7 +115,7 @@ gfsmIOHandle *gfsmio_handle_new(gfsmIOHandleType typ, void *handle_data)
   //--------------------------------
   case gfsmIOTZFile:
     ioh->read_func    = (gfsmIOReadFunc)gfsmio_read_zfile;
-    //ioh->getdelim_func= (gfsmIOReadFunc)gfsmio_getdelim_zfile;
+    ioh->getdelim_func= (gfsmIOGetdelimFunc)gfsmio_getdelim_zfile;
 
     ioh->write_func   = (gfsmIOWriteFunc)gfsmio_write_zfile;
     //ioh->vprintf_func = (gfsmIOReadFunc)gfsmio_vprintf_zfile;
@@ -127,7 +129,7 @@ gfsmIOHandle *gfsmio_handle_new(gfsmIOHandleType typ, void *handle_data)
   //--------------------------------
   case gfsmIOTGString:
     ioh->read_func    = (gfsmIOReadFunc)gfsmio_read_gstring;
-    //ioh->getdelim_func= gfsmio_getdelim_gstring;
+    ioh->getdelim_func= (gfsmIOGetdelimFunc)gfsmio_getdelim_gstring;
 
     ioh->write_func   = (gfsmIOWriteFunc)gfsmio_write_gstring;
     //ioh->vprintf_func = gfsmio_vprintf_gstring;
@@ -318,6 +320,47 @@ gboolean gfsmio_read(gfsmIOHandle *ioh, void *buf, size_t nbytes)
   return FALSE;
 }
 
+/*--------------------------------------------------------------*/
+size_t gfsmio_read_partial(gfsmIOHandle *ioh, void *buf, size_t nbytes)
+{
+  size_t n = 0;
+  int    c;
+  switch (ioh->iotype) {
+  case gfsmIOTCFile:
+#ifndef GFSM_ZLIB_ENABLED
+  case gfsmIOTZFile:
+#endif
+    return ioh->handle ? fread(buf, 1, nbytes, (FILE*)ioh->handle) : 0;
+
+#ifdef GFSM_ZLIB_ENABLED
+  case gfsmIOTZFile:
+    {
+      int rc;
+      if (!ioh->handle) return 0;
+      rc = gzread((gzFile)ioh->handle, buf, nbytes > G_MAXINT ? G_MAXINT : (unsigned)nbytes);
+      return rc > 0 ? (size_t)rc : 0;
+    }
+#endif
+
+  case gfsmIOTGString:
+    {
+      gfsmPosGString *pgs = (gfsmPosGString*)ioh->handle;
+      if (!pgs || !pgs->gs || pgs->pos >= pgs->gs->len) return 0;
+      n = pgs->gs->len - pgs->pos;
+      if (n > nbytes) n = nbytes;
+      memcpy(buf, pgs->gs->str + pgs->pos, n);
+      pgs->pos += n;
+      return n;
+    }
+
+  default:
+    //-- user handles: read() --> getc()
+    while (n < nbytes && (c = gfsmio_getc(ioh)) != GFSMIO_EOF)
+      ((char*)buf)[n++] = (char)c;
+    return n;
+  }
+}
+
 /*--------------------------------------------------------------*/
 ssize_t gfsmio_getline(gfsmIOHandle *ioh, char **lineptr, size_t *n)
 {
@@ -505,6 +548,41 @@ gboolean gfsmio_eof_zfile(gzFile zf)
 gboolean gfsmio_read_zfile(gzFile zf, void *buf, size_t nbytes)
 { return zf ? (gzread(zf,buf,nbytes)==(int)nbytes) : FALSE; }
 
+ssize_t gfsmio_getdelim_zfile(gzFile zf, char **lineptr, size_t *n, int delim)
+{
+  size_t len = 0;
+  int c;
+  if (!zf) return GFSMIO_EOF;
+  if (*lineptr==NULL || *n < 2) {
+    *n = 128;
+    *lineptr = (char*)realloc(*lineptr, *n);
+  }
+
+  if (delim=='\n') {
+    //-- newline-delimited: let zlib scan its own buffer with gzgets()
+    while (gzgets(zf, (*lineptr)+len, (int)(*n-len)) != NULL) {
+      len += strlen((*lineptr)+len);
+      if ((len > 0 && (*lineptr)[len-1]=='\n') || len+1 < *n) break;
+      //-- line longer than buffer: grow and continue
+      *n *= 2;
+      *lineptr = (char*)realloc(*lineptr, *n);
+    }
+  }
+  else {
+    while ( (c=gzgetc(zf)) != -1 ) {
+      if (len+1 >= *n) {
+	*n *= 2;
+	*lineptr = (char*)realloc(*lineptr, *n);
+      }
+      (*lineptr)[len++] = (char)c;
+      if ((char)c == (char)delim) break;
+    }
+  }
+
+  (*lineptr)[len] = '\0';
+  return len==0 ? GFSMIO_EOF : (ssize_t)len;
+}
+
 /*--------------------------------------------------------------
  * gzFile: Write Methods
  */
@@ -546,6 +624,26 @@ gboolean gfsmio_read_gstring(gfsmPosGString *pgs, void *buf, size_t nbytes)
   return FALSE;
 }
 
+ssize_t gfsmio_getdelim_gstring(gfsmPosGString *pgs, char **lineptr, size_t *n, int delim)
+{
+  const char *beg, *end;
+  size_t len;
+  if (!pgs || !pgs->gs || pgs->pos >= pgs->gs->len) return GFSMIO_EOF;
+
+  beg = pgs->gs->str + pgs->pos;
+  end = (const char*)memchr(beg, delim, pgs->gs->len - pgs->pos);
+  len = end ? (size_t)(end-beg)+1 : pgs->gs->len - pgs->pos;
+
+  if (*lineptr==NULL || *n < len+1) {
+    *n = len+1;
+    *lineptr = (char*)realloc(*lineptr, *n);
+  }
+  memcpy(*lineptr, beg, len);
+  (*lineptr)[len] = '\0';
+  pgs->pos += len;
+  return (ssize_t)len;
+}
+
 /*--------------------------------------------------------------
  * GString*: Write Methods
  */
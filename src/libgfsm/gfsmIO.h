@@ -176,6 +176,10 @@ int gfsmio_getc(gfsmIOHandle *ioh);
 /** read \a nbytes of data from \a io into \a buf, as \a fread() */
 gboolean gfsmio_read(gfsmIOHandle *ioh, void *buf, size_t nbytes);
 
+/** read up to \a nbytes of data from \a io into \a buf, as \a fread(buf,1,nbytes,f):
+ *  returns the number of bytes actually read, which is less than \a nbytes only at EOF or on error */
+size_t gfsmio_read_partial(gfsmIOHandle *ioh, void *buf, size_t nbytes);
+
 /** wrapper for getline(), returns number of bytes read (0 on error) */
 ssize_t gfsmio_getline(gfsmIOHandle *ioh, char **lineptr, size_t *n);
 
@@ -82,8 +82,9 @@ gfsmIndexedAutomaton *gfsm_automaton_to_indexed(gfsmAutomaton *fsm, gfsmIndexedA
   }
   gfsm_indexed_automaton_set_semiring(xfsm,fsm->sr); //-- copy semiring
 
-  //-- set root id
+  //-- set root id; cached gfsmAutomaton arc indices are not carried over
   xfsm->root_id = fsm->root_id;
+  xfsm->flags.is_indexed = 0;
 
   //-- index final weights
   gfsm_automaton_to_final_weight_vector(fsm, xfsm->state_final_weight);
@@ -27,6 +27,8 @@
 #include <gfsmEnum.h>
 #include <gfsmUtils.h>
 #include <gfsmCompound.h>
+#include <gfsmMatcher.h>
+#include <gfsmView.h>
 
 /*======================================================================
  * Methods: algebra: intersection
@@ -44,17 +46,34 @@ gfsmAutomaton *gfsm_automaton_intersect(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2
 }
 
 /*--------------------------------------------------------------
- * intersect_full()
+ * intersect_arc_table_index_()
+ *  + arcs of fsm sorted on (lower,upper): cached index, NULL if the arc lists
+ *    of fsm are already lower-sorted, or else a temporary sorted copy
  */
-gfsmAutomaton *gfsm_automaton_intersect_full(gfsmAutomaton *fsm1,
-					     gfsmAutomaton *fsm2,
-					     gfsmAutomaton *intersect,
-					     gfsmStatePairEnum *spenum)
+static
+gfsmArcTableIndex *gfsm_intersect_arc_table_index_(gfsmAutomaton *fsm)
+{
+  gfsmArcTableIndex *tabx = gfsm_automaton_lookup_arc_index(fsm,gfsmLSLower);
+  if (tabx || gfsm_acmask_nth(fsm->flags.sort_mode,0) == gfsmACLower) return tabx;
+  tabx = gfsm_automaton_to_arc_table_index(fsm,NULL);
+  gfsm_arc_table_index_sort_bymask(tabx, (gfsmACLower|(gfsmACUpper<<gfsmACShift)), NULL);
+  return tabx;
+}
+
+/*--------------------------------------------------------------
+ * intersect_view_full_()
+ *  + guts for intersect_full() and intersect_indexed_full(): fsm2 is only read, via view2
+ */
+static
+gfsmAutomaton *gfsm_automaton_intersect_view_full_(gfsmAutomaton *fsm1,
+						   gfsmAutomatonView *view2,
+						   gfsmAutomaton *intersect,
+						   gfsmStatePairEnum *spenum)
 {
   gboolean      spenum_is_temp;
   gfsmStatePair rootpair;
   gfsmStateId   rootid;
-  gfsmComposeFlags flags = 0;
+  gfsmArcTableIndex *tabx1, *tabx2;
 
   //-- setup: output fsm
   if (!intersect) {
@@ -76,14 +95,14 @@ gfsmAutomaton *gfsm_automaton_intersect_full(gfsmAutomaton *fsm1,
     gfsm_enum_clear(spenum);
   }
 
-  //-- setup: flags
-  if (gfsm_acmask_nth(fsm1->flags.sort_mode,0) != gfsmACLower) flags |= gfsmCFEfsm1NeedsArcSort;
-  if (gfsm_acmask_nth(fsm2->flags.sort_mode,0) != gfsmACLower) flags |= gfsmCFEfsm2NeedsArcSort;
+  //-- setup: sorted contiguous arc storage
+  tabx1 = gfsm_intersect_arc_table_index_(fsm1);
+  tabx2 = gfsm_view_lower_arc_table(view2, (gfsmACLower|(gfsmACUpper<<gfsmACShift)));
 
   //-- guts
   rootpair.id1 = fsm1->root_id;
-  rootpair.id2 = fsm2->root_id;
-  rootid = gfsm_automaton_intersect_visit_(rootpair, fsm1, fsm2, intersect, spenum,flags);
+  rootpair.id2 = view2->root_id;
+  rootid = gfsm_automaton_intersect_visit_(rootpair, fsm1, view2, intersect, spenum, tabx1, tabx2);
 
   //-- finalize: set root state
   if (rootid != gfsmNoState) {
@@ -94,35 +113,63 @@ gfsmAutomaton *gfsm_automaton_intersect_full(gfsmAutomaton *fsm1,
 
   //-- cleanup
   if (spenum_is_temp) gfsm_enum_free(spenum);
+  if (tabx1 && tabx1 != fsm1->index_lower) gfsm_arc_table_index_free(tabx1);
+  if (tabx2 && tabx2 != view2->index_lower) gfsm_arc_table_index_free(tabx2);
 
   return intersect;
 }
 
+/*--------------------------------------------------------------
+ * intersect_full()
+ */
+gfsmAutomaton *gfsm_automaton_intersect_full(gfsmAutomaton *fsm1,
+					     gfsmAutomaton *fsm2,
+					     gfsmAutomaton *intersect,
+					     gfsmStatePairEnum *spenum)
+{
+  gfsmAutomatonView view2;
+  return gfsm_automaton_intersect_view_full_(fsm1, gfsm_automaton_view(&view2,fsm2), intersect, spenum);
+}
+
+/*--------------------------------------------------------------
+ * intersect_indexed_full()
+ */
+gfsmAutomaton *gfsm_automaton_intersect_indexed_full(gfsmAutomaton *fsm1,
+						     gfsmIndexedAutomaton *xfsm2,
+						     gfsmAutomaton *intersect,
+						     gfsmStatePairEnum *spenum)
+{
+  gfsmAutomatonView view2;
+  return gfsm_automaton_intersect_view_full_(fsm1, gfsm_indexed_automaton_view(&view2,xfsm2), intersect, spenum);
+}
+
 /*--------------------------------------------------------------
  * intersect_visit()
  */
 gfsmStateId gfsm_automaton_intersect_visit_(gfsmStatePair sp,
 					    gfsmAutomaton *fsm1,
-					    gfsmAutomaton *fsm2,
+					    gfsmAutomatonView *view2,
 					    gfsmAutomaton *fsm,
 					    gfsmStatePairEnum *spenum,
-					    gfsmComposeFlags flags)
+					    gfsmArcTableIndex *tabx1,
+					    gfsmArcTableIndex *tabx2)
 {
-  gfsmState   *q1, *q2;
+  gfsmState   *q1;
   gfsmStateId qid = gfsm_enum_lookup(spenum,&sp);
   gfsmStateId qid2;
-  gfsmArcList *al1, *al2, *ai1, *ai2, *ai2eps;
-  gfsmArc     *a1,*a2;
+  gfsmWeight  fw2;
+  gfsmViewArcIter c1, c2, c1eps, c2eps, c2noneps, e1, e2, e1max, e2max;
+  gfsmArc     *a1, *a2;
+  gboolean    gallop1, gallop2;
 
   //-- ignore already-visited states
   if (qid != gfsmEnumNone) return qid;
 
-  //-- get state pointers for input automata
+  //-- get state pointer for fsm1
   q1 = gfsm_automaton_find_state(fsm1,sp.id1);
-  q2 = gfsm_automaton_find_state(fsm2,sp.id2);
 
   //-- sanity check
-  if ( !(q1 && q2 && q1->is_valid && q2->is_valid) ) return gfsmNoState;
+  if ( !(q1 && q1->is_valid && gfsm_view_has_state(view2,sp.id2)) ) return gfsmNoState;
 
   //-- insert new state into output automaton
   qid = gfsm_automaton_add_state(fsm);
@@ -130,90 +177,129 @@ gfsmStateId gfsm_automaton_intersect_visit_(gfsmStatePair sp,
   //q   = gfsm_automaton_get_state(fsm,qid);
 
   //-- check for final states
-  if (q1->is_final && q2->is_final) {
+  if (q1->is_final && gfsm_view_lookup_final(view2,sp.id2,&fw2)) {
     gfsm_automaton_set_final_state_full(fsm,qid,TRUE,
 					gfsm_sr_times(fsm->sr,
 						      gfsm_automaton_get_final_weight(fsm1,sp.id1),
-						      gfsm_automaton_get_final_weight(fsm2,sp.id2)));
+						      fw2));
   }
 
   //-------------------------------------------
   // recurse on outgoing arcs
 
+  //-- arcs: open iterators & split off (initial) epsilon arcs
+  //   + NULL tables: walk the (already sorted) arc lists of fsm1 and/or fsm2 directly
+  if (tabx1) gfsm_view_arciter_open_table(&c1, tabx1, sp.id1);
+  else       gfsm_view_arciter_open_arclist(&c1, q1->arcs);
+  if (tabx2) gfsm_view_arciter_open_table(&c2, tabx2, sp.id2);
+  else       gfsm_view_arciter_open(&c2, view2, sp.id2);
+  c1eps = c1;
+  c2eps = c2;
+  gfsm_view_arciter_seek_lower(&c1, gfsmEpsilon+1, FALSE);
+  gfsm_view_arciter_seek_lower(&c2, gfsmEpsilon+1, FALSE);
+  c2noneps = c2;
+
   //--------------------------------
-  // recurse: arcs: sort
+  // recurse: arcs: epsilon arcs on fsm1
+  for (e1=c1eps; e1.arc != c1.arc; gfsm_view_arciter_next(&e1)) {
+    a1 = e1.arc;
+    //-- eps: case fsm1:(q1 --eps-->  q1'), fsm2:(q2)
+    qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){a1->target,sp.id2},
+					   fsm1, view2, fsm, spenum, tabx1, tabx2);
+    if (qid2 != gfsmNoState)
+      gfsm_automaton_add_arc(fsm, qid, qid2, gfsmEpsilon, gfsmEpsilon, a1->weight);
 
-  //-- arcs: sort arclists: fsm1
-  if (flags&gfsmCFEfsm1NeedsArcSort) {
-    gfsmArcCompData sortdata = { (gfsmACLower|(gfsmACUpper<<gfsmACShift)),NULL,NULL,NULL };
-    al1 = gfsm_arclist_sort(gfsm_arclist_clone(q1->arcs), &sortdata);
+    //-- eps: case fsm1:(q1 --eps-->  q1'), fsm2:(q2 --eps-->  q2')
+    for (e2=c2eps; e2.arc != c2.arc; gfsm_view_arciter_next(&e2)) {
+      a2 = e2.arc;
+      qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){a1->target,a2->target},
+					     fsm1, view2, fsm, spenum, tabx1, tabx2);
+      if (qid2 != gfsmNoState)
+	gfsm_automaton_add_arc(fsm, qid, qid2, gfsmEpsilon, gfsmEpsilon,
+			       gfsm_sr_times(fsm1->sr, a1->weight, a2->weight));
+    }
   }
-  else { al1 = q1->arcs; }
 
-  //-- arcs: sort arclists: fsm2
-  if (flags&gfsmCFEfsm2NeedsArcSort) {
-    gfsmArcCompData sortdata = { (gfsmACLower|(gfsmACUpper<<gfsmACShift)),NULL,NULL,NULL };
-    al2 = gfsm_arclist_sort(gfsm_arclist_clone(q2->arcs), &sortdata);
+  //--------------------------------
+  // recurse: arcs: non-epsilon arcs: implicit (sigma,rho,phi) arcs on fsm2: match each run of fsm1 labels separately
+  if (gfsm_view_arciter_has_implicit(&c2)) {
+    GArray *matches = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+    guint   mi;
+    while (gfsm_view_arciter_ok(&c1)) {
+      gfsmLabelVal lab = c1.arc->lower;
+      for (e1max=c1; e1max.arc && e1max.arc->lower==lab; gfsm_view_arciter_next(&e1max)) ;
+      g_array_set_size(matches,0);
+      if (tabx2) gfsm_matcher_match_table(tabx2, fsm->sr, sp.id2, lab, matches);
+      else       gfsm_view_match(view2, sp.id2, lab, matches);
+      for (e1=c1; e1.arc != e1max.arc; gfsm_view_arciter_next(&e1)) {
+	a1 = e1.arc;
+	for (mi=0; mi < matches->len; mi++) {
+	  gfsmArcMatch *m = &g_array_index(matches,gfsmArcMatch,mi);
+	  qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){a1->target,m->target},
+						 fsm1, view2, fsm, spenum, tabx1, tabx2);
+	  if (qid2 != gfsmNoState)
+	    gfsm_automaton_add_arc(fsm, qid, qid2, lab, lab,
+				   gfsm_sr_times(fsm1->sr, a1->weight, m->weight));
+	}
+      }
+      c1 = e1max;
+    }
+    g_array_free(matches,TRUE);
   }
-  else { al2 = q2->arcs; }
 
   //--------------------------------
-  // recurse: arcs: iterate
-  for (ai1=al1, ai2=al2; ai1 != NULL; ai1=ai1->next) {
-    a1 = &(ai1->arc);
-    if (a1->lower == gfsmEpsilon) {
-      //-- handle epsilon arcs
-
-      //-- eps: case fsm1:(q1 --eps-->  q1'), fsm2:(q2)
-      qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){a1->target,sp.id2},
-						fsm1, fsm2, fsm, spenum, flags);
-      if (qid2 != gfsmNoState)
-	gfsm_automaton_add_arc(fsm, qid, qid2, gfsmEpsilon, gfsmEpsilon, a1->weight);
-
-      //-- eps: case fsm1:(q1 --eps-->  q1'), fsm2:(q2 --eps-->  q2')
-      for (ai2eps=al2; ai2eps != NULL; ai2eps=ai2eps->next) {
-	a2 = &(ai2eps->arc);
-	if (a2->lower != gfsmEpsilon) break;
+  // recurse: arcs: non-epsilon arcs: sort-merge join on lower label
+  //  + gallop through a contiguous side if it is much larger than the other side;
+  //    arc lists on the other side are only counted as far as that comparison needs
+  gallop1 = gallop2 = FALSE;
+  if (tabx1 || tabx2) {
+    guint n1 = tabx1 ? gfsm_view_arciter_size(&c1) : 0;
+    guint n2 = tabx2 ? gfsm_view_arciter_size(&c2) : 0;
+    if (!tabx1) n1 = gfsm_view_arciter_size_max(&c1, n2/gfsmArcRangeGallopRatio + 1);
+    if (!tabx2) n2 = gfsm_view_arciter_size_max(&c2, n1/gfsmArcRangeGallopRatio + 1);
+    gallop1 = tabx1 && n1 > gfsmArcRangeGallopRatio * n2;
+    gallop2 = tabx2 && n2 > gfsmArcRangeGallopRatio * n1;
+  }
+  while (gfsm_view_arciter_ok(&c1) && gfsm_view_arciter_ok(&c2)) {
+    gfsmLabelVal lab = c1.arc->lower;
 
-	qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){a1->target,a2->target},
-						  fsm1, fsm2, fsm, spenum, flags);
-	if (qid2 != gfsmNoState)
-	  gfsm_automaton_add_arc(fsm, qid, qid2, gfsmEpsilon, gfsmEpsilon,
-				 gfsm_sr_times(fsm1->sr, a1->weight, a2->weight));
-      }
+    if (c2.arc->lower < lab) {
+      gfsm_view_arciter_seek_lower(&c2, lab, gallop2);
+      continue;
+    }
+    else if (c2.arc->lower > lab) {
+      gfsm_view_arciter_seek_lower(&c1, c2.arc->lower, gallop1);
+      continue;
     }
-    else {
-      //-- handle non-epsilon arcs
-      for ( ; ai2 != NULL; ai2=ai2->next) {
-	a2 = &(ai2->arc);
-
-	if      (a2->lower < a1->lower) continue;
-	else if (a2->lower > a1->lower) break;
 
+    //-- matching runs: (a1 in c1..e1max) x (a2 in c2..e2max)
+    for (e1max=c1; e1max.arc && e1max.arc->lower==lab; gfsm_view_arciter_next(&e1max)) ;
+    for (e2max=c2; e2max.arc && e2max.arc->lower==lab; gfsm_view_arciter_next(&e2max)) ;
+    for (e1=c1; e1.arc != e1max.arc; gfsm_view_arciter_next(&e1)) {
+      a1 = e1.arc;
+      for (e2=c2; e2.arc != e2max.arc; gfsm_view_arciter_next(&e2)) {
+	a2 = e2.arc;
 	qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){a1->target,a2->target},
-						  fsm1, fsm2, fsm, spenum, flags);
+					       fsm1, view2, fsm, spenum, tabx1, tabx2);
 	if (qid2 != gfsmNoState)
-	  gfsm_automaton_add_arc(fsm, qid, qid2, a1->lower, a1->lower,
+	  gfsm_automaton_add_arc(fsm, qid, qid2, lab, lab,
 				 gfsm_sr_times(fsm1->sr, a1->weight, a2->weight));
       }
     }
+    c1 = e1max;
+    c2 = e2max;
   }
 
-  //-- handle epsilon-arcs on fsm2
-  for (ai2=al2 ; ai2 != NULL; ai2=ai2->next) {
-    a2 = &(ai2->arc);
-    if (a2->lower != gfsmEpsilon) break;
-
+  //--------------------------------
+  // recurse: arcs: epsilon arcs on fsm2
+  for (e2=c2eps; e2.arc != c2noneps.arc; gfsm_view_arciter_next(&e2)) {
+    a2 = e2.arc;
     //-- eps: case fsm1:(q1), fsm2:(q2 --eps-->  q2')
     qid2 = gfsm_automaton_intersect_visit_((gfsmStatePair){sp.id1,a2->target},
-					   fsm1, fsm2, fsm, spenum, flags);
+					   fsm1, view2, fsm, spenum, tabx1, tabx2);
     if (qid2 != gfsmNoState)
       gfsm_automaton_add_arc(fsm, qid, qid2, gfsmEpsilon, gfsmEpsilon, a2->weight);
   }
 
-  //-- cleanup
-  if (flags&gfsmCFEfsm1NeedsArcSort) gfsm_arclist_free(al1);
-  if (flags&gfsmCFEfsm2NeedsArcSort) gfsm_arclist_free(al2);
-
   return qid;
 }
@@ -27,6 +27,11 @@
 #include <gfsmState.h>
 #include <gfsmArc.h>
 #include <gfsmArcIter.h>
+#include <gfsmMatcher.h>
+#include <gfsmArcIndex.h>
+#include <gfsmCompound.h>
+#include <gfsmAlgebra.h>
+#include <gfsmView.h>
 
 #include <string.h>
 
@@ -46,39 +51,168 @@
 const gfsmStateId gfsmLookupStateMapGet = 16;
 const gfsmStateId gfsmLookupMaxResultStates = 16384;
 
+/*======================================================================
+ * Utilities
+ */
+
+/// transducer access for lookup & viterbi: a vanilla or indexed automaton (via a view) or a packed automaton
+typedef struct {
+  gfsmAutomatonView    view;  ///< view of vanilla or indexed transducer (unused if \a pfst is non-NULL)
+  gfsmPackedAutomaton *pfst;  ///< packed transducer, or NULL
+  gfsmSemiring        *sr;    ///< transducer semiring
+  gfsmStateId          root;  ///< transducer root state
+} gfsmLookupSource;
+
+//--------------------------------------------------------------
+// source_init_(): initialize src for vanilla fst, indexed xfst, or packed pfst (exactly one should be non-NULL)
+static inline
+void gfsm_lookup_source_init_(gfsmLookupSource *src, gfsmAutomaton *fst, gfsmIndexedAutomaton *xfst, gfsmPackedAutomaton *pfst)
+{
+  src->pfst = pfst;
+  if (pfst) {
+    src->sr   = pfst->sr;
+    src->root = pfst->root_id;
+    return;
+  }
+  if (fst) gfsm_automaton_view(&src->view, fst);
+  else     gfsm_indexed_automaton_view(&src->view, xfst);
+  src->sr   = src->view.sr;
+  src->root = src->view.root_id;
+}
+
+//--------------------------------------------------------------
+// final_(): check whether qid is final, and if so get its final weight
+static inline
+gboolean gfsm_lookup_final_(gfsmLookupSource *src, gfsmStateId qid, gfsmWeight *wp)
+{
+  if (src->pfst) {
+    *wp = gfsm_packed_automaton_get_final_weight(src->pfst,qid);
+    return gfsm_packed_automaton_state_is_final(src->pfst,qid);
+  }
+  return gfsm_view_lookup_final(&src->view,qid,wp);
+}
+
+//--------------------------------------------------------------
+// epsilons_(): append all lower-epsilon arcs from qid to eps (a GArray of gfsmArcMatch)
+static inline
+void gfsm_lookup_epsilons_(gfsmLookupSource *src, gfsmStateId qid, GArray *eps)
+{
+  gfsmArcMatch m;
+  g_array_set_size(eps,0);
+
+  if (src->pfst) {
+    guint i, imax;
+    if (!gfsm_packed_automaton_has_state(src->pfst,qid)) return;
+    imax = gfsm_packed_automaton_state_first(src->pfst,qid+1);
+    for (i=gfsm_packed_automaton_seek_lower(src->pfst,qid,gfsmEpsilon);
+	 i < imax && gfsm_packed_arc_lower(src->pfst,i) == gfsmEpsilon;
+	 i++)
+      {
+	m.target = gfsm_packed_arc_target(src->pfst,i);
+	m.upper  = gfsm_packed_arc_upper(src->pfst,i);
+	m.weight = gfsm_packed_arc_weight(src->pfst,i);
+	g_array_append_val(eps,m);
+      }
+  }
+  else {
+    gfsmViewArcIter vai;
+    for (gfsm_view_arciter_open(&vai,&src->view,qid); gfsm_view_arciter_ok(&vai); gfsm_view_arciter_next(&vai)) {
+      gfsmArc *arc = gfsm_view_arciter_arc(&vai);
+      if (arc->lower != gfsmEpsilon) continue;
+      m.target = arc->target;
+      m.upper  = arc->upper;
+      m.weight = arc->weight;
+      g_array_append_val(eps,m);
+    }
+    gfsm_view_arciter_close(&vai);
+  }
+}
+
+//--------------------------------------------------------------
+// match_(): match a against (possibly implicit) arcs from qid, using a lower-label arc index if available
+static inline
+guint gfsm_lookup_match_(gfsmLookupSource *src, gfsmStateId qid, gfsmLabelVal a, GArray *matches)
+{
+  if (src->pfst) return gfsm_matcher_match_packed(src->pfst, qid, a, matches);
+  return gfsm_view_match(&src->view, qid, a, matches);
+}
+
+//--------------------------------------------------------------
+// lookup_result_new_(): create a new empty result automaton with given flags & semiring, like gfsm_automaton_shadow()
+static
+gfsmAutomaton *gfsm_lookup_result_new_(gfsmAutomatonFlags flags, gfsmSemiring *sr)
+{
+  gfsmAutomaton *fsm = gfsm_automaton_new_full(flags, sr->type, gfsmAutomatonDefaultSize);
+  if (sr->type == gfsmSRTUser) gfsm_automaton_set_semiring(fsm, sr);
+  return fsm;
+}
+
+//--------------------------------------------------------------
+// push_(): get result state for configuration (qt,i), pushing a new configuration onto *stackp if required.
+//  + if memo is non-NULL, configurations are shared: an existing result state for (qt,i) is returned as-is
+static inline
+gfsmStateId gfsm_lookup_push_(gfsmAutomaton     *result,
+			      gfsmStatePairEnum *memo,
+			      GSList           **stackp,
+			      gfsmStateId        qt,
+			      guint32            i)
+{
+  gfsmStatePair     sp = {qt,i};
+  gfsmLookupConfig *cfg;
+
+  if (memo) {
+    gfsmStateId qr = gfsm_enum_lookup(memo,&sp);
+    if (qr != gfsmEnumNone) return qr;
+  }
+
+  cfg     = (gfsmLookupConfig*)gfsm_slice_new(gfsmLookupConfig);
+  cfg->qt = qt;
+  cfg->qr = gfsm_automaton_add_state(result);
+  cfg->i  = i;
+  if (memo) gfsm_enum_insert_full(memo,&sp,cfg->qr);
+  *stackp = g_slist_prepend(*stackp, cfg);
+  _debug(printf("PUSH\t\t{qt=%u,qr=%u,i=%u}\n", cfg->qt,cfg->qr,cfg->i);)
+
+  return cfg->qr;
+}
+
+//-- forward decl
+static
+void gfsm_viterbi_expand_column_(gfsmLookupSource     *src,
+				 gfsmAutomaton        *trellis,
+				 gfsmViterbiColumn    *col,
+				 gfsmStateIdVector    *trellis2fst,
+				 gfsmViterbiMap       *fst2trellis,
+				 GArray               *eps);
+
 /*======================================================================
  * Methods: lookup
  */
 
 //--------------------------------------------------------------
-gfsmAutomaton *gfsm_automaton_lookup_full(gfsmAutomaton     *fst,
-					  gfsmLabelVector   *input,
-					  gfsmAutomaton     *result,
-					  gfsmStateIdVector *statemap,
-					  gfsmStateId	     max_result_states
-					  )
+// lookup_full_(): guts for gfsm_automaton_lookup_full(), gfsm_indexed_lookup_full(), gfsm_packed_lookup_full() & lattice variants; result must be clear
+//  + if memo is non-NULL, each (qt,i) configuration gets a single result state (lattice mode)
+static
+gfsmAutomaton *gfsm_lookup_full_(gfsmLookupSource  *src,
+				 gfsmLabelVector   *input,
+				 gfsmAutomaton     *result,
+				 gfsmStateIdVector *statemap,
+				 gfsmStateId        max_result_states,
+				 gfsmStatePairEnum *memo)
 {
   GSList           *stack = NULL;
-  gfsmLookupConfig *cfg   = (gfsmLookupConfig*)gfsm_slice_new(gfsmLookupConfig);
-  gfsmLookupConfig *cfg_new;
-  const gfsmState  *qt;
+  gfsmLookupConfig *cfg;
+  gfsmStateId       qr_new;
   gfsmLabelVal      a;
-  gfsmArcIter       ai;
+  gfsmWeight        fw;
+  GArray           *matches = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+  GArray           *eps     = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+  guint             mi;
 
-  //-- ensure result automaton exists and is clear
-  if (result==NULL) {
-    result = gfsm_automaton_shadow(fst);
-  } else {
-    gfsm_automaton_clear(result);
-  }
   result->flags.is_transducer = TRUE;
 
   //-- initialization
-  result->root_id = gfsm_automaton_add_state(result);
-  cfg->qt = fst->root_id;
-  cfg->qr = result->root_id;
-  cfg->i  = 0;
-  stack = g_slist_prepend(stack, cfg);
+  result->root_id = gfsm_lookup_push_(result, memo, &stack, src->root, 0);
 
   //-- ye olde loope
   while (stack != NULL) {
@@ -96,47 +230,35 @@ gfsmAutomaton *gfsm_automaton_lookup_full(gfsmAutomaton     *fst,
       g_ptr_array_index(statemap, cfg->qr) = GUINT_TO_POINTER(cfg->qt);
     }
 
-    //-- get states
-    qt = gfsm_automaton_find_state_const(fst,    cfg->qt);
-    /*qr =*/gfsm_automaton_find_state           (result, cfg->qr);
+    //-- get input label
     a  = (cfg->i < input->len
 	  ? (gfsmLabelVal)GPOINTER_TO_UINT(g_ptr_array_index(input, cfg->i))
 	  : gfsmNoLabel);
 
     //-- check for final states
-    if (cfg->i >= input->len && gfsm_state_is_final(qt)) {
+    if (cfg->i >= input->len && gfsm_lookup_final_(src, cfg->qt, &fw)) {
       _debug(printf("FINAL\t\t{qt=%u,qr=%u,i=%u}\n", cfg->qt,cfg->qr,cfg->i);)
-      gfsm_automaton_set_final_state_full(result, cfg->qr, TRUE,
-					  gfsm_automaton_get_final_weight(fst, cfg->qt));
+      gfsm_automaton_set_final_state_full(result, cfg->qr, TRUE, fw);
     }
 
-    //-- handle outgoing arcs
-    for (gfsm_arciter_open_ptr(&ai, fst, (gfsmState*)qt); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai))
-      {
-	gfsmArc *arc = gfsm_arciter_arc(&ai);
-	cfg_new = NULL;
-
-	//-- epsilon arcs
-	if (arc->lower == gfsmEpsilon) {
-	  cfg_new = (gfsmLookupConfig*)gfsm_slice_new(gfsmLookupConfig);
-	  cfg_new->qt = arc->target;
-	  cfg_new->qr = gfsm_automaton_add_state(result);
-	  cfg_new->i  = cfg->i;
-	  gfsm_automaton_add_arc(result, cfg->qr, cfg_new->qr, arc->lower, arc->upper, arc->weight);
-	  stack = g_slist_prepend(stack, cfg_new);
-	  _debug(printf("PUSH\t[%u:%u]\t{qt=%u,qr=%u,i=%u}\n", arc->lower,arc->upper, cfg_new->qt,cfg_new->qr,cfg_new->i);)
-	}
-	//-- input-matching arcs
-	else if (a != gfsmNoLabel && arc->lower == a) {
-	  cfg_new = (gfsmLookupConfig*)gfsm_slice_new(gfsmLookupConfig);
-	  cfg_new->qt = arc->target;
-	  cfg_new->qr = gfsm_automaton_add_state(result);
-	  cfg_new->i  = cfg->i+1;
-	  gfsm_automaton_add_arc(result, cfg->qr, cfg_new->qr, arc->lower, arc->upper, arc->weight);
-	  stack = g_slist_prepend(stack, cfg_new);
-	  _debug(printf("PUSH\t[%u:%u]\t{qt=%u,qr=%u,i=%u}\n", arc->lower,arc->upper, cfg_new->qt,cfg_new->qr,cfg_new->i);)
-	}
+    //-- handle outgoing arcs: epsilon arcs
+    gfsm_lookup_epsilons_(src, cfg->qt, eps);
+    for (mi=0; mi < eps->len; mi++) {
+      gfsmArcMatch *m = &g_array_index(eps,gfsmArcMatch,mi);
+      qr_new = gfsm_lookup_push_(result, memo, &stack, m->target, cfg->i);
+      gfsm_automaton_add_arc(result, cfg->qr, qr_new, gfsmEpsilon, m->upper, m->weight);
+    }
+
+    //-- handle outgoing arcs: input-matching (possibly implicit) arcs
+    if (a != gfsmNoLabel && a != gfsmEpsilon) {
+      g_array_set_size(matches,0);
+      gfsm_lookup_match_(src, cfg->qt, a, matches);
+      for (mi=0; mi < matches->len; mi++) {
+	gfsmArcMatch *m = &g_array_index(matches,gfsmArcMatch,mi);
+	qr_new = gfsm_lookup_push_(result, memo, &stack, m->target, cfg->i+1);
+	gfsm_automaton_add_arc(result, cfg->qr, qr_new, a, m->upper, m->weight);
       }
+    }
 
     //-- we're done with this config
     _debug(printf("FREE\t\t{qt=%u,qr=%u,i=%u}\n", cfg->qt,cfg->qr,cfg->i);)
@@ -158,21 +280,174 @@ gfsmAutomaton *gfsm_automaton_lookup_full(gfsmAutomaton     *fst,
 
   //-- set final size of the state-map
   if (statemap) { statemap->len = result->states->len; }
-  
+  g_array_free(matches,TRUE);
+  g_array_free(eps,TRUE);
+
   return result;
 }
 
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_automaton_lookup_full(gfsmAutomaton     *fst,
+					  gfsmLabelVector   *input,
+					  gfsmAutomaton     *result,
+					  gfsmStateIdVector *statemap,
+					  gfsmStateId	     max_result_states
+					  )
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, fst, NULL, NULL);
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_automaton_shadow(fst);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+
+  return gfsm_lookup_full_(&src, input, result, statemap, max_result_states, NULL);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_packed_lookup_full(gfsmPackedAutomaton *pfst,
+				       gfsmLabelVector     *input,
+				       gfsmAutomaton       *result,
+				       gfsmStateIdVector   *statemap,
+				       gfsmStateId          max_result_states)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, NULL, NULL, pfst);
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_lookup_result_new_(pfst->flags, pfst->sr);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+
+  return gfsm_lookup_full_(&src, input, result, statemap, max_result_states, NULL);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_indexed_lookup_full(gfsmIndexedAutomaton *xfst,
+					gfsmLabelVector      *input,
+					gfsmAutomaton        *result,
+					gfsmStateIdVector    *statemap,
+					gfsmStateId           max_result_states)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, NULL, xfst, NULL);
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_lookup_result_new_(xfst->flags, xfst->sr);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+
+  return gfsm_lookup_full_(&src, input, result, statemap, max_result_states, NULL);
+}
 
 /*======================================================================
- * Methods: Viterbi
+ * Methods: lookup lattice
  */
 
+//--------------------------------------------------------------
+// lookup_lattice_full_(): guts for gfsm_automaton_lookup_lattice_full(), gfsm_indexed_lookup_lattice_full() and gfsm_packed_lookup_lattice_full()
+static
+gfsmAutomaton *gfsm_lookup_lattice_full_(gfsmLookupSource  *src,
+					 gfsmLabelVector   *input,
+					 gfsmAutomaton     *result,
+					 gfsmStateIdVector *statemap,
+					 gfsmStateId        max_result_states,
+					 gboolean           connect)
+{
+  gfsmStatePairEnum *memo = gfsm_statepair_enum_new();
+
+  gfsm_lookup_full_(src, input, result, statemap, max_result_states, memo);
+  gfsm_statepair_enum_free(memo);
+
+  //-- prune non-coaccessible states (all result states are accessible by construction)
+  if (connect) gfsm_automaton_connect_bw(result, NULL, NULL);
+
+  return result;
+}
 
 //--------------------------------------------------------------
-gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
+gfsmAutomaton *gfsm_automaton_lookup_lattice_full(gfsmAutomaton     *fst,
 						  gfsmLabelVector   *input,
-						  gfsmAutomaton     *trellis,
-						  gfsmStateIdVector *trellis2fst)
+						  gfsmAutomaton     *result,
+						  gfsmStateIdVector *statemap,
+						  gfsmStateId        max_result_states,
+						  gboolean           connect)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, fst, NULL, NULL);
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_automaton_shadow(fst);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+
+  return gfsm_lookup_lattice_full_(&src, input, result, statemap, max_result_states, connect);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_packed_lookup_lattice_full(gfsmPackedAutomaton *pfst,
+					       gfsmLabelVector     *input,
+					       gfsmAutomaton       *result,
+					       gfsmStateIdVector   *statemap,
+					       gfsmStateId          max_result_states,
+					       gboolean             connect)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, NULL, NULL, pfst);
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_lookup_result_new_(pfst->flags, pfst->sr);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+
+  return gfsm_lookup_lattice_full_(&src, input, result, statemap, max_result_states, connect);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_indexed_lookup_lattice_full(gfsmIndexedAutomaton *xfst,
+						gfsmLabelVector      *input,
+						gfsmAutomaton        *result,
+						gfsmStateIdVector    *statemap,
+						gfsmStateId           max_result_states,
+						gboolean              connect)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, NULL, xfst, NULL);
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_lookup_result_new_(xfst->flags, xfst->sr);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+
+  return gfsm_lookup_lattice_full_(&src, input, result, statemap, max_result_states, connect);
+}
+
+
+/*======================================================================
+ * Methods: Viterbi
+ */
+
+
+//--------------------------------------------------------------
+// lookup_viterbi_full_(): guts for gfsm_automaton_lookup_viterbi_full(), gfsm_indexed_lookup_viterbi_full() and gfsm_packed_lookup_viterbi_full(); trellis must be clear
+static
+gfsmAutomaton *gfsm_lookup_viterbi_full_(gfsmLookupSource  *src,
+					 gfsmLabelVector   *input,
+					 gfsmAutomaton     *trellis,
+					 gfsmStateIdVector *trellis2fst)
 {
   //-- cols: array of (GSList <gfsmViterbiConfig*> *)
   gfsmViterbiTable *cols = g_ptr_array_sized_new(input->len+1);
@@ -182,16 +457,12 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
   gboolean          trellis2fst_is_tmp = FALSE;
   gfsmStateId       qid_trellis, qid_trellis_nxt, qid_fst;
   gpointer          ptr_qid_trellis_nxt;
-  gfsmState        *q_trellis, *q_trellis_nxt, *q_fst;
-  gfsmArcIter       ai;
-  gfsmWeight        w_trellis;
+  gfsmState        *q_trellis, *q_trellis_nxt;
+  GArray           *matches = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+  GArray           *eps     = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+  guint             mi;
+  gfsmWeight        w_trellis, fw;
 
-  //-- ensure trellis automaton exists and is clear
-  if (trellis==NULL) {
-    trellis = gfsm_automaton_shadow(fst);
-  } else {
-    gfsm_automaton_clear(trellis);
-  }
   trellis->flags.is_transducer = TRUE;
 
   //-- ensure trellis->fst stateid-map exists and is clear
@@ -205,16 +476,16 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
   //-- initial config: trellis structure
   qid_trellis = trellis->root_id = gfsm_automaton_add_state(trellis);
   q_trellis = gfsm_automaton_find_state(trellis, qid_trellis);
-  gfsm_automaton_set_final_state_full(trellis, qid_trellis, TRUE, fst->sr->one);
-  gfsm_automaton_add_arc(trellis, qid_trellis, qid_trellis, gfsmNoLabel, gfsmNoLabel, fst->sr->one);
+  gfsm_automaton_set_final_state_full(trellis, qid_trellis, TRUE, src->sr->one);
+  gfsm_automaton_add_arc(trellis, qid_trellis, qid_trellis, gfsmNoLabel, gfsmNoLabel, src->sr->one);
 
   //-- initial config: stateid-mappings
-  g_ptr_array_index(trellis2fst, qid_trellis) = GUINT_TO_POINTER(fst->root_id);
-  g_tree_insert(fst2trellis, GUINT_TO_POINTER(fst->root_id), GUINT_TO_POINTER(qid_trellis));
+  g_ptr_array_index(trellis2fst, qid_trellis) = GUINT_TO_POINTER(src->root);
+  g_tree_insert(fst2trellis, GUINT_TO_POINTER(src->root), GUINT_TO_POINTER(qid_trellis));
 
   //-- initial config: epsilon-expansion on column
   g_ptr_array_index(cols,0) = col = g_slist_prepend(NULL, GUINT_TO_POINTER(qid_trellis));
-  _gfsm_viterbi_expand_column(fst, trellis, col, trellis2fst, fst2trellis);
+  gfsm_viterbi_expand_column_(src, trellis, col, trellis2fst, fst2trellis, eps);
 
   //-- initial config: cleanup
   gfsm_viterbi_map_free(fst2trellis);
@@ -236,18 +507,17 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
 
       //-- get state pointers
       q_trellis = gfsm_automaton_find_state(trellis, qid_trellis);
-      q_fst     = gfsm_automaton_find_state(fst,     qid_fst);
 
       //-- get Viterbi properties
       w_trellis = gfsm_viterbi_node_best_weight(q_trellis);
 
 
-      //-- search for input-matching arcs & add them to the successor map for next column
-      for (gfsm_arciter_open_ptr(&ai, fst, q_fst), gfsm_arciter_seek_lower(&ai,a);
-	   gfsm_arciter_ok(&ai);
-	   gfsm_arciter_next(&ai), gfsm_arciter_seek_lower(&ai,a))
+      //-- search for input-matching (possibly implicit) arcs & add them to the successor map for next column
+      g_array_set_size(matches,0);
+      gfsm_lookup_match_(src, qid_fst, a, matches);
+      for (mi=0; mi < matches->len; mi++)
 	{
-	  gfsmArc     *arc_fst         = gfsm_arciter_arc(&ai);
+	  gfsmArcMatch *arc_fst        = &g_array_index(matches,gfsmArcMatch,mi);
 	  gfsmWeight   w_trellis_nxt;
 	  gpointer     orig_key;
 
@@ -258,13 +528,13 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
 				     &ptr_qid_trellis_nxt))
 	    {
 	      //-- yep: known successor: get old ("*_nxt") & new ("*_nxt_new") weights
-	      gfsmWeight w_trellis_nxt_new = gfsm_sr_times(fst->sr, w_trellis, arc_fst->weight);
+	      gfsmWeight w_trellis_nxt_new = gfsm_sr_times(src->sr, w_trellis, arc_fst->weight);
 	      qid_trellis_nxt = GPOINTER_TO_UINT(ptr_qid_trellis_nxt);
 	      q_trellis_nxt   = gfsm_automaton_find_state(trellis, qid_trellis_nxt);
 	      w_trellis_nxt   = gfsm_viterbi_node_best_weight(q_trellis_nxt);
 
 	      //-- is the new path better than the stored path?
-	      if (gfsm_sr_less(fst->sr, w_trellis_nxt_new, w_trellis_nxt)) {
+	      if (gfsm_sr_less(src->sr, w_trellis_nxt_new, w_trellis_nxt)) {
 		//-- yep: update mappings: trellis automaton
 		gfsmArc *arc_trellis_nxt = gfsm_viterbi_node_arc(q_trellis_nxt);
 		arc_trellis_nxt->target  = qid_trellis;
@@ -287,7 +557,7 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
 	    gfsm_automaton_add_arc(trellis,
 				   qid_trellis_nxt, qid_trellis,
 				   a,               arc_fst->upper,
-				   gfsm_sr_times(fst->sr, w_trellis, arc_fst->weight));
+				   gfsm_sr_times(src->sr, w_trellis, arc_fst->weight));
 
 	    //-- save trellis->fst stateid-map
 	    if (qid_trellis_nxt >= trellis2fst->len) {
@@ -306,7 +576,7 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
     } //-- END: previous column iteration (prevcoli)
 
     //-- expand epsilons in current column
-    _gfsm_viterbi_expand_column(fst, trellis, col, trellis2fst, fst2trellis);
+    gfsm_viterbi_expand_column_(src, trellis, col, trellis2fst, fst2trellis, eps);
 
     //-- update column table
     g_ptr_array_index(cols,i+1) = col;
@@ -322,21 +592,18 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
     //-- get the top element of the queue
     qid_trellis = (gfsmStateId)GPOINTER_TO_UINT(prevcoli->data);
     qid_fst     = (gfsmStateId)GPOINTER_TO_UINT(g_ptr_array_index(trellis2fst, qid_trellis));
-      
+
     //-- get state pointers
     q_trellis = gfsm_automaton_find_state(trellis, qid_trellis);
-    q_fst     = gfsm_automaton_find_state(fst,     qid_fst);
-    
+
     //-- get Viterbi properties
     w_trellis = gfsm_viterbi_node_best_weight(q_trellis);
 
     //-- check for finality
-    if (q_fst->is_final) {
+    if (gfsm_lookup_final_(src, qid_fst, &fw)) {
       gfsm_automaton_add_arc(trellis, qid_trellis_nxt, qid_trellis,
 			     gfsmEpsilon, gfsmEpsilon,
-			     gfsm_sr_times(fst->sr,
-					   w_trellis,
-					   gfsm_automaton_get_final_weight(fst,qid_fst)));
+			     gfsm_sr_times(src->sr, w_trellis, fw));
     }
   }
 
@@ -344,11 +611,11 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
   qid_trellis = qid_trellis_nxt;
   q_trellis = gfsm_automaton_find_state(trellis,qid_trellis);
   q_trellis->arcs = gfsm_arclist_sort(q_trellis->arcs,
-				      &((gfsmArcCompData){gfsmASMWeight,fst->sr,NULL,NULL}));
+				      &((gfsmArcCompData){gfsmASMWeight,src->sr,NULL,NULL}));
 
   //-- break dummy arc on trellis final state (old root)
   q_trellis = gfsm_automaton_find_state(trellis,trellis->root_id);
-  gfsm_arclist_free(q_trellis->arcs);
+  gfsm_arc_pool_release_list(trellis->arc_pool, q_trellis->arcs);
   q_trellis->arcs = NULL;
 
   //-- mark new root
@@ -362,6 +629,8 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
 
   //-- cleanup: column array
   g_ptr_array_free(cols,TRUE);
+  g_array_free(matches,TRUE);
+  g_array_free(eps,TRUE);
   if (trellis2fst_is_tmp) g_ptr_array_free(trellis2fst,TRUE);
   else {
     //-- just set length
@@ -372,19 +641,79 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
 }
 
 
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
+						  gfsmLabelVector   *input,
+						  gfsmAutomaton     *trellis,
+						  gfsmStateIdVector *trellis2fst)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, fst, NULL, NULL);
+
+  //-- ensure trellis automaton exists and is clear
+  if (trellis==NULL) {
+    trellis = gfsm_automaton_shadow(fst);
+  } else {
+    gfsm_automaton_clear(trellis);
+  }
+
+  return gfsm_lookup_viterbi_full_(&src, input, trellis, trellis2fst);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_packed_lookup_viterbi_full(gfsmPackedAutomaton *pfst,
+					       gfsmLabelVector     *input,
+					       gfsmAutomaton       *trellis,
+					       gfsmStateIdVector   *trellis2fst)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, NULL, NULL, pfst);
+
+  //-- ensure trellis automaton exists and is clear
+  if (trellis==NULL) {
+    trellis = gfsm_lookup_result_new_(pfst->flags, pfst->sr);
+  } else {
+    gfsm_automaton_clear(trellis);
+  }
+
+  return gfsm_lookup_viterbi_full_(&src, input, trellis, trellis2fst);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_indexed_lookup_viterbi_full(gfsmIndexedAutomaton *xfst,
+						gfsmLabelVector      *input,
+						gfsmAutomaton        *trellis,
+						gfsmStateIdVector    *trellis2fst)
+{
+  gfsmLookupSource src;
+  gfsm_lookup_source_init_(&src, NULL, xfst, NULL);
+
+  //-- ensure trellis automaton exists and is clear
+  if (trellis==NULL) {
+    trellis = gfsm_lookup_result_new_(xfst->flags, xfst->sr);
+  } else {
+    gfsm_automaton_clear(trellis);
+  }
+
+  return gfsm_lookup_viterbi_full_(&src, input, trellis, trellis2fst);
+}
+
+
 /*======================================================================
  * Methods: Viterbi: expand_column
  */
 
 //--------------------------------------------------------------
-void _gfsm_viterbi_expand_column(gfsmAutomaton        *fst,
+static
+void gfsm_viterbi_expand_column_(gfsmLookupSource     *src,
 				 gfsmAutomaton        *trellis,
 				 gfsmViterbiColumn    *col,
 				 gfsmStateIdVector    *trellis2fst,
-				 gfsmViterbiMap       *fst2trellis)
+				 gfsmViterbiMap       *fst2trellis,
+				 GArray               *eps)
 {
-  gfsmArcIter ai;
   gfsmViterbiColumn *coli;
+  guint              ei;
   gfsmStateId        qid_trellis, qid_fst;
   gfsmState         *q_trellis;
   //gfsmArc           *arc_trellis;
@@ -410,11 +739,10 @@ void _gfsm_viterbi_expand_column(gfsmAutomaton        *fst,
     qid_fst     = (gfsmStateId)GPOINTER_TO_UINT(g_ptr_array_index(trellis2fst,qid_trellis));
 
     //-- search for input-epsilon arcs & add them to this column
-    for (gfsm_arciter_open(&ai,fst,qid_fst), gfsm_arciter_seek_lower(&ai,gfsmEpsilon);
-	 gfsm_arciter_ok(&ai);
-	 gfsm_arciter_next(&ai), gfsm_arciter_seek_lower(&ai,gfsmEpsilon))
+    gfsm_lookup_epsilons_(src, qid_fst, eps);
+    for (ei=0; ei < eps->len; ei++)
       {
-	gfsmArc     *arc_fst = gfsm_arciter_arc(&ai);
+	gfsmArcMatch *arc_fst = &g_array_index(eps,gfsmArcMatch,ei);
 	gfsmStateId  qid_trellis_nxt = gfsmNoState;
 	gpointer     ptr_qid_trellis_nxt;
 	gfsmState   *q_trellis_nxt;
@@ -428,13 +756,13 @@ void _gfsm_viterbi_expand_column(gfsmAutomaton        *fst,
 				   &ptr_qid_trellis_nxt))
 	  {
 	    //-- yep: get the old ("*_eps") & new ("*_nxt") weights
-	    gfsmWeight w_trellis_eps = gfsm_sr_times(fst->sr, w_trellis, arc_fst->weight);
+	    gfsmWeight w_trellis_eps = gfsm_sr_times(src->sr, w_trellis, arc_fst->weight);
 	    qid_trellis_nxt = GPOINTER_TO_UINT(ptr_qid_trellis_nxt);
 	    q_trellis_nxt   = gfsm_automaton_find_state(trellis,qid_trellis_nxt);
 	    w_trellis_nxt   = gfsm_viterbi_node_best_weight(q_trellis_nxt);
 
 	    //-- is the new eps-path better than the stored path?
-	    if (gfsm_sr_less(fst->sr,w_trellis_eps,w_trellis_nxt)) {
+	    if (gfsm_sr_less(src->sr,w_trellis_eps,w_trellis_nxt)) {
 	      //-- yep: update mappings: trellis automaton
 	      gfsmArc *arc_trellis_nxt = gfsm_viterbi_node_arc(q_trellis_nxt);
 	      arc_trellis_nxt->target  = qid_trellis;
@@ -461,7 +789,7 @@ void _gfsm_viterbi_expand_column(gfsmAutomaton        *fst,
 	    gfsm_automaton_add_arc(trellis,
 				   qid_trellis_nxt, qid_trellis,
 				   gfsmEpsilon,     arc_fst->upper,
-				   gfsm_sr_times(fst->sr, w_trellis, arc_fst->weight));
+				   gfsm_sr_times(src->sr, w_trellis, arc_fst->weight));
 
 	    //-- save trellis->fst stateid-map
 	    if (qid_trellis_nxt >= trellis2fst->len) {
@@ -484,6 +812,21 @@ void _gfsm_viterbi_expand_column(gfsmAutomaton        *fst,
 
 
 
+//--------------------------------------------------------------
+void _gfsm_viterbi_expand_column(gfsmAutomaton        *fst,
+				 gfsmAutomaton        *trellis,
+				 gfsmViterbiColumn    *col,
+				 gfsmStateIdVector    *trellis2fst,
+				 gfsmViterbiMap       *fst2trellis)
+{
+  gfsmLookupSource src;
+  GArray *eps = g_array_new(FALSE,FALSE,sizeof(gfsmArcMatch));
+  gfsm_lookup_source_init_(&src, fst, NULL, NULL);
+  gfsm_viterbi_expand_column_(&src, trellis, col, trellis2fst, fst2trellis, eps);
+  g_array_free(eps,TRUE);
+}
+
+
 /*======================================================================
  * Methods: Viterbi: Map
  */
@@ -30,6 +30,8 @@
 
 #include <gfsmAutomaton.h>
 #include <gfsmUtils.h>
+#include <gfsmPacked.h>
+#include <gfsmIndexed.h>
 
 /*======================================================================
  * Types: lookup
@@ -117,6 +119,109 @@ gfsmAutomaton *gfsm_automaton_lookup_full(gfsmAutomaton     *fst,
 					  gfsmStateIdVector *statemap,
 					  gfsmStateId	     max_result_states);
 
+//------------------------------
+/** Like gfsm_automaton_lookup(), but for a packed transducer \a pfst */
+#define gfsm_packed_lookup(pfst,input,result) \
+  gfsm_packed_lookup_full((pfst),(input),(result),NULL,gfsmLookupMaxResultStates)
+
+//------------------------------
+/** Like gfsm_automaton_lookup_full(), but for a packed transducer \a pfst.
+ *  A new \a result automaton inherits the flags and semiring of \a pfst.
+ */
+gfsmAutomaton *gfsm_packed_lookup_full(gfsmPackedAutomaton *pfst,
+				       gfsmLabelVector     *input,
+				       gfsmAutomaton       *result,
+				       gfsmStateIdVector   *statemap,
+				       gfsmStateId          max_result_states);
+
+//------------------------------
+/** Like gfsm_automaton_lookup(), but for an indexed transducer \a xfst */
+#define gfsm_indexed_lookup(xfst,input,result) \
+  gfsm_indexed_lookup_full((xfst),(input),(result),NULL,gfsmLookupMaxResultStates)
+
+//------------------------------
+/** Like gfsm_automaton_lookup_full(), but for an indexed transducer \a xfst, which is accessed in place.
+ *  Arc matching uses binary search if \a xfst is sorted primarily on lower labels.
+ *  A new \a result automaton inherits the flags and semiring of \a xfst.
+ */
+gfsmAutomaton *gfsm_indexed_lookup_full(gfsmIndexedAutomaton *xfst,
+					gfsmLabelVector      *input,
+					gfsmAutomaton        *result,
+					gfsmStateIdVector    *statemap,
+					gfsmStateId           max_result_states);
+
+//@}
+
+/*======================================================================
+ * Methods: lookup lattice
+ */
+///\name Lattice Lookup
+//@{
+
+//------------------------------
+/** Compose string automaton specified by \a input with the transducer \a fst,
+ *  sharing result states: see gfsm_automaton_lookup_lattice_full().
+ *  Non-coaccessible result states are pruned.
+ */
+#define gfsm_automaton_lookup_lattice(fst,input,result) \
+  gfsm_automaton_lookup_lattice_full((fst),(input),(result),NULL,gfsmLookupMaxResultStates,TRUE)
+
+//------------------------------
+/** Compose string automaton specified by \a input with the transducer \a fst,
+ *  storing result in \a result.
+ *
+ *  Unlike gfsm_automaton_lookup_full(), which creates a new result state for each
+ *  path prefix (yielding a tree which may grow exponentially with the input length
+ *  for ambiguous \a fst), this function creates a single result state for each
+ *  reachable pair (\a fst state, input position), yielding a lattice with at most
+ *  <tt>n_states(fst) * (input->len+1)</tt> states.  The lattice is acyclic unless
+ *  \a fst contains cycles of lower-epsilon arcs.
+ *
+ *  \param fst transducer (lower-upper)
+ *  \param input input labels (lower)
+ *  \param result output transducer or NULL
+ *  \param statemap if non-NULL, maps \a result StateIds (indices) to \a fst StateIds (values) on return.
+ *                  Not implicitly created or cleared.
+ *  \param max_result_states maximum number of result states to create
+ *  \param connect if true, non-coaccessible states are removed from \a result
+ *                 (without renumbering, so \a statemap remains valid)
+ *  \returns \a result if non-NULL, otherwise a new automaton.
+ */
+gfsmAutomaton *gfsm_automaton_lookup_lattice_full(gfsmAutomaton     *fst,
+						  gfsmLabelVector   *input,
+						  gfsmAutomaton     *result,
+						  gfsmStateIdVector *statemap,
+						  gfsmStateId        max_result_states,
+						  gboolean           connect);
+
+//------------------------------
+/** Like gfsm_automaton_lookup_lattice(), but for a packed transducer \a pfst */
+#define gfsm_packed_lookup_lattice(pfst,input,result) \
+  gfsm_packed_lookup_lattice_full((pfst),(input),(result),NULL,gfsmLookupMaxResultStates,TRUE)
+
+//------------------------------
+/** Like gfsm_automaton_lookup_lattice_full(), but for a packed transducer \a pfst */
+gfsmAutomaton *gfsm_packed_lookup_lattice_full(gfsmPackedAutomaton *pfst,
+					       gfsmLabelVector     *input,
+					       gfsmAutomaton       *result,
+					       gfsmStateIdVector   *statemap,
+					       gfsmStateId          max_result_states,
+					       gboolean             connect);
+
+//------------------------------
+/** Like gfsm_automaton_lookup_lattice(), but for an indexed transducer \a xfst */
+#define gfsm_indexed_lookup_lattice(xfst,input,result) \
+  gfsm_indexed_lookup_lattice_full((xfst),(input),(result),NULL,gfsmLookupMaxResultStates,TRUE)
+
+//------------------------------
+/** Like gfsm_automaton_lookup_lattice_full(), but for an indexed transducer \a xfst */
+gfsmAutomaton *gfsm_indexed_lookup_lattice_full(gfsmIndexedAutomaton *xfst,
+						gfsmLabelVector      *input,
+						gfsmAutomaton        *result,
+						gfsmStateIdVector    *statemap,
+						gfsmStateId           max_result_states,
+						gboolean              connect);
+
 //@}
 
 
@@ -158,6 +263,30 @@ gfsmAutomaton *gfsm_automaton_lookup_viterbi_full(gfsmAutomaton     *fst,
 						  gfsmAutomaton     *trellis,
 						  gfsmStateIdVector *trellis2fst);
 
+//------------------------------
+/** Like gfsm_automaton_lookup_viterbi(), but for a packed transducer \a pfst */
+#define gfsm_packed_lookup_viterbi(pfst,input,trellis) \
+   gfsm_packed_lookup_viterbi_full((pfst),(input),(trellis),NULL)
+
+//------------------------------
+/** Like gfsm_automaton_lookup_viterbi_full(), but for a packed transducer \a pfst */
+gfsmAutomaton *gfsm_packed_lookup_viterbi_full(gfsmPackedAutomaton *pfst,
+					       gfsmLabelVector     *input,
+					       gfsmAutomaton       *trellis,
+					       gfsmStateIdVector   *trellis2fst);
+
+//------------------------------
+/** Like gfsm_automaton_lookup_viterbi(), but for an indexed transducer \a xfst */
+#define gfsm_indexed_lookup_viterbi(xfst,input,trellis) \
+   gfsm_indexed_lookup_viterbi_full((xfst),(input),(trellis),NULL)
+
+//------------------------------
+/** Like gfsm_automaton_lookup_viterbi_full(), but for an indexed transducer \a xfst */
+gfsmAutomaton *gfsm_indexed_lookup_viterbi_full(gfsmIndexedAutomaton *xfst,
+						gfsmLabelVector      *input,
+						gfsmAutomaton        *trellis,
+						gfsmStateIdVector    *trellis2fst);
+
 //@}
 
 /*======================================================================
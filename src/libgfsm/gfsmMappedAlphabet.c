@@ -0,0 +1,457 @@
+/*=============================================================================*\
+ * File: gfsmMappedAlphabet.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: read-only memory-mapped binary alphabets
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmConfig.h>
+#include <gfsmMappedAlphabet.h>
+#include <gfsmUtils.h>
+
+#include <string.h>
+#include <stdio.h>
+
+/*======================================================================
+ * Constants
+ */
+const guint32 gfsmMappedAlphabetMaxDisp = 65536;
+
+const guint32 gfsmMappedAlphabetMaxSeeds = 32;
+
+/*======================================================================
+ * Hashing
+ */
+
+/*--------------------------------------------------------------
+ * hash_()
+ *  + seeded FNV-1a, followed by a 64-bit finalizer
+ */
+static
+guint64 gfsm_mapped_alphabet_hash_(const gchar *key, guint32 seed)
+{
+  guint64 h = 0xcbf29ce484222325ULL ^ ((guint64)seed * 0x9e3779b97f4a7c15ULL);
+  const guchar *p;
+  for (p=(const guchar*)key; *p; p++) {
+    h ^= *p;
+    h *= 0x100000001b3ULL;
+  }
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+/*--------------------------------------------------------------
+ * hash_split_()
+ *  + bucket and slot-sequence parameters for a hash value
+ */
+static
+void gfsm_mapped_alphabet_hash_split_(guint64 h, guint32 n_buckets, guint32 n_slots,
+				      guint32 *b, guint32 *f1, guint32 *f2)
+{
+  *b  = (guint32)(h % n_buckets);
+  *f1 = (guint32)((h >> 32) % n_slots);
+  *f2 = n_slots > 1 ? 1 + (guint32)(((h * 0x9e3779b97f4a7c15ULL) >> 32) % (n_slots-1)) : 0;
+}
+
+/*--------------------------------------------------------------
+ * slot_()
+ */
+static
+guint32 gfsm_mapped_alphabet_slot_(guint32 f1, guint32 f2, guint32 d, guint32 n_slots)
+{
+  return (guint32)(((guint64)f1 + (guint64)d * (guint64)f2) % n_slots);
+}
+
+/*--------------------------------------------------------------
+ * prime_()
+ *  + smallest prime >= n
+ */
+static
+guint32 gfsm_mapped_alphabet_prime_(guint32 n)
+{
+  guint32 d;
+  if (n <= 2) return 2;
+  if (n % 2 == 0) ++n;
+  for ( ; ; n += 2) {
+    for (d=3; d*d <= n && n % d != 0; d += 2) ;
+    if (d*d > n) return n;
+  }
+  return n;
+}
+
+/*======================================================================
+ * Perfect hash construction
+ */
+
+/// bucket comparison data for gfsm_mapped_alphabet_bucket_compare_()
+typedef struct {
+  const guint32 *bstart;
+} gfsmMappedAlphabetBucketData;
+
+/*--------------------------------------------------------------
+ * bucket_compare_()
+ *  + sort buckets by descending size
+ */
+static
+gint gfsm_mapped_alphabet_bucket_compare_(gconstpointer ap, gconstpointer bp, gpointer data)
+{
+  const guint32 *bstart = ((gfsmMappedAlphabetBucketData*)data)->bstart;
+  guint32 a = *((const guint32*)ap), b = *((const guint32*)bp);
+  guint32 na = bstart[a+1]-bstart[a], nb = bstart[b+1]-bstart[b];
+  return (na > nb ? -1 : (na < nb ? 1 : (a < b ? -1 : (a > b ? 1 : 0))));
+}
+
+/*--------------------------------------------------------------
+ * build_()
+ *  + hash-and-displace: keys are grouped into buckets, which are placed
+ *    largest-first by searching for a displacement d such that every key
+ *    in the bucket lands on a free slot (f1 + d*f2) mod n_slots
+ *  + returns TRUE and fills disp[] and slots[] on success
+ */
+static
+gboolean gfsm_mapped_alphabet_build_(const guint64 *hashes, const guint32 *labels, guint32 n_keys,
+				     guint32 n_buckets, guint32 n_slots,
+				     guint32 *disp, guint32 *slots)
+{
+  guint32 *bstart = g_new0(guint32, n_buckets+1);
+  guint32 *bkeys  = g_new(guint32, n_keys);
+  guint32 *bfill  = g_new0(guint32, n_buckets);
+  guint32 *border = g_new(guint32, n_buckets);
+  guint32 *f1     = g_new(guint32, n_keys);
+  guint32 *f2     = g_new(guint32, n_keys);
+  guint32 *tmp    = g_new(guint32, n_keys);
+  guint8  *taken  = g_new0(guint8, n_slots);
+  gfsmMappedAlphabetBucketData bdata;
+  gboolean rc = TRUE;
+  guint32 i, j, b, d, n;
+
+  //-- bucketize keys (counting sort)
+  for (i=0; i < n_keys; i++) {
+    gfsm_mapped_alphabet_hash_split_(hashes[i], n_buckets, n_slots, &b, &f1[i], &f2[i]);
+    tmp[i] = b;
+    ++bstart[b+1];
+  }
+  for (b=0; b < n_buckets; b++) bstart[b+1] += bstart[b];
+  for (i=0; i < n_keys; i++) {
+    b = tmp[i];
+    bkeys[bstart[b] + bfill[b]++] = i;
+  }
+
+  //-- place buckets, largest first
+  for (b=0; b < n_buckets; b++) border[b] = b;
+  bdata.bstart = bstart;
+  g_qsort_with_data(border, n_buckets, sizeof(guint32), gfsm_mapped_alphabet_bucket_compare_, &bdata);
+
+  for (i=0; i < n_slots; i++) slots[i] = gfsmNoLabel;
+  for (b=0; b < n_buckets; b++) disp[b] = 0;
+
+  for (j=0; rc && j < n_buckets; j++) {
+    guint32 bi = border[j];
+    const guint32 *keys = bkeys + bstart[bi];
+    n = bstart[bi+1] - bstart[bi];
+    if (n == 0) break; //-- all remaining buckets are empty
+
+    for (d=0; d < gfsmMappedAlphabetMaxDisp; d++) {
+      for (i=0; i < n; i++) {
+	guint32 s = gfsm_mapped_alphabet_slot_(f1[keys[i]], f2[keys[i]], d, n_slots);
+	if (taken[s]) break;
+	taken[s] = 1;
+	tmp[i]   = s;
+      }
+      if (i == n) break;
+      //-- collision: release slots taken by this attempt
+      while (i > 0) taken[tmp[--i]] = 0;
+    }
+    if (d == gfsmMappedAlphabetMaxDisp) {
+      rc = FALSE;
+      break;
+    }
+
+    disp[bi] = d;
+    for (i=0; i < n; i++) slots[tmp[i]] = labels[keys[i]];
+  }
+
+  g_free(bstart);
+  g_free(bkeys);
+  g_free(bfill);
+  g_free(border);
+  g_free(f1);
+  g_free(f2);
+  g_free(tmp);
+  g_free(taken);
+  return rc;
+}
+
+/*======================================================================
+ * Methods: Output
+ */
+
+/*--------------------------------------------------------------
+ * save_bin_handle()
+ */
+gboolean gfsm_alphabet_save_bin_handle(gfsmAlphabet *a, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  gfsmMappedAlphabetHeader hdr;
+  GString    *pool    = g_string_new("");
+  GString    *gstr    = g_string_new("");
+  GHashTable *seen    = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+  GArray     *hashes  = g_array_new(FALSE, FALSE, sizeof(guint64));
+  GArray     *klabels = g_array_new(FALSE, FALSE, sizeof(guint32));
+  guint32    *offsets = NULL, *disp = NULL, *slots = NULL;
+  guint32     n_slots_min;
+  gfsmLabelVal lab;
+  gpointer    key;
+  gboolean    rc = FALSE;
+
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, gfsmMappedAlphabetMagic, sizeof(hdr.magic));
+  hdr.version   = gfsmMappedAlphabetVersion;
+  hdr.byteorder = gfsmMappedAlphabetByteOrder;
+  hdr.n_labels  = (a->lab_max == gfsmNoLabel ? 0 : a->lab_max+1);
+
+  //-- collect key strings
+  offsets = g_new(guint32, hdr.n_labels > 0 ? hdr.n_labels : 1);
+  for (lab=0; lab < hdr.n_labels; lab++) {
+    offsets[lab] = gfsmMappedAlphabetNoOffset;
+    if (lab < a->lab_min || (key=gfsm_alphabet_find_key(a,lab)) == gfsmNoKey) continue;
+    gfsm_alphabet_key2string(a, key, gstr);
+
+    offsets[lab] = pool->len;
+    g_string_append_len(pool, gstr->str, gstr->len+1);
+
+    //-- only the first label for each key goes into the index
+    if (g_hash_table_lookup_extended(seen, gstr->str, NULL, NULL)) continue;
+    g_hash_table_insert(seen, g_strdup(gstr->str), NULL);
+    g_array_append_val(klabels, lab);
+  }
+  hdr.n_keys       = klabels->len;
+  hdr.strings_size = pool->len;
+
+  //-- build perfect hash index
+  hdr.n_buckets = hdr.n_keys/3 + 1;
+  n_slots_min   = hdr.n_keys + hdr.n_keys/4 + 1;
+  for ( ; ; n_slots_min += n_slots_min/2 + 1) {
+    hdr.n_slots = gfsm_mapped_alphabet_prime_(n_slots_min);
+    disp  = g_renew(guint32, disp,  hdr.n_buckets);
+    slots = g_renew(guint32, slots, hdr.n_slots);
+    for (hdr.seed=0; hdr.seed < gfsmMappedAlphabetMaxSeeds; hdr.seed++) {
+      guint32 i;
+      g_array_set_size(hashes, 0);
+      for (i=0; i < hdr.n_keys; i++) {
+	guint64 h = gfsm_mapped_alphabet_hash_(pool->str + offsets[g_array_index(klabels,guint32,i)], hdr.seed);
+	g_array_append_val(hashes, h);
+      }
+      if (gfsm_mapped_alphabet_build_((guint64*)hashes->data, (guint32*)klabels->data, hdr.n_keys,
+				      hdr.n_buckets, hdr.n_slots, disp, slots))
+	break;
+    }
+    if (hdr.seed < gfsmMappedAlphabetMaxSeeds) break;
+  }
+
+  //-- write (empty sections are skipped: C FILE* handles fail on zero-length writes)
+  rc = (gfsmio_write(ioh, &hdr, sizeof(hdr))
+	&& (hdr.n_labels == 0 || gfsmio_write(ioh, offsets, sizeof(guint32)*hdr.n_labels))
+	&& gfsmio_write(ioh, disp,  sizeof(guint32)*hdr.n_buckets)
+	&& gfsmio_write(ioh, slots, sizeof(guint32)*hdr.n_slots)
+	&& (pool->len == 0 || gfsmio_write(ioh, pool->str, pool->len)));
+  if (!rc) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),  //-- domain
+		g_quark_from_static_string("alphabet_save_bin"), //-- code
+		"could not store binary alphabet");
+  }
+
+  g_free(offsets);
+  g_free(disp);
+  g_free(slots);
+  g_array_free(hashes, TRUE);
+  g_array_free(klabels, TRUE);
+  g_hash_table_destroy(seen);
+  g_string_free(gstr, TRUE);
+  g_string_free(pool, TRUE);
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * save_bin_filename()
+ */
+gboolean gfsm_alphabet_save_bin_filename(gfsmAlphabet *a, const gchar *filename, gfsmError **errp)
+{
+  gfsmIOHandle *ioh = gfsmio_new_filename(filename, "wb", 0, errp);
+  gboolean rc = ioh && !(*errp) && gfsm_alphabet_save_bin_handle(a, ioh, errp);
+  if (ioh) {
+    gfsmio_close(ioh);
+    gfsmio_handle_free(ioh);
+  }
+  return rc;
+}
+
+/*======================================================================
+ * Methods: Input
+ */
+
+/*--------------------------------------------------------------
+ * file_check()
+ */
+gboolean gfsm_mapped_alphabet_file_check(const gchar *filename)
+{
+  gchar magic[8];
+  gboolean rc = FALSE;
+  FILE *f = fopen(filename, "rb");
+  if (!f) return FALSE;
+  rc = (fread(magic, sizeof(magic), 1, f) == 1
+	&& memcmp(magic, gfsmMappedAlphabetMagic, sizeof(magic)) == 0);
+  fclose(f);
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * open()
+ */
+gfsmMappedAlphabet *gfsm_mapped_alphabet_open(const gchar *filename, gfsmError **errp)
+{
+  GMappedFile *mfile = g_mapped_file_new(filename, FALSE, errp);
+  const gfsmMappedAlphabetHeader *hdr;
+  gfsmMappedAlphabet *ma;
+  const gchar *data;
+  gsize len, need;
+  const gchar *why = NULL;
+
+  if (!mfile) return NULL;
+  data = g_mapped_file_get_contents(mfile);
+  len  = g_mapped_file_get_length(mfile);
+  hdr  = (const gfsmMappedAlphabetHeader*)data;
+
+  //-- sanity checks
+  if (len < sizeof(gfsmMappedAlphabetHeader)
+      || memcmp(hdr->magic, gfsmMappedAlphabetMagic, sizeof(hdr->magic)) != 0)
+    why = "bad magic";
+  else if (hdr->byteorder != gfsmMappedAlphabetByteOrder)
+    why = "byte-order mismatch";
+  else if (hdr->version != gfsmMappedAlphabetVersion)
+    why = "unsupported format version";
+  else if (hdr->n_buckets == 0 || hdr->n_slots == 0)
+    why = "empty hash index";
+  else {
+    need = sizeof(gfsmMappedAlphabetHeader)
+      + sizeof(guint32) * ((gsize)hdr->n_labels + hdr->n_buckets + hdr->n_slots)
+      + hdr->strings_size;
+    if (len < need)
+      why = "file truncated";
+    else if (hdr->strings_size > 0 && data[need-1] != '\0')
+      why = "unterminated string pool";
+  }
+  if (why) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),  //-- domain
+		g_quark_from_static_string("mapped_alphabet_open"), //-- code
+		"could not load binary alphabet file '%s': %s",
+		filename, why);
+    g_mapped_file_unref(mfile);
+    return NULL;
+  }
+
+  ma = g_new0(gfsmMappedAlphabet,1);
+  ma->mfile   = mfile;
+  ma->hdr     = hdr;
+  ma->offsets = (const guint32*)(data + sizeof(gfsmMappedAlphabetHeader));
+  ma->disp    = ma->offsets + hdr->n_labels;
+  ma->slots   = ma->disp + hdr->n_buckets;
+  ma->strings = (const gchar*)(ma->slots + hdr->n_slots);
+  return ma;
+}
+
+/*--------------------------------------------------------------
+ * close()
+ */
+void gfsm_mapped_alphabet_close(gfsmMappedAlphabet *ma)
+{
+  if (!ma) return;
+  if (ma->mfile) g_mapped_file_unref(ma->mfile);
+  g_free(ma);
+}
+
+/*======================================================================
+ * Methods: Lookup
+ */
+
+/*--------------------------------------------------------------
+ * find_key()
+ */
+const gchar *gfsm_mapped_alphabet_find_key(gfsmMappedAlphabet *ma, gfsmLabelVal label)
+{
+  guint32 off;
+  if (label >= ma->hdr->n_labels) return NULL;
+  off = ma->offsets[label];
+  if (off == gfsmMappedAlphabetNoOffset || off >= ma->hdr->strings_size) return NULL;
+  return ma->strings + off;
+}
+
+/*--------------------------------------------------------------
+ * find_label()
+ */
+gfsmLabelVal gfsm_mapped_alphabet_find_label(gfsmMappedAlphabet *ma, const gchar *key)
+{
+  const gfsmMappedAlphabetHeader *hdr = ma->hdr;
+  guint32 b, f1, f2;
+  gfsmLabelVal lab;
+  const gchar *s;
+
+  gfsm_mapped_alphabet_hash_split_(gfsm_mapped_alphabet_hash_(key, hdr->seed),
+				   hdr->n_buckets, hdr->n_slots, &b, &f1, &f2);
+  lab = ma->slots[gfsm_mapped_alphabet_slot_(f1, f2, ma->disp[b], hdr->n_slots)];
+
+  //-- the index maps unknown keys to arbitrary slots: verify
+  if (lab == gfsmNoLabel || !(s=gfsm_mapped_alphabet_find_key(ma,lab)) || strcmp(s,key) != 0)
+    return gfsmNoLabel;
+  return lab;
+}
+
+/*--------------------------------------------------------------
+ * to_alphabet()
+ */
+gfsmAlphabet *gfsm_mapped_alphabet_to_alphabet(gfsmMappedAlphabet *ma, gfsmAlphabet *a)
+{
+  gboolean     is_pointer = (a->type==gfsmATPointer || a->type==gfsmATString);
+  GString     *gs_key = is_pointer ? NULL : g_string_new("");
+  gfsmLabelVal lab;
+  const gchar *s;
+  gpointer     key;
+
+  gfsm_alphabet_reserve(a, ma->hdr->n_labels);
+  for (lab=0; lab < ma->hdr->n_labels; lab++) {
+    if (!(s=gfsm_mapped_alphabet_find_key(ma,lab))) continue;
+    if (is_pointer) {
+      key = (gpointer)s;
+    } else {
+      g_string_assign(gs_key, s);
+      key = gfsm_alphabet_string2key(a, gs_key);
+    }
+    if (gfsm_alphabet_find_label(a,key) != lab) {
+      gfsm_alphabet_remove_key(a, key);
+      gfsm_alphabet_insert(a, key, lab);
+    }
+  }
+
+  if (gs_key) g_string_free(gs_key,TRUE);
+  return a;
+}
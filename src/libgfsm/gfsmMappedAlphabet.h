@@ -0,0 +1,132 @@
+/*=============================================================================*\
+ * File: gfsmMappedAlphabet.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: read-only memory-mapped binary alphabets
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmMappedAlphabet.h
+ *  \brief Read-only binary string alphabets with a perfect-hash key index
+ *
+ *  A binary alphabet file stores a fixed header, a label-indexed table of
+ *  key offsets, a hash-and-displace perfect hash index over all keys, and
+ *  a pool of NUL-terminated key strings.  All tables are 32-bit aligned
+ *  and stored in host byte order, so a file can be memory-mapped and used
+ *  directly without any parsing.
+ */
+
+#ifndef _GFSM_MAPPED_ALPHABET_H
+#define _GFSM_MAPPED_ALPHABET_H
+
+#include <gfsmAlphabet.h>
+
+/*======================================================================
+ * Types
+ */
+
+/// magic string at the beginning of every binary alphabet file
+#define gfsmMappedAlphabetMagic "gfsmLABb"
+
+/// binary alphabet format version
+#define gfsmMappedAlphabetVersion 1
+
+/// byte-order mark stored in binary alphabet files
+#define gfsmMappedAlphabetByteOrder 0x01020304
+
+/// key offset for labels without a key
+#define gfsmMappedAlphabetNoOffset ((guint32)-1)
+
+/// On-disk header of a binary alphabet file
+typedef struct {
+  gchar   magic[8];      ///< ::gfsmMappedAlphabetMagic (without trailing NUL)
+  guint32 version;       ///< ::gfsmMappedAlphabetVersion
+  guint32 byteorder;     ///< ::gfsmMappedAlphabetByteOrder as written by the creator
+  guint32 n_labels;      ///< number of entries in the offset table (maximum label + 1)
+  guint32 n_keys;        ///< number of distinct keys in the hash index
+  guint32 n_buckets;     ///< number of displacement buckets
+  guint32 n_slots;       ///< number of perfect-hash slots
+  guint32 seed;          ///< hash seed
+  guint32 strings_size;  ///< size of the key string pool in bytes
+} gfsmMappedAlphabetHeader;
+
+/// maximum number of displacements tried per bucket before re-seeding (default=65536)
+extern const guint32 gfsmMappedAlphabetMaxDisp;
+
+/// maximum number of hash seeds tried before growing the slot table (default=32)
+extern const guint32 gfsmMappedAlphabetMaxSeeds;
+
+/// Read-only view of a binary alphabet file
+typedef struct {
+  GMappedFile   *mfile;     ///< underlying mapped file
+  const gfsmMappedAlphabetHeader *hdr; ///< file header
+  const guint32 *offsets;   ///< [label] : offset of key string in strings[], or ::gfsmMappedAlphabetNoOffset
+  const guint32 *disp;      ///< [bucket] : displacement for perfect hash
+  const guint32 *slots;     ///< [slot] : label for hash slot, or ::gfsmNoLabel
+  const gchar   *strings;   ///< key string pool
+} gfsmMappedAlphabet;
+
+/*======================================================================
+ * Methods
+ */
+///\name Binary Alphabets
+//@{
+
+/** Write alphabet \a a in binary alphabet format to an (uncompressed) I/O handle.
+ *  Keys are converted to strings with gfsm_alphabet_key2string().
+ *  \returns TRUE on success
+ */
+gboolean gfsm_alphabet_save_bin_handle(gfsmAlphabet *a, gfsmIOHandle *ioh, gfsmError **errp);
+
+/** Write alphabet \a a to a binary alphabet file \a filename.
+ *  Keys are converted to strings with gfsm_alphabet_key2string().
+ *  \returns TRUE on success
+ */
+gboolean gfsm_alphabet_save_bin_filename(gfsmAlphabet *a, const gchar *filename, gfsmError **errp);
+
+/** Check whether \a filename looks like a binary alphabet file */
+gboolean gfsm_mapped_alphabet_file_check(const gchar *filename);
+
+/** Map a binary alphabet file \a filename read-only into memory.
+ *  \returns a new ::gfsmMappedAlphabet, or NULL on error
+ */
+gfsmMappedAlphabet *gfsm_mapped_alphabet_open(const gchar *filename, gfsmError **errp);
+
+/** Unmap and free a ::gfsmMappedAlphabet */
+void gfsm_mapped_alphabet_close(gfsmMappedAlphabet *ma);
+
+/** Get number of label slots in \a ma (maximum label + 1) */
+#define gfsm_mapped_alphabet_n_labels(ma) ((gfsmLabelVal)((ma)->hdr->n_labels))
+
+/** Get number of distinct keys in \a ma */
+#define gfsm_mapped_alphabet_n_keys(ma) ((ma)->hdr->n_keys)
+
+/** Look up the label for string \a key, or ::gfsmNoLabel if \a key is not defined */
+gfsmLabelVal gfsm_mapped_alphabet_find_label(gfsmMappedAlphabet *ma, const gchar *key);
+
+/** Look up the key string for \a label, or NULL if \a label is not defined */
+const gchar *gfsm_mapped_alphabet_find_key(gfsmMappedAlphabet *ma, gfsmLabelVal label);
+
+/** Bulk-insert all (key,label) pairs from \a ma into a (writable) alphabet \a a.
+ *  Keys are converted with gfsm_alphabet_string2key() for non-string alphabets.
+ *  \returns \a a
+ */
+gfsmAlphabet *gfsm_mapped_alphabet_to_alphabet(gfsmMappedAlphabet *ma, gfsmAlphabet *a);
+
+//@}
+
+#endif /* _GFSM_MAPPED_ALPHABET_H */
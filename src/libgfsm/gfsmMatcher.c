@@ -0,0 +1,256 @@
+/*=============================================================================*\
+ * File: gfsmMatcher.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: label matching with implicit sigma, rho, and phi arcs
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmMatcher.h>
+#include <gfsmArcIter.h>
+
+/*======================================================================
+ * Utilities
+ */
+
+//--------------------------------------------------------------
+static inline void gfsm_matcher_push_(GArray *matches, gfsmSemiring *sr, gfsmWeight wphi, const gfsmArc *a, gfsmLabelVal lab)
+{
+  gfsmArcMatch m;
+  m.target = a->target;
+  m.upper  = (gfsm_label_is_implicit(a->lower) && a->upper == a->lower) ? lab : a->upper;
+  m.weight = gfsm_sr_times(sr, wphi, a->weight);
+  g_array_append_val(matches, m);
+}
+
+//--------------------------------------------------------------
+gboolean gfsm_arcrange_has_implicit(gfsmArcRange *range)
+{
+  gfsmArcRange r = *range;
+  if (!gfsm_arcrange_ok(&r) || (r.max-1)->lower < gfsmPhi) return FALSE;
+  gfsm_arcrange_gallop_lower(&r, gfsmPhi);
+  return gfsm_arcrange_ok(&r) && r.min->lower <= gfsmSigma;
+}
+
+//--------------------------------------------------------------
+gboolean gfsm_automaton_has_implicit_arcs(gfsmAutomaton *fsm)
+{
+  gfsmStateId qid;
+  gfsmArcIter ai;
+  for (qid=0; qid < fsm->states->len; qid++) {
+    if (!gfsm_automaton_has_state(fsm,qid)) continue;
+    for (gfsm_arciter_open(&ai,fsm,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      if (gfsm_label_is_implicit(gfsm_arciter_arc(&ai)->lower)) {
+	gfsm_arciter_close(&ai);
+	return TRUE;
+      }
+    }
+    gfsm_arciter_close(&ai);
+  }
+  return FALSE;
+}
+
+/*======================================================================
+ * Matching
+ */
+
+//--------------------------------------------------------------
+guint gfsm_matcher_match_table(gfsmArcTableIndex *tabx,
+			       gfsmSemiring      *sr,
+			       gfsmStateId        qid,
+			       gfsmLabelVal       lab,
+			       GArray            *matches)
+{
+  guint       n0       = matches->len;
+  gboolean    literal  = (lab == gfsmEpsilon || gfsm_label_is_implicit(lab));
+  gfsmStateId maxsteps = tabx->first->len;
+  gfsmWeight  wphi     = sr->one;
+  gfsmArcRange r, rx;
+  gfsmArc     *a, *phi;
+
+  while (qid != gfsmNoState && qid+1 < tabx->first->len) {
+    gboolean explicit_match = FALSE;
+
+    //-- explicit arcs
+    gfsm_arcrange_open_table_index(&r, tabx, qid);
+    rx = r;
+    gfsm_arcrange_gallop_lower(&rx, lab);
+    for (a=rx.min; a < rx.max && a->lower == lab; a++) {
+      gfsm_matcher_push_(matches, sr, wphi, a, lab);
+      explicit_match = TRUE;
+    }
+    if (literal) break;
+
+    //-- implicit arcs: sorted as (phi < rho < sigma)
+    gfsm_arcrange_gallop_lower(&r, gfsmPhi);
+    phi = (r.min < r.max && r.min->lower == gfsmPhi) ? r.min : NULL;
+    for (a=r.min; a < r.max && a->lower <= gfsmSigma; a++) {
+      if (a->lower == gfsmSigma || (a->lower == gfsmRho && !explicit_match))
+	gfsm_matcher_push_(matches, sr, wphi, a, lab);
+    }
+
+    //-- failure transition
+    if (matches->len > n0 || phi == NULL || maxsteps-- == 0) break;
+    wphi = gfsm_sr_times(sr, wphi, phi->weight);
+    qid  = phi->target;
+  }
+
+  return matches->len - n0;
+}
+
+//--------------------------------------------------------------
+guint gfsm_matcher_match_packed(gfsmPackedAutomaton *pfsm,
+				gfsmStateId          qid,
+				gfsmLabelVal         lab,
+				GArray              *matches)
+{
+  guint        n0       = matches->len;
+  gboolean     literal  = (lab == gfsmEpsilon || gfsm_label_is_implicit(lab));
+  gfsmStateId  maxsteps = gfsm_packed_automaton_n_states(pfsm);
+  gfsmSemiring *sr      = pfsm->sr;
+  gfsmWeight   wphi     = sr->one;
+  gfsmArc      arc;
+  guint        i, imax, iphi;
+
+  while (qid != gfsmNoState && gfsm_packed_automaton_has_state(pfsm,qid)) {
+    gboolean explicit_match = FALSE;
+    imax = gfsm_packed_automaton_state_first(pfsm,qid+1);
+
+    //-- explicit arcs
+    for (i=gfsm_packed_automaton_seek_lower(pfsm,qid,lab); i < imax && gfsm_packed_arc_lower(pfsm,i) == lab; i++) {
+      gfsm_matcher_push_(matches, sr, wphi, gfsm_packed_arc_decode(pfsm,qid,i,&arc), lab);
+      explicit_match = TRUE;
+    }
+    if (literal) break;
+
+    //-- implicit arcs: sorted as (phi < rho < sigma)
+    iphi = gfsm_packed_automaton_seek_lower(pfsm,qid,gfsmPhi);
+    for (i=iphi; i < imax && gfsm_packed_arc_lower(pfsm,i) <= gfsmSigma; i++) {
+      gfsmLabelVal lo = gfsm_packed_arc_lower(pfsm,i);
+      if (lo == gfsmSigma || (lo == gfsmRho && !explicit_match))
+	gfsm_matcher_push_(matches, sr, wphi, gfsm_packed_arc_decode(pfsm,qid,i,&arc), lab);
+    }
+
+    //-- failure transition
+    if (matches->len > n0 || iphi >= imax || gfsm_packed_arc_lower(pfsm,iphi) != gfsmPhi || maxsteps-- == 0) break;
+    wphi = gfsm_sr_times(sr, wphi, gfsm_packed_arc_weight(pfsm,iphi));
+    qid  = gfsm_packed_arc_target(pfsm,iphi);
+  }
+
+  return matches->len - n0;
+}
+
+//--------------------------------------------------------------
+guint gfsm_matcher_match_state(gfsmAutomaton *fsm,
+			       gfsmStateId    qid,
+			       gfsmLabelVal   lab,
+			       GArray        *matches)
+{
+  guint        n0       = matches->len;
+  gboolean     literal  = (lab == gfsmEpsilon || gfsm_label_is_implicit(lab));
+  gfsmStateId  maxsteps = fsm->states->len;
+  gfsmSemiring *sr      = fsm->sr;
+  gfsmWeight   wphi     = sr->one;
+  gfsmState    *q;
+  gfsmArcList  *al;
+  gfsmArc      *a, *phi;
+
+  while ((q = gfsm_automaton_find_state(fsm,qid)) != NULL && q->is_valid) {
+    gboolean explicit_match = FALSE, has_rho = FALSE;
+    phi = NULL;
+
+    //-- explicit and sigma arcs
+    for (al=q->arcs; al != NULL; al=al->next) {
+      a = &(al->arc);
+      if (a->lower == lab) {
+	gfsm_matcher_push_(matches, sr, wphi, a, lab);
+	explicit_match = TRUE;
+      }
+      else if (literal) continue;
+      else if (a->lower == gfsmSigma) gfsm_matcher_push_(matches, sr, wphi, a, lab);
+      else if (a->lower == gfsmRho)   has_rho = TRUE;
+      else if (a->lower == gfsmPhi && phi == NULL) phi = a;
+    }
+    if (literal) break;
+
+    //-- rho arcs
+    if (has_rho && !explicit_match) {
+      for (al=q->arcs; al != NULL; al=al->next) {
+	if (al->arc.lower == gfsmRho) gfsm_matcher_push_(matches, sr, wphi, &(al->arc), lab);
+      }
+    }
+
+    //-- failure transition
+    if (matches->len > n0 || phi == NULL || maxsteps-- == 0) break;
+    wphi = gfsm_sr_times(sr, wphi, phi->weight);
+    qid  = phi->target;
+  }
+
+  return matches->len - n0;
+}
+
+//--------------------------------------------------------------
+guint gfsm_matcher_match_indexed(gfsmIndexedAutomaton *xfsm,
+				 gfsmStateId           qid,
+				 gfsmLabelVal          lab,
+				 GArray               *matches)
+{
+  guint        n0       = matches->len;
+  gboolean     literal  = (lab == gfsmEpsilon || gfsm_label_is_implicit(lab));
+  gfsmStateId  maxsteps = gfsm_indexed_automaton_n_states(xfsm);
+  gfsmSemiring *sr      = xfsm->sr;
+  gfsmWeight   wphi     = sr->one;
+  gfsmArcRange r;
+  gfsmArc      *a, *phi;
+
+  //-- arcs sorted on lower labels: use binary search
+  if (gfsm_acmask_nth(xfsm->flags.sort_mode,0) == gfsmACLower)
+    return gfsm_matcher_match_table(xfsm->arcs, sr, qid, lab, matches);
+
+  while (qid != gfsmNoState && gfsm_indexed_automaton_has_state(xfsm,qid)) {
+    gboolean explicit_match = FALSE, has_rho = FALSE;
+    phi = NULL;
+    gfsm_arcrange_open_indexed(&r, xfsm, qid);
+
+    //-- explicit and sigma arcs
+    for (a=r.min; a < r.max; a++) {
+      if (a->lower == lab) {
+	gfsm_matcher_push_(matches, sr, wphi, a, lab);
+	explicit_match = TRUE;
+      }
+      else if (literal) continue;
+      else if (a->lower == gfsmSigma) gfsm_matcher_push_(matches, sr, wphi, a, lab);
+      else if (a->lower == gfsmRho)   has_rho = TRUE;
+      else if (a->lower == gfsmPhi && phi == NULL) phi = a;
+    }
+    if (literal) break;
+
+    //-- rho arcs
+    if (has_rho && !explicit_match) {
+      for (a=r.min; a < r.max; a++) {
+	if (a->lower == gfsmRho) gfsm_matcher_push_(matches, sr, wphi, a, lab);
+      }
+    }
+
+    //-- failure transition
+    if (matches->len > n0 || phi == NULL || maxsteps-- == 0) break;
+    wphi = gfsm_sr_times(sr, wphi, phi->weight);
+    qid  = phi->target;
+  }
+
+  return matches->len - n0;
+}
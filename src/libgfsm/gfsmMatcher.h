@@ -0,0 +1,122 @@
+/*=============================================================================*\
+ * File: gfsmMatcher.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: label matching with implicit sigma, rho, and phi arcs
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmMatcher.h
+ *  \brief Matching labels against explicit and implicit arcs
+ *
+ *  Arcs whose lower label is one of the reserved labels ::gfsmSigma, ::gfsmRho
+ *  or ::gfsmPhi stand for whole classes of arcs.  When a state \a q is
+ *  asked for arcs matching a non-epsilon label \a a:
+ *   - arcs with lower label \a a match;
+ *   - ::gfsmSigma arcs match;
+ *   - ::gfsmRho arcs match if \a q has no arc with lower label \a a;
+ *   - if none of the above matched, a ::gfsmPhi arc from \a q is followed
+ *     (without consuming \a a) and matching is retried at its target.
+ *   .
+ *  A ::gfsmSigma or ::gfsmRho arc with identical lower and upper labels
+ *  copies the matched label to its upper side; otherwise its upper label is used as-is.
+ *  Upper labels of ::gfsmPhi arcs are ignored.
+ *  Epsilon and reserved input labels only ever match arcs with the same lower label.
+ *
+ *  Implicit arcs are honored on the second argument of compose() and intersect(),
+ *  and on the transducer argument of lookup() and lookup_viterbi() (including their
+ *  ::gfsmPackedAutomaton variants).
+ *  All other algorithms treat them as ordinary labels.
+ */
+
+#ifndef _GFSM_MATCHER_H
+#define _GFSM_MATCHER_H
+
+#include <gfsmAutomaton.h>
+#include <gfsmArcIndex.h>
+#include <gfsmPacked.h>
+#include <gfsmIndexed.h>
+
+/*======================================================================
+ * Types
+ */
+
+/// A single (possibly implicit) arc matching some label
+typedef struct {
+  gfsmStateId  target;  ///< target state
+  gfsmLabelVal upper;   ///< upper label of the match
+  gfsmWeight   weight;  ///< weight of the match, including the weights of any ::gfsmPhi arcs followed
+} gfsmArcMatch;
+
+/** Whether \a lab is one of the reserved labels ::gfsmSigma, ::gfsmRho or ::gfsmPhi */
+#define gfsm_label_is_implicit(lab) ((lab) >= gfsmPhi && (lab) <= gfsmSigma)
+
+/*======================================================================
+ * Methods
+ */
+///\name Matching
+//@{
+
+/** Check whether an arc range sorted primarily on lower labels contains any implicit arcs */
+gboolean gfsm_arcrange_has_implicit(gfsmArcRange *range);
+
+/** Check whether any arc of \a fsm has an implicit lower label */
+gboolean gfsm_automaton_has_implicit_arcs(gfsmAutomaton *fsm);
+
+/** Append all matches for label \a lab from state \a qid of \a tabx to \a matches (a GArray of ::gfsmArcMatch).
+ *  \a tabx must be sorted primarily on lower labels.
+ *  \param sr semiring used to accumulate ::gfsmPhi arc weights
+ *  \returns number of matches appended
+ */
+guint gfsm_matcher_match_table(gfsmArcTableIndex *tabx,
+			       gfsmSemiring      *sr,
+			       gfsmStateId        qid,
+			       gfsmLabelVal       lab,
+			       GArray            *matches);
+
+/** Append all matches for label \a lab from state \a qid of the packed automaton \a pfsm
+ *  to \a matches (a GArray of ::gfsmArcMatch).
+ *  \returns number of matches appended
+ */
+guint gfsm_matcher_match_packed(gfsmPackedAutomaton *pfsm,
+				gfsmStateId          qid,
+				gfsmLabelVal         lab,
+				GArray              *matches);
+
+/** Append all matches for label \a lab from state \a qid of \a fsm to \a matches (a GArray of ::gfsmArcMatch).
+ *  Arcs need not be sorted.
+ *  \returns number of matches appended
+ */
+guint gfsm_matcher_match_state(gfsmAutomaton *fsm,
+			       gfsmStateId    qid,
+			       gfsmLabelVal   lab,
+			       GArray        *matches);
+
+/** Append all matches for label \a lab from state \a qid of the indexed automaton \a xfsm
+ *  to \a matches (a GArray of ::gfsmArcMatch).
+ *  Uses gfsm_matcher_match_table() if the arcs of \a xfsm are sorted primarily on lower labels,
+ *  otherwise scans all arcs of each visited state.
+ *  \returns number of matches appended
+ */
+guint gfsm_matcher_match_indexed(gfsmIndexedAutomaton *xfsm,
+				 gfsmStateId           qid,
+				 gfsmLabelVal          lab,
+				 GArray               *matches);
+
+//@}
+
+#endif /* _GFSM_MATCHER_H */
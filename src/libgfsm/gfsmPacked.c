@@ -0,0 +1,377 @@
+/*=============================================================================*\
+ * File: gfsmPacked.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: packed read-only automata
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmPacked.h>
+#include <gfsmArcIter.h>
+
+#include <math.h>
+#include <stdlib.h>
+
+//-- no-inline definitions
+#ifndef GFSM_INLINE_ENABLED
+# include <gfsmPacked.hi>
+#endif
+
+/*======================================================================
+ * Constants
+ */
+const guint gfsmPackedDefaultWeightBits = 32;
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+//----------------------------------------
+gfsmPackedAutomaton *gfsm_packed_automaton_new(void)
+{
+  gfsmPackedAutomaton *pfsm = gfsm_slice_new0(gfsmPackedAutomaton);
+  pfsm->flags              = gfsmAutomatonDefaultFlags;
+  pfsm->sr                 = gfsm_semiring_new(gfsmAutomatonDefaultSRType);
+  pfsm->root_id            = gfsmNoState;
+  pfsm->state_final_weight = gfsm_weight_vector_new();
+  pfsm->state_is_final     = gfsm_bitvector_new();
+  pfsm->state_first        = g_array_new(FALSE,TRUE,sizeof(guint32));
+  pfsm->codebook           = gfsm_weight_vector_new();
+  pfsm->arcs               = g_byte_array_new();
+  gfsm_packed_automaton_clear(pfsm);
+  return pfsm;
+}
+
+//----------------------------------------
+void gfsm_packed_automaton_clear(gfsmPackedAutomaton *pfsm)
+{
+  guint32 zero = 0;
+  pfsm->root_id      = gfsmNoState;
+  pfsm->target_bytes = 1;
+  pfsm->label_bytes  = 1;
+  pfsm->weight_bytes = 4;
+  pfsm->arc_bytes    = pfsm->target_bytes + 2*pfsm->label_bytes + pfsm->weight_bytes;
+  g_array_set_size(pfsm->state_final_weight,0);
+  gfsm_bitvector_clear(pfsm->state_is_final);
+  g_array_set_size(pfsm->state_first,0);
+  g_array_append_val(pfsm->state_first,zero);
+  g_array_set_size(pfsm->codebook,0);
+  g_byte_array_set_size(pfsm->arcs,0);
+}
+
+//----------------------------------------
+void gfsm_packed_automaton_free(gfsmPackedAutomaton *pfsm)
+{
+  if (!pfsm) return;
+  if (pfsm->sr)                 gfsm_semiring_free(pfsm->sr);
+  if (pfsm->state_final_weight) gfsm_weight_vector_free(pfsm->state_final_weight);
+  if (pfsm->state_is_final)     gfsm_bitvector_free(pfsm->state_is_final);
+  if (pfsm->state_first)        g_array_free(pfsm->state_first,TRUE);
+  if (pfsm->codebook)           gfsm_weight_vector_free(pfsm->codebook);
+  if (pfsm->arcs)               g_byte_array_free(pfsm->arcs,TRUE);
+  gfsm_slice_free(gfsmPackedAutomaton,pfsm);
+}
+
+/*======================================================================
+ * Methods: Import & Export: utilities
+ */
+
+//--------------------------------------------------------------
+// nbytes_(): number of bytes needed to store unsigned value v (at least 1)
+static inline
+guint8 gfsm_packed_nbytes_(guint32 v)
+{
+  if (v < 0x100)     return 1;
+  if (v < 0x10000)   return 2;
+  if (v < 0x1000000) return 3;
+  return 4;
+}
+
+//--------------------------------------------------------------
+// put_uint_(): store unsigned value v at p as n little-endian bytes
+static inline
+void gfsm_packed_put_uint_(guint8 *p, guint32 v, guint n)
+{
+  guint i;
+  for (i=0; i < n; i++, v >>= 8) p[i] = (guint8)(v & 0xff);
+}
+
+//--------------------------------------------------------------
+// weight_compare_(): qsort() comparison for distinct-weight vectors
+static int gfsm_packed_weight_compare_(const void *a, const void *b)
+{
+  gfsmWeight wa = *((const gfsmWeight*)a), wb = *((const gfsmWeight*)b);
+  return (wa < wb ? -1 : (wa > wb ? 1 : 0));
+}
+
+/// codebook construction state for gfsm_automaton_to_packed()
+typedef struct {
+  gboolean  exact;    ///< whether every distinct weight has its own code
+  guint     n_inf;    ///< lossy mode: number of non-finite codes (stored first)
+  gdouble   lo;       ///< lossy mode: least finite weight
+  gdouble   width;    ///< lossy mode: width of each value interval
+  guint     n_bins;   ///< lossy mode: number of value intervals
+} gfsmPackedCodebookInfo;
+
+//--------------------------------------------------------------
+// encode_weight_(): get the code for weight w
+static guint32 gfsm_packed_encode_weight_(gfsmPackedAutomaton *pfsm, gfsmPackedCodebookInfo *cbi, gfsmWeight w)
+{
+  gfsmWeight *cb = (gfsmWeight*)pfsm->codebook->data;
+  guint lo, hi;
+
+  if (cbi->exact || !isfinite(w)) {
+    //-- binary search over the sorted exact codes (or the non-finite prefix)
+    lo = 0;
+    hi = cbi->exact ? pfsm->codebook->len : cbi->n_inf;
+    while (lo < hi) {
+      guint mid = lo + (hi-lo)/2;
+      if (cb[mid] < w) lo = mid+1;
+      else             hi = mid;
+    }
+    return lo;
+  }
+
+  //-- lossy: find value interval
+  lo = (cbi->width > 0 ? (guint)((w - cbi->lo) / cbi->width) : 0);
+  if (lo >= cbi->n_bins) lo = cbi->n_bins-1;
+  return cbi->n_inf + lo;
+}
+
+//--------------------------------------------------------------
+// build_codebook_(): populate pfsm->codebook & pfsm->weight_bytes from arc weights in tab
+static void gfsm_packed_build_codebook_(gfsmPackedAutomaton *pfsm,
+					gfsmPackedCodebookInfo *cbi,
+					gfsmArcTable *tab,
+					guint weight_bits)
+{
+  gfsmWeightVector *distinct = gfsm_weight_vector_sized_new(tab->len);
+  gfsmWeight *dw;
+  guint i, n, max_codes;
+
+  //-- get sorted distinct arc weights
+  for (i=0; i < tab->len; i++) {
+    g_array_append_val(distinct, g_array_index(tab,gfsmArc,i).weight);
+  }
+  qsort(distinct->data, distinct->len, sizeof(gfsmWeight), gfsm_packed_weight_compare_);
+  dw = (gfsmWeight*)distinct->data;
+  for (i=0,n=0; i < distinct->len; i++) {
+    if (n == 0 || dw[i] != dw[n-1]) dw[n++] = dw[i];
+  }
+  g_array_set_size(distinct,n);
+
+  memset(cbi, 0, sizeof(gfsmPackedCodebookInfo));
+  cbi->exact = TRUE;
+  g_array_set_size(pfsm->codebook,0);
+
+  //-- trivial case: all arcs share a single weight (or there are no arcs)
+  if (n <= 1) {
+    gfsmWeight w = n ? dw[0] : pfsm->sr->one;
+    g_array_append_val(pfsm->codebook, w);
+    pfsm->weight_bytes = 0;
+    gfsm_weight_vector_free(distinct);
+    return;
+  }
+
+  //-- raw weights (also if an exact codebook would be no smaller)
+  max_codes = 1U << (weight_bits < 16 ? weight_bits : 16);
+  if ((weight_bits != 8 && weight_bits != 16)
+      || (n <= max_codes && (gsize)n*sizeof(gfsmWeight) >= (gsize)tab->len*(sizeof(gfsmWeight)-gfsm_packed_nbytes_(n-1))))
+  {
+    pfsm->weight_bytes = 4;
+    gfsm_weight_vector_free(distinct);
+    return;
+  }
+
+  if (n <= max_codes) {
+    //-- exact codebook
+    g_array_append_vals(pfsm->codebook, dw, n);
+    pfsm->weight_bytes = gfsm_packed_nbytes_(n-1);
+  }
+  else {
+    //-- lossy codebook: non-finite weights first, then evenly spaced intervals over finite weights
+    gdouble *sums = NULL;
+    guint   *counts = NULL;
+    guint    b;
+    gdouble  hi = 0;
+    gboolean have_finite = FALSE;
+
+    for (i=0; i < n; i++) {
+      if (!isfinite(dw[i])) { g_array_append_val(pfsm->codebook, dw[i]); continue; }
+      if (!have_finite) { cbi->lo = dw[i]; have_finite = TRUE; }
+      hi = dw[i];
+    }
+    cbi->exact  = FALSE;
+    cbi->n_inf  = pfsm->codebook->len;
+    cbi->n_bins = max_codes - cbi->n_inf;
+    cbi->width  = (hi - cbi->lo) / cbi->n_bins;
+
+    //-- codebook entries: mean of all arc weights falling into each interval
+    sums   = g_new0(gdouble, cbi->n_bins);
+    counts = g_new0(guint,   cbi->n_bins);
+    for (i=0; i < tab->len; i++) {
+      gfsmWeight w = g_array_index(tab,gfsmArc,i).weight;
+      if (!isfinite(w)) continue;
+      b = gfsm_packed_encode_weight_(pfsm,cbi,w) - cbi->n_inf;
+      sums[b] += w;
+      ++counts[b];
+    }
+    for (b=0; b < cbi->n_bins; b++) {
+      gfsmWeight w = (counts[b] ? sums[b]/counts[b] : cbi->lo + (b+0.5)*cbi->width);
+      g_array_append_val(pfsm->codebook, w);
+    }
+    g_free(sums);
+    g_free(counts);
+    pfsm->weight_bytes = gfsm_packed_nbytes_(max_codes-1);
+  }
+
+  gfsm_weight_vector_free(distinct);
+}
+
+/*======================================================================
+ * Methods: Import & Export
+ */
+
+//----------------------------------------
+gfsmPackedAutomaton *gfsm_automaton_to_packed(gfsmAutomaton *fsm, gfsmPackedAutomaton *pfsm, guint weight_bits)
+{
+  gfsmArcTableIndex *tabx;
+  gfsmPackedCodebookInfo cbi;
+  gfsmArcCompMask sort_mask = gfsm_acmask_from_args(gfsmACLower,gfsmACUpper,gfsmACNone);
+  gfsmStateId n_states = gfsm_automaton_n_states(fsm), qid;
+  gfsmLabelVal maxlab = 0;
+  guint i;
+  guint8 *p;
+
+  //-- maybe allocate new packed automaton
+  if (pfsm==NULL) pfsm = gfsm_packed_automaton_new();
+  else            gfsm_packed_automaton_clear(pfsm);
+
+  //-- copy: flags, semiring, root
+  pfsm->flags = fsm->flags;
+  pfsm->flags.is_indexed = 0;
+  if (pfsm->sr->type != fsm->sr->type || fsm->sr->type == gfsmSRTUser) {
+    gfsm_semiring_free(pfsm->sr);
+    pfsm->sr = gfsm_semiring_copy(fsm->sr);
+  }
+  pfsm->root_id = fsm->root_id;
+
+  //-- get arcs sorted by (source,lower,upper), using the cached lower-label index if available
+  if ( !(tabx = gfsm_automaton_lookup_arc_index(fsm,gfsmLSLower)) ) {
+    tabx = gfsm_automaton_to_arc_table_index(fsm,NULL);
+    gfsm_arc_table_index_sort_bymask(tabx, sort_mask, NULL);
+  }
+
+  //-- states
+  gfsm_automaton_to_final_weight_vector(fsm, pfsm->state_final_weight);
+  gfsm_bitvector_resize(pfsm->state_is_final, n_states);
+  gfsm_bitvector_zero(pfsm->state_is_final);
+  for (qid=0; qid < n_states; qid++) {
+    if (gfsm_automaton_is_final_state(fsm,qid)) gfsm_bitvector_set(pfsm->state_is_final,qid,TRUE);
+  }
+  g_array_set_size(pfsm->state_first, n_states+1);
+  for (qid=0; qid <= n_states; qid++) {
+    g_array_index(pfsm->state_first,guint32,qid) = (gfsmArc*)g_ptr_array_index(tabx->first,qid) - (gfsmArc*)tabx->tab->data;
+  }
+
+  //-- record layout
+  for (i=0; i < tabx->tab->len; i++) {
+    gfsmArc *a = &g_array_index(tabx->tab,gfsmArc,i);
+    if (a->lower > maxlab) maxlab = a->lower;
+    if (a->upper > maxlab) maxlab = a->upper;
+  }
+  gfsm_packed_build_codebook_(pfsm, &cbi, tabx->tab, weight_bits);
+  pfsm->target_bytes = gfsm_packed_nbytes_(n_states ? n_states-1 : 0);
+  pfsm->label_bytes  = gfsm_packed_nbytes_(maxlab);
+  pfsm->arc_bytes    = pfsm->target_bytes + 2*pfsm->label_bytes + pfsm->weight_bytes;
+
+  //-- arcs
+  g_byte_array_set_size(pfsm->arcs, tabx->tab->len * pfsm->arc_bytes);
+  for (i=0, p=pfsm->arcs->data; i < tabx->tab->len; i++, p += pfsm->arc_bytes) {
+    gfsmArc *a = &g_array_index(tabx->tab,gfsmArc,i);
+    guint8  *pw = p + pfsm->target_bytes + 2*pfsm->label_bytes;
+    gfsm_packed_put_uint_(p,                                         a->target, pfsm->target_bytes);
+    gfsm_packed_put_uint_(p + pfsm->target_bytes,                    a->lower,  pfsm->label_bytes);
+    gfsm_packed_put_uint_(p + pfsm->target_bytes + pfsm->label_bytes, a->upper, pfsm->label_bytes);
+    if (pfsm->weight_bytes == 4) memcpy(pw, &a->weight, sizeof(gfsmWeight));
+    else gfsm_packed_put_uint_(pw, gfsm_packed_encode_weight_(pfsm,&cbi,a->weight), pfsm->weight_bytes);
+  }
+
+  //-- cleanup
+  if (tabx != fsm->index_lower) gfsm_arc_table_index_free(tabx);
+
+  return pfsm;
+}
+
+//----------------------------------------
+gfsmAutomaton *gfsm_packed_to_automaton(gfsmPackedAutomaton *pfsm, gfsmAutomaton *fsm)
+{
+  gfsmStateId qid, n_states = gfsm_packed_automaton_n_states(pfsm);
+  gfsmArc     arc;
+  guint       i;
+
+  //-- maybe allocate new automaton
+  if (fsm==NULL) {
+    fsm = gfsm_automaton_new_full(pfsm->flags, pfsm->sr->type, n_states);
+  } else {
+    gfsm_automaton_clear(fsm);
+    fsm->flags = pfsm->flags;
+    gfsm_automaton_reserve(fsm, n_states);
+  }
+  gfsm_automaton_set_semiring(fsm, pfsm->sr);
+
+  //-- set root id
+  fsm->root_id = pfsm->root_id;
+
+  //-- update state-wise
+  for (qid=0; qid < n_states; qid++) {
+    gfsm_automaton_ensure_state(fsm,qid);
+    if (gfsm_packed_automaton_state_is_final(pfsm,qid)) {
+      gfsm_automaton_set_final_state_full(fsm,qid,TRUE,g_array_index(pfsm->state_final_weight,gfsmWeight,qid));
+    }
+
+    for (i=gfsm_packed_automaton_state_first(pfsm,qid); i < gfsm_packed_automaton_state_first(pfsm,qid+1); i++) {
+      gfsm_packed_arc_decode(pfsm,qid,i,&arc);
+      gfsm_automaton_add_arc(fsm,qid,arc.target,arc.lower,arc.upper,arc.weight);
+    }
+  }
+
+  return fsm;
+}
+
+/*======================================================================
+ * ArcRange
+ */
+
+//----------------------------------------
+void gfsm_arcrange_open_packed(gfsmArcRange *range, gfsmPackedAutomaton *pfsm, gfsmStateId qid, GArray *buf)
+{
+  guint i, i0, deg = gfsm_packed_automaton_out_degree(pfsm,qid);
+  gfsmArc *a;
+
+  g_array_set_size(buf, deg);
+  if (deg == 0) {
+    gfsm_arcrange_close(range);
+    return;
+  }
+  i0 = gfsm_packed_automaton_state_first(pfsm,qid);
+  for (i=0, a=(gfsmArc*)buf->data; i < deg; i++, a++) {
+    gfsm_packed_arc_decode(pfsm, qid, i0+i, a);
+  }
+  range->min = (gfsmArc*)buf->data;
+  range->max = range->min + deg;
+}
@@ -0,0 +1,222 @@
+/*=============================================================================*\
+ * File: gfsmPacked.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: packed read-only automata
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmPacked.h
+ *  \brief Packed read-only automata with compact arc storage
+ *
+ *  A ::gfsmPackedAutomaton stores the arcs of each state as fixed-size byte records
+ *  (target, lower, upper, weight) sorted by (lower,upper), without any source field.
+ *  Targets and labels are stored in as few little-endian bytes as the automaton
+ *  requires.  Weights are stored either as raw ::gfsmWeight values or as 8- or 16-bit
+ *  codes into a per-automaton codebook; if the automaton has more distinct arc weights
+ *  than the requested number of codes, weights are quantized.
+ *
+ *  Packed automata are intended for serving lookups: they cannot be modified in place,
+ *  but can be converted from and to ::gfsmAutomaton.
+ */
+
+#ifndef _GFSM_PACKED_H
+#define _GFSM_PACKED_H
+
+#include <gfsmAutomaton.h>
+#include <gfsmArcIndex.h>
+#include <gfsmBitVector.h>
+#include <string.h>
+
+/*======================================================================
+ * Types
+ */
+
+/// Type for a packed read-only automaton.
+typedef struct {
+  //-- gfsmAutomaton compatibility
+  gfsmAutomatonFlags  flags;              /**< automaton flags, for ::gfsmAutomaton compatibility (stored arcs are always sorted by (lower,upper)) */
+  gfsmSemiring       *sr;                 /**< semiring used for arc weight computations */
+  gfsmStateId         root_id;            /**< id of root state, or gfsmNoState if not defined */
+  //
+  //-- record layout
+  guint8              target_bytes;       /**< bytes per stored arc target (1..4) */
+  guint8              label_bytes;        /**< bytes per stored arc label (1..4) */
+  guint8              weight_bytes;       /**< bytes per stored arc weight: 0 (single codebook entry), 1 or 2 (codebook index), or 4 (raw ::gfsmWeight) */
+  guint8              arc_bytes;          /**< total bytes per stored arc */
+  //
+  //-- data
+  gfsmWeightVector   *state_final_weight; /**< [qid] : final weight of \a qid, or sr->zero */
+  gfsmBitVector      *state_is_final;     /**< [qid] : TRUE iff \a qid is final (independent of its final weight) */
+  GArray             *state_first;        /**< [qid] : index (guint32) of first arc of \a qid; n_states+1 entries */
+  gfsmWeightVector   *codebook;           /**< [code] : arc weight for stored codes; unused if weight_bytes==4 */
+  GByteArray         *arcs;               /**< packed arc records, grouped by source state */
+} gfsmPackedAutomaton;
+
+/*======================================================================
+ * Constants
+ */
+
+/** Default number of bits per stored arc weight for gfsm_automaton_to_packed() (32: no quantization) */
+extern const guint gfsmPackedDefaultWeightBits;
+
+/*======================================================================
+ * Methods: constructors, etc.
+ */
+/// \name Constructors etc.
+//@{
+
+/** Create a new empty ::gfsmPackedAutomaton */
+gfsmPackedAutomaton *gfsm_packed_automaton_new(void);
+
+/** Clear a ::gfsmPackedAutomaton */
+void gfsm_packed_automaton_clear(gfsmPackedAutomaton *pfsm);
+
+/** Free a ::gfsmPackedAutomaton */
+void gfsm_packed_automaton_free(gfsmPackedAutomaton *pfsm);
+
+//@}
+
+/*======================================================================
+ * Methods: Import & Export
+ */
+/// \name Import & Export
+//@{
+
+/** Pack a ::gfsmAutomaton.
+ *  \param fsm source automaton
+ *  \param pfsm destination packed automaton, may be NULL to allocate a new one
+ *  \param weight_bits number of bits per stored arc weight: 8 or 16 to store codebook indices,
+ *         32 (or anything else) to store raw weights.
+ *         If \a fsm has no more distinct arc weights than the requested codebook size,
+ *         all weights are stored exactly; otherwise they are quantized to the means
+ *         of evenly spaced value intervals.
+ *  \returns \a pfsm
+ */
+gfsmPackedAutomaton *gfsm_automaton_to_packed(gfsmAutomaton *fsm, gfsmPackedAutomaton *pfsm, guint weight_bits);
+
+/** Unpack a ::gfsmPackedAutomaton.
+ *  \param pfsm source packed automaton
+ *  \param fsm destination automaton, may be NULL to allocate a new one
+ *  \returns \a fsm
+ */
+gfsmAutomaton *gfsm_packed_to_automaton(gfsmPackedAutomaton *pfsm, gfsmAutomaton *fsm);
+
+//@}
+
+/*======================================================================
+ * Methods: Accessors
+ */
+/// \name Accessors
+//@{
+
+/** Get number of states in \a pfsm */
+GFSM_INLINE
+gfsmStateId gfsm_packed_automaton_n_states(gfsmPackedAutomaton *pfsm);
+
+/** Get number of arcs in \a pfsm */
+GFSM_INLINE
+guint gfsm_packed_automaton_n_arcs(gfsmPackedAutomaton *pfsm);
+
+/** Get root state of \a pfsm */
+GFSM_INLINE
+gfsmStateId gfsm_packed_automaton_get_root(gfsmPackedAutomaton *pfsm);
+
+/** Check whether \a qid is a state of \a pfsm */
+GFSM_INLINE
+gboolean gfsm_packed_automaton_has_state(gfsmPackedAutomaton *pfsm, gfsmStateId qid);
+
+/** Check whether state \a qid of \a pfsm is final */
+GFSM_INLINE
+gboolean gfsm_packed_automaton_state_is_final(gfsmPackedAutomaton *pfsm, gfsmStateId qid);
+
+/** Get final weight of state \a qid of \a pfsm (sr->zero if non-final) */
+GFSM_INLINE
+gfsmWeight gfsm_packed_automaton_get_final_weight(gfsmPackedAutomaton *pfsm, gfsmStateId qid);
+
+/** Get number of outgoing arcs of state \a qid of \a pfsm */
+GFSM_INLINE
+guint gfsm_packed_automaton_out_degree(gfsmPackedAutomaton *pfsm, gfsmStateId qid);
+
+/** Get index of first outgoing arc of state \a qid (one past the last arc of \a qid-1) */
+GFSM_INLINE
+guint gfsm_packed_automaton_state_first(gfsmPackedAutomaton *pfsm, gfsmStateId qid);
+
+/** Get total number of bytes used by \a pfsm for state and arc storage */
+GFSM_INLINE
+gsize gfsm_packed_automaton_size(gfsmPackedAutomaton *pfsm);
+
+//@}
+
+/*======================================================================
+ * Methods: Arc access
+ */
+/// \name Arc access
+//@{
+
+/** Get target state of stored arc \a i */
+GFSM_INLINE
+gfsmStateId gfsm_packed_arc_target(gfsmPackedAutomaton *pfsm, guint i);
+
+/** Get lower label of stored arc \a i */
+GFSM_INLINE
+gfsmLabelVal gfsm_packed_arc_lower(gfsmPackedAutomaton *pfsm, guint i);
+
+/** Get upper label of stored arc \a i */
+GFSM_INLINE
+gfsmLabelVal gfsm_packed_arc_upper(gfsmPackedAutomaton *pfsm, guint i);
+
+/** Get (decoded) weight of stored arc \a i */
+GFSM_INLINE
+gfsmWeight gfsm_packed_arc_weight(gfsmPackedAutomaton *pfsm, guint i);
+
+/** Get stored weight code of arc \a i (0 if \a pfsm->weight_bytes is 0; undefined if it is 4) */
+GFSM_INLINE
+guint32 gfsm_packed_arc_code(gfsmPackedAutomaton *pfsm, guint i);
+
+/** Decode stored arc \a i with source state \a qid into \a arc.  \returns \a arc */
+GFSM_INLINE
+gfsmArc *gfsm_packed_arc_decode(gfsmPackedAutomaton *pfsm, gfsmStateId qid, guint i, gfsmArc *arc);
+
+/** Get index of the first arc of state \a qid whose lower label is at least \a lab
+ *  (binary search; one past the last arc of \a qid if there is none)
+ */
+GFSM_INLINE
+guint gfsm_packed_automaton_seek_lower(gfsmPackedAutomaton *pfsm, gfsmStateId qid, gfsmLabelVal lab);
+
+//@}
+
+/*======================================================================
+ * ArcRange
+ */
+///\name gfsmArcRange interface
+//@{
+
+/** Open a ::gfsmArcRange for outgoing arcs from state \a qid in \a pfsm.
+ *  Arcs of \a qid are decoded into \a buf (a GArray of ::gfsmArc), which is
+ *  resized as needed; the range is valid until \a buf is next modified.
+ */
+void gfsm_arcrange_open_packed(gfsmArcRange *range, gfsmPackedAutomaton *pfsm, gfsmStateId qid, GArray *buf);
+
+//@}
+
+//-- inline definitions
+#ifdef GFSM_INLINE_ENABLED
+# include <gfsmPacked.hi>
+#endif
+
+#endif /* _GFSM_PACKED_H */
@@ -0,0 +1,268 @@
+/*=============================================================================*\
+ * File: gfsmPackedIO.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: packed read-only automata: I/O
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmPackedIO.h>
+#include <gfsmUtils.h>
+
+#include <string.h>
+
+/*======================================================================
+ * Constants: Binary I/O
+ */
+const gfsmVersionInfo gfsm_packed_version_bincompat_min_store =
+  {
+    0,  // major
+    0,  // minor
+    21  // micro: first version which stores explicit final-state bits
+  };
+
+const gchar gfsm_packed_header_magic[16] = "gfsm_packed\0";
+
+/*======================================================================
+ * Methods: Binary I/O: load()
+ */
+
+/*--------------------------------------------------------------
+ * load_bin_header()
+ */
+gboolean gfsm_packed_automaton_load_bin_header(gfsmPackedAutomatonHeader *hdr, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  if (!gfsmio_read(ioh, hdr, sizeof(gfsmPackedAutomatonHeader))) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),
+		g_quark_from_static_string("packed_automaton_load_bin_header:size"),
+		"could not read header");
+    return FALSE;
+  }
+  else if (strcmp(hdr->magic, gfsm_packed_header_magic) != 0) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),
+		g_quark_from_static_string("packed_automaton_load_bin_header:magic"),
+		"bad magic");
+    return FALSE;
+  }
+  else if (gfsm_version_compare(gfsm_version, hdr->version_min) < 0) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),
+		g_quark_from_static_string("packed_automaton_load_bin_header:version"),
+		"libgfsm v%u.%u.%u is obsolete - stored automaton needs at least v%u.%u.%u",
+		gfsm_version.major,
+		gfsm_version.minor,
+		gfsm_version.micro,
+		hdr->version_min.major,
+		hdr->version_min.minor,
+		hdr->version_min.micro);
+    return FALSE;
+  }
+  else if (hdr->target_bytes < 1 || hdr->target_bytes > 4
+	   || hdr->label_bytes < 1 || hdr->label_bytes > 4
+	   || (hdr->weight_bytes > 2 && hdr->weight_bytes != 4)
+	   || (hdr->weight_bytes < 4 && hdr->n_codes == 0)
+	   || hdr->arc_bytes != hdr->target_bytes + 2*hdr->label_bytes + hdr->weight_bytes)
+  {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),
+		g_quark_from_static_string("packed_automaton_load_bin_header:layout"),
+		"bad arc record layout");
+    return FALSE;
+  }
+  if (hdr->srtype == gfsmSRTUnknown || hdr->srtype >= gfsmSRTUser) {
+    //-- compatibility hack
+    hdr->srtype = gfsmAutomatonDefaultSRType;
+  }
+  return TRUE;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_check_(): sanity-check loaded state offsets, targets, and weight codes
+ */
+static gboolean gfsm_packed_automaton_load_bin_check_(gfsmPackedAutomaton *pfsm, gfsmError **errp)
+{
+  gfsmStateId qid, n_states = gfsm_packed_automaton_n_states(pfsm);
+  guint       i, n_arcs = gfsm_packed_automaton_n_arcs(pfsm);
+  const gchar *what = NULL;
+
+  for (qid=0; qid < n_states && !what; qid++) {
+    if (gfsm_packed_automaton_state_first(pfsm,qid) > gfsm_packed_automaton_state_first(pfsm,qid+1))
+      what = "bad state offsets";
+  }
+  if (!what && gfsm_packed_automaton_state_first(pfsm,n_states) != n_arcs)
+    what = "bad state offsets";
+
+  for (i=0; i < n_arcs && !what; i++) {
+    if (gfsm_packed_arc_target(pfsm,i) >= n_states)
+      what = "bad arc target";
+    else if (pfsm->weight_bytes < 4 && gfsm_packed_arc_code(pfsm,i) >= pfsm->codebook->len)
+      what = "bad arc weight code";
+  }
+
+  if (what) {
+    g_set_error(errp,
+		g_quark_from_static_string("gfsm"),
+		g_quark_from_static_string("packed_automaton_load_bin_handle:check"),
+		"%s", what);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_handle()
+ */
+gboolean gfsm_packed_automaton_load_bin_handle(gfsmPackedAutomaton *pfsm, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  gfsmPackedAutomatonHeader hdr;
+  gfsm_packed_automaton_clear(pfsm);
+
+  //-- load header
+  if (!gfsm_packed_automaton_load_bin_header(&hdr,ioh,errp)) return FALSE;
+
+  //-- set automaton-global properties
+  pfsm->flags        = hdr.flags;
+  pfsm->root_id      = hdr.root_id;
+  pfsm->target_bytes = hdr.target_bytes;
+  pfsm->label_bytes  = hdr.label_bytes;
+  pfsm->weight_bytes = hdr.weight_bytes;
+  pfsm->arc_bytes    = hdr.arc_bytes;
+  if (pfsm->sr->type != hdr.srtype) {
+    gfsm_semiring_free(pfsm->sr);
+    pfsm->sr = gfsm_semiring_new(hdr.srtype);
+  }
+
+  //------ load: state_final_weight, state_is_final, codebook
+  if (!gfsm_weight_vector_read_bin_handle(pfsm->state_final_weight, ioh, errp)) { return FALSE; }
+  if (!gfsm_bitvector_read_bin_handle(pfsm->state_is_final, ioh, errp)) { return FALSE; }
+  if (!gfsm_weight_vector_read_bin_handle(pfsm->codebook, ioh, errp)) { return FALSE; }
+
+  //------ load: state offsets, arcs
+  g_array_set_size(pfsm->state_first, hdr.n_states+1);
+  g_byte_array_set_size(pfsm->arcs, (gsize)hdr.n_arcs * hdr.arc_bytes);
+  if (pfsm->state_final_weight->len != hdr.n_states
+      || gfsm_bitvector_size(pfsm->state_is_final) < hdr.n_states
+      || pfsm->codebook->len != hdr.n_codes
+      || !gfsmio_read(ioh, pfsm->state_first->data, (hdr.n_states+1)*sizeof(guint32))
+      || (pfsm->arcs->len > 0 && !gfsmio_read(ioh, pfsm->arcs->data, pfsm->arcs->len)))
+    {
+      g_set_error(errp,
+		  g_quark_from_static_string("gfsm"),
+		  g_quark_from_static_string("packed_automaton_load_bin_handle:data"),
+		  "could not read packed automaton data");
+      return FALSE;
+    }
+
+  return gfsm_packed_automaton_load_bin_check_(pfsm, errp);
+}
+
+/*--------------------------------------------------------------
+ * load_bin_file()
+ */
+gboolean gfsm_packed_automaton_load_bin_file(gfsmPackedAutomaton *pfsm, FILE *f, gfsmError **errp)
+{
+  gfsmIOHandle *ioh = gfsmio_new_zfile(f,"rb",-1);
+  gboolean rc = gfsm_packed_automaton_load_bin_handle(pfsm, ioh, errp);
+  if (ioh) {
+    gfsmio_close(ioh);
+    gfsmio_handle_free(ioh);
+  }
+  return rc;
+}
+
+/*--------------------------------------------------------------
+ * load_bin_filename()
+ */
+gboolean gfsm_packed_automaton_load_bin_filename(gfsmPackedAutomaton *pfsm, const gchar *filename, gfsmError **errp)
+{
+  gfsmIOHandle *ioh = gfsmio_new_filename(filename, "rb", -1, errp);
+  gboolean rc = ioh && !(*errp) && gfsm_packed_automaton_load_bin_handle(pfsm, ioh, errp);
+  if (ioh) {
+    gfsmio_close(ioh);
+    gfsmio_handle_free(ioh);
+  }
+  return rc;
+}
+
+/*======================================================================
+ * Methods: Binary I/O: save()
+ */
+
+/*--------------------------------------------------------------
+ * save_bin_handle()
+ */
+gboolean gfsm_packed_automaton_save_bin_handle(gfsmPackedAutomaton *pfsm, gfsmIOHandle *ioh, gfsmError **errp)
+{
+  gfsmPackedAutomatonHeader hdr;
+
+  //-- create header
+  memset(&hdr, 0, sizeof(gfsmPackedAutomatonHeader));
+  strcpy(hdr.magic, gfsm_packed_header_magic);
+  hdr.version      = gfsm_version;
+  hdr.version_min  = gfsm_packed_version_bincompat_min_store;
+  hdr.flags        = pfsm->flags;
+  hdr.root_id      = pfsm->root_id;
+  hdr.n_states     = gfsm_packed_automaton_n_states(pfsm);
+  hdr.n_arcs       = gfsm_packed_automaton_n_arcs(pfsm);
+  hdr.srtype       = pfsm->sr->type;
+  hdr.n_codes      = pfsm->codebook->len;
+  hdr.target_bytes = pfsm->target_bytes;
+  hdr.label_bytes  = pfsm->label_bytes;
+  hdr.weight_bytes = pfsm->weight_bytes;
+  hdr.arc_bytes    = pfsm->arc_bytes;
+
+  //-- write header
+  if (!gfsmio_write(ioh, &hdr, sizeof(gfsmPackedAutomatonHeader))) {
+    g_set_error(errp, g_quark_from_static_string("gfsm"),
+		      g_quark_from_static_string("packed_automaton_save_bin:header"),
+		      "could not store header");
+    return FALSE;
+  }
+
+  //------ save: state_final_weight, state_is_final, codebook
+  if (!gfsm_weight_vector_write_bin_handle(pfsm->state_final_weight, ioh, errp)) { return FALSE; }
+  if (!gfsm_bitvector_write_bin_handle(pfsm->state_is_final, ioh, errp)) { return FALSE; }
+  if (!gfsm_weight_vector_write_bin_handle(pfsm->codebook, ioh, errp)) { return FALSE; }
+
+  //------ save: state offsets, arcs
+  if (!gfsmio_write(ioh, pfsm->state_first->data, pfsm->state_first->len*sizeof(guint32))
+      || (pfsm->arcs->len > 0 && !gfsmio_write(ioh, pfsm->arcs->data, pfsm->arcs->len)))
+    {
+      g_set_error(errp, g_quark_from_static_string("gfsm"),
+		  g_quark_from_static_string("packed_automaton_save_bin:data"),
+		  "could not store packed automaton data");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+/*--------------------------------------------------------------
+ * save_bin_filename()
+ */
+gboolean gfsm_packed_automaton_save_bin_filename(gfsmPackedAutomaton *pfsm, const gchar *filename, int zlevel, gfsmError **errp)
+{
+  gfsmIOHandle *ioh = gfsmio_new_filename(filename, "wb", zlevel, errp);
+  gboolean rc = ioh && !(*errp) && gfsm_packed_automaton_save_bin_handle(pfsm, ioh, errp);
+  if (ioh) {
+    gfsmio_close(ioh);
+    gfsmio_handle_free(ioh);
+  }
+  return rc;
+}
@@ -0,0 +1,97 @@
+/*=============================================================================*\
+ * File: gfsmPackedIO.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: packed read-only automata: I/O
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmPackedIO.h
+ *  \brief Librarian routines for packed automata.
+ */
+
+#ifndef _GFSM_PACKED_IO_H
+#define _GFSM_PACKED_IO_H
+
+#include <gfsmAutomatonIO.h>
+#include <gfsmPacked.h>
+
+/*======================================================================
+ * Types
+ */
+/// Header info for binary files
+typedef struct {
+  gchar              magic[16];    /**< magic header string "gfsm_packed" */
+  gfsmVersionInfo    version;      /**< gfsm version which created the stored file */
+  gfsmVersionInfo    version_min;  /**< minimum gfsm version required to load the file */
+  gfsmAutomatonFlags flags;        /**< automaton flags */
+  gfsmStateId        root_id;      /**< Id of root node */
+  gfsmStateId        n_states;     /**< number of stored states */
+  guint32            n_arcs;       /**< number of stored arcs */
+  guint32            srtype;       /**< semiring type (cast to ::gfsmSRType) */
+  guint32            n_codes;      /**< number of codebook entries */
+  guint8             target_bytes; /**< bytes per stored arc target */
+  guint8             label_bytes;  /**< bytes per stored arc label */
+  guint8             weight_bytes; /**< bytes per stored arc weight */
+  guint8             arc_bytes;    /**< total bytes per stored arc */
+  guint32            reserved2;    /**< reserved */
+} gfsmPackedAutomatonHeader;
+
+/*======================================================================
+ * Constants
+ */
+
+/** Magic header string for stored ::gfsmPackedAutomaton files */
+extern const gchar gfsm_packed_header_magic[16];
+
+/** Minimum libgfsm version required for loading files stored by this version of libgfsm */
+extern const gfsmVersionInfo gfsm_packed_version_bincompat_min_store;
+
+/*======================================================================
+ * Methods: Binary I/O
+ */
+/// \name Packed Automaton Methods: Binary I/O
+//@{
+
+/** Load a packed automaton header from a stored binary file.
+ *  Returns TRUE iff the header looks valid. */
+gboolean gfsm_packed_automaton_load_bin_header(gfsmPackedAutomatonHeader *hdr, gfsmIOHandle *ioh, gfsmError **errp);
+
+/** Load a packed automaton from a ::gfsmIOHandle (implicitly clear()s \a pfsm).
+ *  Stored arcs are checked for consistency with the stored states and codebook. */
+gboolean gfsm_packed_automaton_load_bin_handle(gfsmPackedAutomaton *pfsm, gfsmIOHandle *ioh, gfsmError **errp);
+
+/** Load a packed automaton from a stored binary file (implicitly clear()s \a pfsm) */
+gboolean gfsm_packed_automaton_load_bin_file(gfsmPackedAutomaton *pfsm, FILE *f, gfsmError **errp);
+
+/** Load a packed automaton from a named binary file (implicitly clear()s \a pfsm) */
+gboolean gfsm_packed_automaton_load_bin_filename(gfsmPackedAutomaton *pfsm, const gchar *filename, gfsmError **errp);
+
+/*--------------------------------------------------------------*/
+
+/** Store a packed automaton in binary form to a gfsmIOHandle* */
+gboolean gfsm_packed_automaton_save_bin_handle(gfsmPackedAutomaton *pfsm, gfsmIOHandle *ioh, gfsmError **errp);
+
+/** Store a packed automaton to a named binary file, possibly compressing.
+ *  Set \a zlevel=-1 for default compression, and
+ *  set \a zlevel=0  for no compression, otherwise should be as for zlib (1 <= zlevel <= 9)
+ */
+gboolean gfsm_packed_automaton_save_bin_filename(gfsmPackedAutomaton *pfsm, const gchar *filename, int zlevel, gfsmError **errp);
+
+//@}
+
+#endif /* _GFSM_PACKED_IO_H */
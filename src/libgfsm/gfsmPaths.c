@@ -24,6 +24,7 @@
 #include <gfsmPaths.h>
 #include <gfsmArc.h>
 #include <gfsmArcIter.h>
+#include <gfsmView.h>
 #include <stdlib.h>
 
 //-- inline definitions
@@ -167,35 +168,21 @@ gfsmSet *gfsm_automaton_paths(gfsmAutomaton *fsm, gfsmSet *paths)
 }
 
 //--------------------------------------------------------------
-gfsmSet *gfsm_automaton_paths_full(gfsmAutomaton *fsm, gfsmSet *paths, gfsmLabelSide which)
-{
-  gfsmPath *tmp = gfsm_path_new(fsm->sr);
-  if (paths==NULL) {
-    paths = gfsm_set_new_full((GCompareDataFunc)gfsm_path_compare_data,
-			      (gpointer)fsm->sr,
-			      (GDestroyNotify)gfsm_path_free);
-  }
-  _gfsm_automaton_paths_r(fsm, paths, which, fsm->root_id, tmp);
-  gfsm_path_free(tmp);
-  return paths;
-}
-
-//--------------------------------------------------------------
-gfsmSet *_gfsm_automaton_paths_r(gfsmAutomaton *fsm,
-				 gfsmSet       *paths,
-				 gfsmLabelSide  which, 
-				 gfsmStateId    q,
-				 gfsmPath      *path)
+// paths_r_(): recursive guts for gfsm_automaton_paths_full() and gfsm_indexed_automaton_paths_full()
+static
+void gfsm_view_paths_r_(gfsmAutomatonView *view,
+			gfsmSet           *paths,
+			gfsmLabelSide      which,
+			gfsmStateId        q,
+			gfsmPath          *path)
 {
-  gfsmArcIter ai;
-  gfsmWeight  fw;
-
-  //-- sanity check
+  gfsmViewArcIter vai;
+  gfsmWeight      fw;
 
   //-- if final state, add to set of full paths
-  if (gfsm_automaton_lookup_final(fsm,q,&fw)) {
+  if (gfsm_view_lookup_final(view,q,&fw)) {
     gfsmWeight path_w = path->w;
-    path->w = gfsm_sr_times(fsm->sr, fw, path_w);
+    path->w = gfsm_sr_times(view->sr, fw, path_w);
 
     if (!gfsm_set_contains(paths,path)) {
       gfsm_set_insert(paths, gfsm_path_new_copy(path));
@@ -204,8 +191,8 @@ gfsmSet *_gfsm_automaton_paths_r(gfsmAutomaton *fsm,
   }
 
   //-- investigate all outgoing arcs
-  for (gfsm_arciter_open(&ai, fsm, q); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
-    gfsmArc    *arc = gfsm_arciter_arc(&ai);
+  for (gfsm_view_arciter_open(&vai, view, q); gfsm_view_arciter_ok(&vai); gfsm_view_arciter_next(&vai)) {
+    gfsmArc    *arc = gfsm_view_arciter_arc(&vai);
     gfsmWeight    w = path->w;
     gfsmLabelVal lo,hi;
 
@@ -220,17 +207,63 @@ gfsmSet *_gfsm_automaton_paths_r(gfsmAutomaton *fsm,
       hi = arc->upper;
     }
 
-    gfsm_path_push(path, lo, hi, arc->weight, fsm->sr);
-    _gfsm_automaton_paths_r(fsm, paths, which, arc->target, path);
+    gfsm_path_push(path, lo, hi, arc->weight, view->sr);
+    gfsm_view_paths_r_(view, paths, which, arc->target, path);
 
     gfsm_path_pop(path, lo, hi);
     path->w = w;
   }
-  gfsm_arciter_close(&ai);
+  gfsm_view_arciter_close(&vai);
+}
 
+//--------------------------------------------------------------
+// paths_full_(): guts for gfsm_automaton_paths_full() and gfsm_indexed_automaton_paths_full()
+static
+gfsmSet *gfsm_view_paths_full_(gfsmAutomatonView *view, gfsmSet *paths, gfsmLabelSide which)
+{
+  gfsmPath *tmp = gfsm_path_new(view->sr);
+  if (paths==NULL) {
+    paths = gfsm_set_new_full((GCompareDataFunc)gfsm_path_compare_data,
+			      (gpointer)view->sr,
+			      (GDestroyNotify)gfsm_path_free);
+  }
+  gfsm_view_paths_r_(view, paths, which, view->root_id, tmp);
+  gfsm_path_free(tmp);
   return paths;
 }
 
+//--------------------------------------------------------------
+gfsmSet *gfsm_automaton_paths_full(gfsmAutomaton *fsm, gfsmSet *paths, gfsmLabelSide which)
+{
+  gfsmAutomatonView view;
+  return gfsm_view_paths_full_(gfsm_automaton_view(&view,fsm), paths, which);
+}
+
+//--------------------------------------------------------------
+gfsmSet *_gfsm_automaton_paths_r(gfsmAutomaton *fsm,
+				 gfsmSet       *paths,
+				 gfsmLabelSide  which, 
+				 gfsmStateId    q,
+				 gfsmPath      *path)
+{
+  gfsmAutomatonView view;
+  gfsm_view_paths_r_(gfsm_automaton_view(&view,fsm), paths, which, q, path);
+  return paths;
+}
+
+//--------------------------------------------------------------
+gfsmSet *gfsm_indexed_automaton_paths(gfsmIndexedAutomaton *xfsm, gfsmSet *paths)
+{
+  return gfsm_indexed_automaton_paths_full(xfsm, paths, (xfsm->flags.is_transducer ? gfsmLSBoth : gfsmLSLower));
+}
+
+//--------------------------------------------------------------
+gfsmSet *gfsm_indexed_automaton_paths_full(gfsmIndexedAutomaton *xfsm, gfsmSet *paths, gfsmLabelSide which)
+{
+  gfsmAutomatonView view;
+  return gfsm_view_paths_full_(gfsm_indexed_automaton_view(&view,xfsm), paths, which);
+}
+
 /*======================================================================
  * Methods: Automaton Serialization: paths_to_strings()
  */
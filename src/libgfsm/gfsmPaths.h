@@ -28,6 +28,7 @@
 #define _GFSM_PATHS_H
 
 #include <gfsmAutomaton.h>
+#include <gfsmIndexed.h>
 
 /*======================================================================
  * Types: paths
@@ -148,6 +149,12 @@ gfsmSet *_gfsm_automaton_paths_r(gfsmAutomaton *fsm,
 				 gfsmStateId    q,
 				 gfsmPath      *path);
 
+/** Like gfsm_automaton_paths(), but for an indexed automaton \a xfsm, which is accessed in place */
+gfsmSet *gfsm_indexed_automaton_paths(gfsmIndexedAutomaton *xfsm, gfsmSet *paths);
+
+/** Like gfsm_automaton_paths_full(), but for an indexed automaton \a xfsm, which is accessed in place */
+gfsmSet *gfsm_indexed_automaton_paths_full(gfsmIndexedAutomaton *xfsm, gfsmSet *paths, gfsmLabelSide which);
+
 
 //------------------------------
 /** Convert a gfsmPathSet to a list of (char*)s.
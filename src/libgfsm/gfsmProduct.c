@@ -54,6 +54,7 @@ gfsmAutomaton *gfsm_automaton_product2(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2)
   gfsmArc     *a;
 
   //-- chuck out all upper-labels from fsm1
+  gfsm_automaton_touch(fsm1);
   for (qid=0; qid < fsm1->states->len; qid++) {
     qp = gfsm_automaton_find_state(fsm1,qid);
     if (!qp || !qp->is_valid) continue;
@@ -63,7 +64,8 @@ gfsmAutomaton *gfsm_automaton_product2(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2)
     }
   }
 
-  //-- chuck out all upper-labels from fsm2
+  //-- chuck out all lower-labels from fsm2
+  gfsm_automaton_touch(fsm2);
   for (qid=0; qid < fsm2->states->len; qid++) {
     qp = gfsm_automaton_find_state(fsm2,qid);
     if (!qp || !qp->is_valid) continue;
@@ -43,6 +43,7 @@ gfsmAutomaton *gfsm_automaton_invert(gfsmAutomaton *fsm)
   gint aci;
 
   //-- invert arcs
+  gfsm_automaton_touch(fsm);
   for (id=0; id < fsm->states->len; id++) {
     for (gfsm_arciter_open(&ai,fsm,id); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
       gfsmArc *a = gfsm_arciter_arc(&ai);
@@ -81,6 +82,7 @@ gfsmAutomaton *gfsm_automaton_project(gfsmAutomaton *fsm, gfsmLabelSide which)
 
   if (which==gfsmLSBoth) return fsm;
 
+  gfsm_automaton_touch(fsm);
   for (id=0; id < fsm->states->len; id++) {
     for (gfsm_arciter_open(&ai,fsm,id); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
       gfsmArc *a = gfsm_arciter_arc(&ai);
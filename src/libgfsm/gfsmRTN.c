@@ -0,0 +1,529 @@
+/*=============================================================================*\
+ * File: gfsmRTN.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: delayed replacement (recursive transition networks)
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmRTN.h>
+#include <gfsmArcIter.h>
+#include <gfsmArcIndex.h>
+#include <gfsmLookup.h>
+#include <gfsmEnum.h>
+
+/*======================================================================
+ * Constants
+ */
+const guint32 gfsmRTNDefaultMaxDepth = 1;
+
+/*======================================================================
+ * Utilities
+ */
+
+//--------------------------------------------------------------
+static gfsmAutomaton *gfsm_rtn_frame_fsm_(gfsmRTN *rtn, const gfsmRTNFrame *fr)
+{
+  return (fr->rule == 0
+	  ? rtn->root
+	  : g_array_index(rtn->rules, gfsmRTNRule, fr->rule-1).fsm);
+}
+
+//--------------------------------------------------------------
+/** get 1 + index of the first rule matching arc \a a, or 0 if no rule matches */
+static guint32 gfsm_rtn_match_rule_(gfsmRTN *rtn, const gfsmArc *a)
+{
+  guint32 i;
+  for (i=0; i < rtn->rules->len; i++) {
+    const gfsmRTNRule *r = &g_array_index(rtn->rules, gfsmRTNRule, i);
+    if ((r->lo == gfsmNoLabel || r->lo == a->lower) && (r->hi == gfsmNoLabel || r->hi == a->upper))
+      return i+1;
+  }
+  return 0;
+}
+
+//--------------------------------------------------------------
+/** check whether rule \a rule is active in frame \a fid or any of its callers */
+static gboolean gfsm_rtn_rule_active_(gfsmRTN *rtn, guint32 fid, guint32 rule)
+{
+  for ( ; fid != 0; fid = g_array_index(rtn->frames, gfsmRTNFrame, fid).parent) {
+    if (g_array_index(rtn->frames, gfsmRTNFrame, fid).rule == rule) return TRUE;
+  }
+  return FALSE;
+}
+
+//--------------------------------------------------------------
+/** get (interned) id of the frame calling rule \a rule from frame \a parent, returning to \a ret */
+static guint32 gfsm_rtn_frame_id_(gfsmRTN *rtn, guint32 parent, guint32 rule, gfsmStateId ret)
+{
+  gfsmStatePair site = { rule, ret };
+  gfsmStatePair key;
+  guint32       fid;
+
+  key.id1 = parent;
+  key.id2 = gfsm_enum_lookup(rtn->sites, &site);
+  if (key.id2 == gfsmEnumNone) {
+    key.id2 = gfsm_enum_insert(rtn->sites, &site);
+  }
+
+  fid = gfsm_enum_lookup(rtn->frame2id, &key);
+  if (fid == gfsmEnumNone) {
+    gfsmRTNFrame fr;
+    fr.parent = parent;
+    fr.rule   = rule;
+    fr.ret    = ret;
+    fr.depth  = g_array_index(rtn->frames, gfsmRTNFrame, parent).depth + 1;
+    fid       = rtn->frames->len;
+    g_array_append_val(rtn->frames, fr);
+    gfsm_enum_insert_full(rtn->frame2id, &key, fid);
+  }
+  return fid;
+}
+
+//--------------------------------------------------------------
+/** get (interned) cache state id for configuration (\a fid, \a qid) */
+static gfsmStateId gfsm_rtn_config_id_(gfsmRTN *rtn, guint32 fid, gfsmStateId qid)
+{
+  gfsmStatePair cfg = { fid, qid };
+  gfsmStateId   cid = gfsm_enum_lookup(rtn->config2id, &cfg);
+  if (cid == gfsmEnumNone) {
+    cid = gfsm_automaton_add_state(rtn->cache);
+    gfsm_enum_insert_full(rtn->config2id, &cfg, cid);
+    if (cid >= rtn->configs->len) g_array_set_size(rtn->configs, cid+1);
+    g_array_index(rtn->configs, gfsmStatePair, cid) = cfg;
+  }
+  return cid;
+}
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+//--------------------------------------------------------------
+gfsmRTN *gfsm_rtn_new(gfsmAutomaton *root, guint32 max_depth)
+{
+  gfsmRTN *rtn = g_new0(gfsmRTN,1);
+  rtn->root      = root;
+  rtn->max_depth = max_depth;
+  rtn->rules     = g_array_new(FALSE,FALSE,sizeof(gfsmRTNRule));
+  rtn->frames    = g_array_new(FALSE,FALSE,sizeof(gfsmRTNFrame));
+  rtn->sites     = gfsm_statepair_enum_new();
+  rtn->frame2id  = gfsm_statepair_enum_new();
+  rtn->configs   = g_array_sized_new(FALSE,FALSE,sizeof(gfsmStatePair),gfsmAutomatonDefaultSize);
+  rtn->config2id = gfsm_statepair_enum_new();
+  rtn->cache     = gfsm_automaton_shadow(root);
+  rtn->expanded  = gfsm_bitvector_new();
+  gfsm_rtn_clear_cache(rtn);
+  return rtn;
+}
+
+//--------------------------------------------------------------
+void gfsm_rtn_add_rule(gfsmRTN *rtn, gfsmLabelVal lo, gfsmLabelVal hi, gfsmAutomaton *fsm)
+{
+  gfsmRTNRule r = { lo, hi, fsm };
+  g_array_append_val(rtn->rules, r);
+  gfsm_rtn_clear_cache(rtn);
+}
+
+//--------------------------------------------------------------
+void gfsm_rtn_clear_cache(gfsmRTN *rtn)
+{
+  gfsmRTNFrame root_frame = { 0, 0, gfsmNoState, 0 };
+
+  g_array_set_size(rtn->frames, 0);
+  g_array_append_val(rtn->frames, root_frame);
+  gfsm_enum_clear(rtn->sites);
+  gfsm_enum_clear(rtn->frame2id);
+  g_array_set_size(rtn->configs, 0);
+  gfsm_enum_clear(rtn->config2id);
+  gfsm_automaton_clear(rtn->cache);
+  rtn->cache->flags.sort_mode     = gfsmASMNone;
+  rtn->cache->flags.is_transducer = TRUE;
+  gfsm_bitvector_clear(rtn->expanded);
+  g_clear_error(&rtn->error);
+}
+
+//--------------------------------------------------------------
+void gfsm_rtn_free(gfsmRTN *rtn)
+{
+  if (!rtn) return;
+  g_array_free(rtn->rules,TRUE);
+  g_array_free(rtn->frames,TRUE);
+  gfsm_enum_free(rtn->sites);
+  gfsm_enum_free(rtn->frame2id);
+  g_array_free(rtn->configs,TRUE);
+  gfsm_enum_free(rtn->config2id);
+  gfsm_automaton_free(rtn->cache);
+  gfsm_bitvector_free(rtn->expanded);
+  if (rtn->error) g_error_free(rtn->error);
+  g_free(rtn);
+}
+
+/*======================================================================
+ * Expansion
+ */
+
+//--------------------------------------------------------------
+gfsmStateId gfsm_rtn_root(gfsmRTN *rtn)
+{
+  if (rtn->root->root_id == gfsmNoState) return gfsmNoState;
+  rtn->cache->root_id = gfsm_rtn_config_id_(rtn, 0, rtn->root->root_id);
+  return rtn->cache->root_id;
+}
+
+//--------------------------------------------------------------
+gfsmState *gfsm_rtn_expand_state(gfsmRTN *rtn, gfsmStateId cid)
+{
+  gfsmStatePair  cfg;
+  gfsmRTNFrame   fr;
+  gfsmAutomaton *fsm;
+  gfsmArcIter    ai;
+  gfsmWeight     fw;
+  gboolean       can_call;
+
+  if (cid == gfsmNoState || cid >= rtn->configs->len) return NULL;
+  if (gfsm_bitvector_get(rtn->expanded, cid)) return gfsm_automaton_find_state(rtn->cache, cid);
+  gfsm_bitvector_set(rtn->expanded, cid, TRUE);
+
+  //-- copy config & frame: underlying arrays may grow during expansion
+  cfg = g_array_index(rtn->configs, gfsmStatePair, cid);
+  fr  = g_array_index(rtn->frames, gfsmRTNFrame, cfg.id1);
+  fsm = gfsm_rtn_frame_fsm_(rtn, &fr);
+  can_call = (rtn->max_depth == 0 || fr.depth < rtn->max_depth);
+
+  if (!gfsm_automaton_has_state(fsm, cfg.id2)) return gfsm_automaton_find_state(rtn->cache, cid);
+
+  //-- arcs: calls push a new frame, everything else stays in the current one
+  for (gfsm_arciter_open(&ai, fsm, cfg.id2); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+    gfsmArc *a    = gfsm_arciter_arc(&ai);
+    guint32  rule = can_call ? gfsm_rtn_match_rule_(rtn, a) : 0;
+
+    if (rule) {
+      gfsmAutomaton *sub = g_array_index(rtn->rules, gfsmRTNRule, rule-1).fsm;
+      guint32        fid;
+      if (sub->root_id == gfsmNoState) continue; //-- empty sub-automaton: no path through this arc
+      if (rtn->max_depth == 0 && gfsm_rtn_rule_active_(rtn, cfg.id1, rule)) {
+	//-- recursion without a depth limit: the expansion would be infinite
+	if (!rtn->error)
+	  g_set_error(&rtn->error,
+		      g_quark_from_static_string("gfsm"),
+		      g_quark_from_static_string("rtn_expand_state:recursive"),
+		      "recursive call to replacement rule %u with unlimited depth", rule-1);
+	continue;
+      }
+      fid = gfsm_rtn_frame_id_(rtn, cfg.id1, rule, a->target);
+      gfsm_automaton_add_arc(rtn->cache, cid, gfsm_rtn_config_id_(rtn, fid, sub->root_id),
+			     gfsmEpsilon, gfsmEpsilon, a->weight);
+    } else {
+      gfsm_automaton_add_arc(rtn->cache, cid, gfsm_rtn_config_id_(rtn, cfg.id1, a->target),
+			     a->lower, a->upper, a->weight);
+    }
+  }
+  gfsm_arciter_close(&ai);
+
+  //-- final states: accept in the root frame, return to the caller otherwise
+  if (gfsm_automaton_lookup_final(fsm, cfg.id2, &fw)) {
+    if (cfg.id1 == 0) {
+      gfsm_automaton_set_final_state_full(rtn->cache, cid, TRUE, fw);
+    } else {
+      gfsm_automaton_add_arc(rtn->cache, cid, gfsm_rtn_config_id_(rtn, fr.parent, fr.ret),
+			     gfsmEpsilon, gfsmEpsilon, fw);
+    }
+  }
+
+  return gfsm_automaton_find_state(rtn->cache, cid);
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_rtn_expand(gfsmRTN *rtn, gfsmAutomaton *result)
+{
+  gfsmStateId cid;
+
+  //-- configurations are only ever created by expanding their predecessors,
+  //   so expanding all of them in id order is a breadth-first traversal from the root
+  for (cid = gfsm_rtn_root(rtn); cid != gfsmNoState && cid < rtn->configs->len; cid++) {
+    gfsm_rtn_expand_state(rtn, cid);
+  }
+
+  if (result == NULL) result = gfsm_automaton_new();
+  gfsm_automaton_copy(result, rtn->cache);
+  return result;
+}
+
+/*======================================================================
+ * Algorithms: lookup
+ */
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_rtn_lookup_full(gfsmRTN           *rtn,
+				    gfsmLabelVector   *input,
+				    gfsmAutomaton     *result,
+				    gfsmStateId        max_result_states)
+{
+  GSList           *stack = NULL;
+  gfsmLookupConfig *cfg;
+  gfsmLookupConfig *cfg_new;
+  gfsmState        *qt;
+  gfsmArcList      *al;
+  gfsmLabelVal      a;
+  gfsmWeight        fw;
+
+  //-- ensure result automaton exists and is clear
+  if (result==NULL) {
+    result = gfsm_automaton_shadow(rtn->root);
+  } else {
+    gfsm_automaton_clear(result);
+  }
+  result->flags.is_transducer = TRUE;
+
+  //-- initialization
+  result->root_id = gfsm_automaton_add_state(result);
+  if (gfsm_rtn_root(rtn) == gfsmNoState) return result;
+  cfg = (gfsmLookupConfig*)gfsm_slice_new(gfsmLookupConfig);
+  cfg->qt = rtn->cache->root_id;
+  cfg->qr = result->root_id;
+  cfg->i  = 0;
+  stack = g_slist_prepend(stack, cfg);
+
+  //-- ye olde loope
+  while (stack != NULL) {
+    //-- pop the top element off the stack
+    cfg   = (gfsmLookupConfig*)(stack->data);
+    stack = g_slist_delete_link(stack, stack);
+
+    //-- get states (expanding on demand)
+    qt = gfsm_rtn_expand_state(rtn, cfg->qt);
+    a  = (cfg->i < input->len
+	  ? (gfsmLabelVal)GPOINTER_TO_UINT(g_ptr_array_index(input, cfg->i))
+	  : gfsmNoLabel);
+
+    //-- check for final states
+    if (cfg->i >= input->len && gfsm_automaton_lookup_final(rtn->cache, cfg->qt, &fw)) {
+      gfsm_automaton_set_final_state_full(result, cfg->qr, TRUE, fw);
+    }
+
+    //-- handle outgoing arcs
+    for (al = (qt ? qt->arcs : NULL); al != NULL; al = al->next) {
+      gfsmArc *arc = &(al->arc);
+
+      if (arc->lower == gfsmEpsilon || (a != gfsmNoLabel && arc->lower == a)) {
+	cfg_new = (gfsmLookupConfig*)gfsm_slice_new(gfsmLookupConfig);
+	cfg_new->qt = arc->target;
+	cfg_new->qr = gfsm_automaton_add_state(result);
+	cfg_new->i  = (arc->lower == gfsmEpsilon ? cfg->i : cfg->i+1);
+	gfsm_automaton_add_arc(result, cfg->qr, cfg_new->qr, arc->lower, arc->upper, arc->weight);
+	stack = g_slist_prepend(stack, cfg_new);
+      }
+    }
+
+    //-- we're done with this config
+    gfsm_slice_free(gfsmLookupConfig,cfg);
+
+    //-- check state-limit threshhold
+    if (gfsm_automaton_n_states(result) >= max_result_states) {
+      g_printerr("gfsm_rtn_lookup(): Warning: maximum number of result-states (%u) exceeded, aborting lookup\n", max_result_states);
+      break;
+    }
+  }
+
+  //-- ensure stack is empty
+  while (stack != NULL) {
+    gfsm_slice_free(gfsmLookupConfig,(gfsmLookupConfig*)(stack->data));
+    stack = g_slist_delete_link(stack, stack);
+  }
+
+  return result;
+}
+
+/*======================================================================
+ * Algorithms: paths
+ */
+
+//--------------------------------------------------------------
+static void gfsm_rtn_paths_r_(gfsmRTN *rtn, gfsmSet *paths, gfsmLabelSide which, gfsmStateId cid, gfsmPath *path)
+{
+  gfsmSemiring *sr = rtn->cache->sr;
+  gfsmState    *q  = gfsm_rtn_expand_state(rtn, cid);
+  gfsmArcList  *al;
+  gfsmWeight    fw;
+
+  if (!q) return;
+
+  //-- if final state, add to set of full paths
+  if (gfsm_automaton_lookup_final(rtn->cache, cid, &fw)) {
+    gfsmWeight path_w = path->w;
+    path->w = gfsm_sr_times(sr, fw, path_w);
+    if (!gfsm_set_contains(paths,path)) {
+      gfsm_set_insert(paths, gfsm_path_new_copy(path));
+    }
+    path->w = path_w;
+  }
+
+  //-- investigate all outgoing arcs (arc list nodes stay put while other states are expanded)
+  for (al = q->arcs; al != NULL; al = al->next) {
+    gfsmArc     *arc = &(al->arc);
+    gfsmWeight     w = path->w;
+    gfsmLabelVal lo = (which==gfsmLSUpper ? gfsmEpsilon : arc->lower);
+    gfsmLabelVal hi = (which==gfsmLSLower ? gfsmEpsilon : arc->upper);
+
+    gfsm_path_push(path, lo, hi, arc->weight, sr);
+    gfsm_rtn_paths_r_(rtn, paths, which, arc->target, path);
+    gfsm_path_pop(path, lo, hi);
+    path->w = w;
+  }
+}
+
+//--------------------------------------------------------------
+gfsmSet *gfsm_rtn_paths_full(gfsmRTN *rtn, gfsmSet *paths, gfsmLabelSide which)
+{
+  gfsmPath *tmp = gfsm_path_new(rtn->cache->sr);
+  if (paths==NULL) {
+    paths = gfsm_set_new_full((GCompareDataFunc)gfsm_path_compare_data,
+			      (gpointer)rtn->cache->sr,
+			      (GDestroyNotify)gfsm_path_free);
+  }
+  gfsm_rtn_paths_r_(rtn, paths, which, gfsm_rtn_root(rtn), tmp);
+  gfsm_path_free(tmp);
+  return paths;
+}
+
+/*======================================================================
+ * Algorithms: compose
+ */
+
+//--------------------------------------------------------------
+static gfsmStateId gfsm_rtn_compose_qid_(gfsmAutomaton *fsm, gfsmComposeState sp, GQueue *queue,
+					 gfsmComposeStateEnum *spenum, GArray *spenumr)
+{
+  gfsmStateId qid = gfsm_enum_lookup(spenum,&sp);
+  if (qid==gfsmEnumNone) {
+    qid = gfsm_automaton_add_state(fsm);
+    gfsm_enum_insert_full(spenum, &sp, qid);
+    if (qid >= spenumr->len) g_array_set_size(spenumr,qid+1);
+    g_array_index(spenumr, gfsmComposeState, qid) = sp;
+    g_queue_push_tail(queue, GUINT_TO_POINTER(qid));
+  }
+  return qid;
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_rtn_compose_full(gfsmRTN *rtn, gfsmAutomaton *fsm2, gfsmAutomaton *composition)
+{
+  gfsmComposeStateEnum *spenum  = gfsm_compose_state_enum_new();
+  GArray               *spenumr = g_array_sized_new(FALSE,FALSE,sizeof(gfsmComposeState),gfsmAutomatonDefaultSize);
+  GQueue               *queue   = g_queue_new();
+  gfsmArcTableIndex    *tabx2;
+  gfsmSemiring         *sr;
+  gfsmStateId           rootid;
+
+  //-- setup: output fsm
+  if (!composition) {
+    composition = gfsm_automaton_shadow(rtn->root);
+  } else {
+    gfsm_automaton_clear(composition);
+    gfsm_automaton_copy_shallow(composition, rtn->root);
+  }
+  composition->flags.sort_mode     = gfsmASMNone;
+  composition->flags.is_transducer = 1;
+  sr = composition->sr;
+
+  //-- setup: fsm2 arcs sorted on lower labels
+  if (!(tabx2 = gfsm_automaton_lookup_arc_index(fsm2,gfsmLSLower))) {
+    tabx2 = gfsm_automaton_to_arc_table_index(fsm2,NULL);
+    if (gfsm_acmask_nth(fsm2->flags.sort_mode,0) != gfsmACLower) gfsm_arc_table_index_sort_bymask(tabx2, gfsmACLower, NULL);
+  }
+
+  //-- setup: root
+  if (gfsm_rtn_root(rtn) != gfsmNoState && fsm2->root_id != gfsmNoState) {
+    rootid = gfsm_rtn_compose_qid_(composition, (gfsmComposeState){rtn->cache->root_id, fsm2->root_id, 0},
+				   queue, spenum, spenumr);
+    gfsm_automaton_set_root(composition, rootid);
+  }
+
+  //-- guts: same 3-state epsilon filter as gfsm_automaton_compose_visit_()
+  while (!g_queue_is_empty(queue)) {
+    gfsmStateId      qid = GPOINTER_TO_UINT(g_queue_pop_head(queue));
+    gfsmComposeState sp  = g_array_index(spenumr, gfsmComposeState, qid);
+    gfsmState       *q1  = gfsm_rtn_expand_state(rtn, sp.id1);
+    gfsmState       *q2  = gfsm_automaton_find_state(fsm2, sp.id2);
+    gfsmArcRange     r2, r2eps, r2lab;
+    gfsmArcList     *al;
+    gfsmArc         *a1, *a2;
+    gfsmWeight       fw1, fw2;
+
+    if ( !(q1 && q2 && q1->is_valid && q2->is_valid) ) continue;
+
+    //-- check for final states
+    if (gfsm_automaton_lookup_final(rtn->cache, sp.id1, &fw1) && gfsm_automaton_lookup_final(fsm2, sp.id2, &fw2)) {
+      gfsm_automaton_set_final_state_full(composition, qid, TRUE, gfsm_sr_times(sr, fw1, fw2));
+    }
+
+    //-- split off epsilon arcs of fsm2
+    gfsm_arcrange_open_table_index(&r2, tabx2, sp.id2);
+    r2eps = r2;
+    gfsm_arcrange_seek_lower(&r2, gfsmEpsilon+1);
+    r2eps.max = r2.min;
+
+    //-- (NULL,eps): fsm2 moves alone
+    if (sp.idf != 2) {
+      for (a2=r2eps.min; a2 < r2eps.max; a2++) {
+	gfsm_automaton_add_arc(composition, qid,
+			       gfsm_rtn_compose_qid_(composition, (gfsmComposeState){sp.id1, a2->target, 1}, queue,spenum,spenumr),
+			       gfsmEpsilon, a2->upper, a2->weight);
+      }
+    }
+
+    //-- arcs of the (unsorted) expanded rtn state
+    for (al = q1->arcs; al != NULL; al = al->next) {
+      a1 = &(al->arc);
+      if (a1->upper == gfsmEpsilon) {
+	//-- (eps,NULL): rtn moves alone
+	if (sp.idf != 1) {
+	  gfsm_automaton_add_arc(composition, qid,
+				 gfsm_rtn_compose_qid_(composition, (gfsmComposeState){a1->target, sp.id2, 2}, queue,spenum,spenumr),
+				 a1->lower, gfsmEpsilon, a1->weight);
+	}
+	//-- (eps,eps): both move
+	if (sp.idf == 0) {
+	  for (a2=r2eps.min; a2 < r2eps.max; a2++) {
+	    gfsm_automaton_add_arc(composition, qid,
+				   gfsm_rtn_compose_qid_(composition, (gfsmComposeState){a1->target, a2->target, 0}, queue,spenum,spenumr),
+				   a1->lower, a2->upper, gfsm_sr_times(sr, a1->weight, a2->weight));
+	  }
+	}
+	continue;
+      }
+
+      //-- non-eps: (a1->upper == a2->lower)
+      r2lab = r2;
+      gfsm_arcrange_gallop_lower(&r2lab, a1->upper);
+      for (a2=r2lab.min; a2 < r2lab.max && a2->lower == a1->upper; a2++) {
+	gfsm_automaton_add_arc(composition, qid,
+			       gfsm_rtn_compose_qid_(composition, (gfsmComposeState){a1->target, a2->target, 0}, queue,spenum,spenumr),
+			       a1->lower, a2->upper, gfsm_sr_times(sr, a1->weight, a2->weight));
+      }
+    }
+  }
+
+  //-- cleanup
+  gfsm_enum_free(spenum);
+  g_array_free(spenumr,TRUE);
+  g_queue_free(queue);
+  if (tabx2 != fsm2->index_lower) gfsm_arc_table_index_free(tabx2);
+
+  return composition;
+}
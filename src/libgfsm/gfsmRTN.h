@@ -0,0 +1,156 @@
+/*=============================================================================*\
+ * File: gfsmRTN.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: delayed replacement (recursive transition networks)
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmRTN.h
+ *  \brief Delayed replacement: recursive transition networks
+ *
+ *  A ::gfsmRTN represents the result of replacing "call" arcs in a root
+ *  automaton by sub-automata (as gfsm_automaton_replace() does), without
+ *  copying any sub-automaton.  States of the replaced automaton are
+ *  configurations (call stack, state), which are expanded on demand into
+ *  an internal cache automaton as algorithms visit them.
+ */
+
+#ifndef _GFSM_RTN_H
+#define _GFSM_RTN_H
+
+#include <gfsmAutomaton.h>
+#include <gfsmCompound.h>
+#include <gfsmBitVector.h>
+#include <gfsmPaths.h>
+#include <gfsmError.h>
+
+/*======================================================================
+ * Types
+ */
+
+/// Replacement rule for a ::gfsmRTN
+typedef struct {
+  gfsmLabelVal   lo;   ///< lower label of call arcs, or ::gfsmNoLabel to ignore lower labels
+  gfsmLabelVal   hi;   ///< upper label of call arcs, or ::gfsmNoLabel to ignore upper labels
+  gfsmAutomaton *fsm;  ///< sub-automaton replacing matching arcs (not owned by the RTN)
+} gfsmRTNRule;
+
+/// Call stack frame for a ::gfsmRTN (interned; frame 0 is the root automaton)
+typedef struct {
+  guint32      parent;  ///< caller frame
+  guint32      rule;    ///< 1 + index of the called rule, or 0 for the root frame
+  gfsmStateId  ret;     ///< return state in the caller's automaton
+  guint32      depth;   ///< number of active calls
+} gfsmRTNFrame;
+
+/// Recursive transition network with an on-demand expansion cache
+typedef struct {
+  gfsmAutomaton     *root;      ///< root automaton (not owned)
+  GArray            *rules;     ///< replacement rules (gfsmRTNRule), tried in order
+  guint32            max_depth; ///< maximum call depth, or 0 for no limit; deeper call arcs are kept literally
+  GArray            *frames;    ///< interned call stack frames (gfsmRTNFrame)
+  gfsmStatePairEnum *sites;     ///< maps (rule, ret) pairs to call-site ids
+  gfsmStatePairEnum *frame2id;  ///< maps (parent, site) pairs to frame ids
+  GArray            *configs;   ///< [cid] : configuration (gfsmStatePair: id1=frame, id2=state)
+  gfsmStatePairEnum *config2id; ///< maps configurations to cache state ids
+  gfsmAutomaton     *cache;     ///< expanded configurations
+  gfsmBitVector     *expanded;  ///< [cid] : whether the arcs of configuration cid have been expanded
+  gfsmError         *error;     ///< first expansion error (recursive call without a depth limit), or NULL
+} gfsmRTN;
+
+/// default call depth limit for gfsmreplace and friends
+extern const guint32 gfsmRTNDefaultMaxDepth;
+
+/*======================================================================
+ * Constructors etc.
+ */
+///\name Constructors etc.
+//@{
+
+/** Create a new ::gfsmRTN over root automaton \a root with call depth limit \a max_depth (0: unlimited).
+ *  With \a max_depth 0, a call to a rule which is already active in a calling frame
+ *  would never terminate: such calls are dropped and \a rtn->error is set on expansion.
+ */
+gfsmRTN *gfsm_rtn_new(gfsmAutomaton *root, guint32 max_depth);
+
+/** Add a replacement rule to \a rtn: arcs labelled \a lo:hi are replaced by calls to \a fsm.
+ *  Clears the expansion cache.
+ */
+void gfsm_rtn_add_rule(gfsmRTN *rtn, gfsmLabelVal lo, gfsmLabelVal hi, gfsmAutomaton *fsm);
+
+/** Discard all expanded configurations and any expansion error */
+void gfsm_rtn_clear_cache(gfsmRTN *rtn);
+
+/** Free \a rtn (but not its root or sub-automata) */
+void gfsm_rtn_free(gfsmRTN *rtn);
+
+//@}
+
+/*======================================================================
+ * Expansion
+ */
+///\name Expansion
+//@{
+
+/** Get the cache state id of the root configuration of \a rtn */
+gfsmStateId gfsm_rtn_root(gfsmRTN *rtn);
+
+/** Ensure that the outgoing arcs and final weight of configuration \a cid are expanded.
+ *  Recursive calls without a depth limit are dropped, setting \a rtn->error.
+ *  \returns the cache state for \a cid, or NULL if \a cid is invalid.
+ *  The returned pointer is only valid until the next expansion.
+ */
+gfsmState *gfsm_rtn_expand_state(gfsmRTN *rtn, gfsmStateId cid);
+
+/** Expand all configurations of \a rtn reachable from its root into \a result
+ *  (which is cleared; if NULL, a new automaton is created).
+ *  With a finite depth limit, this is equivalent to nested application of gfsm_automaton_replace(),
+ *  but each sub-automaton is copied at most once per distinct calling context.
+ *  \returns \a result; check \a rtn->error, which is set if \a rtn is recursive and has no depth limit
+ */
+gfsmAutomaton *gfsm_rtn_expand(gfsmRTN *rtn, gfsmAutomaton *result);
+
+//@}
+
+/*======================================================================
+ * Algorithms
+ */
+///\name Algorithms
+//@{
+
+/** Like gfsm_automaton_lookup_full(), but traverses \a rtn directly. */
+gfsmAutomaton *gfsm_rtn_lookup_full(gfsmRTN           *rtn,
+				    gfsmLabelVector   *input,
+				    gfsmAutomaton     *result,
+				    gfsmStateId        max_result_states);
+
+/** Like gfsm_automaton_paths_full(), but traverses \a rtn directly.
+ *  \warning \a rtn must be acyclic (up to its depth limit)
+ */
+gfsmSet *gfsm_rtn_paths_full(gfsmRTN *rtn, gfsmSet *paths, gfsmLabelSide which);
+
+/** Like gfsm_automaton_compose_full(), with \a rtn as left argument.
+ *  Only configurations of \a rtn reached by the composition are expanded.
+ *  \param composition output automaton (cleared), or NULL to create a new one
+ *  \returns \a composition
+ */
+gfsmAutomaton *gfsm_rtn_compose_full(gfsmRTN *rtn, gfsmAutomaton *fsm2, gfsmAutomaton *composition);
+
+//@}
+
+#endif /* _GFSM_RTN_H */
@@ -94,7 +94,7 @@ gfsmAutomaton *gfsm_automaton_insert_automaton(gfsmAutomaton *fsm1,
     if (!s1 || !s2 || !s2->is_valid) continue;
 
     //-- copy state
-    gfsm_state_copy(s1,s2);
+    gfsm_state_copy_full(s1,s2,fsm1->arc_pool);
 
     //-- translate targets for adopted arcs
     for (gfsm_arciter_open_ptr(&ai,fsm1,s1); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai))
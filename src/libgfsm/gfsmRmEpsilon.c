@@ -28,8 +28,9 @@
 #include <gfsmEnum.h>
 #include <gfsmUtils.h>
 #include <gfsmCompound.h>
+#include <gfsmThreads.h>
 
-#include <gfsmPQueue.h>
+#include <gfsmHeap.h>
 
 /*======================================================================
  * Methods: algebra: rmepsilon
@@ -37,33 +38,28 @@
 //-- implementation of algorithm from hh2010: (Hanneforth & de la Higuera, 2010)
 
 //--------------------------------------------------------------
-// + arc comparison from hh2010
-static
-int gfsm_rmeps_arc_compare(const gfsmArc *a, const gfsmArc *b, gpointer user_data)
+// + heap key for arc queue, following the arc order of hh2010 eqs (3)-(5):
+//   self-loops (p==q) first, then descending by target state q
+GFSM_INLINE
+gfsmHeapKey gfsm_rmeps_arc_key(const gfsmArc *a)
 {
-  const gfsmStateId p=a->source, q=a->target, p1=b->source, q1=b->target;
-  if (
-      (   p==q && p1==q1 && q>q1) //-- hh2010 eq (3)
-      || (p!=q && p1!=q1 && q>q1) //-- hh2010 eq (4)
-      || (p==q && p1!=q1)         //-- hh2010 eq (5)
-      )
-    return -1;
-  else if (
-	   (   p1==q1 && p==q && q1>q) //-- hh2010 eq (3)
-	   || (p1!=q1 && p!=q && q1>q) //-- hh2010 eq (4)
-	   || (p1==q1 && p!=q)         //-- hh2010 eq (5)
-	   )
-    return 1;
-#if 0
-  return (p>p1 ? -1
-	  : (p==p1
-	     ? (q>q1 ? -1
-		: (q==q1 ? 0
-		   : 1))
-	     : 1));
-#else
-  return 0;
-#endif
+  return (a->source==a->target ? 0.0 : 4294967296.0) + (gfsmHeapKey)(G_MAXUINT32 - a->target);
+}
+
+//--------------------------------------------------------------
+// + enqueue an epsilon arc, (re-)using a free arc-slot id if available
+static inline
+void gfsm_rmeps_push(gfsmHeap *heap, GPtrArray *slots, GArray *free_slots, gfsmArc *arc)
+{
+  guint id;
+  if (free_slots->len > 0) {
+    id = g_array_index(free_slots,guint,--free_slots->len);
+    g_ptr_array_index(slots,id) = arc;
+  } else {
+    id = slots->len;
+    g_ptr_array_add(slots,arc);
+  }
+  gfsm_heap_push(heap, id, gfsm_rmeps_arc_key(arc));
 }
 
 //--------------------------------------------------------------
@@ -108,7 +104,10 @@ gint gfsm_rmeps_arc_compare_lut(const gfsmArc *a, const gfsmArc *b)
 gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
 {
   //-- variables
-  gfsmPriorityQueue *pqueue;
+  gfsmHeap  *pqueue;
+  GPtrArray *slots;       //-- [id] : gfsmArc* enqueued as id
+  GArray    *free_slots;  //-- guint : ids of popped arcs
+  guint      id;
   gfsmStateId pid;
   gfsmWeight westar, fw_p=0, fw_q=0;
   gfsmArc *pwq;
@@ -116,6 +115,8 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
   gfsmArcList *pal,*pal1, *qal, **palp;
   gint cmp;
 
+  gfsm_automaton_touch(fsm);
+
   //-- pre-sort arcs
   if (gfsm_acmask_nth(fsm->flags.sort_mode,0) != gfsmACLower
       || gfsm_acmask_nth(fsm->flags.sort_mode,1) != gfsmACUpper
@@ -126,7 +127,9 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
 
   //-- setup priority queue (hh2010:1-2)
   //   : moo: collect (q --eps:eps--> r) runs in the style of gfsm_automaton_arcuniq()
-  pqueue = gfsm_pqueue_new((GCompareDataFunc)gfsm_rmeps_arc_compare, NULL);
+  pqueue     = gfsm_heap_new(0);
+  slots      = g_ptr_array_new();
+  free_slots = g_array_new(FALSE,FALSE,sizeof(guint));
   for (pid=0; pid < fsm->states->len; pid++) {
     pptr = gfsm_automaton_open_state(fsm,pid);
     if (pptr == NULL) continue;
@@ -141,11 +144,11 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
       for (pal1=pal->next; pal1!=NULL && pal1->arc.lower==gfsmEpsilon && pal1->arc.upper==gfsmEpsilon && pal1->arc.target==pal->arc.target; pal1=pal->next) {
 	pal->next = pal1->next;
 	pal->arc.weight = gfsm_sr_plus(fsm->sr, pal->arc.weight, pal1->arc.weight);
-	gfsm_arclist_free_1(pal1);
+	gfsm_arc_pool_release(fsm->arc_pool, pal1);
       }
 
       //-- initialize priority queue
-      gfsm_pqueue_push(pqueue, &(pal->arc));
+      gfsm_rmeps_push(pqueue, slots, free_slots, &(pal->arc));
       _debug(fprintf(stderr, "rmeps[init]: push" _arcfmt "\n", _arcargs(&pal->arc)));
     }
   }
@@ -154,9 +157,11 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
   //fsm->flags.sort_mode = gfsmASMNone;
 
   //-- queue-processing loop (hh2010:3-24)
-  while (!gfsm_pqueue_isempty(pqueue)) {
+  while (!gfsm_heap_isempty(pqueue)) {
     //-- dequeue next arc to process, and remove it from the fsm (hh2010:4-5)
-    pwq  = (gfsmArc*)gfsm_pqueue_pop(pqueue);
+    id   = gfsm_heap_pop(pqueue);
+    pwq  = (gfsmArc*)g_ptr_array_index(slots,id);
+    g_array_append_val(free_slots,id);
     pptr = gfsm_automaton_open_state(fsm,pwq->source);
     pptr->arcs = gfsm_arclist_remove_node(pptr->arcs, (gfsmArcList*)pwq);
 
@@ -196,11 +201,11 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
 	}
 	else {
 	  //-- no matching arc: insert a new one (hh2010:15-18)
-	  pal1  = gfsm_arclist_new_full(pwq->source, qal->arc.target, qal->arc.lower, qal->arc.upper, gfsm_sr_times(fsm->sr, pwq->weight, qal->arc.weight), *palp);
+	  pal1  = gfsm_arc_pool_node_new(fsm->arc_pool, pwq->source, qal->arc.target, qal->arc.lower, qal->arc.upper, gfsm_sr_times(fsm->sr, pwq->weight, qal->arc.weight), *palp);
 	  *palp = pal1;
 	  if (qal->arc.lower==gfsmEpsilon && qal->arc.upper==gfsmEpsilon) {
 	    //-- ... and maybe enqueue it (hh2010:17-18)
-	    gfsm_pqueue_push(pqueue, pal1);
+	    gfsm_rmeps_push(pqueue, slots, free_slots, &(pal1->arc));
 	  }
 	}
       } //-- end loop: arcs(q)
@@ -221,11 +226,264 @@ gfsmAutomaton *gfsm_automaton_rmepsilon(gfsmAutomaton *fsm)
     }
 
     //-- local cleanup
-    gfsm_arclist_free_1((gfsmArcList*)pwq);
+    gfsm_arc_pool_release(fsm->arc_pool, (gfsmArcList*)pwq);
     gfsm_automaton_close_state(fsm,pptr);
   }
 
   //-- cleanup & return
-  gfsm_pqueue_free(pqueue);
+  gfsm_heap_free(pqueue);
+  g_ptr_array_free(slots,TRUE);
+  g_array_free(free_slots,TRUE);
+  return fsm;
+}
+
+/*======================================================================
+ * Methods: algebra: rmepsilon: per-state epsilon closure
+ */
+
+/// per-state result for gfsm_automaton_rmepsilon_closure()
+typedef struct {
+  gfsmArcList *arcs;          ///< new (epsilon-free) outgoing arcs
+  gfsmWeight   final_weight;  ///< new final weight (if is_final is set)
+  guint8       changed;       ///< whether this state had any outgoing epsilon arcs
+  guint8       is_final;      ///< whether this state is final in the output automaton
+} gfsmRmEpsResult_;
+
+/// per-thread scratch data for gfsm_automaton_rmepsilon_closure()
+typedef struct {
+  gfsmWeight *d;        ///< [q] : epsilon-distance from current source to q
+  gfsmWeight *r;        ///< [q] : residual weight of q (generic semirings only)
+  guint8     *seen;     ///< [q] : whether d[q] is defined for the current source
+  guint8     *inq;      ///< [q] : whether q is currently enqueued
+  GArray     *queue;    ///< FIFO of gfsmStateId
+  GArray     *closure;  ///< gfsmStateId : states with seen[q] set
+  GArray     *arcs;     ///< gfsmArc : collected non-epsilon arcs
+  gfsmArcPool *pool;    ///< private pool for new arc nodes, or NULL if fsm is not pooled
+} gfsmRmEpsScratch_;
+
+/// shared data for gfsm_automaton_rmepsilon_closure()
+typedef struct {
+  gfsmAutomaton     *fsm;
+  gfsmRmEpsResult_  *results;
+  gfsmRmEpsScratch_ *scratch;
+} gfsmRmEpsData_;
+
+//--------------------------------------------------------------
+// + true iff arc is an epsilon arc
+#define gfsm_rmeps_is_eps_(ap) ((ap)->lower==gfsmEpsilon && (ap)->upper==gfsmEpsilon)
+
+//--------------------------------------------------------------
+// + sets d[qid] to zero if qid is new to the closure
+static inline
+void gfsm_rmeps_see_(gfsmRmEpsScratch_ *s, gfsmSemiring *sr, gfsmStateId qid)
+{
+  if (s->seen[qid]) return;
+  s->seen[qid] = 1;
+  s->d[qid] = s->r[qid] = sr->zero;
+  g_array_append_val(s->closure,qid);
+}
+
+//--------------------------------------------------------------
+// + enqueues qid if it isn't already on the queue
+static inline
+void gfsm_rmeps_enqueue_(gfsmRmEpsScratch_ *s, gfsmStateId qid)
+{
+  if (s->inq[qid]) return;
+  s->inq[qid] = 1;
+  g_array_append_val(s->queue,qid);
+}
+
+//--------------------------------------------------------------
+// + populates s->closure and s->d[] with the epsilon-closure of pid
+// + generic single-source shortest-distance (Mohri, 2002), with fast paths for boolean & tropical semirings
+static
+void gfsm_rmeps_closure_(gfsmAutomaton *fsm, gfsmStateId pid, gfsmRmEpsScratch_ *s)
+{
+  gfsmSemiring *sr = fsm->sr;
+  gfsmSRType srtype = gfsm_sr_type(sr);
+  guint head;
+
+  gfsm_rmeps_see_(s,sr,pid);
+  s->d[pid] = s->r[pid] = sr->one;
+  gfsm_rmeps_enqueue_(s,pid);
+
+  for (head=0; head < s->queue->len; head++) {
+    gfsmStateId  qid = g_array_index(s->queue,gfsmStateId,head);
+    gfsmState   *qp  = gfsm_automaton_find_state(fsm,qid);
+    gfsmWeight   rq  = s->r[qid];
+    gfsmArcList *al;
+
+    s->inq[qid] = 0;
+    s->r[qid]   = sr->zero;
+
+    //-- epsilon arcs are initial, since arcs are sorted on (lower,upper,target)
+    for (al=qp->arcs; al != NULL && gfsm_rmeps_is_eps_(&al->arc); al=al->next) {
+      gfsmStateId tid = al->arc.target;
+      if (!gfsm_automaton_has_state(fsm,tid)) continue;
+
+      switch (srtype) {
+      case gfsmSRTBoolean:
+	//-- boolean: plain reachability
+	if (!al->arc.weight || s->seen[tid]) break;
+	gfsm_rmeps_see_(s,sr,tid);
+	s->d[tid] = sr->one;
+	gfsm_rmeps_enqueue_(s,tid);
+	break;
+
+      case gfsmSRTTropical: {
+	//-- tropical: label-correcting relaxation (no residuals needed)
+	gfsmWeight w = s->d[qid] + al->arc.weight;
+	if (s->seen[tid] && s->d[tid] <= w) break;
+	gfsm_rmeps_see_(s,sr,tid);
+	s->d[tid] = w;
+	gfsm_rmeps_enqueue_(s,tid);
+	break;
+      }
+
+      default: {
+	//-- generic: propagate residual weight until d[] no longer changes
+	gfsmWeight x, dnew;
+	gfsm_rmeps_see_(s,sr,tid);
+	x    = gfsm_sr_times(sr, rq, al->arc.weight);
+	dnew = gfsm_sr_plus(sr, s->d[tid], x);
+	if (dnew == s->d[tid]) break;
+	s->d[tid] = dnew;
+	s->r[tid] = gfsm_sr_plus(sr, s->r[tid], x);
+	gfsm_rmeps_enqueue_(s,tid);
+	break;
+      }
+      }
+    }
+  }
+  s->queue->len = 0;
+}
+
+//--------------------------------------------------------------
+// + gfsmParallelFunc: computes results[begin..end)
+static
+void gfsm_rmeps_closure_chunk_(guint begin, guint end, guint thread_id, gfsmRmEpsData_ *data)
+{
+  gfsmAutomaton     *fsm = data->fsm;
+  gfsmSemiring      *sr  = fsm->sr;
+  gfsmRmEpsScratch_ *s   = &data->scratch[thread_id];
+  gfsmStateId pid;
+  guint i;
+
+  for (pid=begin; pid < end; pid++) {
+    gfsmState        *pp  = gfsm_automaton_find_state(fsm,pid);
+    gfsmRmEpsResult_ *res = &data->results[pid];
+    gfsmArc          *arcs;
+    gfsmWeight        fw;
+
+    //-- states without epsilon arcs are left as they are
+    if (!pp || !pp->is_valid || !pp->arcs || !gfsm_rmeps_is_eps_(&pp->arcs->arc)) continue;
+    res->changed = 1;
+
+    gfsm_rmeps_closure_(fsm, pid, s);
+
+    //-- collect non-epsilon arcs & final weights of all states in the closure
+    for (i=0; i < s->closure->len; i++) {
+      gfsmStateId  qid = g_array_index(s->closure,gfsmStateId,i);
+      gfsmWeight   dq  = s->d[qid];
+      gfsmArcList *al;
+
+      s->seen[qid] = 0;
+      if (gfsm_sr_equal(sr, dq, sr->zero)) continue;
+
+      for (al=gfsm_automaton_find_state(fsm,qid)->arcs; al != NULL; al=al->next) {
+	gfsmArc arc;
+	if (gfsm_rmeps_is_eps_(&al->arc)) continue;
+	arc        = al->arc;
+	arc.source = pid;
+	arc.weight = gfsm_sr_times(sr, dq, al->arc.weight);
+	g_array_append_val(s->arcs,arc);
+      }
+
+      if (gfsm_automaton_lookup_final(fsm,qid,&fw)) {
+	res->final_weight = res->is_final ? gfsm_sr_plus(sr, res->final_weight, gfsm_sr_times(sr,dq,fw)) : gfsm_sr_times(sr,dq,fw);
+	res->is_final     = 1;
+      }
+    }
+    s->closure->len = 0;
+
+    //-- sort on (lower,upper,target), merging structurally identical arcs
+    g_array_sort(s->arcs, (GCompareFunc)gfsm_rmeps_arc_compare_lut);
+    arcs = (gfsmArc*)s->arcs->data;
+    for (i=s->arcs->len; i > 0; i--) {
+      if (res->arcs && gfsm_rmeps_arc_compare_lut(&arcs[i-1], &res->arcs->arc)==0) {
+	res->arcs->arc.weight = gfsm_sr_plus(sr, arcs[i-1].weight, res->arcs->arc.weight);
+      } else {
+	res->arcs = gfsm_arc_pool_node_new(s->pool, pid, arcs[i-1].target, arcs[i-1].lower, arcs[i-1].upper, arcs[i-1].weight, res->arcs);
+      }
+    }
+    s->arcs->len = 0;
+  }
+}
+
+//--------------------------------------------------------------
+gfsmAutomaton *gfsm_automaton_rmepsilon_closure(gfsmAutomaton *fsm)
+{
+  gfsmRmEpsData_ data;
+  gfsmStateId    n_states, pid;
+  guint          n_threads, i;
+
+  //-- sanity check
+  if (!fsm || gfsm_automaton_n_states(fsm)==0) return fsm;
+  n_states = fsm->states->len;
+  gfsm_automaton_touch(fsm);
+
+  //-- pre-sort arcs: epsilon arcs come first
+  gfsm_automaton_arcsort(fsm, gfsm_acmask_from_chars("lut"));
+
+  //-- allocate
+  n_threads    = gfsm_threads_get_default();
+  data.fsm     = fsm;
+  data.results = g_new0(gfsmRmEpsResult_, n_states);
+  data.scratch = g_new0(gfsmRmEpsScratch_, n_threads);
+  for (i=0; i < n_threads; i++) {
+    gfsmRmEpsScratch_ *s = &data.scratch[i];
+    s->d       = g_new(gfsmWeight, n_states);
+    s->r       = g_new(gfsmWeight, n_states);
+    s->seen    = g_new0(guint8, n_states);
+    s->inq     = g_new0(guint8, n_states);
+    s->queue   = g_array_new(FALSE,FALSE,sizeof(gfsmStateId));
+    s->closure = g_array_new(FALSE,FALSE,sizeof(gfsmStateId));
+    s->arcs    = g_array_new(FALSE,FALSE,sizeof(gfsmArc));
+    s->pool    = fsm->arc_pool ? gfsm_arc_pool_new() : NULL;
+  }
+
+  //-- compute closures (read-only on fsm)
+  gfsm_parallel_for(n_states, n_threads, 0, (gfsmParallelFunc)gfsm_rmeps_closure_chunk_, &data);
+
+  //-- install results
+  for (i=0; fsm->arc_pool && i < n_threads; i++) {
+    gfsm_arc_pool_merge(fsm->arc_pool, data.scratch[i].pool);
+  }
+  for (pid=0; pid < n_states; pid++) {
+    gfsmRmEpsResult_ *res = &data.results[pid];
+    gfsmState *pp;
+    if (!res->changed) continue;
+    pp = gfsm_automaton_find_state(fsm,pid);
+    gfsm_arc_pool_release_list(fsm->arc_pool, pp->arcs);
+    pp->arcs = res->arcs;
+    if (res->is_final)
+      gfsm_automaton_set_final_state_full(fsm, pid, TRUE, res->final_weight);
+  }
+
+  //-- cleanup
+  for (i=0; i < n_threads; i++) {
+    gfsmRmEpsScratch_ *s = &data.scratch[i];
+    g_free(s->d);
+    g_free(s->r);
+    g_free(s->seen);
+    g_free(s->inq);
+    g_array_free(s->queue,TRUE);
+    g_array_free(s->closure,TRUE);
+    g_array_free(s->arcs,TRUE);
+    if (s->pool) gfsm_arc_pool_free(s->pool);
+  }
+  g_free(data.scratch);
+  g_free(data.results);
+
   return fsm;
 }
@@ -48,6 +48,11 @@ gfsmAutomaton *gfsm_automaton_sigma(gfsmAutomaton *fsm, gfsmAlphabet *abet)
   fsm->root_id = gfsm_automaton_add_state_full(fsm,0);
   gfsm_automaton_add_state_full(fsm,1);
   gfsm_automaton_set_final_state_full(fsm,1,TRUE,fsm->sr->one);
-  gfsm_alphabet_foreach(abet, (gfsmAlphabetForeachFunc)gfsm_automaton_sigma_foreach_func_, fsm);
+  if (abet == NULL) {
+    //-- no alphabet: single implicit arc
+    gfsm_automaton_add_arc(fsm,0,1,gfsmSigma,gfsmSigma,fsm->sr->one);
+  } else {
+    gfsm_alphabet_foreach(abet, (gfsmAlphabetForeachFunc)gfsm_automaton_sigma_foreach_func_, fsm);
+  }
   return fsm;
 }
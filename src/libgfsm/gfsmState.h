@@ -63,18 +63,36 @@ gfsmState *gfsm_state_new(void);
 GFSM_INLINE
 gfsmState *gfsm_state_copy(gfsmState *dst, const gfsmState *src);
 
+/** Copy an existing state, releasing old arcs of \a dst to and allocating new ones from \a pool (may be \c NULL) */
+GFSM_INLINE
+gfsmState *gfsm_state_copy_full(gfsmState *dst, const gfsmState *src, gfsmArcPool *pool);
+
 /** Clear an existing state */
 GFSM_INLINE
 void gfsm_state_clear(gfsmState *s);
 
-/** Destroy a state */
+/** Clear an existing state, releasing its arcs to \a pool (may be \c NULL) */
+GFSM_INLINE
+void gfsm_state_clear_full(gfsmState *s, gfsmArcPool *pool);
+
+/** Destroy a state.
+ *  Arcs of a state belonging to a pooled automaton must be released with gfsm_state_free_full() */
 GFSM_INLINE
 void gfsm_state_free(gfsmState *s, gboolean free_arcs);
 
-/** Close a state (generic) */
+/** Destroy a state, releasing its arcs (if \a free_arcs is true) to \a pool (may be \c NULL) */
+GFSM_INLINE
+void gfsm_state_free_full(gfsmState *s, gboolean free_arcs, gfsmArcPool *pool);
+
+/** Close a state (generic).
+ *  Temporary arcs of a state belonging to a pooled automaton must be released with gfsm_state_close_full() */
 GFSM_INLINE
 void gfsm_state_close(gfsmState *s);
 
+/** Close a state, releasing temporary arcs to \a pool (may be \c NULL) */
+GFSM_INLINE
+void gfsm_state_close_full(gfsmState *s, gfsmArcPool *pool);
+
 //@}
 
 /*======================================================================
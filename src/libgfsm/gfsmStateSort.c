@@ -24,6 +24,7 @@
 #include <gfsmArcIter.h>
 #include <gfsmUtils.h>
 #include <gfsmBitVector.h>
+#include <gfsmCompound.h>
 #include <stdlib.h>
 
 //======================================================================
@@ -173,48 +174,55 @@ gfsmStateIdMap* gfsm_statemap_depths(gfsmAutomaton *fsm, gfsmStateIdMap *depths)
 //======================================================================
 // Methods: gfsmStateIdMap application 
 
+//--------------------------------------------------------------
+static
+gboolean gfsm_statemap_apply_finals_foreach_(gpointer qid_p, gpointer w_p, GArray *finals)
+{
+  gfsmStateWeightPair swp;
+  swp.id = GPOINTER_TO_UINT(qid_p);
+  swp.w  = gfsm_ptr2weight(w_p);
+  g_array_append_val(finals,swp);
+  return FALSE; //-- continue traversal
+}
+
 //--------------------------------------------------------------
 void gfsm_statemap_apply(gfsmAutomaton *fsm, gfsmStateIdMap *old2new, gfsmStateId n_new_states)
 {
-  gfsmStateId    oldid, newid;
-  gfsmState     *s_old, *s_new;
-  gfsmWeightMap *new_finals = gfsm_weightmap_new(gfsm_uint_compare);
-  GArray        *new_states = NULL;
+  gfsmStateId    oldid, newid, n_old_states = fsm->states->len;
+  gfsmState     *states;
+  gfsmBitVector *placed;    //-- placed[qid] iff position qid already holds its new state
+  GArray        *finals;    //-- flat array of gfsmStateWeightPair: (oldid,weight) for all final states
+  gboolean       finals_fixed = TRUE;
+  guint          i;
 
   //-- get new number of states
   if (n_new_states==0 || n_new_states==gfsmNoState) {
     n_new_states = 0;
-    for (oldid=0; oldid < fsm->states->len; oldid++) {
+    for (oldid=0; oldid < n_old_states; oldid++) {
       if (!gfsm_automaton_has_state(fsm,oldid)) continue;
       newid = g_array_index(old2new,gfsmStateId,oldid);
       if (newid != gfsmNoState && newid >= n_new_states) { n_new_states=newid+1; }
     }
   }
 
-  //-- allocate new state-vector (initialize to NULL)
-  new_states = g_array_sized_new(FALSE,TRUE,sizeof(gfsmState),n_new_states);
-
-  //-- renumber states
-  for (oldid=0; oldid < fsm->states->len; oldid++) {
-    gfsmArcIter ai; 
-    newid = g_array_index(old2new,gfsmStateId,oldid);
-
-    if (newid==gfsmNoState || !gfsm_automaton_has_state(fsm,oldid)) continue; //-- ignore bad states
+  //-- snapshot final weights into a single flat array (old ids)
+  finals = g_array_sized_new(FALSE,FALSE,sizeof(gfsmStateWeightPair),gfsm_weightmap_size(fsm->finals));
+  gfsm_weightmap_foreach(fsm->finals, (GTraverseFunc)gfsm_statemap_apply_finals_foreach_, finals);
 
-    //-- copy state data
-    s_old  = gfsm_automaton_find_state(fsm, oldid);
-    s_new  = &(g_array_index(new_states,gfsmState,newid));
-    *s_new = *s_old;
+  //-- renumber sources & targets of outgoing arcs; drop unmapped states
+  gfsm_automaton_touch(fsm);
+  for (oldid=0; oldid < n_old_states; oldid++) {
+    gfsmState  *qp = gfsm_automaton_find_state(fsm,oldid);
+    gfsmArcIter ai;
+    if (!qp->is_valid) continue;
 
-    //-- check for final state
-    if (s_new->is_final) {
-      gfsmWeight fw =0; //-- hack to convince gcc not to complain about unitialized fw
-      gfsm_weightmap_lookup(fsm->finals, GUINT_TO_POINTER(oldid), &fw);
-      gfsm_weightmap_insert(new_finals,  GUINT_TO_POINTER(newid),  fw);
+    newid = g_array_index(old2new,gfsmStateId,oldid);
+    if (newid==gfsmNoState) {
+      gfsm_state_clear_full(qp, fsm->arc_pool);
+      continue;
     }
 
-    //-- renumber sources & targets of outgoing arcs
-    for (gfsm_arciter_open_ptr(&ai, fsm, s_new); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+    for (gfsm_arciter_open_ptr(&ai, fsm, qp); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
       gfsmArc *a = gfsm_arciter_arc(&ai);
       a->source  = newid;
       a->target  = g_array_index(old2new,gfsmStateId,a->target);
@@ -222,17 +230,60 @@ void gfsm_statemap_apply(gfsmAutomaton *fsm, gfsmStateIdMap *old2new, gfsmStateI
     gfsm_arciter_close(&ai);
   }
 
-  //-- set new root-id
-  fsm->root_id = g_array_index(old2new,gfsmStateId,fsm->root_id);
+  //-- permute state vector in place by following cycles (resp. chains ending in invalid 'holes') of old2new
+  if (n_new_states > n_old_states) g_array_set_size(fsm->states, n_new_states); //-- new slots are zeroed (invalid)
+  states = (gfsmState*)fsm->states->data;
+  placed = gfsm_bitvector_sized_new(fsm->states->len);
+  for (oldid=0; oldid < n_old_states; oldid++) {
+    gfsmState tmp;
+    gfsmStateId src;
+    if (gfsm_bitvector_get(placed,oldid) || !states[oldid].is_valid) continue;
+
+    //-- lift state out of its slot & walk its cycle
+    tmp = states[oldid];
+    for (src=oldid; TRUE; ) {
+      gfsmState next;
+      newid = g_array_index(old2new,gfsmStateId,src);
+      next  = states[newid];
+      states[newid] = tmp;
+      gfsm_bitvector_set(placed,newid,1);
+      if (newid==oldid || !next.is_valid) break; //-- cycle closed, or chain ended in a hole
+      tmp = next;
+      src = newid;
+    }
 
-  //-- set new final weights
-  gfsm_weightmap_free(fsm->finals);
-  fsm->finals = new_finals;
+    //-- chain ended in a hole: vacate the slot we started from
+    if (!gfsm_bitvector_get(placed,oldid)) {
+      states[oldid].is_valid = FALSE;
+      states[oldid].is_final = FALSE;
+      states[oldid].arcs     = NULL;
+    }
+  }
+  gfsm_bitvector_free(placed);
+  g_array_set_size(fsm->states, n_new_states);
+
+  //-- set new root-id
+  if (fsm->root_id != gfsmNoState)
+    fsm->root_id = g_array_index(old2new,gfsmStateId,fsm->root_id);
 
-  //-- set new state vector
-  g_array_free(fsm->states,TRUE);
-  fsm->states = new_states;
-  fsm->states->len = n_new_states;
+  //-- set new final weights: only touch the weight-map if some final state actually moved
+  for (i=0; i < finals->len; i++) {
+    gfsmStateWeightPair *swp = &g_array_index(finals,gfsmStateWeightPair,i);
+    if (g_array_index(old2new,gfsmStateId,swp->id) != swp->id) { finals_fixed=FALSE; break; }
+  }
+  if (!finals_fixed) {
+    for (i=0; i < finals->len; i++) {
+      gfsmStateWeightPair *swp = &g_array_index(finals,gfsmStateWeightPair,i);
+      gfsm_weightmap_remove(fsm->finals, GUINT_TO_POINTER(swp->id));
+    }
+    for (i=0; i < finals->len; i++) {
+      gfsmStateWeightPair *swp = &g_array_index(finals,gfsmStateWeightPair,i);
+      newid = g_array_index(old2new,gfsmStateId,swp->id);
+      if (newid==gfsmNoState) continue;
+      gfsm_weightmap_insert(fsm->finals, GUINT_TO_POINTER(newid), swp->w);
+    }
+  }
+  g_array_free(finals,TRUE);
 }
 
 
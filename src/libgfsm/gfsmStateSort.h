@@ -78,6 +78,8 @@ void gfsm_statesort_bfs(gfsmAutomaton *fsm, gfsmStateIdMap *old2new);
 //@{
 
 /** Renumber states of \a fsm according to the ::gfsmStateIdMap \a old2new .
+ *  The state vector of \a fsm is permuted in place by following the cycles of \a old2new,
+ *  so no second copy of the state vector is allocated; states mapped to ::gfsmNoState are freed.
  *  \param fsm automaton whose states are to be mapped
  *  \param old2new state-mapping to apply
  *  \param n_new_states number of target states to allocate; may be 0 (zero) to auto-compute
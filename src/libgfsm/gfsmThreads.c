@@ -0,0 +1,157 @@
+
+/*=============================================================================*\
+ * File: gfsmThreads.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: multi-threading utilities
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmThreads.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*======================================================================
+ * Configuration
+ */
+
+//-- 0: not yet initialized
+static guint gfsm_threads_default = 0;
+
+//--------------------------------------------------------------
+static
+guint gfsm_threads_n_processors_(void)
+{
+#ifdef GFSM_THREADS_ENABLED
+  guint n = g_get_num_processors();
+  return n > 0 ? n : 1;
+#else
+  return 1;
+#endif
+}
+
+//--------------------------------------------------------------
+guint gfsm_threads_get_default(void)
+{
+#ifdef GFSM_THREADS_ENABLED
+  if (gfsm_threads_default == 0) {
+    const char *env = getenv("GFSM_THREADS");
+    if (env == NULL || *env == '\0') {
+      gfsm_threads_default = 1;
+    } else if (strcmp(env,"auto") == 0) {
+      gfsm_threads_default = gfsm_threads_n_processors_();
+    } else {
+      gfsm_threads_default = strtoul(env,NULL,0);
+      if (gfsm_threads_default == 0) gfsm_threads_default = gfsm_threads_n_processors_();
+    }
+  }
+  return gfsm_threads_default;
+#else
+  return 1;
+#endif
+}
+
+//--------------------------------------------------------------
+void gfsm_threads_set_default(guint n_threads)
+{
+  gfsm_threads_default = n_threads > 0 ? n_threads : gfsm_threads_n_processors_();
+}
+
+/*======================================================================
+ * Parallel loops
+ */
+
+#ifdef GFSM_THREADS_ENABLED
+/// shared state for gfsm_parallel_for() workers
+typedef struct {
+  gfsmParallelFunc func;       ///< job function
+  gpointer         data;       ///< user data
+  guint            n_items;    ///< total number of items
+  guint            chunk_size; ///< items per chunk
+  volatile gint    next;       ///< next chunk index to be handed out
+} gfsmParallelJob;
+
+/// per-thread worker data for gfsm_parallel_for()
+typedef struct {
+  gfsmParallelJob *job;        ///< shared job data
+  guint            thread_id;  ///< dense worker index
+} gfsmParallelWorker;
+
+//--------------------------------------------------------------
+static
+gpointer gfsm_parallel_worker_(gfsmParallelWorker *w)
+{
+  gfsmParallelJob *job = w->job;
+  guint n_chunks = (job->n_items + job->chunk_size - 1) / job->chunk_size;
+  guint chunk;
+  while ((chunk = (guint)g_atomic_int_add(&job->next,1)) < n_chunks) {
+    guint begin = chunk * job->chunk_size;
+    guint end   = begin + job->chunk_size;
+    if (end > job->n_items) end = job->n_items;
+    (*job->func)(begin, end, w->thread_id, job->data);
+  }
+  return NULL;
+}
+#endif /* GFSM_THREADS_ENABLED */
+
+//--------------------------------------------------------------
+guint gfsm_parallel_for(guint n_items, guint n_threads, guint chunk_size, gfsmParallelFunc func, gpointer data)
+{
+#ifdef GFSM_THREADS_ENABLED
+  gfsmParallelJob     job;
+  gfsmParallelWorker *workers;
+  GThread           **threads;
+  guint               i;
+
+  if (n_threads == 0) n_threads = gfsm_threads_get_default();
+  if (chunk_size == 0) {
+    //-- auto: aim for a few chunks per thread, for load balancing
+    chunk_size = n_items / (4*n_threads);
+    if (chunk_size < 64) chunk_size = 64;
+  }
+  if (n_threads > 1 && n_items > chunk_size) {
+    guint n_chunks = (n_items + chunk_size - 1) / chunk_size;
+    if (n_threads > n_chunks) n_threads = n_chunks;
+
+    job.func       = func;
+    job.data       = data;
+    job.n_items    = n_items;
+    job.chunk_size = chunk_size;
+    job.next       = 0;
+
+    workers = g_new(gfsmParallelWorker, n_threads);
+    threads = g_new0(GThread*, n_threads);
+    for (i=0; i < n_threads; i++) {
+      workers[i].job       = &job;
+      workers[i].thread_id = i;
+      if (i > 0)
+        threads[i] = g_thread_new("gfsm-worker", (GThreadFunc)gfsm_parallel_worker_, &workers[i]);
+    }
+    gfsm_parallel_worker_(&workers[0]); //-- calling thread is worker #0
+    for (i=1; i < n_threads; i++) {
+      g_thread_join(threads[i]);
+    }
+    g_free(threads);
+    g_free(workers);
+    return n_threads;
+  }
+#endif /* GFSM_THREADS_ENABLED */
+
+  //-- serial fallback
+  if (n_items > 0) (*func)(0, n_items, 0, data);
+  return 1;
+}
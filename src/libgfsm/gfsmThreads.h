@@ -0,0 +1,90 @@
+
+/*=============================================================================*\
+ * File: gfsmThreads.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: multi-threading utilities
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmThreads.h
+ *  \brief Multi-threading utilities (data-parallel loops over index ranges)
+ */
+
+#ifndef _GFSM_THREADS_H
+#define _GFSM_THREADS_H
+
+#include <gfsmCommon.h>
+
+/*======================================================================
+ * Types
+ */
+
+/** Type for data-parallel job functions used by gfsm_parallel_for().
+ *  Called as \code (*func)(begin, end, thread_id, data) \endcode
+ *  to process all items \a i with <tt>begin &lt;= i &lt; end</tt>.
+ *  \a thread_id is a dense worker index in the range <tt>[0,n_threads)</tt>
+ *  which may be used to address per-thread scratch data.
+ */
+typedef void (*gfsmParallelFunc) (guint begin, guint end, guint thread_id, gpointer data);
+
+/*======================================================================
+ * Configuration
+ */
+///\name Configuration
+//@{
+
+/** Get the default number of worker threads used by library routines.
+ *  If not explicitly set with gfsm_threads_set_default(), the value is read
+ *  once from the environment variable \c GFSM_THREADS; a value of \c 0 or \c "auto"
+ *  selects the number of available processors.  Otherwise, the default is 1 (one),
+ *  i.e. no multi-threading.
+ *  \returns 1 (one) if gfsm was built without thread support.
+ */
+guint gfsm_threads_get_default(void);
+
+/** Set the default number of worker threads used by library routines.
+ *  \param n_threads number of threads, or 0 (zero) for the number of available processors
+ */
+void gfsm_threads_set_default(guint n_threads);
+
+//@}
+
+/*======================================================================
+ * Parallel loops
+ */
+///\name Parallel loops
+//@{
+
+/** Call \a func on consecutive chunks of the index range <tt>[0,n_items)</tt>
+ *  using up to \a n_threads worker threads, and wait for all of them to finish.
+ *  Chunks are handed out dynamically, so \a func may be called several times per thread.
+ *  If \a n_threads is 1 (one), if \a n_items is no larger than \a chunk_size,
+ *  or if gfsm was built without thread support, \a func is simply called once
+ *  in the calling thread as \code (*func)(0, n_items, 0, data) \endcode
+ *  \param n_items    number of items to process
+ *  \param n_threads  maximum number of threads to use, or 0 (zero) for gfsm_threads_get_default()
+ *  \param chunk_size number of items per chunk, or 0 (zero) for an automatic choice
+ *  \param func       job function
+ *  \param data       user data for \a func
+ *  \returns number of threads actually used
+ */
+guint gfsm_parallel_for(guint n_items, guint n_threads, guint chunk_size, gfsmParallelFunc func, gpointer data);
+
+//@}
+
+#endif /* _GFSM_THREADS_H */
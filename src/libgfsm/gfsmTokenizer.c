@@ -0,0 +1,275 @@
+/*=============================================================================*\
+ * File: gfsmTokenizer.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: precompiled string-to-label tokenizers
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmConfig.h>
+#include <gfsmTokenizer.h>
+#include <gfsmError.h>
+
+#include <string.h>
+#include <ctype.h>
+
+//-- no-inline definitions
+#ifndef GFSM_INLINE_ENABLED
+# include <gfsmTokenizer.hi>
+#endif
+
+/*======================================================================
+ * Constructors etc.
+ */
+
+/// trie node used during construction
+typedef struct {
+  guint32 first_child;   ///< first child node, or 0
+  guint32 last_child;    ///< last child node, or 0
+  guint32 next_sibling;  ///< next sibling node, or 0
+  guchar  byte;          ///< input byte leading to this node
+} gfsmTokenizerBuildNode;
+
+/*--------------------------------------------------------------
+ * key_compare_()
+ */
+static
+gint gfsm_tokenizer_key_compare_(gconstpointer a, gconstpointer b)
+{
+  return strcmp(*((const gchar**)a), *((const gchar**)b));
+}
+
+/*--------------------------------------------------------------
+ * new()
+ */
+gfsmTokenizer *gfsm_tokenizer_new(gfsmAlphabet *abet, gfsmTokenizerFlags flags)
+{
+  gfsmTokenizer *tok = g_new0(gfsmTokenizer,1);
+  GPtrArray *keys  = g_ptr_array_new();
+  GArray    *nodes = g_array_new(FALSE, TRUE, sizeof(gfsmTokenizerBuildNode));
+  GArray    *labs  = g_array_new(FALSE, FALSE, sizeof(gfsmLabelVal));
+  GArray    *path  = g_array_new(FALSE, TRUE, sizeof(guint32));
+  GString   *gstr  = g_string_new("");
+  const gchar *prev = "";
+  gfsmTokenizerBuildNode *bn;
+  gfsmLabelVal lab, nolab = gfsmNoLabel;
+  gpointer key;
+  guint32 i, n, d, len, edge;
+
+  tok->flags = flags;
+  tok->utf8  = abet->utf8;
+
+  //-- collect key strings, sorted bytewise so that children are created in order
+  for (lab=abet->lab_min; lab <= abet->lab_max && lab < gfsmNoLabel; lab++) {
+    if ((key=gfsm_alphabet_find_key(abet,lab)) == gfsmNoKey) continue;
+    gfsm_alphabet_key2string(abet, key, gstr);
+    g_ptr_array_add(keys, g_strdup(gstr->str));
+  }
+  g_ptr_array_sort(keys, gfsm_tokenizer_key_compare_);
+
+  //-- build trie: each key shares its longest common prefix with its predecessor
+  g_array_set_size(nodes, 1);
+  g_array_append_val(labs, nolab);
+  g_array_set_size(path, 1);
+  for (i=0; i < keys->len; i++) {
+    const gchar *s = (const gchar*)g_ptr_array_index(keys,i);
+    if (i > 0 && strcmp(s,prev)==0) continue;
+
+    for (d=0; s[d] && s[d]==prev[d]; d++) ;
+    len = strlen(s);
+    if (path->len < len+1) g_array_set_size(path, len+1);
+    for ( ; d < len; d++) {
+      guint32 parent = g_array_index(path,guint32,d);
+      guint32 child  = nodes->len;
+      g_array_set_size(nodes, child+1);
+      g_array_append_val(labs, nolab);
+      bn = &g_array_index(nodes,gfsmTokenizerBuildNode,child);
+      bn->byte = (guchar)s[d];
+      bn = &g_array_index(nodes,gfsmTokenizerBuildNode,parent);
+      if (bn->last_child) g_array_index(nodes,gfsmTokenizerBuildNode,bn->last_child).next_sibling = child;
+      else                bn->first_child = child;
+      bn->last_child = child;
+      g_array_index(path,guint32,d+1) = child;
+    }
+
+    //-- label: whatever the alphabet maps this string to
+    g_string_assign(gstr, s);
+    g_array_index(labs,gfsmLabelVal,g_array_index(path,guint32,len))
+      = gfsm_alphabet_find_label(abet, gfsm_alphabet_string2key(abet,gstr));
+    prev = s;
+  }
+
+  //-- compile: children of each node become a contiguous edge range
+  n = tok->n_nodes   = nodes->len;
+  tok->labels        = (gfsmLabelVal*)g_array_free(labs, FALSE);
+  tok->edge_first    = g_new(guint32, n+1);
+  tok->edge_bytes    = g_new(guchar,  n > 1 ? n-1 : 1);
+  tok->edge_targets  = g_new(guint32, n > 1 ? n-1 : 1);
+  for (i=0, edge=0; i < n; i++) {
+    guint32 child;
+    tok->edge_first[i] = edge;
+    for (child=g_array_index(nodes,gfsmTokenizerBuildNode,i).first_child;
+	 child != 0;
+	 child=g_array_index(nodes,gfsmTokenizerBuildNode,child).next_sibling)
+      {
+	bn = &g_array_index(nodes,gfsmTokenizerBuildNode,child);
+	tok->edge_bytes[edge]   = bn->byte;
+	tok->edge_targets[edge] = child;
+	if (i == 0) tok->root[bn->byte] = child;
+	++edge;
+      }
+  }
+  tok->edge_first[n] = edge;
+
+  //-- cleanup
+  for (i=0; i < keys->len; i++) g_free(g_ptr_array_index(keys,i));
+  g_ptr_array_free(keys, TRUE);
+  g_array_free(nodes, TRUE);
+  g_array_free(path, TRUE);
+  g_string_free(gstr, TRUE);
+
+  return tok;
+}
+
+/*--------------------------------------------------------------
+ * free()
+ */
+void gfsm_tokenizer_free(gfsmTokenizer *tok)
+{
+  if (!tok) return;
+  g_free(tok->labels);
+  g_free(tok->edge_first);
+  g_free(tok->edge_bytes);
+  g_free(tok->edge_targets);
+  g_free(tok);
+}
+
+/*======================================================================
+ * Lookup
+ */
+
+/*--------------------------------------------------------------
+ * longest_match()
+ */
+gfsmLabelVal gfsm_tokenizer_longest_match(gfsmTokenizer *tok, const gchar *str, const gchar **endp)
+{
+  gfsmLabelVal lab = gfsmNoLabel;
+  guint32 node = 0;
+  const gchar *p;
+
+  for (p=str; *p; p++) {
+    if ( !(node=gfsm_tokenizer_step(tok, node, (guchar)*p)) ) break;
+    if (tok->labels[node] == gfsmNoLabel) continue;
+    if (tok->utf8 && (((guchar)p[1]) & 0xc0) == 0x80) continue; //-- not on a character boundary
+    lab   = tok->labels[node];
+    *endp = p+1;
+  }
+  return lab;
+}
+
+/*--------------------------------------------------------------
+ * warn_undefined_()
+ */
+static
+void gfsm_tokenizer_warn_undefined_(gfsmTokenizer *tok, const gchar *sym, gsize len, const gchar *str)
+{
+  gchar *s = g_strndup(sym, len);
+  if (tok->flags & gfsmTFAtt) {
+    gfsm_carp(g_error_new(g_quark_from_static_string("gfsm"), //--domain
+			  g_quark_from_static_string("gfsm_tokenizer_string_to_labels"), //-- code
+			  "Warning: unknown %s symbol [%s] in string '%s' -- skipping.",
+			  (tok->utf8 ? "UTF-8" : "byte"), s, str));
+  } else {
+    gfsm_carp(g_error_new(g_quark_from_static_string("gfsm"), //--domain
+			  g_quark_from_static_string("gfsm_tokenizer_string_to_labels"), //-- code
+			  "Warning: unknown %s character '%s' in string '%s' -- skipping.",
+			  (tok->utf8 ? "UTF-8" : "byte"), s, str));
+  }
+  g_free(s);
+}
+
+/*--------------------------------------------------------------
+ * string_to_labels()
+ */
+gfsmLabelVector *gfsm_tokenizer_string_to_labels(gfsmTokenizer *tok,
+						 const gchar *str,
+						 gfsmLabelVector *vec,
+						 gboolean warn_on_undefined)
+{
+  gboolean     is_utf8 = tok->utf8;
+  gboolean     is_att  = (tok->flags & gfsmTFAtt) != 0;
+  gboolean     longest = (tok->flags & gfsmTFLongest) != 0;
+  const gchar *s, *s_nxt, *sym, *sym_end;
+  gfsmLabelVal lab;
+
+  //-- setup vector
+  if (vec==NULL) {
+    vec = g_ptr_array_sized_new(str ? strlen(str) : 0);
+  } else {
+    g_ptr_array_set_size(vec, 0);
+  }
+
+  for (s=str; s && *s; s=s_nxt) {
+    //-- default: next single character
+    sym = s;
+    if (is_utf8) {
+      if ( !(s_nxt=g_utf8_find_next_char(s,NULL)) ) break;
+    } else {
+      s_nxt = s+1;
+    }
+    sym_end = s_nxt;
+
+    if (is_att && *s == '[') {
+      //-- bracket escape: [SYMBOL]
+      if ( !(sym_end=strchr(s+1,']')) ) break;
+      sym   = s+1;
+      s_nxt = sym_end+1;
+      lab   = gfsm_tokenizer_find_label_len(tok, sym, sym_end-sym);
+    }
+    else if (is_att && *s == '\\') {
+      //-- backslash escape: \CHAR
+      sym = s+1;
+      if (!*sym) break;
+      if (is_utf8) {
+	if ( !(sym_end=g_utf8_find_next_char(sym,NULL)) ) break;
+      } else {
+	sym_end = sym+1;
+      }
+      s_nxt = sym_end;
+      lab   = gfsm_tokenizer_find_label_len(tok, sym, sym_end-sym);
+    }
+    else if (is_att && isspace((guchar)*s)) {
+      continue; //-- ignore spaces
+    }
+    else if (longest && (lab=gfsm_tokenizer_longest_match(tok, s, &sym_end)) != gfsmNoLabel) {
+      s_nxt = sym_end;
+    }
+    else {
+      lab = gfsm_tokenizer_find_label_len(tok, sym, sym_end-sym);
+    }
+
+    //-- check for non-existant labels
+    if (lab==gfsmNoLabel) {
+      if (warn_on_undefined) gfsm_tokenizer_warn_undefined_(tok, sym, sym_end-sym, str);
+      continue;
+    }
+
+    g_ptr_array_add(vec, GUINT_TO_POINTER(lab));
+  }
+
+  return vec;
+}
@@ -0,0 +1,119 @@
+/*=============================================================================*\
+ * File: gfsmTokenizer.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: precompiled string-to-label tokenizers
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmTokenizer.h
+ *  \brief Byte-level symbol tries for fast string-to-label conversion
+ *
+ *  A ::gfsmTokenizer is compiled once from a string alphabet and maps input
+ *  strings to label vectors in a single left-to-right pass without allocating
+ *  any temporary strings or performing any hash lookups.
+ */
+
+#ifndef _GFSM_TOKENIZER_H
+#define _GFSM_TOKENIZER_H
+
+#include <gfsmAlphabet.h>
+
+/*======================================================================
+ * Types
+ */
+
+/// Tokenizer mode flags
+typedef enum {
+  gfsmTFChars   = 0x0,  ///< default: one symbol per (byte or UTF-8) character, like gfsm_alphabet_string_to_labels()
+  gfsmTFAtt     = 0x1,  ///< AT&T-style bracket and backslash escapes, like gfsm_alphabet_att_string_to_labels()
+  gfsmTFLongest = 0x2   ///< match unescaped text greedily against all (multi-character) alphabet symbols
+} gfsmTokenizerFlagsE;
+
+/// Type for tokenizer mode flags (bitwise-or of ::gfsmTokenizerFlagsE values)
+typedef guint32 gfsmTokenizerFlags;
+
+/** Compiled symbol trie.
+ *  Node 0 is the root, whose transitions are stored in a dense table;
+ *  the transitions of all other nodes are stored as sorted byte ranges
+ *  in the flat \a edge_bytes and \a edge_targets arrays.
+ */
+typedef struct {
+  gfsmTokenizerFlags flags;     ///< mode flags
+  gboolean      utf8;           ///< whether to interpret input as UTF-8 (default: from alphabet)
+  guint32       n_nodes;        ///< number of trie nodes
+  guint32       root[256];      ///< [byte] : target node of root transition, or 0 for none
+  gfsmLabelVal *labels;         ///< [node] : label for the symbol ending at node, or ::gfsmNoLabel
+  guint32      *edge_first;     ///< [node] : index of first outgoing edge of node (n_nodes+1 entries)
+  guchar       *edge_bytes;     ///< [edge] : input byte of edge
+  guint32      *edge_targets;   ///< [edge] : target node of edge
+} gfsmTokenizer;
+
+/*======================================================================
+ * Constructors etc.
+ */
+///\name Constructors etc.
+//@{
+
+/** Compile a new ::gfsmTokenizer from the symbols of \a abet.
+ *  Keys are converted with gfsm_alphabet_key2string(), so \a abet should really
+ *  be a ::gfsmStringAlphabet.  The tokenizer does not track later changes to \a abet.
+ */
+gfsmTokenizer *gfsm_tokenizer_new(gfsmAlphabet *abet, gfsmTokenizerFlags flags);
+
+/** Free a ::gfsmTokenizer */
+void gfsm_tokenizer_free(gfsmTokenizer *tok);
+
+//@}
+
+/*======================================================================
+ * Lookup
+ */
+///\name Lookup
+//@{
+
+/** Get the trie node reached from \a node by byte \a c, or 0 if there is no such transition */
+GFSM_INLINE
+guint32 gfsm_tokenizer_step(gfsmTokenizer *tok, guint32 node, guchar c);
+
+/** Look up the label for the \a len bytes at \a str, or ::gfsmNoLabel if they do not form a symbol */
+GFSM_INLINE
+gfsmLabelVal gfsm_tokenizer_find_label_len(gfsmTokenizer *tok, const gchar *str, gsize len);
+
+/** Find the longest symbol prefix of \a str (ending on a character boundary in UTF-8 mode).
+ *  \returns label of the longest match or ::gfsmNoLabel;
+ *    if a match was found, \a *endp is set to point just past it
+ */
+gfsmLabelVal gfsm_tokenizer_longest_match(gfsmTokenizer *tok, const gchar *str, const gchar **endp);
+
+/** Convert \a str to a vector of labels according to \a tok->flags.
+ *  \a vec is cleared before conversion.
+ *  \returns \a vec if non-\a NULL, otherwise a new gfsmLabelVector.
+ */
+gfsmLabelVector *gfsm_tokenizer_string_to_labels(gfsmTokenizer *tok,
+						 const gchar *str,
+						 gfsmLabelVector *vec,
+						 gboolean warn_on_undefined);
+
+//@}
+
+//-- inline definitions
+#ifdef GFSM_INLINE_ENABLED
+# include <gfsmTokenizer.hi>
+#endif
+
+#endif /* _GFSM_TOKENIZER_H */
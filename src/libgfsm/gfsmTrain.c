@@ -27,33 +27,15 @@
 #include <gfsmState.h>
 #include <gfsmArc.h>
 #include <gfsmArcIter.h>
+#include <gfsmThreads.h>
 
 #include <string.h>
+#include <math.h>
 
 /*======================================================================
  * Methods: train: low-level
  */
 
-//--------------------------------------------------------------
-GFSM_INLINE
-gfsmTrainConfig* gfsm_train_config_new(guint32 i, guint32 j, gfsmStateId qf, gfsmArc *a, gfsmTrainConfig *prev)
-{
-  gfsmTrainConfig *cfg = (gfsmTrainConfig*)gfsm_slice_new(gfsmTrainConfig);
-  cfg->i = i;
-  cfg->j = j;
-  cfg->qf = qf;
-  cfg->a = a;
-  cfg->prev = prev;
-  return cfg;
-}
-
-//--------------------------------------------------------------
-GFSM_INLINE
-gfsmStateId gfsm_train_config_stateid(gfsmTrainConfig *cfg, gfsmAutomaton *fst)
-{
-  return (cfg->a ? cfg->a->target : (cfg->qf==gfsmNoState ? gfsm_automaton_get_root(fst) : cfg->qf));
-}
-
 //--------------------------------------------------------------
 GFSM_INLINE
 guint gfsm_train_config_pathlength(gfsmTrainConfig *cfg)
@@ -197,6 +179,8 @@ gfsmTrainer* gfsm_trainer_new(gfsmAutomaton *fst)
       ++wi;
     }
   }
+  //-- arc weights were modified in place: drop any cached (or stored) arc indices
+  gfsm_automaton_touch(fst);
 
   return trainer;
 }
@@ -243,91 +227,464 @@ gfsmAutomaton* gfsm_trainer_automaton(gfsmTrainer *trainer, gboolean steal)
       arc->weight = trainer->counts[wi];
     }
   }
+  gfsm_automaton_touch(fst);
 
   return fst;
 }
 
+/*======================================================================
+ * Methods: train: search graph
+ */
+
+//-- number of gfsmTrainConfig per arena block
+#define GFSM_TRAIN_ARENA_BLOCK 1024
+
+//-- empty hash slot / no edge
+#define GFSM_TRAIN_NONE ((guint32)-1)
+
+/// search graph node: a unique configuration (q,i,j)
+typedef struct {
+  gfsmStateId  q;       //-- state
+  guint32      i;       //-- position in input
+  guint32      j;       //-- position in output
+  guint32      edges;   //-- index of first outgoing edge, or GFSM_TRAIN_NONE
+  gfsmArcList *cursor;  //-- DFS: next arc to try
+  guint8       color;   //-- DFS: 0:unvisited, 1:active, 2:done
+  gboolean     final;   //-- whether this is a successful configuration
+  gdouble      fwd;     //-- number of paths from the initial configuration
+  gdouble      bwd;     //-- number of paths to successful configurations
+  gdouble      alpha;   //-- expected counts: log forward probability
+  gdouble      beta;    //-- expected counts: log backward probability
+} gfsmTrainNode_;
+
+/// search graph edge
+typedef struct {
+  guint32  target;  //-- target node
+  guint32  next;    //-- next edge from the same source, or GFSM_TRAIN_NONE
+  gfsmArc *arc;     //-- followed arc
+} gfsmTrainEdge_;
+
+/// per-thread scratch data for training; all storage is re-used across pairs
+typedef struct {
+  GArray    *nodes;   //-- GArray of gfsmTrainNode_
+  GArray    *edges;   //-- GArray of gfsmTrainEdge_
+  GArray    *order;   //-- node ids in DFS post-order, GArray of guint32
+  GArray    *stack;   //-- DFS stack, GArray of guint32
+  guint32   *slots;   //-- open-addressing hash table over node ids
+  guint32    mask;    //-- number of slots - 1
+  GPtrArray *blocks;  //-- config arena: blocks of GFSM_TRAIN_ARENA_BLOCK gfsmTrainConfig
+  guint      block;   //-- current arena block
+  guint      used;    //-- number of configs used in current arena block
+  gdouble   *counts;  //-- [wi] : accumulated counts, added to trainer->counts by the caller
+} gfsmTrainScratch_;
+
 //--------------------------------------------------------------
-void gfsm_trainer_train(gfsmTrainer *trainer, gfsmLabelVector *input, gfsmLabelVector *output)
+static
+void gfsm_train_scratch_init_(gfsmTrainScratch_ *s, guint nweights)
+{
+  s->nodes  = g_array_new(FALSE,FALSE,sizeof(gfsmTrainNode_));
+  s->edges  = g_array_new(FALSE,FALSE,sizeof(gfsmTrainEdge_));
+  s->order  = g_array_new(FALSE,FALSE,sizeof(guint32));
+  s->stack  = g_array_new(FALSE,FALSE,sizeof(guint32));
+  s->mask   = 255;
+  s->slots  = g_new(guint32, s->mask+1);
+  memset(s->slots, 0xff, (s->mask+1)*sizeof(guint32));
+  s->blocks = g_ptr_array_new();
+  s->block  = 0;
+  s->used   = 0;
+  s->counts = g_new0(gdouble, nweights);
+}
+
+//--------------------------------------------------------------
+static
+void gfsm_train_scratch_clear_(gfsmTrainScratch_ *s)
+{
+  guint b;
+  g_array_free(s->nodes,TRUE);
+  g_array_free(s->edges,TRUE);
+  g_array_free(s->order,TRUE);
+  g_array_free(s->stack,TRUE);
+  g_free(s->slots);
+  for (b=0; b < s->blocks->len; b++) g_free(g_ptr_array_index(s->blocks,b));
+  g_ptr_array_free(s->blocks,TRUE);
+  g_free(s->counts);
+}
+
+//--------------------------------------------------------------
+static inline
+guint32 gfsm_train_hash_(gfsmStateId q, guint32 i, guint32 j)
+{
+  guint32 h = q*0x9e3779b1u;
+  h ^= (i + 0x7f4a7c15u + (h<<6) + (h>>2));
+  h ^= (j*0x85ebca6bu + (h<<6) + (h>>2));
+  return h ^ (h>>15);
+}
+
+//--------------------------------------------------------------
+// + returns id of node (q,i,j), adding it if required
+static
+guint32 gfsm_train_node_(gfsmTrainScratch_ *s, gfsmAutomaton *fst, gfsmStateId q, guint32 i, guint32 j,
+			 gfsmLabelVector *input, gfsmLabelVector *output)
+{
+  gfsmTrainNode_ *nodes = (gfsmTrainNode_*)s->nodes->data;
+  gfsmTrainNode_  node;
+  guint32 h;
+
+  for (h=gfsm_train_hash_(q,i,j)&s->mask; s->slots[h] != GFSM_TRAIN_NONE; h=(h+1)&s->mask) {
+    gfsmTrainNode_ *n = &nodes[s->slots[h]];
+    if (n->q==q && n->i==i && n->j==j) return s->slots[h];
+  }
+
+  //-- add a new node
+  node.q      = q;
+  node.i      = i;
+  node.j      = j;
+  node.edges  = GFSM_TRAIN_NONE;
+  node.cursor = NULL;
+  node.color  = 0;
+  node.final  = (i >= input->len && j >= output->len && gfsm_automaton_state_is_final(fst,q));
+  node.fwd    = 0;
+  node.bwd    = 0;
+  node.alpha  = -INFINITY;
+  node.beta   = -INFINITY;
+  g_array_append_val(s->nodes, node);
+  s->slots[h] = s->nodes->len-1;
+
+  //-- grow hash table at load factor 1/2
+  if (2*s->nodes->len > s->mask+1) {
+    guint32 id;
+    g_free(s->slots);
+    s->mask  = 2*s->mask+1;
+    s->slots = g_new(guint32, s->mask+1);
+    memset(s->slots, 0xff, (s->mask+1)*sizeof(guint32));
+    nodes = (gfsmTrainNode_*)s->nodes->data;
+    for (id=0; id < s->nodes->len; id++) {
+      for (h=gfsm_train_hash_(nodes[id].q,nodes[id].i,nodes[id].j)&s->mask; s->slots[h] != GFSM_TRAIN_NONE; h=(h+1)&s->mask) ;
+      s->slots[h] = id;
+    }
+  }
+
+  return s->nodes->len-1;
+}
+
+//--------------------------------------------------------------
+// + releases per-pair storage, keeping allocated memory for the next pair
+static
+void gfsm_train_scratch_reset_(gfsmTrainScratch_ *s)
+{
+  gfsmTrainNode_ *nodes = (gfsmTrainNode_*)s->nodes->data;
+  guint32 id, h;
+  for (id=0; id < s->nodes->len; id++) {
+    //-- probe for id itself, so clearing slots in any order is safe
+    for (h=gfsm_train_hash_(nodes[id].q,nodes[id].i,nodes[id].j)&s->mask; s->slots[h] != id; h=(h+1)&s->mask) ;
+    s->slots[h] = GFSM_TRAIN_NONE;
+  }
+  s->nodes->len = 0;
+  s->edges->len = 0;
+  s->order->len = 0;
+  s->stack->len = 0;
+  s->block = 0;
+  s->used  = 0;
+}
+//--------------------------------------------------------------
+static inline
+gfsmTrainConfig* gfsm_train_config_alloc_(gfsmTrainScratch_ *s, guint32 i, guint32 j, gfsmStateId qf, gfsmArc *a, gfsmTrainConfig *prev)
+{
+  gfsmTrainConfig *cfg;
+  if (s->block >= s->blocks->len) {
+    g_ptr_array_add(s->blocks, g_new(gfsmTrainConfig, GFSM_TRAIN_ARENA_BLOCK));
+  }
+  cfg = ((gfsmTrainConfig*)g_ptr_array_index(s->blocks,s->block)) + s->used;
+  if (++s->used == GFSM_TRAIN_ARENA_BLOCK) {
+    ++s->block;
+    s->used = 0;
+  }
+  cfg->i    = i;
+  cfg->j    = j;
+  cfg->qf   = qf;
+  cfg->a    = a;
+  cfg->prev = prev;
+  return cfg;
+}
+
+//--------------------------------------------------------------
+// + builds the search graph of all configurations reachable from (root,0,0), merging
+//   configurations which share (state,i,j); fills s->order with node ids in post-order
+//   and computes the number of successful paths from each node.
+// + returns FALSE if the search graph is cyclic (i.e. there may be infinitely many paths)
+static
+gboolean gfsm_train_build_graph_(gfsmTrainScratch_ *s, gfsmAutomaton *fst, gfsmLabelVector *input, gfsmLabelVector *output)
+{
+  gboolean acyclic = TRUE;
+  guint32  id, tid;
+  gfsmTrainNode_ *n;
+
+  id = gfsm_train_node_(s, fst, gfsm_automaton_get_root(fst), 0, 0, input, output);
+  g_array_append_val(s->stack, id);
+
+  while (s->stack->len > 0) {
+    gfsmLabelVal a, b;
+    id = g_array_index(s->stack, guint32, s->stack->len-1);
+    n  = &g_array_index(s->nodes, gfsmTrainNode_, id);
+
+    //-- first visit: start arc iteration
+    if (n->color == 0) {
+      const gfsmState *qt = gfsm_automaton_find_state_const(fst, n->q);
+      n->color  = 1;
+      n->cursor = (qt && qt->is_valid) ? qt->arcs : NULL;
+    }
+    a = (n->i < input->len  ? (gfsmLabelVal)GPOINTER_TO_UINT(g_ptr_array_index(input,  n->i)) : gfsmNoLabel);
+    b = (n->j < output->len ? (gfsmLabelVal)GPOINTER_TO_UINT(g_ptr_array_index(output, n->j)) : gfsmNoLabel);
+
+    //-- follow next matching arc
+    for ( ; n->cursor != NULL; n->cursor = n->cursor->next) {
+      gfsmArc *arc = &(n->cursor->arc);
+      guint32  i2  = n->i, j2 = n->j;
+      gfsmTrainEdge_ e;
+
+      if      (arc->lower==gfsmEpsilon && arc->upper==gfsmEpsilon) ;
+      else if (arc->lower==gfsmEpsilon && arc->upper==b && b!=gfsmNoLabel) ++j2;
+      else if (arc->lower==a && arc->upper==gfsmEpsilon && a!=gfsmNoLabel) ++i2;
+      else if (arc->lower==a && arc->upper==b && a!=gfsmNoLabel && b!=gfsmNoLabel) { ++i2; ++j2; }
+      else continue;
+
+      n->cursor = n->cursor->next;
+      tid = gfsm_train_node_(s, fst, arc->target, i2, j2, input, output);
+      n   = &g_array_index(s->nodes, gfsmTrainNode_, id);  //-- s->nodes may have been re-allocated
+
+      e.target = tid;
+      e.arc    = arc;
+      e.next   = n->edges;
+      n->edges = s->edges->len;
+      g_array_append_val(s->edges, e);
+
+      switch (g_array_index(s->nodes, gfsmTrainNode_, tid).color) {
+      case 0: g_array_append_val(s->stack, tid); break;
+      case 1: acyclic = FALSE; break;
+      default: break;
+      }
+      break;
+    }
+    if (n->cursor != NULL || g_array_index(s->stack, guint32, s->stack->len-1) != id)
+      continue;
+
+    //-- all arcs done: count successful paths
+    n->color = 2;
+    n->bwd   = n->final ? 1 : 0;
+    for (tid=n->edges; tid != GFSM_TRAIN_NONE; tid=g_array_index(s->edges,gfsmTrainEdge_,tid).next) {
+      gfsmTrainEdge_ *e = &g_array_index(s->edges,gfsmTrainEdge_,tid);
+      n->bwd += g_array_index(s->nodes,gfsmTrainNode_,e->target).bwd;
+    }
+    g_array_append_val(s->order, id);
+    s->stack->len--;
+  }
+
+  return acyclic;
+}
+
+//--------------------------------------------------------------
+// + adds counts for all successful paths directly from the search graph
+static
+void gfsm_train_count_graph_(gfsmTrainer *trainer, gfsmTrainScratch_ *s, gdouble pathMass)
+{
+  gfsmTrainNode_ *nodes = (gfsmTrainNode_*)s->nodes->data;
+  gfsmTrainEdge_ *edges = (gfsmTrainEdge_*)s->edges->data;
+  guint32 oi, ei;
+  guint   wi;
+
+  //-- forward path counts, in topological order
+  nodes[0].fwd = 1;
+  for (oi=s->order->len; oi > 0; oi--) {
+    gfsmTrainNode_ *n = &nodes[g_array_index(s->order,guint32,oi-1)];
+    if (n->fwd == 0 || n->bwd == 0) continue;
+
+    if (n->final) {
+      wi = gfsm_automaton_get_final_weight(trainer->fst, n->q);
+      s->counts[wi] += pathMass * n->fwd;
+    }
+    for (ei=n->edges; ei != GFSM_TRAIN_NONE; ei=edges[ei].next) {
+      gfsmTrainNode_ *t = &nodes[edges[ei].target];
+      if (t->bwd == 0) continue;
+      wi = edges[ei].arc->weight;
+      s->counts[wi] += pathMass * n->fwd * t->bwd;
+      t->fwd += n->fwd;
+    }
+  }
+}
+
+//--------------------------------------------------------------
+// + log probability of weight w in semiring sr
+static inline
+gdouble gfsm_train_logprob_(gfsmSemiring *sr, gfsmWeight w)
+{
+  switch (sr->type) {
+  case gfsmSRTReal:
+  case gfsmSRTProb:     return log(w);
+  case gfsmSRTLog:
+  case gfsmSRTTropical: return -w;
+  case gfsmSRTPLog:
+  case gfsmSRTArctic:   return w;
+  default:              return 0;
+  }
+}
+
+//--------------------------------------------------------------
+static inline
+gdouble gfsm_train_logadd_(gdouble x, gdouble y)
+{
+  if (x == -INFINITY) return y;
+  if (y == -INFINITY) return x;
+  return x > y ? (x + log1p(exp(y-x))) : (y + log1p(exp(x-y)));
+}
+
+//--------------------------------------------------------------
+// + adds posterior expected counts for all successful paths (forward-backward on the search graph)
+static
+void gfsm_train_expect_graph_(gfsmTrainer *trainer, gfsmTrainScratch_ *s)
+{
+  gfsmTrainNode_ *nodes = (gfsmTrainNode_*)s->nodes->data;
+  gfsmTrainEdge_ *edges = (gfsmTrainEdge_*)s->edges->data;
+  gfsmSemiring   *sr    = trainer->fst->sr;
+  gdouble  lpf, lpa, logZ;
+  guint32  oi, ei;
+  guint    wi;
+
+  //-- backward probabilities, in post-order
+  for (oi=0; oi < s->order->len; oi++) {
+    gfsmTrainNode_ *n = &nodes[g_array_index(s->order,guint32,oi)];
+    if (n->bwd == 0) continue;
+    if (n->final) {
+      wi      = gfsm_automaton_get_final_weight(trainer->fst, n->q);
+      n->beta = gfsm_train_logprob_(sr, trainer->weights[wi]);
+    }
+    for (ei=n->edges; ei != GFSM_TRAIN_NONE; ei=edges[ei].next) {
+      gfsmTrainNode_ *t = &nodes[edges[ei].target];
+      if (t->bwd == 0) continue;
+      lpa     = gfsm_train_logprob_(sr, trainer->weights[(guint)edges[ei].arc->weight]);
+      n->beta = gfsm_train_logadd_(n->beta, lpa + t->beta);
+    }
+  }
+  logZ = nodes[0].beta;
+  if (logZ == -INFINITY || isnan(logZ)) return;
+
+  //-- forward probabilities & posteriors, in topological order
+  nodes[0].alpha = 0;
+  for (oi=s->order->len; oi > 0; oi--) {
+    gfsmTrainNode_ *n = &nodes[g_array_index(s->order,guint32,oi-1)];
+    if (n->alpha == -INFINITY || n->beta == -INFINITY) continue;
+
+    if (n->final) {
+      wi  = gfsm_automaton_get_final_weight(trainer->fst, n->q);
+      lpf = gfsm_train_logprob_(sr, trainer->weights[wi]);
+      s->counts[wi] += exp(n->alpha + lpf - logZ);
+    }
+    for (ei=n->edges; ei != GFSM_TRAIN_NONE; ei=edges[ei].next) {
+      gfsmTrainNode_ *t = &nodes[edges[ei].target];
+      if (t->beta == -INFINITY) continue;
+      wi  = edges[ei].arc->weight;
+      lpa = gfsm_train_logprob_(sr, trainer->weights[wi]);
+      s->counts[wi] += exp(n->alpha + lpa + t->beta - logZ);
+      t->alpha = gfsm_train_logadd_(t->alpha, n->alpha + lpa);
+    }
+  }
+}
+
+//--------------------------------------------------------------
+// + enumerates successful paths through the search graph as gfsmTrainConfig chains
+//   allocated from the arena
+// + returns a GSList* of path-final gfsmTrainConfig*
+static
+GSList* gfsm_train_enum_paths_(gfsmTrainScratch_ *s)
+{
+  gfsmTrainNode_  *nodes = (gfsmTrainNode_*)s->nodes->data;
+  gfsmTrainEdge_  *edges = (gfsmTrainEdge_*)s->edges->data;
+  GPtrArray       *cfgs  = g_ptr_array_new(); //-- DFS stack of configs, parallel to edge cursors in s->stack
+  GSList          *succ  = NULL;
+  gfsmTrainConfig *cfg;
+  guint32 ei;
+
+  if (nodes[0].bwd == 0) return NULL;
+  s->stack->len = 0;
+  cfg = gfsm_train_config_alloc_(s, 0, 0, gfsmNoState, NULL, NULL);
+  g_ptr_array_add(cfgs, cfg);
+  g_array_append_val(s->stack, nodes[0].edges);
+  if (nodes[0].final)
+    succ = g_slist_prepend(succ, gfsm_train_config_alloc_(s, 0, 0, nodes[0].q, NULL, cfg));
+
+  while (s->stack->len > 0) {
+    guint32 *cursor = &g_array_index(s->stack, guint32, s->stack->len-1);
+    gfsmTrainNode_ *t;
+
+    //-- skip edges into dead ends
+    while (*cursor != GFSM_TRAIN_NONE && nodes[edges[*cursor].target].bwd == 0)
+      *cursor = edges[*cursor].next;
+    if (*cursor == GFSM_TRAIN_NONE) {
+      s->stack->len--;
+      cfgs->len--;
+      continue;
+    }
+    ei      = *cursor;
+    *cursor = edges[ei].next;
+
+    //-- follow edge
+    t   = &nodes[edges[ei].target];
+    cfg = gfsm_train_config_alloc_(s, t->i, t->j, gfsmNoState, edges[ei].arc,
+				   (gfsmTrainConfig*)g_ptr_array_index(cfgs, cfgs->len-1));
+    if (t->final)
+      succ = g_slist_prepend(succ, gfsm_train_config_alloc_(s, t->i, t->j, t->q, NULL, cfg));
+    g_ptr_array_add(cfgs, cfg);
+    g_array_append_val(s->stack, t->edges);
+  }
+
+  g_ptr_array_free(cfgs,TRUE);
+  return succ;
+}
+
+/*======================================================================
+ * Methods: train: high-level (cont.)
+ */
+
+//--------------------------------------------------------------
+// + guts for gfsm_trainer_train() and gfsm_trainer_train_pairs(): read-only on trainer, updates s->counts
+static
+void gfsm_trainer_train_scratch_(gfsmTrainer *trainer, gfsmTrainScratch_ *s, gfsmLabelVector *input, gfsmLabelVector *output)
 {
   gfsmAutomaton *fst = trainer->fst;
-  gfsmTrainConfig *cfg=gfsm_train_config_new(0,0,gfsmNoState,NULL,NULL), *cfg_new=NULL;
-  GSList *stack=NULL; //-- DFS search stack, GSList* of gfsmTrainConfig*
-  GSList *used=NULL;  //-- used search configs, GSList* of gfsmTrainConfig*
+  gfsmTrainConfig *cfg;
   GSList *succ=NULL;  //-- final configs of successful paths, GSList* of path-final gfsmTrainConfig*
   GSList *paths=NULL; //-- full successful paths, GSList* of gfsmTrainPath* (==GPtrArray*)
   GSList *nod;	      //-- list-iterator temporary
-  gfsmStateId	    q;
-  const gfsmState  *qt;
-  gfsmLabelVal      a,b;
-  gfsmArcIter       ai;
   gfsmWeight        pathMass, arcMass;
 
-  //-- sanity check(s)
-  if (!trainer->fst) {
-    g_printerr("gfsm_trainer_train(): cannot train NULL fst");
-    exit(1);
+  //-- search: build graph of unique (state,i,j) configurations
+  if (!gfsm_train_build_graph_(s, fst, input, output)) {
+    g_printerr("gfsm_trainer_train(): epsilon cycle in search space - ignoring training pair\n");
+    gfsm_train_scratch_reset_(s);
+    return;
   }
 
-  //-- initialization
-  stack = g_slist_prepend(stack, cfg);
-
-  //-- ye olde loope
-  while (stack != NULL) {
-    //-- pop the top element off the stack, and push it to the 'used'-list
-    cfg       = (gfsmTrainConfig*)(stack->data);
-    nod       = stack;
-    stack     = g_slist_remove_link(stack, nod);
-    nod->next = used;
-    used      = nod;
-
-    //-- get state, labels
-    q  = gfsm_train_config_stateid(cfg, fst);
-    qt = gfsm_automaton_find_state_const(fst, q);
-    a  = (cfg->i < input->len  ? (gfsmLabelVal)GPOINTER_TO_UINT(g_ptr_array_index(input,  cfg->i)) : gfsmNoLabel);
-    b  = (cfg->j < output->len ? (gfsmLabelVal)GPOINTER_TO_UINT(g_ptr_array_index(output, cfg->j)) : gfsmNoLabel);
-
-    //-- check for final states
-    if (cfg->i >= input->len && cfg->j >= output->len && gfsm_state_is_final(qt)) {
-      cfg_new = gfsm_train_config_new(cfg->i, cfg->j, q, NULL, cfg);
-      succ    = g_slist_prepend(succ, cfg_new);
-      used    = g_slist_prepend(used, cfg_new);
-    }
-
-    //-- handle outgoing arcs
-    for (gfsm_arciter_open_ptr(&ai, fst, (gfsmState*)qt); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai))
-      {
-	gfsmArc *arc = gfsm_arciter_arc(&ai);
+  //-------- expected counts: forward-backward on the search graph
+  if (trainer->expectedCounts) {
+    gfsm_train_expect_graph_(trainer, s);
+    gfsm_train_scratch_reset_(s);
+    return;
+  }
 
-	//-- arc: (eps,eps)
-	if (arc->lower==gfsmEpsilon && arc->upper==gfsmEpsilon) {
-	  cfg_new = gfsm_train_config_new(cfg->i, cfg->j, gfsmNoState, arc, cfg);
-	}
-	//-- arc: (eps,b)
-	else if (arc->lower==gfsmEpsilon && arc->upper==b && b!=gfsmNoLabel) {
-	  cfg_new = gfsm_train_config_new(cfg->i, cfg->j+1, gfsmNoState, arc, cfg);
-	}
-	//-- arc: (a,eps)
-	else if (arc->lower==a && arc->upper==gfsmEpsilon && a!=gfsmNoLabel) {
-	  cfg_new = gfsm_train_config_new(cfg->i+1, cfg->j, gfsmNoState, arc, cfg);
-	}
-	//-- arc: (a,b)
-	else if (arc->lower==a && arc->upper==b && a!=gfsmNoLabel && b!=gfsmNoLabel) {
-	  cfg_new = gfsm_train_config_new(cfg->i+1, cfg->j+1, gfsmNoState, arc, cfg);
-	}
-	//-- arc: other
-	else {
-	  continue;
-	}
-	stack = g_slist_prepend(stack, cfg_new);
-      }
-    gfsm_arciter_close(&ai);
+  //-------- no path-level options: count directly on the search graph
+  if (!trainer->bestPathsOnly && !trainer->prunePathPermutations && !trainer->distributeOverArcs) {
+    gdouble npaths = g_array_index(s->nodes,gfsmTrainNode_,0).bwd;
+    if (npaths > 0)
+      gfsm_train_count_graph_(trainer, s, (trainer->distributeOverPaths ? 1.0/npaths : 1.0));
+    gfsm_train_scratch_reset_(s);
+    return;
   }
 
   //-------- convert successful configs to paths
+  succ = gfsm_train_enum_paths_(s);
   for (nod=succ; nod!=NULL; nod=nod->next) {
     paths = g_slist_prepend(paths, gfsm_train_path_new((gfsmTrainConfig*)nod->data));;
   }
+  g_slist_free(succ);
 
   //-------- prune (multiple successful paths only)
   if (paths && paths->next) {
@@ -397,11 +754,11 @@ void gfsm_trainer_train(gfsmTrainer *trainer, gfsmLabelVector *input, gfsmLabelV
       cfg = (gfsmTrainConfig*)path->pdata[i];
       if (cfg->a) {
 	wi = cfg->a->weight;
-	trainer->counts[wi] += arcMass;
+	s->counts[wi] += arcMass;
       }
       if (cfg->qf != gfsmNoState) {
 	wi = gfsm_automaton_get_final_weight(fst,cfg->qf);
-	trainer->counts[wi] += arcMass;
+	s->counts[wi] += arcMass;
       }
     }
 
@@ -409,11 +766,82 @@ void gfsm_trainer_train(gfsmTrainer *trainer, gfsmLabelVector *input, gfsmLabelV
     g_ptr_array_free(path, TRUE);
   }
 
-  //-- cleanup: used configs
-  while (used != NULL) {
-    cfg  = (gfsmTrainConfig*)used->data;
-    used = g_slist_delete_link(used,used);
-    gfsm_slice_free(gfsmTrainConfig,cfg);
+  //-- cleanup: configs
+  gfsm_train_scratch_reset_(s);
+}
+
+//--------------------------------------------------------------
+void gfsm_trainer_train(gfsmTrainer *trainer, gfsmLabelVector *input, gfsmLabelVector *output)
+{
+  gfsmTrainScratch_ s;
+  guint wi;
+
+  //-- sanity check(s)
+  if (!trainer->fst) {
+    g_printerr("gfsm_trainer_train(): cannot train NULL fst");
+    exit(1);
+  }
+
+  gfsm_train_scratch_init_(&s, trainer->nweights);
+  gfsm_trainer_train_scratch_(trainer, &s, input, output);
+  for (wi=0; wi < trainer->nweights; wi++)
+    trainer->counts[wi] += s.counts[wi];
+  gfsm_train_scratch_clear_(&s);
+}
+
+/// shared data for gfsm_trainer_train_pairs()
+typedef struct {
+  gfsmTrainer       *trainer;
+  GPtrArray         *inputs;
+  GPtrArray         *outputs;
+  gfsmTrainScratch_ *scratch;  //-- [thread_id] : scratch data
+} gfsmTrainPairsData_;
+
+//--------------------------------------------------------------
+// + gfsmParallelFunc: trains on pairs [begin,end)
+static
+void gfsm_trainer_train_chunk_(guint begin, guint end, guint thread_id, gfsmTrainPairsData_ *data)
+{
+  guint i;
+  for (i=begin; i < end; i++) {
+    gfsm_trainer_train_scratch_(data->trainer, &data->scratch[thread_id],
+				(gfsmLabelVector*)g_ptr_array_index(data->inputs,i),
+				(gfsmLabelVector*)g_ptr_array_index(data->outputs,i));
   }
+}
 
+//--------------------------------------------------------------
+void gfsm_trainer_train_pairs(gfsmTrainer *trainer, GPtrArray *inputs, GPtrArray *outputs, guint n_threads)
+{
+  gfsmTrainPairsData_ data;
+  guint t, wi;
+
+  //-- sanity check(s)
+  if (!trainer->fst) {
+    g_printerr("gfsm_trainer_train_pairs(): cannot train NULL fst");
+    exit(1);
+  }
+  if (n_threads == 0) n_threads = gfsm_threads_get_default();
+  if (n_threads > inputs->len) n_threads = MAX(1,inputs->len);
+
+  //-- per-thread scratch and counts
+  data.trainer = trainer;
+  data.inputs  = inputs;
+  data.outputs = outputs;
+  data.scratch = g_new(gfsmTrainScratch_, n_threads);
+  for (t=0; t < n_threads; t++) {
+    gfsm_train_scratch_init_(&data.scratch[t], trainer->nweights);
+  }
+
+  gfsm_parallel_for(inputs->len, n_threads, 0, (gfsmParallelFunc)gfsm_trainer_train_chunk_, &data);
+
+  //-- merge counts: per-thread partial sums are kept in double precision, so that
+  //   the result does not depend on the number of threads
+  for (wi=0; wi < trainer->nweights; wi++) {
+    gdouble c = 0;
+    for (t=0; t < n_threads; t++) c += data.scratch[t].counts[wi];
+    trainer->counts[wi] += c;
+  }
+  for (t=0; t < n_threads; t++) gfsm_train_scratch_clear_(&data.scratch[t]);
+  g_free(data.scratch);
 }
@@ -62,6 +62,14 @@ typedef struct {
    */
   gboolean distributeOverArcs;
 
+  /** 
+   * If true, each (input,output) pair adds the expected number of occurrences of each arc
+   * (rsp. final weight) in its successful paths, computed by the forward-backward algorithm
+   * with path probabilities given by the original weights (see gfsm_trainer_train()).
+   * Overrides all other training options.
+   */
+  gboolean expectedCounts;
+
   /** 
    * source transducer to use for training; weights are indices into ::gfsmTrainer::weights
    */
@@ -134,10 +142,35 @@ gfsmAutomaton* gfsm_trainer_automaton(gfsmTrainer *trainer, gboolean steal);
  *  number of occurrences of the corresponding arc (rsp. final state) in any successful path in \a fst
  *  with labels (\a input, \a output).  May be run multiple times on the same trainer to add
  *  counts for multiple (\a input, \a output) pairs.
+ *
+ *  Search configurations sharing (state,i,j) are merged, so the search itself takes time
+ *  polynomial in the lengths of \a input and \a output.  If none of ::gfsmTrainer::bestPathsOnly,
+ *  ::gfsmTrainer::prunePathPermutations, and ::gfsmTrainer::distributeOverArcs is set, counts
+ *  are computed directly on the merged search graph; otherwise successful paths are enumerated.
+ *  Pairs whose search space contains an epsilon cycle are ignored with a warning.
+ *
+ *  If ::gfsmTrainer::expectedCounts is set, counts are instead incremented by posterior expected
+ *  occurrence counts under the original weights of \a trainer->fst, interpreted as probabilities
+ *  in the ::gfsmSRTReal and ::gfsmSRTProb semirings, as negative log probabilities in the
+ *  ::gfsmSRTLog and ::gfsmSRTTropical semirings, and as log probabilities in the ::gfsmSRTPLog
+ *  and ::gfsmSRTArctic semirings.  In all other semirings, all successful paths are equally likely.
+ *  This takes time linear in the size of the merged search graph.
  *  \param trainer transducer trainer, which should have been initialized as by gfsm_trainer_new()
  *  \param input input labels (lower)
  *  \param output output labels (upper)
  */
 void gfsm_trainer_train(gfsmTrainer *trainer, gfsmLabelVector *input, gfsmLabelVector *output);
 
+//------------------------------
+/** train on multiple (input,output) pairs, as if by calling gfsm_trainer_train() for each pair in turn.
+ *  Pairs are processed by up to \a n_threads worker threads, each of which accumulates its own
+ *  double-precision count vector; these are summed and added to \a trainer->counts when all
+ *  pairs are done, so that the resulting counts do not depend on \a n_threads.
+ *  \param trainer transducer trainer, which should have been initialized as by gfsm_trainer_new()
+ *  \param inputs  input label vectors: GPtrArray* of gfsmLabelVector*
+ *  \param outputs output label vectors: GPtrArray* of gfsmLabelVector*, parallel to \a inputs
+ *  \param n_threads number of threads to use, or 0 (zero) for gfsm_threads_get_default()
+ */
+void gfsm_trainer_train_pairs(gfsmTrainer *trainer, GPtrArray *inputs, GPtrArray *outputs, guint n_threads);
+
 #endif /* _GFSM_TRAIN_H */
@@ -34,7 +34,8 @@ const gfsmAutomatonFlags gfsmTrieDefaultFlags =
     TRUE,         //-- is_weighted:1
     TRUE,         //-- is_deterministic:1
     gfsmASMLower, //-- sort_mode:24
-    0             //-- unused:5
+    FALSE,        //-- is_indexed:1
+    0             //-- unused:4
   };
 
 const gfsmSRType gfsmTrieDefaultSRType = gfsmSRTReal;
@@ -68,6 +69,9 @@ gfsmStateId gfsm_trie_add_path_full(gfsmTrie          *trie,
   gfsmStateId  qid;
   guint i;
 
+  //-- arc weights are modified in place
+  gfsm_automaton_touch(trie);
+
   //-- ensure trie has a root state
   if (!gfsm_automaton_has_state(trie,trie->root_id)) {
     trie->root_id = gfsm_automaton_add_state(trie);
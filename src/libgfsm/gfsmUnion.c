@@ -33,21 +33,74 @@
  */
 
 /*--------------------------------------------------------------
- * union_()
+ * union_adopt_()
+ *  + copies states of fsm2 into fsm1 at (fsm2 qid)+offset
+ *  + fsm1 should already have room for all states of fsm2
+ *  + fsm1 "smart" arc-insertion should be disabled; sortdata->mask holds the original sort mode of fsm1
  */
-gfsmAutomaton *gfsm_automaton_union(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2)
+static
+void gfsm_automaton_union_adopt_(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2, gfsmStateId offset, gfsmArcCompData *sortdata)
 {
-  gfsmStateId offset;
   gfsmStateId id2;
+
+  for (id2 = 0; id2 < fsm2->states->len; id2++) {
+    const gfsmState *s2 = gfsm_automaton_find_state_const(fsm2,id2);
+    gfsmState       *s1 = gfsm_automaton_find_state(fsm1,id2+offset);
+    gfsmArcIter      ai;
+    gfsm_state_copy_full(s1,s2,fsm1->arc_pool);
+    for (gfsm_arciter_open_ptr(&ai, fsm1, s1); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      gfsmArc *a = gfsm_arciter_arc(&ai);
+      a->target += offset;
+    }
+    //-- index final states from @fsm2
+    if (s2->is_final) {
+      gfsm_automaton_set_final_state_full(fsm1, id2+offset, TRUE, gfsm_automaton_get_final_weight(fsm2, id2));
+    }
+    //-- maybe sort new arcs
+    if (sortdata->mask != gfsmASMNone
+	&& (fsm2->flags.sort_mode != sortdata->mask
+	    || (sortdata->mask == gfsmASMWeight && fsm2->sr->type != fsm1->sr->type)))
+      {
+	s1->arcs = gfsm_arclist_sort(s1->arcs, sortdata);
+      }
+  }
+}
+
+/*--------------------------------------------------------------
+ * union()
+ */
+gfsmAutomaton *gfsm_automaton_union(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2)
+{
+  return gfsm_automaton_union_n(fsm1, &fsm2, 1);
+}
+
+/*--------------------------------------------------------------
+ * union_n()
+ */
+gfsmAutomaton *gfsm_automaton_union_n(gfsmAutomaton *fsm1, gfsmAutomaton **fsms, guint n_fsms)
+{
+  gfsmAutomaton **fsms2 = g_new0(gfsmAutomaton*, n_fsms);
+  gfsmStateId offset, size;
   gfsmStateId oldroot1;
   gfsmArcCompData sortdata = {0,0,0,0};
+  guint i;
+
+  //-- get inputs (copying fsm1 if it is also an input) and total size
+  size = fsm1->states->len + 1;
+  for (i=0; i < n_fsms; i++) {
+    if (!fsms[i] || fsms[i]->root_id==gfsmNoState) continue;
+    fsms2[i] = (fsms[i]==fsm1 ? gfsm_automaton_clone(fsm1) : fsms[i]);
+    size    += fsms2[i]->states->len;
+  }
 
   //-- sanity check
-  if (!fsm2 || fsm2->root_id==gfsmNoState) return fsm1;
+  if (size == fsm1->states->len + 1) {
+    g_free(fsms2);
+    return fsm1;
+  }
 
   offset = fsm1->states->len + 1;
-  gfsm_automaton_reserve(fsm1, offset + fsm2->states->len);
-
+  gfsm_automaton_reserve(fsm1, size);
 
   //-- add new root and eps-arc to old root for fsm1
   oldroot1 = fsm1->root_id;
@@ -61,39 +114,181 @@ gfsmAutomaton *gfsm_automaton_union(gfsmAutomaton *fsm1, gfsmAutomaton *fsm2)
   sortdata.sr   = fsm1->sr;
   fsm1->flags.sort_mode = gfsmASMNone;
 
-  //-- adopt states from fsm2 into fsm1
-  for (id2 = 0; id2 < fsm2->states->len; id2++) {
-    const gfsmState *s2 = gfsm_automaton_find_state_const(fsm2,id2);
-    gfsmState       *s1 = gfsm_automaton_find_state(fsm1,id2+offset);
-    gfsmArcIter      ai;
-    gfsm_state_copy(s1,s2);
-    for (gfsm_arciter_open_ptr(&ai, fsm1, s1); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
-      gfsmArc *a = gfsm_arciter_arc(&ai);
-      a->target += offset;
-    }
-    //-- index final states from @fsm2
-    if (s2->is_final) {
-      gfsm_automaton_set_final_state_full(fsm1, id2+offset, TRUE, gfsm_automaton_get_final_weight(fsm2, id2));
-    }
-    //-- maybe sort new arcs
-    if (sortdata.mask != gfsmASMNone
-	&& (fsm2->flags.sort_mode != sortdata.mask
-	    || (sortdata.mask == gfsmASMWeight && fsm2->sr->type != fsm1->sr->type)))
-      {
-	s1->arcs = gfsm_arclist_sort(s1->arcs, &sortdata);
-      }
+  //-- adopt states from each input into fsm1
+  for (i=0, size=offset; i < n_fsms; i++) {
+    if (!fsms2[i]) continue;
+    gfsm_automaton_union_adopt_(fsm1, fsms2[i], size, &sortdata);
+    size += fsms2[i]->states->len;
   }
 
   //-- re-instate "smart" arc-insertion
   fsm1->flags.sort_mode = sortdata.mask;
 
-  //-- add epsilon arc to translated root(fsm2) in fsm1
-  gfsm_automaton_add_arc(fsm1,
-			 fsm1->root_id,
-			 offset + fsm2->root_id,
-			 gfsmEpsilon,
-			 gfsmEpsilon,
-			 fsm1->sr->one);
+  //-- add epsilon arcs to translated input roots in fsm1
+  for (i=0; i < n_fsms; i++) {
+    if (!fsms2[i]) continue;
+    gfsm_automaton_add_arc(fsm1,
+			   fsm1->root_id,
+			   offset + fsms2[i]->root_id,
+			   gfsmEpsilon,
+			   gfsmEpsilon,
+			   fsm1->sr->one);
+    offset += fsms2[i]->states->len;
+    if (fsms2[i] != fsms[i]) gfsm_automaton_free(fsms2[i]);
+  }
+
+  g_free(fsms2);
+  return fsm1;
+}
+
+/*======================================================================
+ * Methods: algebra: union: trie
+ */
+
+/// state-pair stack entry for gfsm_automaton_union_trie_n()
+typedef struct {
+  gfsmStateId q;       ///< state in input automaton
+  gfsmStateId t;       ///< state in output automaton
+  gboolean    shared;  ///< whether t is a prefix-tree state which may be shared with other inputs
+} gfsmUnionTrieItem;
+
+//--------------------------------------------------------------
+// union_trie_indegree_(): increment in-degree of qid in indeg (a GArray of guint32)
+static inline
+void gfsm_union_trie_indegree_inc_(GArray *indeg, gfsmStateId qid)
+{
+  if (qid >= indeg->len) g_array_set_size(indeg, qid+1);
+  ++g_array_index(indeg,guint32,qid);
+}
+
+//--------------------------------------------------------------
+// union_trie_private_(): get private copy of input state q in fsm1, creating and queueing it if required
+static inline
+gfsmStateId gfsm_union_trie_private_(gfsmAutomaton *fsm1, GArray *q2t, GArray *stack, gfsmStateId q)
+{
+  gfsmStateId *tp = &g_array_index(q2t,gfsmStateId,q);
+  if (*tp == gfsmNoState) {
+    gfsmUnionTrieItem item;
+    *tp = item.t = gfsm_automaton_add_state(fsm1);
+    item.q      = q;
+    item.shared = FALSE;
+    g_array_append_val(stack,item);
+  }
+  return *tp;
+}
+
+//--------------------------------------------------------------
+// union_trie_find_(): find shareable arc (lo,hi,w) from t in fsm1 to a tree state t' < tmax
+static
+gfsmStateId gfsm_union_trie_find_(gfsmAutomaton *fsm1, GArray *indeg, gfsmStateId t, gfsmStateId tmax, gfsmArc *a2)
+{
+  gfsmArcIter ai;
+  gfsmStateId found = gfsmNoState;
+  for (gfsm_arciter_open(&ai,fsm1,t); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+    gfsmArc *a1 = gfsm_arciter_arc(&ai);
+    if (a1->lower == a2->lower && a1->upper == a2->upper && a1->weight == a2->weight
+	&& a1->target < tmax && a1->target < indeg->len && g_array_index(indeg,guint32,a1->target) == 1)
+      {
+	found = a1->target;
+	break;
+      }
+  }
+  gfsm_arciter_close(&ai);
+  return found;
+}
+
+/*--------------------------------------------------------------
+ * union_trie_n()
+ */
+gfsmAutomaton *gfsm_automaton_union_trie_n(gfsmAutomaton *fsm1, gfsmAutomaton **fsms, guint n_fsms)
+{
+  GArray *indeg = g_array_sized_new(FALSE,TRUE,sizeof(guint32),fsm1->states->len);
+  GArray *q2t   = g_array_new(FALSE,FALSE,sizeof(gfsmStateId));
+  GArray *stack = g_array_new(FALSE,FALSE,sizeof(gfsmUnionTrieItem));
+  gfsmArcCompMask sort_mask = fsm1->flags.sort_mode;
+  gfsmStateId qid, size;
+  gfsmArcIter ai;
+  guint i;
+
+  //-- get in-degrees of existing states
+  g_array_set_size(indeg, fsm1->states->len);
+  for (qid=0; qid < fsm1->states->len; qid++) {
+    if (!gfsm_automaton_has_state(fsm1,qid)) continue;
+    for (gfsm_arciter_open(&ai,fsm1,qid); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+      gfsm_union_trie_indegree_inc_(indeg, gfsm_arciter_arc(&ai)->target);
+    }
+    gfsm_arciter_close(&ai);
+  }
+
+  //-- ensure fsm1 has a root with no incoming arcs
+  if (fsm1->root_id == gfsmNoState) {
+    fsm1->root_id = gfsm_automaton_add_state(fsm1);
+  }
+  else if (fsm1->root_id < indeg->len && g_array_index(indeg,guint32,fsm1->root_id) > 0) {
+    gfsmStateId oldroot1 = fsm1->root_id;
+    fsm1->root_id = gfsm_automaton_add_state(fsm1);
+    gfsm_automaton_add_arc(fsm1, fsm1->root_id, oldroot1, gfsmEpsilon, gfsmEpsilon, fsm1->sr->one);
+    gfsm_union_trie_indegree_inc_(indeg, oldroot1);
+  }
+
+  //-- avoid "smart" arc-insertion (temporary)
+  fsm1->flags.sort_mode = gfsmASMNone;
+
+  for (i=0; i < n_fsms; i++) {
+    gfsmAutomaton *fsm2 = fsms[i];
+    gfsmUnionTrieItem item;
+    if (!fsm2 || fsm2->root_id==gfsmNoState) continue;
+    if (fsm2==fsm1) fsm2 = gfsm_automaton_clone(fsm1);
+
+    //-- states of fsm1 created for this input are never shared with it
+    size = fsm1->states->len;
+    g_array_set_size(q2t, fsm2->states->len);
+    for (qid=0; qid < q2t->len; qid++) g_array_index(q2t,gfsmStateId,qid) = gfsmNoState;
+
+    item.q      = fsm2->root_id;
+    item.t      = fsm1->root_id;
+    item.shared = TRUE;
+    g_array_append_val(stack,item);
+
+    while (stack->len > 0) {
+      item = g_array_index(stack,gfsmUnionTrieItem,stack->len-1);
+      g_array_set_size(stack, stack->len-1);
+
+      //-- final weights
+      if (gfsm_automaton_is_final_state(fsm2,item.q)) {
+	gfsmWeight fw = gfsm_automaton_get_final_weight(fsm2,item.q);
+	if (gfsm_automaton_is_final_state(fsm1,item.t))
+	  fw = gfsm_sr_plus(fsm1->sr, fw, gfsm_automaton_get_final_weight(fsm1,item.t));
+	gfsm_automaton_set_final_state_full(fsm1, item.t, TRUE, fw);
+      }
+
+      //-- arcs: share prefix-tree arcs where possible, otherwise copy
+      for (gfsm_arciter_open(&ai,fsm2,item.q); gfsm_arciter_ok(&ai); gfsm_arciter_next(&ai)) {
+	gfsmArc    *a2 = gfsm_arciter_arc(&ai);
+	gfsmStateId t2 = gfsmNoState;
+
+	if (item.shared && (t2 = gfsm_union_trie_find_(fsm1, indeg, item.t, size, a2)) != gfsmNoState) {
+	  gfsmUnionTrieItem next = {a2->target, t2, TRUE};
+	  g_array_append_val(stack,next);
+	  continue;
+	}
+
+	t2 = gfsm_union_trie_private_(fsm1, q2t, stack, a2->target);
+	gfsm_automaton_add_arc(fsm1, item.t, t2, a2->lower, a2->upper, a2->weight);
+	gfsm_union_trie_indegree_inc_(indeg, t2);
+      }
+      gfsm_arciter_close(&ai);
+    }
+
+    if (fsm2 != fsms[i]) gfsm_automaton_free(fsm2);
+  }
+
+  //-- re-instate "smart" arc-insertion
+  if (sort_mask != gfsmASMNone) gfsm_automaton_arcsort(fsm1, sort_mask);
+  fsm1->flags.sort_mode = sort_mask;
 
+  g_array_free(indeg,TRUE);
+  g_array_free(q2t,TRUE);
+  g_array_free(stack,TRUE);
   return fsm1;
 }
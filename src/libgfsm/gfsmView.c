@@ -0,0 +1,75 @@
+/*=============================================================================*\
+ * File: gfsmView.c
+ * Author: agent <agent@local>
+ * Description: finite state machine library: read-only automaton views
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+#include <gfsmView.h>
+#include <gfsmMatcher.h>
+
+//-- no-inline definitions
+#ifndef GFSM_INLINE_ENABLED
+# include <gfsmView.hi>
+#endif
+
+/*======================================================================
+ * Accessors
+ */
+
+//--------------------------------------------------------------
+guint gfsm_view_match(gfsmAutomatonView *view, gfsmStateId qid, gfsmLabelVal lab, GArray *matches)
+{
+  if (view->index_lower) return gfsm_matcher_match_table(view->index_lower, view->sr, qid, lab, matches);
+  return (view->fsm
+	  ? gfsm_matcher_match_state(view->fsm, qid, lab, matches)
+	  : gfsm_matcher_match_indexed(view->xfsm, qid, lab, matches));
+}
+
+//--------------------------------------------------------------
+gfsmArcTableIndex *gfsm_view_lower_arc_table(gfsmAutomatonView *view, gfsmArcCompMask mask)
+{
+  gfsmArcTableIndex *tabx;
+  if (view->index_lower) return view->index_lower;
+  if (view->fsm) {
+    if (gfsm_acmask_nth(view->flags.sort_mode,0) == gfsmACLower) return NULL;
+    tabx = gfsm_automaton_to_arc_table_index(view->fsm,NULL);
+  } else {
+    tabx = gfsm_arc_table_index_clone(view->xfsm->arcs);
+  }
+  gfsm_arc_table_index_sort_bymask(tabx, mask, NULL);
+  return tabx;
+}
+
+/*======================================================================
+ * Arc iterators
+ */
+
+//--------------------------------------------------------------
+gboolean gfsm_view_arciter_has_implicit(const gfsmViewArcIter *vai)
+{
+  gfsmArcList *al;
+  if (!vai->node) {
+    gfsmArcRange range = { vai->arc, vai->arc ? vai->max : NULL };
+    return gfsm_arcrange_has_implicit(&range);
+  }
+  for (al=vai->node; al != NULL; al=al->next) {
+    if (gfsm_label_is_implicit(al->arc.lower)) return TRUE;
+  }
+  return FALSE;
+}
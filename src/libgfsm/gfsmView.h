@@ -0,0 +1,189 @@
+/*=============================================================================*\
+ * File: gfsmView.h
+ * Author: agent <agent@local>
+ * Description: finite state machine library: read-only automaton views
+ *
+ * Copyright (c) 2026 agent.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+ *=============================================================================*/
+
+/** \file gfsmView.h
+ *  \brief Uniform read-only access to the states and arcs of vanilla and indexed automata
+ *
+ *  A ::gfsmAutomatonView wraps either a ::gfsmAutomaton or a ::gfsmIndexedAutomaton
+ *  without copying it, so that read-only algorithms written against the view
+ *  can operate on either representation without conversion.
+ */
+
+#ifndef _GFSM_VIEW_H
+#define _GFSM_VIEW_H
+
+#include <gfsmAutomaton.h>
+#include <gfsmIndexed.h>
+
+/*======================================================================
+ * Types
+ */
+
+/// Read-only view of a ::gfsmAutomaton or a ::gfsmIndexedAutomaton
+typedef struct {
+  gfsmAutomaton        *fsm;          /**< underlying vanilla automaton, or NULL */
+  gfsmIndexedAutomaton *xfsm;         /**< underlying indexed automaton, or NULL */
+  gfsmAutomatonFlags    flags;        /**< flags of the underlying automaton */
+  gfsmSemiring         *sr;           /**< semiring of the underlying automaton */
+  gfsmStateId           root_id;      /**< root state of the underlying automaton */
+  gfsmArcTableIndex    *index_lower;  /**< arcs sorted by (source,lower,...), or NULL if unavailable */
+} gfsmAutomatonView;
+
+/// Iterator over the outgoing arcs of a single state of a ::gfsmAutomatonView
+typedef struct {
+  gfsmArc     *arc;   /**< current arc, or NULL if no more arcs are available */
+  gfsmArcList *node;  /**< current arc list node (vanilla automata only) */
+  gfsmArc     *max;   /**< first arc \b not in range (indexed automata only) */
+} gfsmViewArcIter;
+
+/*======================================================================
+ * Methods: constructors
+ */
+///\name Constructors
+//@{
+
+/** Initialize \a view for read-only access to \a fsm.
+ *  \a view is invalidated by any destructive operation on \a fsm.
+ *  \returns \a view
+ */
+GFSM_INLINE
+gfsmAutomatonView *gfsm_automaton_view(gfsmAutomatonView *view, gfsmAutomaton *fsm);
+
+/** Initialize \a view for read-only access to \a xfsm.
+ *  \a view is invalidated by any destructive operation on \a xfsm.
+ *  \returns \a view
+ */
+GFSM_INLINE
+gfsmAutomatonView *gfsm_indexed_automaton_view(gfsmAutomatonView *view, gfsmIndexedAutomaton *xfsm);
+
+//@}
+
+/*======================================================================
+ * Methods: accessors
+ */
+///\name Accessors
+//@{
+
+/** Get number of states (including any invalid states) in \a view */
+GFSM_INLINE
+gfsmStateId gfsm_view_n_states(gfsmAutomatonView *view);
+
+/** Check whether \a view has a valid state \a qid */
+GFSM_INLINE
+gboolean gfsm_view_has_state(gfsmAutomatonView *view, gfsmStateId qid);
+
+/** Check whether state \a qid of \a view is final, and if so store its final weight in \a *wp.
+ *  Otherwise, \a *wp is set to the semiring zero.
+ */
+GFSM_INLINE
+gboolean gfsm_view_lookup_final(gfsmAutomatonView *view, gfsmStateId qid, gfsmWeight *wp);
+
+/** Append all matches for label \a lab from state \a qid of \a view to \a matches (a GArray of ::gfsmArcMatch),
+ *  as for gfsm_matcher_match_table().
+ *  \returns number of matches appended
+ */
+guint gfsm_view_match(gfsmAutomatonView *view, gfsmStateId qid, gfsmLabelVal lab, GArray *matches);
+
+/** Get the arcs of \a view sorted primarily on lower labels, as required for sort-merge joins.
+ *  \param mask sort mask for a temporary table; its primary key should be ::gfsmACLower
+ *  \returns
+ *    \a view->index_lower if available,
+ *    NULL if \a view wraps a vanilla automaton whose arc lists are already sorted on lower labels,
+ *    or else a new temporary table sorted by \a mask, which the caller must free
+ *    with gfsm_arc_table_index_free()
+ */
+gfsmArcTableIndex *gfsm_view_lower_arc_table(gfsmAutomatonView *view, gfsmArcCompMask mask);
+
+//@}
+
+/*======================================================================
+ * Methods: arc iterators
+ */
+///\name Arc Iterators
+//@{
+
+/** Open \a vai for the outgoing arcs of state \a qid in \a view */
+GFSM_INLINE
+void gfsm_view_arciter_open(gfsmViewArcIter *vai, gfsmAutomatonView *view, gfsmStateId qid);
+
+/** Close \a vai (currently does nothing) */
+GFSM_INLINE
+void gfsm_view_arciter_close(gfsmViewArcIter *vai);
+
+/** Check whether \a vai points to a valid arc */
+GFSM_INLINE
+gboolean gfsm_view_arciter_ok(const gfsmViewArcIter *vai);
+
+/** Get the current arc of \a vai, or NULL if none is available.
+ *  The returned arc belongs to the underlying automaton and must not be modified.
+ */
+GFSM_INLINE
+gfsmArc *gfsm_view_arciter_arc(const gfsmViewArcIter *vai);
+
+/** Advance \a vai to the next outgoing arc */
+GFSM_INLINE
+void gfsm_view_arciter_next(gfsmViewArcIter *vai);
+
+/** Open \a vai for the arcs of the arc list \a al */
+GFSM_INLINE
+void gfsm_view_arciter_open_arclist(gfsmViewArcIter *vai, gfsmArcList *al);
+
+/** Open \a vai for the outgoing arcs of state \a qid in the arc table index \a tabx */
+GFSM_INLINE
+void gfsm_view_arciter_open_table(gfsmViewArcIter *vai, gfsmArcTableIndex *tabx, gfsmStateId qid);
+
+/** Advance \a vai to the first arc with lower label >= \a lab.
+ *  Remaining arcs must be sorted primarily by lower label.
+ *  Contiguous (indexed) arcs are searched by galloping if \a gallop is true;
+ *  arc lists are always scanned linearly.
+ */
+GFSM_INLINE
+void gfsm_view_arciter_seek_lower(gfsmViewArcIter *vai, gfsmLabelVal lab, gboolean gallop);
+
+/** Advance \a vai to the first arc with upper label >= \a lab.
+ *  Remaining arcs must be sorted primarily by upper label.
+ *  \see gfsm_view_arciter_seek_lower()
+ */
+GFSM_INLINE
+void gfsm_view_arciter_seek_upper(gfsmViewArcIter *vai, gfsmLabelVal lab, gboolean gallop);
+
+/** Get the number of arcs remaining in \a vai; linear in the number of arcs for arc lists */
+GFSM_INLINE
+guint gfsm_view_arciter_size(const gfsmViewArcIter *vai);
+
+/** Get the number of arcs remaining in \a vai, counting at most \a max arcs of an arc list */
+GFSM_INLINE
+guint gfsm_view_arciter_size_max(const gfsmViewArcIter *vai, guint max);
+
+/** Check whether any arc remaining in \a vai has an implicit lower label (::gfsmSigma, ::gfsmRho, or ::gfsmPhi).
+ *  Contiguous arcs must be sorted primarily by lower label.
+ */
+gboolean gfsm_view_arciter_has_implicit(const gfsmViewArcIter *vai);
+
+//@}
+
+//-- inline definitions
+#ifdef GFSM_INLINE_ENABLED
+# include <gfsmView.hi>
+#endif
+
+#endif /* _GFSM_VIEW_H */
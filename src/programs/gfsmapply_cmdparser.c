@@ -91,9 +91,12 @@ cmdline_parser_print_help (void)
   printf("   -lLABELS   --labels=LABELS   Set -i and -o labels simultaneously.\n");
   printf("   -a         --att-mode        Parse/format string(s) in AT&T-compatible mode.\n");
   printf("   -u         --utf8            Assume UTF-8 encoded alphabet(s) and input(s).\n");
+  printf("   -M         --longest-match   Tokenize input string(s) by longest match over all alphabet symbols.\n");
   printf("   -q         --quiet           Suppress warnings about undefined symbols.\n");
   printf("   -fFSTFILE  --fst=FSTFILE     Transducer to apply (default=stdin).\n");
   printf("   -QN        --maxq=N          Maximum number of result states to generate (default=0:system limit)\n");
+  printf("   -L         --lattice         Build a shared result lattice rather than a path tree.\n");
+  printf("   -C         --connect         Prune non-coaccessible result states (implies --lattice).\n");
   printf("   -A         --align           Output aligned arc paths.\n");
   printf("   -zLEVEL    --compress=LEVEL  Specify compression level of output file.\n");
   printf("   -FFILE     --output=FILE     Specifiy output file (default=stdout).\n");
@@ -125,9 +128,12 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->labels_arg = NULL; 
   args_info->att_mode_flag = 0; 
   args_info->utf8_flag = 0; 
+  args_info->longest_match_flag = 0; 
   args_info->quiet_flag = 0; 
   args_info->fst_arg = gog_strdup("-"); 
   args_info->maxq_arg = 0; 
+  args_info->lattice_flag = 0; 
+  args_info->connect_flag = 0; 
   args_info->align_flag = 0; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
@@ -148,9 +154,12 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->labels_given = 0;
   args_info->att_mode_given = 0;
   args_info->utf8_given = 0;
+  args_info->longest_match_given = 0;
   args_info->quiet_given = 0;
   args_info->fst_given = 0;
   args_info->maxq_given = 0;
+  args_info->lattice_given = 0;
+  args_info->connect_given = 0;
   args_info->align_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
@@ -178,9 +187,12 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "labels", 1, NULL, 'l' },
 	{ "att-mode", 0, NULL, 'a' },
 	{ "utf8", 0, NULL, 'u' },
+	{ "longest-match", 0, NULL, 'M' },
 	{ "quiet", 0, NULL, 'q' },
 	{ "fst", 1, NULL, 'f' },
 	{ "maxq", 1, NULL, 'Q' },
+	{ "lattice", 0, NULL, 'L' },
+	{ "connect", 0, NULL, 'C' },
 	{ "align", 0, NULL, 'A' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
@@ -195,9 +207,12 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'l', ':',
 	'a',
 	'u',
+	'M',
 	'q',
 	'f', ':',
 	'Q', ':',
+	'L',
+	'C',
 	'A',
 	'z', ':',
 	'F', ':',
@@ -318,6 +333,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->utf8_flag = !(args_info->utf8_flag);
           break;
         
+        case 'M':	 /* Tokenize input string(s) by longest match over all alphabet symbols. */
+          if (args_info->longest_match_given) {
+            fprintf(stderr, "%s: `--longest-match' (`-M') option given more than once\n", PROGRAM);
+          }
+          args_info->longest_match_given++;
+         if (args_info->longest_match_given <= 1)
+           args_info->longest_match_flag = !(args_info->longest_match_flag);
+          break;
+        
         case 'q':	 /* Suppress warnings about undefined symbols. */
           if (args_info->quiet_given) {
             fprintf(stderr, "%s: `--quiet' (`-q') option given more than once\n", PROGRAM);
@@ -344,6 +368,24 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->maxq_arg = (int)atoi(val);
           break;
         
+        case 'L':	 /* Build a shared result lattice rather than a path tree. */
+          if (args_info->lattice_given) {
+            fprintf(stderr, "%s: `--lattice' (`-L') option given more than once\n", PROGRAM);
+          }
+          args_info->lattice_given++;
+         if (args_info->lattice_given <= 1)
+           args_info->lattice_flag = !(args_info->lattice_flag);
+          break;
+        
+        case 'C':	 /* Prune non-coaccessible result states (implies --lattice). */
+          if (args_info->connect_given) {
+            fprintf(stderr, "%s: `--connect' (`-C') option given more than once\n", PROGRAM);
+          }
+          args_info->connect_given++;
+         if (args_info->connect_given <= 1)
+           args_info->connect_flag = !(args_info->connect_flag);
+          break;
+        
         case 'A':	 /* Output aligned arc paths. */
           if (args_info->align_given) {
             fprintf(stderr, "%s: `--align' (`-A') option given more than once\n", PROGRAM);
@@ -453,6 +495,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->utf8_flag = !(args_info->utf8_flag);
           }
           
+          /* Tokenize input string(s) by longest match over all alphabet symbols. */
+          else if (strcmp(olong, "longest-match") == 0) {
+            if (args_info->longest_match_given) {
+              fprintf(stderr, "%s: `--longest-match' (`-M') option given more than once\n", PROGRAM);
+            }
+            args_info->longest_match_given++;
+           if (args_info->longest_match_given <= 1)
+             args_info->longest_match_flag = !(args_info->longest_match_flag);
+          }
+          
           /* Suppress warnings about undefined symbols. */
           else if (strcmp(olong, "quiet") == 0) {
             if (args_info->quiet_given) {
@@ -482,6 +534,26 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->maxq_arg = (int)atoi(val);
           }
           
+          /* Build a shared result lattice rather than a path tree. */
+          else if (strcmp(olong, "lattice") == 0) {
+            if (args_info->lattice_given) {
+              fprintf(stderr, "%s: `--lattice' (`-L') option given more than once\n", PROGRAM);
+            }
+            args_info->lattice_given++;
+           if (args_info->lattice_given <= 1)
+             args_info->lattice_flag = !(args_info->lattice_flag);
+          }
+          
+          /* Prune non-coaccessible result states (implies --lattice). */
+          else if (strcmp(olong, "connect") == 0) {
+            if (args_info->connect_given) {
+              fprintf(stderr, "%s: `--connect' (`-C') option given more than once\n", PROGRAM);
+            }
+            args_info->connect_given++;
+           if (args_info->connect_given <= 1)
+             args_info->connect_flag = !(args_info->connect_flag);
+          }
+          
           /* Output aligned arc paths. */
           else if (strcmp(olong, "align") == 0) {
             if (args_info->align_given) {
@@ -25,9 +25,12 @@ struct gengetopt_args_info {
   char * labels_arg;	 /* Set -i and -o labels simultaneously. (default=NULL). */
   int att_mode_flag;	 /* Parse/format string(s) in AT&T-compatible mode. (default=0). */
   int utf8_flag;	 /* Assume UTF-8 encoded alphabet(s) and input(s). (default=0). */
+  int longest_match_flag;	 /* Tokenize input string(s) by longest match over all alphabet symbols. (default=0). */
   int quiet_flag;	 /* Suppress warnings about undefined symbols. (default=0). */
   char * fst_arg;	 /* Transducer to apply (default=stdin). (default=-). */
   int maxq_arg;	 /* Maximum number of result states to generate (default=0:system limit) (default=0). */
+  int lattice_flag;	 /* Build a shared result lattice rather than a path tree. (default=0). */
+  int connect_flag;	 /* Prune non-coaccessible result states (implies --lattice). (default=0). */
   int align_flag;	 /* Output aligned arc paths. (default=0). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
@@ -40,9 +43,12 @@ struct gengetopt_args_info {
   int labels_given;	 /* Whether labels was given */
   int att_mode_given;	 /* Whether att-mode was given */
   int utf8_given;	 /* Whether utf8 was given */
+  int longest_match_given;	 /* Whether longest-match was given */
   int quiet_given;	 /* Whether quiet was given */
   int fst_given;	 /* Whether fst was given */
   int maxq_given;	 /* Whether maxq was given */
+  int lattice_given;	 /* Whether lattice was given */
+  int connect_given;	 /* Whether connect was given */
   int align_given;	 /* Whether align was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
@@ -47,6 +47,7 @@ FILE  *outfile = NULL;
 
 //-- global structs
 gfsmAlphabet  *ilabels=NULL, *olabels=NULL, *qlabels=NULL;
+gfsmTokenizer *itokenizer=NULL;
 gfsmAutomaton *fst = NULL, *result=NULL;
 gfsmError     *err = NULL;
 gfsmLabelVector *labvec = NULL;
@@ -103,6 +104,9 @@ void get_my_options(int argc, char **argv)
 		 progname, args.ilabels_arg, (err ? err->message : "?"));
       exit(2);
     }
+    itokenizer = gfsm_tokenizer_new(ilabels,
+				    (att_mode ? gfsmTFAtt : gfsmTFChars)
+				    | (args.longest_match_flag ? gfsmTFLongest : gfsmTFChars));
   }
   //-- labels: output
   if (args.olabels_given) {
@@ -187,7 +191,10 @@ gfsmAutomaton *lookup_labels(gfsmAutomaton *fst, int argc, char **argv)
   if (max_states==0) max_states = gfsmNoState;
 
   //-- actual lookup
-  result = gfsm_automaton_lookup_full(fst, vec, result, NULL, max_states);
+  if (args.lattice_flag || args.connect_flag)
+    result = gfsm_automaton_lookup_lattice_full(fst, vec, result, NULL, max_states, args.connect_flag);
+  else
+    result = gfsm_automaton_lookup_full(fst, vec, result, NULL, max_states);
 
   //-- cleanup
   g_ptr_array_free(vec,TRUE);
@@ -208,8 +215,11 @@ void apply_word(const char *w)
   fputc('\t', outfile);
 
   //-- lookup guts
-  labvec = gfsm_alphabet_generic_string_to_labels(ilabels, w,labvec, warn_on_undef, att_mode);
-  result = gfsm_automaton_lookup_full(fst, labvec, result, NULL, max_states);
+  labvec = gfsm_tokenizer_string_to_labels(itokenizer, w,labvec, warn_on_undef);
+  if (args.lattice_flag || args.connect_flag)
+    result = gfsm_automaton_lookup_lattice_full(fst, labvec, result, NULL, max_states, args.connect_flag);
+  else
+    result = gfsm_automaton_lookup_full(fst, labvec, result, NULL, max_states);
 
   //-- stringification
   if (args.align_flag) {
@@ -309,6 +319,7 @@ int main (int argc, char **argv)
   if (outfile != stdout) fclose(outfile);
   if (fst)    gfsm_automaton_free(fst);
   if (result) gfsm_automaton_free(result);
+  if (itokenizer) gfsm_tokenizer_free(itokenizer);
   if (ilabels)  gfsm_alphabet_free(ilabels);
   if (olabels)  gfsm_alphabet_free(olabels);
   if (qlabels)  gfsm_alphabet_free(qlabels);
@@ -93,6 +93,7 @@ cmdline_parser_print_help (void)
   printf("   -C       --cost            Alias for '--weight'\n");
   printf("   -mMODE   --mode=MODE       Sort by explicit mode string (overrides -l, -u, etc.)\n");
   printf("   -U       --unique          After sorting, collect weights on otherwise identical arcs\n");
+  printf("   -x       --index           Store lower- and upper-label arc indices with the output automaton\n");
   printf("   -zLEVEL  --compress=LEVEL  Specify compression level of output file.\n");
   printf("   -FFILE   --output=FILE     Specifiy output file (default=stdout).\n");
 }
@@ -125,6 +126,7 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->cost_flag = 0; 
   args_info->mode_arg = gog_strdup(""); 
   args_info->unique_flag = 0; 
+  args_info->index_flag = 0; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
 }
@@ -146,6 +148,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->cost_given = 0;
   args_info->mode_given = 0;
   args_info->unique_given = 0;
+  args_info->index_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
 
@@ -172,6 +175,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "cost", 0, NULL, 'C' },
 	{ "mode", 1, NULL, 'm' },
 	{ "unique", 0, NULL, 'U' },
+	{ "index", 0, NULL, 'x' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
         { NULL,	0, NULL, 0 }
@@ -187,6 +191,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'C',
 	'm', ':',
 	'U',
+	'x',
 	'z', ':',
 	'F', ':',
 	'\0'
@@ -324,6 +329,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->unique_flag = !(args_info->unique_flag);
           break;
         
+        case 'x':	 /* Store lower- and upper-label arc indices with the output automaton */
+          if (args_info->index_given) {
+            fprintf(stderr, "%s: `--index' (`-x') option given more than once\n", PROGRAM);
+          }
+          args_info->index_given++;
+         if (args_info->index_given <= 1)
+           args_info->index_flag = !(args_info->index_flag);
+          break;
+        
         case 'z':	 /* Specify compression level of output file. */
           if (args_info->compress_given) {
             fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
@@ -424,6 +438,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->unique_flag = !(args_info->unique_flag);
           }
           
+          /* Store lower- and upper-label arc indices with the output automaton */
+          else if (strcmp(olong, "index") == 0) {
+            if (args_info->index_given) {
+              fprintf(stderr, "%s: `--index' (`-x') option given more than once\n", PROGRAM);
+            }
+            args_info->index_given++;
+           if (args_info->index_given <= 1)
+             args_info->index_flag = !(args_info->index_flag);
+          }
+          
           /* Specify compression level of output file. */
           else if (strcmp(olong, "compress") == 0) {
             if (args_info->compress_given) {
@@ -27,6 +27,7 @@ struct gengetopt_args_info {
   int cost_flag;	 /* Alias for '--weight' (default=0). */
   char * mode_arg;	 /* Sort by explicit mode string (overrides -l, -u, etc.) (default=). */
   int unique_flag;	 /* After sorting, collect weights on otherwise identical arcs (default=0). */
+  int index_flag;	 /* Store lower- and upper-label arc indices with the output automaton (default=0). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
@@ -40,6 +41,7 @@ struct gengetopt_args_info {
   int cost_given;	 /* Whether cost was given */
   int mode_given;	 /* Whether mode was given */
   int unique_given;	 /* Whether unique was given */
+  int index_given;	 /* Whether index was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
   
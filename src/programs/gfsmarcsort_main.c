@@ -93,6 +93,12 @@ int main (int argc, char **argv)
   if (args.unique_flag)
     gfsm_automaton_arcuniq(fsm);
 
+  //-- index?
+  if (args.index_flag) {
+    gfsm_automaton_get_arc_index(fsm,gfsmLSLower);
+    gfsm_automaton_get_arc_index(fsm,gfsmLSUpper);
+  }
+
   //-- spew automaton
   if (!gfsm_automaton_save_bin_filename(fsm,outfilename,args.compress_arg,&err)) {
     g_printerr("%s: store failed to '%s': %s\n", progname, outfilename, err->message);
@@ -86,6 +86,7 @@ cmdline_parser_print_help (void)
   printf("   -h        --help            Print help and exit.\n");
   printf("   -V        --version         Print version and exit.\n");
   printf("   -iLABELS  --ilabels=LABELS  Specify input (lower) labels file for alphabet.\n");
+  printf("   -I        --implicit        Complete with implicit arcs instead of the alphabet.\n");
   printf("   -zLEVEL   --compress=LEVEL  Specify compression level of output file.\n");
   printf("   -FFILE    --output=FILE     Specifiy output file (default=stdout).\n");
 }
@@ -111,6 +112,7 @@ static void
 clear_args(struct gengetopt_args_info *args_info)
 {
   args_info->ilabels_arg = NULL; 
+  args_info->implicit_flag = 0; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
 }
@@ -125,6 +127,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->help_given = 0;
   args_info->version_given = 0;
   args_info->ilabels_given = 0;
+  args_info->implicit_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
 
@@ -146,6 +149,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "help", 0, NULL, 'h' },
 	{ "version", 0, NULL, 'V' },
 	{ "ilabels", 1, NULL, 'i' },
+	{ "implicit", 0, NULL, 'I' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
         { NULL,	0, NULL, 0 }
@@ -154,6 +158,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'h',
 	'V',
 	'i', ':',
+	'I',
 	'z', ':',
 	'F', ':',
 	'\0'
@@ -228,6 +233,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->ilabels_arg = gog_strdup(val);
           break;
         
+        case 'I':	 /* Complete with implicit arcs instead of the alphabet. */
+          if (args_info->implicit_given) {
+            fprintf(stderr, "%s: `--implicit' (`-I') option given more than once\n", PROGRAM);
+          }
+          args_info->implicit_given++;
+         if (args_info->implicit_given <= 1)
+           args_info->implicit_flag = !(args_info->implicit_flag);
+          break;
+        
         case 'z':	 /* Specify compression level of output file. */
           if (args_info->compress_given) {
             fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
@@ -278,6 +292,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->ilabels_arg = gog_strdup(val);
           }
           
+          /* Complete with implicit arcs instead of the alphabet. */
+          else if (strcmp(olong, "implicit") == 0) {
+            if (args_info->implicit_given) {
+              fprintf(stderr, "%s: `--implicit' (`-I') option given more than once\n", PROGRAM);
+            }
+            args_info->implicit_given++;
+           if (args_info->implicit_given <= 1)
+             args_info->implicit_flag = !(args_info->implicit_flag);
+          }
+          
           /* Specify compression level of output file. */
           else if (strcmp(olong, "compress") == 0) {
             if (args_info->compress_given) {
@@ -20,12 +20,14 @@ extern "C" {
 
 struct gengetopt_args_info {
   char * ilabels_arg;	 /* Specify input (lower) labels file for alphabet. (default=NULL). */
+  int implicit_flag;	 /* Complete with implicit arcs instead of the alphabet. (default=0). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
   int ilabels_given;	 /* Whether ilabels was given */
+  int implicit_given;	 /* Whether implicit was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
   
@@ -88,8 +88,9 @@ int main (int argc, char **argv)
   }
 
   //-- complement
-  if (ilabels) gfsm_automaton_complement_full(fsm,ilabels);
-  else         gfsm_automaton_complement(fsm);
+  if (args.implicit_flag) gfsm_automaton_complement_implicit(fsm);
+  else if (ilabels)       gfsm_automaton_complement_full(fsm,ilabels);
+  else                    gfsm_automaton_complement(fsm);
 
   //-- spew automaton
   if (!gfsm_automaton_save_bin_filename(fsm,outfilename,args.compress_arg,&err)) {
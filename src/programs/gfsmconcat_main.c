@@ -44,7 +44,8 @@ const char *outfilename = "-";
 
 //-- global structs etc.
 gfsmError *err = NULL;
-gfsmAutomaton *fsmOut=NULL, *fsmIn=NULL;
+gfsmAutomaton *fsmOut=NULL;
+GPtrArray     *fsmsIn=NULL;
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -66,29 +67,22 @@ void get_my_options(int argc, char **argv)
   //-- load environmental defaults
   //cmdline_parser_envdefaults(&args);
 
-  //-- initialize automaton
-  fsmIn = gfsm_automaton_new();
+  //-- initialize input array
+  fsmsIn = g_ptr_array_sized_new(args.inputs_num+1);
 }
 
 /*--------------------------------------------------------------------------
- * compute_operation()
+ * load_input()
  *  + utility routine
  */
-void compute_operation(const char *infilename)
+void load_input(const char *infilename)
 {
-  //-- load automaton
+  gfsmAutomaton *fsmIn = gfsm_automaton_new();
   if (!gfsm_automaton_load_bin_filename(fsmIn,infilename,&err)) {
     g_printerr("%s: load failed for '%s': %s\n", progname, infilename, err->message);
     exit(255);
   }
-
-  //-- compute concat
-  if (fsmOut == NULL) {
-    fsmOut = fsmIn;
-    fsmIn  = gfsm_automaton_new();
-  } else {
-    gfsm_automaton_concat(fsmOut,fsmIn);
-  }
+  g_ptr_array_add(fsmsIn, fsmIn);
 }
 
 /*--------------------------------------------------------------------------
@@ -100,9 +94,14 @@ int main (int argc, char **argv)
   get_my_options(argc,argv);
 
   for (i = 0; i < args.inputs_num; i++) {
-    compute_operation(args.inputs[i]);
+    load_input(args.inputs[i]);
   }
-  if (args.inputs_num == 1) compute_operation("-");
+  if (args.inputs_num == 1) load_input("-");
+
+  //-- compute concat
+  fsmOut = (gfsmAutomaton*)g_ptr_array_index(fsmsIn,0);
+  g_ptr_array_index(fsmsIn,0) = NULL;
+  gfsm_automaton_concat_n(fsmOut, ((gfsmAutomaton**)fsmsIn->pdata)+1, fsmsIn->len-1);
 
   //-- spew automaton
   if (!gfsm_automaton_save_bin_filename(fsmOut,outfilename,args.compress_arg,&err)) {
@@ -111,7 +110,10 @@ int main (int argc, char **argv)
   }
 
   //-- cleanup
-  if (fsmIn) gfsm_automaton_free(fsmIn);
+  for (i = 0; i < fsmsIn->len; i++) {
+    if (g_ptr_array_index(fsmsIn,i)) gfsm_automaton_free((gfsmAutomaton*)g_ptr_array_index(fsmsIn,i));
+  }
+  g_ptr_array_free(fsmsIn,TRUE);
   if (fsmOut) gfsm_automaton_free(fsmOut);
 
   return 0;
@@ -90,6 +90,8 @@ cmdline_parser_print_help (void)
   printf("   -sSRTYPE  --semiring=SRTYPE  Specify semiring type.\n");
   printf("   -zLEVEL   --compress=LEVEL   Specify compression level of output file.\n");
   printf("   -FFILE    --output=FILE      Specifiy output file (default=stdout).\n");
+  printf("   -B        --blocked          Store output in blocked binary format.\n");
+  printf("   -e        --varint           Store states and arcs as compact variable-length records.\n");
 }
 
 #if defined(HAVE_STRDUP) || defined(strdup)
@@ -117,6 +119,8 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->semiring_arg = NULL; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
+  args_info->blocked_flag = 0; 
+  args_info->varint_flag = 0; 
 }
 
 
@@ -133,6 +137,8 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->semiring_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
+  args_info->blocked_given = 0;
+  args_info->varint_given = 0;
 
   clear_args(args_info);
 
@@ -156,6 +162,8 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "semiring", 1, NULL, 's' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
+	{ "blocked", 0, NULL, 'B' },
+	{ "varint", 0, NULL, 'e' },
         { NULL,	0, NULL, 0 }
       };
       static char short_options[] = {
@@ -166,6 +174,8 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	's', ':',
 	'z', ':',
 	'F', ':',
+	'B',
+	'e',
 	'\0'
       };
 
@@ -271,6 +281,24 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->output_arg = gog_strdup(val);
           break;
         
+        case 'B':	 /* Store output in blocked binary format. */
+          if (args_info->blocked_given) {
+            fprintf(stderr, "%s: `--blocked' (`-B') option given more than once\n", PROGRAM);
+          }
+          args_info->blocked_given++;
+         if (args_info->blocked_given <= 1)
+           args_info->blocked_flag = !(args_info->blocked_flag);
+          break;
+        
+        case 'e':	 /* Store states and arcs as compact variable-length records. */
+          if (args_info->varint_given) {
+            fprintf(stderr, "%s: `--varint' (`-e') option given more than once\n", PROGRAM);
+          }
+          args_info->varint_given++;
+         if (args_info->varint_given <= 1)
+           args_info->varint_flag = !(args_info->varint_flag);
+          break;
+        
         case 0:	 /* Long option(s) with no short form */
         /* Print help and exit. */
           if (strcmp(olong, "help") == 0) {
@@ -341,6 +369,26 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->output_arg = gog_strdup(val);
           }
           
+          /* Store output in blocked binary format. */
+          else if (strcmp(olong, "blocked") == 0) {
+            if (args_info->blocked_given) {
+              fprintf(stderr, "%s: `--blocked' (`-B') option given more than once\n", PROGRAM);
+            }
+            args_info->blocked_given++;
+           if (args_info->blocked_given <= 1)
+             args_info->blocked_flag = !(args_info->blocked_flag);
+          }
+          
+          /* Store states and arcs as compact variable-length records. */
+          else if (strcmp(olong, "varint") == 0) {
+            if (args_info->varint_given) {
+              fprintf(stderr, "%s: `--varint' (`-e') option given more than once\n", PROGRAM);
+            }
+            args_info->varint_given++;
+           if (args_info->varint_given <= 1)
+             args_info->varint_flag = !(args_info->varint_flag);
+          }
+          
           else {
             fprintf(stderr, "%s: unknown long option '%s'.\n", PROGRAM, olong);
             return (EXIT_FAILURE);
@@ -24,6 +24,8 @@ struct gengetopt_args_info {
   char * semiring_arg;	 /* Specify semiring type. (default=NULL). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
+  int blocked_flag;	 /* Store output in blocked binary format. (default=0). */
+  int varint_flag;	 /* Store states and arcs as compact variable-length records. (default=0). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
@@ -32,6 +34,8 @@ struct gengetopt_args_info {
   int semiring_given;	 /* Whether semiring was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
+  int blocked_given;	 /* Whether blocked was given */
+  int varint_given;	 /* Whether varint was given */
   
   char **inputs;         /* unnamed arguments */
   unsigned inputs_num;   /* number of unnamed arguments */
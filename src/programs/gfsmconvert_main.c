@@ -45,6 +45,7 @@ const char *outfilename = "-";
 gfsmAutomaton *fsm;
 gfsmError     *err = NULL;
 gfsmSRType     srtype = gfsmSRTUnknown;
+gfsmBinCoding  coding = gfsmBCFixed;
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -61,6 +62,9 @@ void get_my_options(int argc, char **argv)
   if (args.inputs_num > 0) infilename = args.inputs[0];
   outfilename = args.output_arg;
 
+  //-- output record coding
+  if (args.varint_flag) coding = gfsmBCVarint;
+
   //-- initialize fsm
   fsm = gfsm_automaton_new();
 }
@@ -97,7 +101,9 @@ int main (int argc, char **argv)
   }
 
   //-- store automaton
-  if (!gfsm_automaton_save_bin_filename(fsm,outfilename,args.compress_arg,&err)) {
+  if (args.blocked_flag
+      ? !gfsm_automaton_save_bin_filename_blocked(fsm,outfilename,args.compress_arg,coding,&err)
+      : !gfsm_automaton_save_bin_filename_full(fsm,outfilename,args.compress_arg,coding,&err)) {
     g_printerr("%s: store failed to '%s': %s\n", progname, outfilename, err->message);
     exit(4);
   }
@@ -112,6 +112,7 @@ int main (int argc, char **argv)
   g_string_free(modestr,TRUE);
 #endif
   printf("%-24s: %d\n", "flags.is_deterministic", hdr.flags.is_deterministic);
+  printf("%-24s: %d\n", "flags.is_indexed", hdr.flags.is_indexed);
   printf("%-24s: %d\n", "flags.unused", hdr.flags.unused);
 
   printf("%-24s: %u\n", "root_id", hdr.root_id);
@@ -119,9 +120,9 @@ int main (int argc, char **argv)
   printf("%-24s: %u\n", "n_arcs", hdr.n_arcs_007);
   printf("%-24s: %u (%s)\n", "srtype", hdr.srtype, gfsm_sr_type_to_name(hdr.srtype));
 
-  printf("%-24s: %u\n", "unused1", hdr.unused1);
-  printf("%-24s: %u\n", "unused2", hdr.unused2);
-  printf("%-24s: %u\n", "unused3", hdr.unused3);
+  printf("%-24s: %u\n", "n_blocks", hdr.n_blocks);
+  printf("%-24s: %u\n", "arc_indices", hdr.arc_indices);
+  printf("%-24s: %u\n", "arc_coding", hdr.arc_coding);
 
   GFSM_FINISH
 
@@ -86,6 +86,8 @@ cmdline_parser_print_help (void)
   printf("   -h       --help            Print help and exit.\n");
   printf("   -V       --version         Print version and exit.\n");
   printf("   -u       --unindex         Convert indexed automaton to unindexed format\n");
+  printf("   -c       --compact         Convert to or from packed read-only format\n");
+  printf("   -wBITS   --weight-bits=BITS  Bits per stored arc weight for --compact (8, 16, or 32).\n");
   printf("   -zLEVEL  --compress=LEVEL  Specify compression level of output file.\n");
   printf("   -FFILE   --output=FILE     Specifiy output file (default=stdout).\n");
 }
@@ -111,6 +113,8 @@ static void
 clear_args(struct gengetopt_args_info *args_info)
 {
   args_info->unindex_flag = 0; 
+  args_info->compact_flag = 0; 
+  args_info->weight_bits_arg = 32; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
 }
@@ -125,6 +129,8 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->help_given = 0;
   args_info->version_given = 0;
   args_info->unindex_given = 0;
+  args_info->compact_given = 0;
+  args_info->weight_bits_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
 
@@ -146,6 +152,8 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "help", 0, NULL, 'h' },
 	{ "version", 0, NULL, 'V' },
 	{ "unindex", 0, NULL, 'u' },
+	{ "compact", 0, NULL, 'c' },
+	{ "weight-bits", 1, NULL, 'w' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
         { NULL,	0, NULL, 0 }
@@ -154,6 +162,8 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'h',
 	'V',
 	'u',
+	'c',
+	'w', ':',
 	'z', ':',
 	'F', ':',
 	'\0'
@@ -228,6 +238,23 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->unindex_flag = !(args_info->unindex_flag);
           break;
         
+        case 'c':	 /* Convert to or from packed read-only format */
+          if (args_info->compact_given) {
+            fprintf(stderr, "%s: `--compact' (`-c') option given more than once\n", PROGRAM);
+          }
+          args_info->compact_given++;
+         if (args_info->compact_given <= 1)
+           args_info->compact_flag = !(args_info->compact_flag);
+          break;
+        
+        case 'w':	 /* Bits per stored arc weight for --compact (8, 16, or 32). */
+          if (args_info->weight_bits_given) {
+            fprintf(stderr, "%s: `--weight-bits' (`-w') option given more than once\n", PROGRAM);
+          }
+          args_info->weight_bits_given++;
+          args_info->weight_bits_arg = (int)atoi(val);
+          break;
+        
         case 'z':	 /* Specify compression level of output file. */
           if (args_info->compress_given) {
             fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
@@ -278,6 +305,25 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->unindex_flag = !(args_info->unindex_flag);
           }
           
+          /* Convert to or from packed read-only format */
+          else if (strcmp(olong, "compact") == 0) {
+            if (args_info->compact_given) {
+              fprintf(stderr, "%s: `--compact' (`-c') option given more than once\n", PROGRAM);
+            }
+            args_info->compact_given++;
+           if (args_info->compact_given <= 1)
+             args_info->compact_flag = !(args_info->compact_flag);
+          }
+          
+          /* Bits per stored arc weight for --compact (8, 16, or 32). */
+          else if (strcmp(olong, "weight-bits") == 0) {
+            if (args_info->weight_bits_given) {
+              fprintf(stderr, "%s: `--weight-bits' (`-w') option given more than once\n", PROGRAM);
+            }
+            args_info->weight_bits_given++;
+            args_info->weight_bits_arg = (int)atoi(val);
+          }
+          
           /* Specify compression level of output file. */
           else if (strcmp(olong, "compress") == 0) {
             if (args_info->compress_given) {
@@ -20,12 +20,16 @@ extern "C" {
 
 struct gengetopt_args_info {
   int unindex_flag;	 /* Convert indexed automaton to unindexed format (default=0). */
+  int compact_flag;	 /* Convert to or from packed read-only format (default=0). */
+  int weight_bits_arg;	 /* Bits per stored arc weight for --compact (8, 16, or 32). (default=32). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
   int unindex_given;	 /* Whether unindex was given */
+  int compact_given;	 /* Whether compact was given */
+  int weight_bits_given;	 /* Whether weight-bits was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
   
@@ -44,6 +44,7 @@ const char *outfilename = "-";
 //-- global structs
 gfsmAutomaton         *fsm=NULL;
 gfsmIndexedAutomaton *xfsm=NULL;
+gfsmPackedAutomaton  *pfsm=NULL;
 gfsmError             *err=NULL;
 
 /*--------------------------------------------------------------------------
@@ -71,7 +72,49 @@ int main (int argc, char **argv)
   get_my_options(argc,argv);
 
   //-- dispatch
-  if (args.unindex_given) {
+  if (args.compact_given && args.unindex_given) {
+    //-- convert packed --> vanilla
+
+    //-- load packed
+    pfsm = gfsm_packed_automaton_new();
+    if (!gfsm_packed_automaton_load_bin_filename(pfsm,infilename,&err)) {
+      g_printerr("%s: load failed for packed automaton from '%s': %s\n", progname, infilename,
+		 (err ? err->message : "?"));
+      exit(3);
+    }
+
+    //-- unpack
+    fsm = gfsm_packed_to_automaton(pfsm,NULL);
+
+    //-- store vanilla
+    if (!gfsm_automaton_save_bin_filename(fsm,outfilename,args.compress_arg,&err)) {
+      g_printerr("%s: store failed for vanilla automaton to '%s': %s\n", progname, outfilename,
+		 (err ? err->message : "?"));
+      exit(4);
+    }
+  }
+  else if (args.compact_given) {
+    //-- convert vanilla --> packed
+
+    //-- load vanilla
+    fsm = gfsm_automaton_new();
+    if (!gfsm_automaton_load_bin_filename(fsm,infilename,&err)) {
+      g_printerr("%s: load failed for vanilla automaton from '%s': %s\n", progname, infilename,
+		 (err ? err->message : "?"));
+      exit(3);
+    }
+
+    //-- pack
+    pfsm = gfsm_automaton_to_packed(fsm,NULL,args.weight_bits_arg);
+
+    //-- store packed
+    if (!gfsm_packed_automaton_save_bin_filename(pfsm,outfilename,args.compress_arg,&err)) {
+      g_printerr("%s: store failed for packed automaton to '%s': %s\n", progname, outfilename,
+		 (err ? err->message : "?"));
+      exit(4);
+    }
+  }
+  else if (args.unindex_given) {
     //-- convert indexed --> vanilla
 
     //-- load index
@@ -118,6 +161,7 @@ int main (int argc, char **argv)
   //-- cleanup
   if (fsm)  gfsm_automaton_free(fsm);
   if (xfsm) gfsm_indexed_automaton_free(xfsm);
+  if (pfsm) gfsm_packed_automaton_free(pfsm);
 
   GFSM_FINISH
   return 0;
@@ -90,6 +90,7 @@ cmdline_parser_print_help (void)
   printf("   -m        --map-mode       Output original strings in addition to label vectors.\n");
   printf("   -q        --quiet          Suppress warnings about undefined symbols.\n");
   printf("   -u        --utf8           Assume UTF-8 encoded alphabet and input\n");
+  printf("   -M        --longest-match  Tokenize input string(s) by longest match over all alphabet symbols.\n");
   printf("   -oFILE    --output=FILE    Specifiy output file (default=stdout).\n");
 }
 
@@ -118,6 +119,7 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->map_mode_flag = 0; 
   args_info->quiet_flag = 0; 
   args_info->utf8_flag = 0; 
+  args_info->longest_match_flag = 0; 
   args_info->output_arg = gog_strdup("-"); 
 }
 
@@ -135,6 +137,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->map_mode_given = 0;
   args_info->quiet_given = 0;
   args_info->utf8_given = 0;
+  args_info->longest_match_given = 0;
   args_info->output_given = 0;
 
   clear_args(args_info);
@@ -159,6 +162,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "map-mode", 0, NULL, 'm' },
 	{ "quiet", 0, NULL, 'q' },
 	{ "utf8", 0, NULL, 'u' },
+	{ "longest-match", 0, NULL, 'M' },
 	{ "output", 1, NULL, 'o' },
         { NULL,	0, NULL, 0 }
       };
@@ -170,6 +174,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'm',
 	'q',
 	'u',
+	'M',
 	'o', ':',
 	'\0'
       };
@@ -279,6 +284,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->utf8_flag = !(args_info->utf8_flag);
           break;
         
+        case 'M':	 /* Tokenize input string(s) by longest match over all alphabet symbols. */
+          if (args_info->longest_match_given) {
+            fprintf(stderr, "%s: `--longest-match' (`-M') option given more than once\n", PROGRAM);
+          }
+          args_info->longest_match_given++;
+         if (args_info->longest_match_given <= 1)
+           args_info->longest_match_flag = !(args_info->longest_match_flag);
+          break;
+        
         case 'o':	 /* Specifiy output file (default=stdout). */
           if (args_info->output_given) {
             fprintf(stderr, "%s: `--output' (`-o') option given more than once\n", PROGRAM);
@@ -361,6 +375,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->utf8_flag = !(args_info->utf8_flag);
           }
           
+          /* Tokenize input string(s) by longest match over all alphabet symbols. */
+          else if (strcmp(olong, "longest-match") == 0) {
+            if (args_info->longest_match_given) {
+              fprintf(stderr, "%s: `--longest-match' (`-M') option given more than once\n", PROGRAM);
+            }
+            args_info->longest_match_given++;
+           if (args_info->longest_match_given <= 1)
+             args_info->longest_match_flag = !(args_info->longest_match_flag);
+          }
+          
           /* Specifiy output file (default=stdout). */
           else if (strcmp(olong, "output") == 0) {
             if (args_info->output_given) {
@@ -24,6 +24,7 @@ struct gengetopt_args_info {
   int map_mode_flag;	 /* Output original strings in addition to label vectors. (default=0). */
   int quiet_flag;	 /* Suppress warnings about undefined symbols. (default=0). */
   int utf8_flag;	 /* Assume UTF-8 encoded alphabet and input (default=0). */
+  int longest_match_flag;	 /* Tokenize input string(s) by longest match over all alphabet symbols. (default=0). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
@@ -33,6 +34,7 @@ struct gengetopt_args_info {
   int map_mode_given;	 /* Whether map-mode was given */
   int quiet_given;	 /* Whether quiet was given */
   int utf8_given;	 /* Whether utf8 was given */
+  int longest_match_given;	 /* Whether longest-match was given */
   int output_given;	 /* Whether output was given */
   
   char **inputs;         /* unnamed arguments */
@@ -50,6 +50,7 @@ FILE  *outfile = NULL;
 
 //-- global structs
 gfsmAlphabet  *labels=NULL;
+gfsmTokenizer *tokenizer=NULL;
 gfsmError     *err = NULL;
 gboolean       att_mode = FALSE;
 gboolean       map_mode = FALSE;
@@ -105,12 +106,17 @@ void get_my_options(int argc, char **argv)
   map_mode = args.map_mode_flag;
   warn_on_undef = !args.quiet_flag;
   labels->utf8 = args.utf8_flag;
+
+  //-- compile tokenizer
+  tokenizer = gfsm_tokenizer_new(labels,
+				 (att_mode ? gfsmTFAtt : gfsmTFChars)
+				 | (args.longest_match_flag ? gfsmTFLongest : gfsmTFChars));
 }
 
 /*--------------------------------------------------------------------------
  * apply_labels_file()
  */
-void apply_labels_file(gfsmAlphabet *labels, FILE *infile, FILE *outfile)
+void apply_labels_file(gfsmTokenizer *tok, FILE *infile, FILE *outfile)
 {
   char            *str = NULL;
   size_t           buflen = 0;
@@ -130,7 +136,7 @@ void apply_labels_file(gfsmAlphabet *labels, FILE *infile, FILE *outfile)
     if (map_mode) { fprintf(outfile, "%s\t", str); }
 
     //-- convert
-    vec = gfsm_alphabet_generic_string_to_labels(labels,str,vec,warn_on_undef,att_mode);
+    vec = gfsm_tokenizer_string_to_labels(tok,str,vec,warn_on_undef);
 
     //-- dump labels
     for (i=0; i<vec->len; i++) {
@@ -157,7 +163,7 @@ int main (int argc, char **argv)
 
   //-- process input(s)
   if (args.inputs_num==0) {
-    apply_labels_file(labels,stdin,outfile);
+    apply_labels_file(tokenizer,stdin,outfile);
   }
   for (i=0; i < args.inputs_num; i++) {
     FILE *infile = (strcmp(args.inputs[i],"-")==0 ? stdin : fopen(args.inputs[i], "r"));
@@ -165,12 +171,13 @@ int main (int argc, char **argv)
       g_printerr("%s: load failed for input file '%s': %s\n", progname, args.inputs[i], strerror(errno));
       exit(255);
     }
-    apply_labels_file(labels,infile,outfile);
+    apply_labels_file(tokenizer,infile,outfile);
     if (infile != stdin) fclose(infile);
   }
 
 
   //-- cleanup
+  if (tokenizer) gfsm_tokenizer_free(tokenizer);
   if (labels) gfsm_alphabet_free(labels);
 
   GFSM_FINISH
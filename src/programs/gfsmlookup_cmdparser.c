@@ -86,7 +86,11 @@ cmdline_parser_print_help (void)
   printf("   -h         --help            Print help and exit.\n");
   printf("   -V         --version         Print version and exit.\n");
   printf("   -fFSTFILE  --fst=FSTFILE     Transducer to apply (default=stdin).\n");
+  printf("   -c         --compact         FSTFILE is a packed automaton (see gfsmindex --compact)\n");
+  printf("   -x         --indexed         FSTFILE is an indexed automaton (see gfsmindex)\n");
   printf("   -QN        --maxq=N          Maximum number of result states to generate (default=0:system limit)\n");
+  printf("   -L         --lattice         Build a shared result lattice rather than a path tree.\n");
+  printf("   -C         --connect         Prune non-coaccessible result states (implies --lattice).\n");
   printf("   -zLEVEL    --compress=LEVEL  Specify compression level of output file.\n");
   printf("   -FFILE     --output=FILE     Specifiy output file (default=stdout).\n");
 }
@@ -112,7 +116,11 @@ static void
 clear_args(struct gengetopt_args_info *args_info)
 {
   args_info->fst_arg = gog_strdup("-"); 
+  args_info->compact_flag = 0; 
+  args_info->indexed_flag = 0; 
   args_info->maxq_arg = 0; 
+  args_info->lattice_flag = 0; 
+  args_info->connect_flag = 0; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
 }
@@ -127,7 +135,11 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->help_given = 0;
   args_info->version_given = 0;
   args_info->fst_given = 0;
+  args_info->compact_given = 0;
+  args_info->indexed_given = 0;
   args_info->maxq_given = 0;
+  args_info->lattice_given = 0;
+  args_info->connect_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
 
@@ -149,7 +161,11 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "help", 0, NULL, 'h' },
 	{ "version", 0, NULL, 'V' },
 	{ "fst", 1, NULL, 'f' },
+	{ "compact", 0, NULL, 'c' },
+	{ "indexed", 0, NULL, 'x' },
 	{ "maxq", 1, NULL, 'Q' },
+	{ "lattice", 0, NULL, 'L' },
+	{ "connect", 0, NULL, 'C' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
         { NULL,	0, NULL, 0 }
@@ -158,7 +174,11 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'h',
 	'V',
 	'f', ':',
+	'c',
+	'x',
 	'Q', ':',
+	'L',
+	'C',
 	'z', ':',
 	'F', ':',
 	'\0'
@@ -233,6 +253,24 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->fst_arg = gog_strdup(val);
           break;
         
+        case 'c':	 /* FSTFILE is a packed automaton (see gfsmindex --compact) */
+          if (args_info->compact_given) {
+            fprintf(stderr, "%s: `--compact' (`-c') option given more than once\n", PROGRAM);
+          }
+          args_info->compact_given++;
+         if (args_info->compact_given <= 1)
+           args_info->compact_flag = !(args_info->compact_flag);
+          break;
+        
+        case 'x':	 /* FSTFILE is an indexed automaton (see gfsmindex) */
+          if (args_info->indexed_given) {
+            fprintf(stderr, "%s: `--indexed' (`-x') option given more than once\n", PROGRAM);
+          }
+          args_info->indexed_given++;
+         if (args_info->indexed_given <= 1)
+           args_info->indexed_flag = !(args_info->indexed_flag);
+          break;
+        
         case 'Q':	 /* Maximum number of result states to generate (default=0:system limit) */
           if (args_info->maxq_given) {
             fprintf(stderr, "%s: `--maxq' (`-Q') option given more than once\n", PROGRAM);
@@ -241,6 +279,24 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->maxq_arg = (int)atoi(val);
           break;
         
+        case 'L':	 /* Build a shared result lattice rather than a path tree. */
+          if (args_info->lattice_given) {
+            fprintf(stderr, "%s: `--lattice' (`-L') option given more than once\n", PROGRAM);
+          }
+          args_info->lattice_given++;
+         if (args_info->lattice_given <= 1)
+           args_info->lattice_flag = !(args_info->lattice_flag);
+          break;
+        
+        case 'C':	 /* Prune non-coaccessible result states (implies --lattice). */
+          if (args_info->connect_given) {
+            fprintf(stderr, "%s: `--connect' (`-C') option given more than once\n", PROGRAM);
+          }
+          args_info->connect_given++;
+         if (args_info->connect_given <= 1)
+           args_info->connect_flag = !(args_info->connect_flag);
+          break;
+        
         case 'z':	 /* Specify compression level of output file. */
           if (args_info->compress_given) {
             fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
@@ -291,6 +347,26 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->fst_arg = gog_strdup(val);
           }
           
+          /* FSTFILE is a packed automaton (see gfsmindex --compact) */
+          else if (strcmp(olong, "compact") == 0) {
+            if (args_info->compact_given) {
+              fprintf(stderr, "%s: `--compact' (`-c') option given more than once\n", PROGRAM);
+            }
+            args_info->compact_given++;
+           if (args_info->compact_given <= 1)
+             args_info->compact_flag = !(args_info->compact_flag);
+          }
+          
+          /* FSTFILE is an indexed automaton (see gfsmindex) */
+          else if (strcmp(olong, "indexed") == 0) {
+            if (args_info->indexed_given) {
+              fprintf(stderr, "%s: `--indexed' (`-x') option given more than once\n", PROGRAM);
+            }
+            args_info->indexed_given++;
+           if (args_info->indexed_given <= 1)
+             args_info->indexed_flag = !(args_info->indexed_flag);
+          }
+          
           /* Maximum number of result states to generate (default=0:system limit) */
           else if (strcmp(olong, "maxq") == 0) {
             if (args_info->maxq_given) {
@@ -300,6 +376,26 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->maxq_arg = (int)atoi(val);
           }
           
+          /* Build a shared result lattice rather than a path tree. */
+          else if (strcmp(olong, "lattice") == 0) {
+            if (args_info->lattice_given) {
+              fprintf(stderr, "%s: `--lattice' (`-L') option given more than once\n", PROGRAM);
+            }
+            args_info->lattice_given++;
+           if (args_info->lattice_given <= 1)
+             args_info->lattice_flag = !(args_info->lattice_flag);
+          }
+          
+          /* Prune non-coaccessible result states (implies --lattice). */
+          else if (strcmp(olong, "connect") == 0) {
+            if (args_info->connect_given) {
+              fprintf(stderr, "%s: `--connect' (`-C') option given more than once\n", PROGRAM);
+            }
+            args_info->connect_given++;
+           if (args_info->connect_given <= 1)
+             args_info->connect_flag = !(args_info->connect_flag);
+          }
+          
           /* Specify compression level of output file. */
           else if (strcmp(olong, "compress") == 0) {
             if (args_info->compress_given) {
@@ -20,14 +20,22 @@ extern "C" {
 
 struct gengetopt_args_info {
   char * fst_arg;	 /* Transducer to apply (default=stdin). (default=-). */
+  int compact_flag;	 /* FSTFILE is a packed automaton (see gfsmindex --compact) (default=0). */
+  int indexed_flag;	 /* FSTFILE is an indexed automaton (see gfsmindex) (default=0). */
   int maxq_arg;	 /* Maximum number of result states to generate (default=0:system limit) (default=0). */
+  int lattice_flag;	 /* Build a shared result lattice rather than a path tree. (default=0). */
+  int connect_flag;	 /* Prune non-coaccessible result states (implies --lattice). (default=0). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
   int fst_given;	 /* Whether fst was given */
+  int compact_given;	 /* Whether compact was given */
+  int indexed_given;	 /* Whether indexed was given */
   int maxq_given;	 /* Whether maxq was given */
+  int lattice_given;	 /* Whether lattice was given */
+  int connect_given;	 /* Whether connect was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
   
@@ -44,8 +44,10 @@ const char *fstfilename = "-";
 const char *outfilename = "-";
 
 //-- global structs
-gfsmAutomaton *fst = NULL;
-gfsmError     *err = NULL;
+gfsmAutomaton        *fst = NULL;
+gfsmIndexedAutomaton *xfst = NULL;
+gfsmPackedAutomaton  *pfst = NULL;
+gfsmError           *err = NULL;
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -63,6 +65,22 @@ void get_my_options(int argc, char **argv)
   outfilename = args.output_arg;
 
   //-- load FST
+  if (args.compact_flag) {
+    pfst = gfsm_packed_automaton_new();
+    if (!gfsm_packed_automaton_load_bin_filename(pfst, fstfilename, &err)) {
+      g_printerr("%s: load failed for packed FST file '%s': %s\n", progname, fstfilename, err->message);
+      exit(255);
+    }
+    return;
+  }
+  if (args.indexed_flag) {
+    xfst = gfsm_indexed_automaton_new();
+    if (!gfsm_indexed_automaton_load_bin_filename(xfst, fstfilename, &err)) {
+      g_printerr("%s: load failed for indexed FST file '%s': %s\n", progname, fstfilename, err->message);
+      exit(255);
+    }
+    return;
+  }
   fst = gfsm_automaton_new();
   if (!gfsm_automaton_load_bin_filename(fst, fstfilename, &err)) {
     g_printerr("%s: load failed for FST file '%s': %s\n", progname, fstfilename, err->message);
@@ -93,7 +111,20 @@ gfsmAutomaton *lookup_labels(gfsmAutomaton *fst, int argc, char **argv)
   if (max_states==0) max_states = gfsmNoState;
 
   //-- actual lookup
-  result = gfsm_automaton_lookup_full(fst, vec, result, NULL, max_states);
+  if (args.lattice_flag || args.connect_flag) {
+    if (pfst)
+      result = gfsm_packed_lookup_lattice_full(pfst, vec, result, NULL, max_states, args.connect_flag);
+    else if (xfst)
+      result = gfsm_indexed_lookup_lattice_full(xfst, vec, result, NULL, max_states, args.connect_flag);
+    else
+      result = gfsm_automaton_lookup_lattice_full(fst, vec, result, NULL, max_states, args.connect_flag);
+  }
+  else if (pfst)
+    result = gfsm_packed_lookup_full(pfst, vec, result, NULL, max_states);
+  else if (xfst)
+    result = gfsm_indexed_lookup_full(xfst, vec, result, NULL, max_states);
+  else
+    result = gfsm_automaton_lookup_full(fst, vec, result, NULL, max_states);
 
   //-- cleanup
   g_ptr_array_free(vec,TRUE);
@@ -122,6 +153,8 @@ int main (int argc, char **argv)
 
   //-- cleanup
   if (fst)    gfsm_automaton_free(fst);
+  if (xfst)   gfsm_indexed_automaton_free(xfst);
+  if (pfst)   gfsm_packed_automaton_free(pfst);
   if (result) gfsm_automaton_free(result);
 
   GFSM_FINISH
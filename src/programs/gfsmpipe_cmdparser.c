@@ -0,0 +1,567 @@
+/* -*- Mode: C -*-
+ *
+ * File: gfsmpipe_cmdparser.c
+ * Description: Code for command-line parser struct gengetopt_args_info.
+ *
+ * File autogenerated by optgen.perl version 0.06
+ * generated with the following command:
+ * /usr/local/bin/optgen.perl -u -l --no-handle-rcfile --nopod -F gfsmpipe_cmdparser gfsmpipe.gog
+ *
+ * The developers of optgen.perl consider the fixed text that goes in all
+ * optgen.perl output files to be in the public domain:
+ * we make no copyright claims on it.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <ctype.h>
+
+/* If we use autoconf/autoheader.  */
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#ifdef HAVE_PWD_H
+# include <pwd.h>
+#endif
+
+/* Allow user-overrides for PACKAGE and VERSION */
+#ifndef PACKAGE
+#  define PACKAGE "PACKAGE"
+#endif
+
+#ifndef VERSION
+#  define VERSION "VERSION"
+#endif
+
+
+#ifndef PROGRAM
+# define PROGRAM "gfsmpipe"
+#endif
+
+/* #define cmdline_parser_DEBUG */
+
+/* Check for "configure's" getopt check result.  */
+#ifndef HAVE_GETOPT_LONG
+# include "getopt.h"
+#else
+# include <getopt.h>
+#endif
+
+#include "gfsmpipe_cmdparser.h"
+
+
+/* user code section */
+
+/* end user  code section */
+
+
+void
+cmdline_parser_print_version (void)
+{
+  printf("gfsmpipe (%s %s) by Bryan Jurish <moocow.bovine@gmail.com>\n", PACKAGE, VERSION);
+}
+
+void
+cmdline_parser_print_help (void)
+{
+  cmdline_parser_print_version ();
+  printf("\n");
+  printf("Purpose:\n");
+  printf("  Apply a chain of operations to a finite state machine in a single process\n");
+  printf("\n");
+  
+  printf("Usage: %s [OPTIONS]... STAGE(s)\n", "gfsmpipe");
+  
+  printf("\n");
+  printf(" Arguments:\n");
+  printf("   STAGE(s)  Operations to apply, in order\n");
+  
+  printf("\n");
+  printf(" Options:\n");
+  printf("   -h       --help            Print help and exit.\n");
+  printf("   -V       --version         Print version and exit.\n");
+  printf("   -iFILE   --input=FILE      Specify input file (default=stdin).\n");
+  printf("   -zLEVEL  --compress=LEVEL  Specify compression level of output file.\n");
+  printf("   -FFILE   --output=FILE     Specifiy output file (default=stdout).\n");
+  printf("   -v       --verbose         Report time, size, and memory usage for each stage to stderr.\n");
+  printf("   -B       --blocked         Store output in blocked binary format.\n");
+  printf("   -e       --varint          Store states and arcs as compact variable-length records.\n");
+  printf("   -P       --pool            Allocate arcs from a per-automaton node pool.\n");
+}
+
+#if defined(HAVE_STRDUP) || defined(strdup)
+# define gog_strdup strdup
+#else
+/* gog_strdup(): automatically generated from strdup.c. */
+/* strdup.c replacement of strdup, which is not standard */
+static char *
+gog_strdup (const char *s)
+{
+  char *result = (char*)malloc(strlen(s) + 1);
+  if (result == (char*)0)
+    return (char*)0;
+  strcpy(result, s);
+  return result;
+}
+#endif /* HAVE_STRDUP */
+
+/* clear_args(args_info): clears all args & resets to defaults */
+static void
+clear_args(struct gengetopt_args_info *args_info)
+{
+  args_info->input_arg = gog_strdup("-"); 
+  args_info->compress_arg = -1; 
+  args_info->output_arg = gog_strdup("-"); 
+  args_info->verbose_flag = 0; 
+  args_info->blocked_flag = 0; 
+  args_info->varint_flag = 0; 
+  args_info->pool_flag = 0; 
+}
+
+
+int
+cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_info)
+{
+  int c;	/* Character of the parsed option.  */
+  int missing_required_options = 0;	
+
+  args_info->help_given = 0;
+  args_info->version_given = 0;
+  args_info->input_given = 0;
+  args_info->compress_given = 0;
+  args_info->output_given = 0;
+  args_info->verbose_given = 0;
+  args_info->blocked_given = 0;
+  args_info->varint_given = 0;
+  args_info->pool_given = 0;
+
+  clear_args(args_info);
+
+  /* rcfile handling */
+  
+  /* end rcfile handling */
+
+  optarg = 0;
+  optind = 1;
+  opterr = 1;
+  optopt = '?';
+
+  while (1)
+    {
+      int option_index = 0;
+      static struct option long_options[] = {
+	{ "help", 0, NULL, 'h' },
+	{ "version", 0, NULL, 'V' },
+	{ "input", 1, NULL, 'i' },
+	{ "compress", 1, NULL, 'z' },
+	{ "output", 1, NULL, 'F' },
+	{ "verbose", 0, NULL, 'v' },
+	{ "blocked", 0, NULL, 'B' },
+	{ "varint", 0, NULL, 'e' },
+	{ "pool", 0, NULL, 'P' },
+        { NULL,	0, NULL, 0 }
+      };
+      static char short_options[] = {
+	'h',
+	'V',
+	'i', ':',
+	'z', ':',
+	'F', ':',
+	'v',
+	'B',
+	'e',
+	'P',
+	'\0'
+      };
+
+      c = getopt_long (argc, argv, short_options, long_options, &option_index);
+
+      if (c == -1) break;	/* Exit from 'while (1)' loop.  */
+
+      if (cmdline_parser_parse_option(c, long_options[option_index].name, optarg, args_info) != 0) {
+	exit (EXIT_FAILURE);
+      }
+    } /* while */
+
+  
+
+  if ( missing_required_options )
+    exit (EXIT_FAILURE);
+
+  
+  if (optind < argc) {
+      int i = 0 ;
+      args_info->inputs_num = argc - optind ;
+      args_info->inputs = (char **)(malloc ((args_info->inputs_num)*sizeof(char *))) ;
+      while (optind < argc)
+        args_info->inputs[ i++ ] = gog_strdup (argv[optind++]) ; 
+  }
+
+  return 0;
+}
+
+
+/* Parse a single option */
+int
+cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
+			       struct gengetopt_args_info *args_info)
+{
+  if (!oshort && !(olong && *olong)) return 1;  /* ignore null options */
+
+#ifdef cmdline_parser_DEBUG
+  fprintf(stderr, "parse_option(): oshort='%c', olong='%s', val='%s'\n", oshort, olong, val);*/
+#endif
+
+  switch (oshort)
+    {
+      case 'h':	 /* Print help and exit. */
+          if (args_info->help_given) {
+            fprintf(stderr, "%s: `--help' (`-h') option given more than once\n", PROGRAM);
+          }
+          clear_args(args_info);
+          cmdline_parser_print_help();
+          exit(EXIT_SUCCESS);
+        
+          break;
+        
+        case 'V':	 /* Print version and exit. */
+          if (args_info->version_given) {
+            fprintf(stderr, "%s: `--version' (`-V') option given more than once\n", PROGRAM);
+          }
+          clear_args(args_info);
+          cmdline_parser_print_version();
+          exit(EXIT_SUCCESS);
+        
+          break;
+        
+        case 'i':	 /* Specify input file (default=stdin). */
+          if (args_info->input_given) {
+            fprintf(stderr, "%s: `--input' (`-i') option given more than once\n", PROGRAM);
+          }
+          args_info->input_given++;
+          if (args_info->input_arg) free(args_info->input_arg);
+          args_info->input_arg = gog_strdup(val);
+          break;
+        
+        case 'z':	 /* Specify compression level of output file. */
+          if (args_info->compress_given) {
+            fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
+          }
+          args_info->compress_given++;
+          args_info->compress_arg = (int)atoi(val);
+          break;
+        
+        case 'F':	 /* Specifiy output file (default=stdout). */
+          if (args_info->output_given) {
+            fprintf(stderr, "%s: `--output' (`-F') option given more than once\n", PROGRAM);
+          }
+          args_info->output_given++;
+          if (args_info->output_arg) free(args_info->output_arg);
+          args_info->output_arg = gog_strdup(val);
+          break;
+        
+        case 'v':	 /* Report time, size, and memory usage for each stage to stderr. */
+          if (args_info->verbose_given) {
+            fprintf(stderr, "%s: `--verbose' (`-v') option given more than once\n", PROGRAM);
+          }
+          args_info->verbose_given++;
+         if (args_info->verbose_given <= 1)
+           args_info->verbose_flag = !(args_info->verbose_flag);
+          break;
+        
+        case 'B':	 /* Store output in blocked binary format. */
+          if (args_info->blocked_given) {
+            fprintf(stderr, "%s: `--blocked' (`-B') option given more than once\n", PROGRAM);
+          }
+          args_info->blocked_given++;
+         if (args_info->blocked_given <= 1)
+           args_info->blocked_flag = !(args_info->blocked_flag);
+          break;
+        
+        case 'e':	 /* Store states and arcs as compact variable-length records. */
+          if (args_info->varint_given) {
+            fprintf(stderr, "%s: `--varint' (`-e') option given more than once\n", PROGRAM);
+          }
+          args_info->varint_given++;
+         if (args_info->varint_given <= 1)
+           args_info->varint_flag = !(args_info->varint_flag);
+          break;
+        
+        case 'P':	 /* Allocate arcs from a per-automaton node pool. */
+          if (args_info->pool_given) {
+            fprintf(stderr, "%s: `--pool' (`-P') option given more than once\n", PROGRAM);
+          }
+          args_info->pool_given++;
+         if (args_info->pool_given <= 1)
+           args_info->pool_flag = !(args_info->pool_flag);
+          break;
+        
+        case 0:	 /* Long option(s) with no short form */
+        /* Print help and exit. */
+          if (strcmp(olong, "help") == 0) {
+            if (args_info->help_given) {
+              fprintf(stderr, "%s: `--help' (`-h') option given more than once\n", PROGRAM);
+            }
+            clear_args(args_info);
+            cmdline_parser_print_help();
+            exit(EXIT_SUCCESS);
+          
+          }
+          
+          /* Print version and exit. */
+          else if (strcmp(olong, "version") == 0) {
+            if (args_info->version_given) {
+              fprintf(stderr, "%s: `--version' (`-V') option given more than once\n", PROGRAM);
+            }
+            clear_args(args_info);
+            cmdline_parser_print_version();
+            exit(EXIT_SUCCESS);
+          
+          }
+          
+          /* Specify input file (default=stdin). */
+          else if (strcmp(olong, "input") == 0) {
+            if (args_info->input_given) {
+              fprintf(stderr, "%s: `--input' (`-i') option given more than once\n", PROGRAM);
+            }
+            args_info->input_given++;
+            if (args_info->input_arg) free(args_info->input_arg);
+            args_info->input_arg = gog_strdup(val);
+          }
+          
+          /* Specify compression level of output file. */
+          else if (strcmp(olong, "compress") == 0) {
+            if (args_info->compress_given) {
+              fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
+            }
+            args_info->compress_given++;
+            args_info->compress_arg = (int)atoi(val);
+          }
+          
+          /* Specifiy output file (default=stdout). */
+          else if (strcmp(olong, "output") == 0) {
+            if (args_info->output_given) {
+              fprintf(stderr, "%s: `--output' (`-F') option given more than once\n", PROGRAM);
+            }
+            args_info->output_given++;
+            if (args_info->output_arg) free(args_info->output_arg);
+            args_info->output_arg = gog_strdup(val);
+          }
+          
+          /* Report time, size, and memory usage for each stage to stderr. */
+          else if (strcmp(olong, "verbose") == 0) {
+            if (args_info->verbose_given) {
+              fprintf(stderr, "%s: `--verbose' (`-v') option given more than once\n", PROGRAM);
+            }
+            args_info->verbose_given++;
+           if (args_info->verbose_given <= 1)
+             args_info->verbose_flag = !(args_info->verbose_flag);
+          }
+          
+          /* Store output in blocked binary format. */
+          else if (strcmp(olong, "blocked") == 0) {
+            if (args_info->blocked_given) {
+              fprintf(stderr, "%s: `--blocked' (`-B') option given more than once\n", PROGRAM);
+            }
+            args_info->blocked_given++;
+           if (args_info->blocked_given <= 1)
+             args_info->blocked_flag = !(args_info->blocked_flag);
+          }
+          
+          /* Store states and arcs as compact variable-length records. */
+          else if (strcmp(olong, "varint") == 0) {
+            if (args_info->varint_given) {
+              fprintf(stderr, "%s: `--varint' (`-e') option given more than once\n", PROGRAM);
+            }
+            args_info->varint_given++;
+           if (args_info->varint_given <= 1)
+             args_info->varint_flag = !(args_info->varint_flag);
+          }
+          
+          /* Allocate arcs from a per-automaton node pool. */
+          else if (strcmp(olong, "pool") == 0) {
+            if (args_info->pool_given) {
+              fprintf(stderr, "%s: `--pool' (`-P') option given more than once\n", PROGRAM);
+            }
+            args_info->pool_given++;
+           if (args_info->pool_given <= 1)
+             args_info->pool_flag = !(args_info->pool_flag);
+          }
+          
+          else {
+            fprintf(stderr, "%s: unknown long option '%s'.\n", PROGRAM, olong);
+            return (EXIT_FAILURE);
+          }
+          break;
+
+        case '?':	 /* Invalid Option */
+          fprintf(stderr, "%s: unknown option '%s'.\n", PROGRAM, olong);
+          return (EXIT_FAILURE);
+
+
+        default:	/* bug: options not considered.  */
+          fprintf (stderr, "%s: option unknown: %c\n", PROGRAM, oshort);
+          abort ();
+        } /* switch */
+  return 0;
+}
+
+
+/* Initialize options not yet given from environmental defaults */
+void
+cmdline_parser_envdefaults(struct gengetopt_args_info *args_info)
+{
+  
+
+  return;
+}
+
+
+/* Load option values from an .rc file */
+void
+cmdline_parser_read_rcfile(const char *filename,
+			      struct gengetopt_args_info *args_info,
+			      int user_specified)
+{
+  char *fullname;
+  FILE *rcfile;
+
+  if (!filename) return; /* ignore NULL filenames */
+
+#if defined(HAVE_GETUID) && defined(HAVE_GETPWUID)
+  if (*filename == '~') {
+    /* tilde-expansion hack */
+    struct passwd *pwent = getpwuid(getuid());
+    if (!pwent) {
+      fprintf(stderr, "%s: user-id %d not found!\n", PROGRAM, getuid());
+      return;
+    }
+    if (!pwent->pw_dir) {
+      fprintf(stderr, "%s: home directory for user-id %d not found!\n", PROGRAM, getuid());
+      return;
+    }
+    fullname = (char *)malloc(strlen(pwent->pw_dir)+strlen(filename));
+    strcpy(fullname, pwent->pw_dir);
+    strcat(fullname, filename+1);
+  } else {
+    fullname = gog_strdup(filename);
+  }
+#else /* !(defined(HAVE_GETUID) && defined(HAVE_GETPWUID)) */
+  fullname = gog_strdup(filename);
+#endif /* defined(HAVE_GETUID) && defined(HAVE_GETPWUID) */
+
+  /* try to open */
+  rcfile = fopen(fullname,"r");
+  if (!rcfile) {
+    if (user_specified) {
+      fprintf(stderr, "%s: warning: open failed for rc-file '%s': %s\n",
+	      PROGRAM, fullname, strerror(errno));
+    }
+  }
+  else {
+   cmdline_parser_read_rc_stream(rcfile, fullname, args_info);
+  }
+
+  /* cleanup */
+  if (fullname != filename) free(fullname);
+  if (rcfile) fclose(rcfile);
+
+  return;
+}
+
+
+/* Parse option values from an .rc file : guts */
+#define OPTPARSE_GET 32
+void
+cmdline_parser_read_rc_stream(FILE *rcfile,
+				 const char *filename,
+				 struct gengetopt_args_info *args_info)
+{
+  char *optname  = (char *)malloc(OPTPARSE_GET);
+  char *optval   = (char *)malloc(OPTPARSE_GET);
+  size_t onsize  = OPTPARSE_GET;
+  size_t ovsize  = OPTPARSE_GET;
+  size_t onlen   = 0;
+  size_t ovlen   = 0;
+  int    lineno  = 0;
+  char c;
+
+#ifdef cmdline_parser_DEBUG
+  fprintf(stderr, "cmdline_parser_read_rc_stream('%s'):\n", filename);
+#endif
+
+  while ((c = fgetc(rcfile)) != EOF) {
+    onlen = 0;
+    ovlen = 0;
+    lineno++;
+
+    /* -- get next option-name */
+    /* skip leading space and comments */
+    if (isspace(c)) continue;
+    if (c == '#') {
+      while ((c = fgetc(rcfile)) != EOF) {
+	if (c == '\n') break;
+      }
+      continue;
+    }
+
+    /* parse option-name */
+    while (c != EOF && c != '=' && !isspace(c)) {
+      /* re-allocate if necessary */
+      if (onlen >= onsize-1) {
+	char *tmp = (char *)malloc(onsize+OPTPARSE_GET);
+	strcpy(tmp,optname);
+	free(optname);
+
+	onsize += OPTPARSE_GET;
+	optname = tmp;
+      }
+      optname[onlen++] = c;
+      c = fgetc(rcfile);
+    }
+    optname[onlen++] = '\0';
+
+#ifdef cmdline_parser_DEBUG
+    fprintf(stderr, "cmdline_parser_read_rc_stream('%s'): line %d: optname='%s'\n",
+	    filename, lineno, optname);
+#endif
+
+    /* -- get next option-value */
+    /* skip leading space */
+    while ((c = fgetc(rcfile)) != EOF && isspace(c)) {
+      ;
+    }
+
+    /* parse option-value */
+    while (c != EOF && c != '\n') {
+      /* re-allocate if necessary */
+      if (ovlen >= ovsize-1) {
+	char *tmp = (char *)malloc(ovsize+OPTPARSE_GET);
+	strcpy(tmp,optval);
+	free(optval);
+	ovsize += OPTPARSE_GET;
+	optval = tmp;
+      }
+      optval[ovlen++] = c;
+      c = fgetc(rcfile);
+    }
+    optval[ovlen++] = '\0';
+
+    /* now do the action for the option */
+    if (cmdline_parser_parse_option('\0',optname,optval,args_info) != 0) {
+      fprintf(stderr, "%s: error in file '%s' at line %d.\n", PROGRAM, filename, lineno);
+      
+    }
+  }
+
+  /* cleanup */
+  free(optname);
+  free(optval);
+
+  return;
+}
@@ -0,0 +1,73 @@
+/* -*- Mode: C -*-
+ *
+ * File: gfsmpipe_cmdparser.h
+ * Description: Headers for command-line parser struct gengetopt_args_info.
+ *
+ * File autogenerated by optgen.perl version 0.06.
+ *
+ */
+
+#ifndef gfsmpipe_cmdparser_h
+#define gfsmpipe_cmdparser_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * moocow: Never set PACKAGE and VERSION here.
+ */
+
+struct gengetopt_args_info {
+  char * input_arg;	 /* Specify input file (default=stdin). (default=-). */
+  int compress_arg;	 /* Specify compression level of output file. (default=-1). */
+  char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
+  int verbose_flag;	 /* Report time, size, and memory usage for each stage to stderr. (default=0). */
+  int blocked_flag;	 /* Store output in blocked binary format. (default=0). */
+  int varint_flag;	 /* Store states and arcs as compact variable-length records. (default=0). */
+  int pool_flag;	 /* Allocate arcs from a per-automaton node pool. (default=0). */
+
+  int help_given;	 /* Whether help was given */
+  int version_given;	 /* Whether version was given */
+  int input_given;	 /* Whether input was given */
+  int compress_given;	 /* Whether compress was given */
+  int output_given;	 /* Whether output was given */
+  int verbose_given;	 /* Whether verbose was given */
+  int blocked_given;	 /* Whether blocked was given */
+  int varint_given;	 /* Whether varint was given */
+  int pool_given;	 /* Whether pool was given */
+  
+  char **inputs;         /* unnamed arguments */
+  unsigned inputs_num;   /* number of unnamed arguments */
+};
+
+/* read rc files (if any) and parse all command-line options in one swell foop */
+int  cmdline_parser (int argc, char *const *argv, struct gengetopt_args_info *args_info);
+
+/* instantiate defaults from environment variables: you must call this yourself! */
+void cmdline_parser_envdefaults (struct gengetopt_args_info *args_info);
+
+/* read a single rc-file */
+void cmdline_parser_read_rcfile (const char *filename,
+				    struct gengetopt_args_info *args_info,
+				    int user_specified);
+
+/* read a single rc-file (stream) */
+void cmdline_parser_read_rc_stream (FILE *rcfile,
+				       const char *filename,
+				       struct gengetopt_args_info *args_info);
+
+/* parse a single option */
+int cmdline_parser_parse_option (char oshort, const char *olong, const char *val,
+				    struct gengetopt_args_info *args_info);
+
+/* print help message */
+void cmdline_parser_print_help(void);
+
+/* print version */
+void cmdline_parser_print_version(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* gfsmpipe_cmdparser_h */
@@ -0,0 +1,232 @@
+/*
+   gfsm-utils : finite state automaton utilities
+   Copyright (C) 2026 by agent <agent@local>
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 3 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include <gfsm.h>
+
+#if defined(HAVE_GETRUSAGE) && defined(HAVE_SYS_RESOURCE_H)
+# include <sys/resource.h>
+#endif
+
+#include "gfsmpipe_cmdparser.h"
+
+/*--------------------------------------------------------------------------
+ * Globals
+ *--------------------------------------------------------------------------*/
+char *progname = "gfsmpipe";
+
+//-- options
+struct gengetopt_args_info args;
+
+//-- files
+const char *infilename  = "-";
+const char *outfilename = "-";
+
+//-- global structs
+gfsmAutomaton *fsm;
+GTimer        *timer;
+gfsmBinCoding  coding = gfsmBCFixed;
+
+/*--------------------------------------------------------------------------
+ * Option Processing
+ *--------------------------------------------------------------------------*/
+void get_my_options(int argc, char **argv)
+{
+  if (cmdline_parser(argc, argv, &args) != 0)
+    exit(1);
+
+  //-- input, output
+  if (args.input_arg)  infilename  = args.input_arg;
+  if (args.output_arg) outfilename = args.output_arg;
+
+  //-- output record coding
+  if (args.varint_flag) coding = gfsmBCVarint;
+
+  //-- load environmental defaults
+  //cmdline_parser_envdefaults(&args);
+
+  //-- initialize automaton
+  fsm   = gfsm_automaton_new();
+  timer = g_timer_new();
+  if (args.pool_flag) gfsm_automaton_use_arc_pool(fsm, TRUE);
+}
+
+/*--------------------------------------------------------------------------
+ * report_stage()
+ *  + print stage statistics to stderr if --verbose was given
+ */
+void report_stage(const char *stage, gdouble elapsed)
+{
+  gfsmStateId n_states;
+  guint       n_arcs;
+  gsize       n_bytes;
+
+  if (!args.verbose_flag) return;
+
+  n_states = gfsm_automaton_n_states(fsm);
+  n_arcs   = gfsm_automaton_n_arcs(fsm);
+  n_bytes  = (gsize)n_states*sizeof(gfsmState) + (gsize)n_arcs*sizeof(gfsmArcListNode);
+
+  g_printerr("%s: %-24s %10u states %10u arcs %10lu KB %9.3f sec",
+	     progname, stage, n_states, n_arcs, (gulong)(n_bytes/1024), elapsed);
+
+#if defined(HAVE_GETRUSAGE) && defined(HAVE_SYS_RESOURCE_H)
+  {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) == 0)
+      g_printerr(" %10ld KB peak", (long)ru.ru_maxrss);
+  }
+#endif
+
+  g_printerr("\n");
+}
+
+/*--------------------------------------------------------------------------
+ * load_operand()
+ *  + load the second operand of a binary stage
+ */
+gfsmAutomaton *load_operand(const char *stage, const char *filename)
+{
+  gfsmError     *err = NULL;
+  gfsmAutomaton *fsm2;
+
+  if (!filename || !*filename) {
+    g_printerr("%s: stage '%s' requires a FILE argument\n", progname, stage);
+    exit(2);
+  }
+  fsm2 = gfsm_automaton_new();
+  if (args.pool_flag) gfsm_automaton_use_arc_pool(fsm2, TRUE);
+  if (!gfsm_automaton_load_bin_filename(fsm2,filename,&err)) {
+    g_printerr("%s: load failed for '%s': %s\n", progname, filename, err->message);
+    exit(255);
+  }
+  return fsm2;
+}
+
+/*--------------------------------------------------------------------------
+ * apply_stage()
+ *  + apply a single STAGE of the form OPERATION or OPERATION=ARGUMENT to fsm
+ */
+void apply_stage(const char *stage)
+{
+  const char    *eq  = strchr(stage,'=');
+  gchar         *op  = eq ? g_strndup(stage, eq-stage) : g_strdup(stage);
+  const char    *arg = eq ? eq+1 : NULL;
+  gfsmAutomaton *fsm2 = NULL;
+
+  //-- unary operations
+  if      (strcmp(op,"arcsort")==0)     { gfsm_automaton_arcsort(fsm, arg ? gfsm_acmask_from_chars(arg) : gfsmASMLower); }
+  else if (strcmp(op,"arcuniq")==0)     { gfsm_automaton_arcuniq(fsm); }
+  else if (strcmp(op,"closure")==0) {
+    if (arg) gfsm_automaton_n_closure(fsm, strtoul(arg,NULL,0));
+    else     gfsm_automaton_closure(fsm, FALSE);
+  }
+  else if (strcmp(op,"connect")==0)     { gfsm_automaton_connect(fsm); }
+  else if (strcmp(op,"determinize")==0) { gfsm_automaton_determinize(fsm); }
+  else if (strcmp(op,"invert")==0)      { gfsm_automaton_invert(fsm); }
+  else if (strcmp(op,"minimize")==0)    { gfsm_automaton_minimize(fsm); }
+  else if (strcmp(op,"optional")==0)    { gfsm_automaton_optional(fsm); }
+  else if (strcmp(op,"project")==0) {
+    if (!arg || strcmp(arg,"lo")==0 || strcmp(arg,"lower")==0 || strcmp(arg,"1")==0)
+      gfsm_automaton_project(fsm, gfsmLSLower);
+    else if (strcmp(arg,"hi")==0 || strcmp(arg,"upper")==0 || strcmp(arg,"2")==0)
+      gfsm_automaton_project(fsm, gfsmLSUpper);
+    else {
+      g_printerr("%s: unknown projection side '%s' in stage '%s'\n", progname, arg, stage);
+      exit(2);
+    }
+  }
+  else if (strcmp(op,"renumber")==0)    { gfsm_statesort_bfs(fsm,NULL); }
+  else if (strcmp(op,"reverse")==0)     { gfsm_automaton_reverse(fsm); }
+  else if (strcmp(op,"rmepsilon")==0)   { gfsm_automaton_rmepsilon(fsm); }
+
+  //-- binary operations
+  else if (strcmp(op,"compose")==0)     { gfsm_automaton_compose(fsm,    fsm2=load_operand(stage,arg)); }
+  else if (strcmp(op,"concat")==0)      { gfsm_automaton_concat(fsm,     fsm2=load_operand(stage,arg)); }
+  else if (strcmp(op,"difference")==0)  { gfsm_automaton_difference(fsm, fsm2=load_operand(stage,arg)); }
+  else if (strcmp(op,"intersect")==0)   { gfsm_automaton_intersect(fsm,  fsm2=load_operand(stage,arg)); }
+  else if (strcmp(op,"product")==0)     { gfsm_automaton_product2(fsm,   fsm2=load_operand(stage,arg)); }
+  else if (strcmp(op,"union")==0)       { gfsm_automaton_union(fsm,      fsm2=load_operand(stage,arg)); }
+
+  else {
+    g_printerr("%s: unknown operation '%s' in stage '%s'\n", progname, op, stage);
+    exit(2);
+  }
+
+  if (fsm2) gfsm_automaton_free(fsm2);
+  g_free(op);
+}
+
+/*--------------------------------------------------------------------------
+ * MAIN
+ *--------------------------------------------------------------------------*/
+int main (int argc, char **argv)
+{
+  gfsmError *err = NULL;
+  gdouble    t_total = 0, t_stage;
+  guint      i;
+  int        rc = 0;
+  get_my_options(argc,argv);
+
+  //-- load automaton
+  g_timer_start(timer);
+  if (!gfsm_automaton_load_bin_filename(fsm,infilename,&err)) {
+    g_printerr("%s: load failed for '%s': %s\n", progname, infilename, err->message);
+    exit(255);
+  }
+  t_total += (t_stage = g_timer_elapsed(timer,NULL));
+  report_stage("(load)", t_stage);
+
+  //-- apply stages
+  for (i=0; i < args.inputs_num; i++) {
+    g_timer_start(timer);
+    apply_stage(args.inputs[i]);
+    t_total += (t_stage = g_timer_elapsed(timer,NULL));
+    report_stage(args.inputs[i], t_stage);
+  }
+
+  //-- spew automaton
+  g_timer_start(timer);
+  if (args.blocked_flag
+      ? !gfsm_automaton_save_bin_filename_blocked(fsm,outfilename,args.compress_arg,coding,&err)
+      : !gfsm_automaton_save_bin_filename_full(fsm,outfilename,args.compress_arg,coding,&err)) {
+    g_printerr("%s: store failed to '%s': %s\n", progname, outfilename, err->message);
+    exit(4);
+  }
+  t_total += (t_stage = g_timer_elapsed(timer,NULL));
+  report_stage("(save)", t_stage);
+  report_stage("(total)", t_total);
+
+  //-- get exit status: 255 if no root state
+  if (fsm->root_id == gfsmNoState) rc=255;
+
+  //-- cleanup
+  if (fsm) gfsm_automaton_free(fsm);
+  g_timer_destroy(timer);
+
+  return rc;
+}
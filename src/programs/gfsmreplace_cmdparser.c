@@ -85,6 +85,7 @@ cmdline_parser_print_help (void)
   printf("   -rFSMFILE  --replacement=FSMFILE  Replacement automaton (binary gfsm file)\n");
   printf("   -lLABEL    --lower=LABEL          Lower label to replace (default=any)\n");
   printf("   -uLABEL    --upper=LABEL          Upper label to replace (default=any)\n");
+  printf("   -DN        --depth=N              Expand replacements recursively up to depth N (0: unlimited)\n");
   printf("   -zLEVEL    --compress=LEVEL       Specify compression level of output file.\n");
   printf("   -FFILE     --output=FILE          Specifiy output file (default=stdout).\n");
 }
@@ -112,6 +113,7 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->replacement_arg = gog_strdup("-"); 
   args_info->lower_arg = 0; 
   args_info->upper_arg = 0; 
+  args_info->depth_arg = 0; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
 }
@@ -128,6 +130,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->replacement_given = 0;
   args_info->lower_given = 0;
   args_info->upper_given = 0;
+  args_info->depth_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
 
@@ -151,6 +154,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "replacement", 1, NULL, 'r' },
 	{ "lower", 1, NULL, 'l' },
 	{ "upper", 1, NULL, 'u' },
+	{ "depth", 1, NULL, 'D' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
         { NULL,	0, NULL, 0 }
@@ -161,6 +165,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'r', ':',
 	'l', ':',
 	'u', ':',
+	'D', ':',
 	'z', ':',
 	'F', ':',
 	'\0'
@@ -251,6 +256,14 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->upper_arg = (int)atoi(val);
           break;
         
+        case 'D':	 /* Expand replacements recursively up to depth N (0: unlimited) */
+          if (args_info->depth_given) {
+            fprintf(stderr, "%s: `--depth' (`-D') option given more than once\n", PROGRAM);
+          }
+          args_info->depth_given++;
+          args_info->depth_arg = (int)atoi(val);
+          break;
+        
         case 'z':	 /* Specify compression level of output file. */
           if (args_info->compress_given) {
             fprintf(stderr, "%s: `--compress' (`-z') option given more than once\n", PROGRAM);
@@ -319,6 +332,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->upper_arg = (int)atoi(val);
           }
           
+          /* Expand replacements recursively up to depth N (0: unlimited) */
+          else if (strcmp(olong, "depth") == 0) {
+            if (args_info->depth_given) {
+              fprintf(stderr, "%s: `--depth' (`-D') option given more than once\n", PROGRAM);
+            }
+            args_info->depth_given++;
+            args_info->depth_arg = (int)atoi(val);
+          }
+          
           /* Specify compression level of output file. */
           else if (strcmp(olong, "compress") == 0) {
             if (args_info->compress_given) {
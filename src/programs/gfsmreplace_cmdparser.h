@@ -22,6 +22,7 @@ struct gengetopt_args_info {
   char * replacement_arg;	 /* Replacement automaton (binary gfsm file) (default=-). */
   int lower_arg;	 /* Lower label to replace (default=any) (default=0). */
   int upper_arg;	 /* Upper label to replace (default=any) (default=0). */
+  int depth_arg;	 /* Expand replacements recursively up to depth N (0: unlimited) (default=0). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
@@ -30,6 +31,7 @@ struct gengetopt_args_info {
   int replacement_given;	 /* Whether replacement was given */
   int lower_given;	 /* Whether lower was given */
   int upper_given;	 /* Whether upper was given */
+  int depth_given;	 /* Whether depth was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
   
@@ -45,7 +45,7 @@ const char *infilename  = "-";
 const char *outfilename = "-";
 
 //-- global structs
-gfsmAutomaton *repl = NULL, *fsm=NULL;
+gfsmAutomaton *repl = NULL, *fsm=NULL, *out=NULL;
 gfsmError     *err = NULL;
 
 /*--------------------------------------------------------------------------
@@ -88,19 +88,36 @@ int main (int argc, char **argv)
   }
 
   //-- perform replacement
-  gfsm_automaton_replace(fsm,
-			 (args.lower_given ? args.lower_arg : gfsmNoLabel),
-			 (args.upper_given ? args.upper_arg : gfsmNoLabel),
-			 repl);
+  if (args.depth_given) {
+    //-- delayed (recursive) replacement
+    gfsmRTN *rtn = gfsm_rtn_new(fsm, (guint32)args.depth_arg);
+    gfsm_rtn_add_rule(rtn,
+		      (args.lower_given ? args.lower_arg : gfsmNoLabel),
+		      (args.upper_given ? args.upper_arg : gfsmNoLabel),
+		      repl);
+    out = gfsm_rtn_expand(rtn, NULL);
+    if (rtn->error) {
+      g_printerr("%s: replacement failed: %s\n", progname, rtn->error->message);
+      exit(3);
+    }
+    gfsm_rtn_free(rtn);
+  } else {
+    gfsm_automaton_replace(fsm,
+			   (args.lower_given ? args.lower_arg : gfsmNoLabel),
+			   (args.upper_given ? args.upper_arg : gfsmNoLabel),
+			   repl);
+    out = fsm;
+  }
 
   //-- save output
-  if (!gfsm_automaton_save_bin_filename(fsm,outfilename,args.compress_arg,&err)) {
+  if (!gfsm_automaton_save_bin_filename(out,outfilename,args.compress_arg,&err)) {
     g_printerr("%s: store failed to '%s': %s\n", progname, outfilename, err->message);
     exit(4);
   }
 
   //-- cleanup
   if (repl) gfsm_automaton_free(repl);
+  if (out && out != fsm) gfsm_automaton_free(out);
   if (fsm)  gfsm_automaton_free(fsm);
 
   GFSM_FINISH
@@ -80,7 +80,8 @@ int main (int argc, char **argv)
   }
 
   //-- rmepsilon
-  gfsm_automaton_rmepsilon(fsm);
+  if (args.closure_flag) gfsm_automaton_rmepsilon_closure(fsm);
+  else                   gfsm_automaton_rmepsilon(fsm);
 
   //-- connect?
   if (args.connect_flag) gfsm_automaton_connect(fsm);
@@ -91,10 +91,12 @@ cmdline_parser_print_help (void)
   printf("   -a         --att-mode            Parse string(s) in AT&T-compatible mode.\n");
   printf("   -q         --quiet               Suppress warnings about undefined symbols.\n");
   printf("   -u         --utf8                Assume UTF-8 encoded alphabet and input.\n");
+  printf("   -M         --longest-match       Tokenize input string(s) by longest match over all alphabet symbols.\n");
   printf("   -B         --best                Only consider cost-minimal path(s) for each training pair.\n");
   printf("   -O         --ordered             Count permutations in arc-order as multiple paths.\n");
   printf("   -P         --distribute-by-path  Distribute pair-mass over multiple paths.\n");
   printf("   -A         --distribute-by-arc   Distribute path-mass over arcs.\n");
+  printf("   -E         --expected            Accumulate expected counts (forward-backward).\n");
   printf("   -fFSTFILE  --fst=FSTFILE         Transducer to apply (required).\n");
   printf("   -zLEVEL    --compress=LEVEL      Specify compression level of output file.\n");
   printf("   -FFILE     --output=FILE         Specifiy output file (default=stdout).\n");
@@ -126,10 +128,12 @@ clear_args(struct gengetopt_args_info *args_info)
   args_info->att_mode_flag = 0; 
   args_info->quiet_flag = 0; 
   args_info->utf8_flag = 0; 
+  args_info->longest_match_flag = 0; 
   args_info->best_flag = 0; 
   args_info->ordered_flag = 0; 
   args_info->distribute_by_path_flag = 0; 
   args_info->distribute_by_arc_flag = 0; 
+  args_info->expected_flag = 0; 
   args_info->fst_arg = NULL; 
   args_info->compress_arg = -1; 
   args_info->output_arg = gog_strdup("-"); 
@@ -150,10 +154,12 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->att_mode_given = 0;
   args_info->quiet_given = 0;
   args_info->utf8_given = 0;
+  args_info->longest_match_given = 0;
   args_info->best_given = 0;
   args_info->ordered_given = 0;
   args_info->distribute_by_path_given = 0;
   args_info->distribute_by_arc_given = 0;
+  args_info->expected_given = 0;
   args_info->fst_given = 0;
   args_info->compress_given = 0;
   args_info->output_given = 0;
@@ -181,10 +187,12 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "att-mode", 0, NULL, 'a' },
 	{ "quiet", 0, NULL, 'q' },
 	{ "utf8", 0, NULL, 'u' },
+	{ "longest-match", 0, NULL, 'M' },
 	{ "best", 0, NULL, 'B' },
 	{ "ordered", 0, NULL, 'O' },
 	{ "distribute-by-path", 0, NULL, 'P' },
 	{ "distribute-by-arc", 0, NULL, 'A' },
+	{ "expected", 0, NULL, 'E' },
 	{ "fst", 1, NULL, 'f' },
 	{ "compress", 1, NULL, 'z' },
 	{ "output", 1, NULL, 'F' },
@@ -199,10 +207,12 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'a',
 	'q',
 	'u',
+	'M',
 	'B',
 	'O',
 	'P',
 	'A',
+	'E',
 	'f', ':',
 	'z', ':',
 	'F', ':',
@@ -323,6 +333,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->utf8_flag = !(args_info->utf8_flag);
           break;
         
+        case 'M':	 /* Tokenize input string(s) by longest match over all alphabet symbols. */
+          if (args_info->longest_match_given) {
+            fprintf(stderr, "%s: `--longest-match' (`-M') option given more than once\n", PROGRAM);
+          }
+          args_info->longest_match_given++;
+         if (args_info->longest_match_given <= 1)
+           args_info->longest_match_flag = !(args_info->longest_match_flag);
+          break;
+        
         case 'B':	 /* Only consider cost-minimal path(s) for each training pair. */
           if (args_info->best_given) {
             fprintf(stderr, "%s: `--best' (`-B') option given more than once\n", PROGRAM);
@@ -359,6 +378,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
            args_info->distribute_by_arc_flag = !(args_info->distribute_by_arc_flag);
           break;
         
+        case 'E':	 /* Accumulate expected counts (forward-backward). */
+          if (args_info->expected_given) {
+            fprintf(stderr, "%s: `--expected' (`-E') option given more than once\n", PROGRAM);
+          }
+          args_info->expected_given++;
+         if (args_info->expected_given <= 1)
+           args_info->expected_flag = !(args_info->expected_flag);
+          break;
+        
         case 'f':	 /* Transducer to apply (required). */
           if (args_info->fst_given) {
             fprintf(stderr, "%s: `--fst' (`-f') option given more than once\n", PROGRAM);
@@ -468,6 +496,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->utf8_flag = !(args_info->utf8_flag);
           }
           
+          /* Tokenize input string(s) by longest match over all alphabet symbols. */
+          else if (strcmp(olong, "longest-match") == 0) {
+            if (args_info->longest_match_given) {
+              fprintf(stderr, "%s: `--longest-match' (`-M') option given more than once\n", PROGRAM);
+            }
+            args_info->longest_match_given++;
+           if (args_info->longest_match_given <= 1)
+             args_info->longest_match_flag = !(args_info->longest_match_flag);
+          }
+          
           /* Only consider cost-minimal path(s) for each training pair. */
           else if (strcmp(olong, "best") == 0) {
             if (args_info->best_given) {
@@ -508,6 +546,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
              args_info->distribute_by_arc_flag = !(args_info->distribute_by_arc_flag);
           }
           
+          /* Accumulate expected counts (forward-backward). */
+          else if (strcmp(olong, "expected") == 0) {
+            if (args_info->expected_given) {
+              fprintf(stderr, "%s: `--expected' (`-E') option given more than once\n", PROGRAM);
+            }
+            args_info->expected_given++;
+           if (args_info->expected_given <= 1)
+             args_info->expected_flag = !(args_info->expected_flag);
+          }
+          
           /* Transducer to apply (required). */
           else if (strcmp(olong, "fst") == 0) {
             if (args_info->fst_given) {
@@ -25,10 +25,12 @@ struct gengetopt_args_info {
   int att_mode_flag;	 /* Parse string(s) in AT&T-compatible mode. (default=0). */
   int quiet_flag;	 /* Suppress warnings about undefined symbols. (default=0). */
   int utf8_flag;	 /* Assume UTF-8 encoded alphabet and input. (default=0). */
+  int longest_match_flag;	 /* Tokenize input string(s) by longest match over all alphabet symbols. (default=0). */
   int best_flag;	 /* Only consider cost-minimal path(s) for each training pair. (default=0). */
   int ordered_flag;	 /* Count permutations in arc-order as multiple paths. (default=0). */
   int distribute_by_path_flag;	 /* Distribute pair-mass over multiple paths. (default=0). */
   int distribute_by_arc_flag;	 /* Distribute path-mass over arcs. (default=0). */
+  int expected_flag;	 /* Accumulate expected counts (forward-backward). (default=0). */
   char * fst_arg;	 /* Transducer to apply (required). (default=NULL). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
@@ -41,10 +43,12 @@ struct gengetopt_args_info {
   int att_mode_given;	 /* Whether att-mode was given */
   int quiet_given;	 /* Whether quiet was given */
   int utf8_given;	 /* Whether utf8 was given */
+  int longest_match_given;	 /* Whether longest-match was given */
   int best_given;	 /* Whether best was given */
   int ordered_given;	 /* Whether ordered was given */
   int distribute_by_path_given;	 /* Whether distribute-by-path was given */
   int distribute_by_arc_given;	 /* Whether distribute-by-arc was given */
+  int expected_given;	 /* Whether expected was given */
   int fst_given;	 /* Whether fst was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
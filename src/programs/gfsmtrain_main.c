@@ -48,6 +48,7 @@ const char *input_default = "-";
 gfsmTrainer *trainer=NULL;
 gfsmAutomaton *fst  =NULL;
 gfsmAlphabet  *ilabels=NULL, *olabels=NULL;
+gfsmTokenizer *itokenizer=NULL, *otokenizer=NULL;
 gfsmError     *err = NULL;
 
 gboolean       att_mode = FALSE;
@@ -121,22 +122,53 @@ void get_my_options(int argc, char **argv)
   trainer->prunePathPermutations = !args.ordered_flag;
   trainer->distributeOverPaths   =  args.distribute_by_path_flag;
   trainer->distributeOverArcs    =  args.distribute_by_arc_flag;
+  trainer->expectedCounts        =  args.expected_flag;
 
   //-- mode flags
   att_mode = args.att_mode_flag;
   warn_on_undef = !args.quiet_flag;
+
+  //-- compile tokenizers
+  if (ilabels) {
+    itokenizer = gfsm_tokenizer_new(ilabels,
+				    (att_mode ? gfsmTFAtt : gfsmTFChars)
+				    | (args.longest_match_flag ? gfsmTFLongest : gfsmTFChars));
+  }
+  if (olabels) {
+    otokenizer = gfsm_tokenizer_new(olabels,
+				    (att_mode ? gfsmTFAtt : gfsmTFChars)
+				    | (args.longest_match_flag ? gfsmTFLongest : gfsmTFChars));
+  }
 }
 
 /*--------------------------------------------------------------------------
  * guts
  */
-void train_pairfile(FILE *pairfile)
+
+//-- number of pairs to read before training on them
+const guint train_batch_size = 4096;
+
+//-- ivecs: batch of input label vectors
+//-- ovecs: batch of output label vectors, parallel to ivecs
+void train_batch(GPtrArray *ivecs, GPtrArray *ovecs, guint npairs)
+{
+  //-- drop unused vectors (only for the last batch)
+  while (ivecs->len > npairs) {
+    g_ptr_array_free((gfsmLabelVector*)g_ptr_array_index(ivecs,ivecs->len-1), TRUE);
+    g_ptr_array_free((gfsmLabelVector*)g_ptr_array_index(ovecs,ovecs->len-1), TRUE);
+    g_ptr_array_set_size(ivecs, ivecs->len-1);
+    g_ptr_array_set_size(ovecs, ovecs->len-1);
+  }
+  if (npairs > 0)
+    gfsm_trainer_train_pairs(trainer, ivecs, ovecs, 0);
+}
+
+void train_pairfile(FILE *pairfile, GPtrArray *ivecs, GPtrArray *ovecs)
 {
   char            *str = NULL, *istr,*ostr;
   size_t           buflen = 0;
   ssize_t          linelen = 0;
-  gfsmLabelVector  *ivec = g_ptr_array_new();
-  gfsmLabelVector  *ovec = g_ptr_array_new();
+  guint            npairs = 0;
 
   while (!feof(pairfile)) {
     linelen = getdelim(&str,&buflen,'\n',pairfile);
@@ -160,17 +192,23 @@ void train_pairfile(FILE *pairfile)
     }
 
     //-- convert to labels
-    ivec = gfsm_alphabet_generic_string_to_labels(ilabels, istr, ivec, warn_on_undef, att_mode);
-    ovec = gfsm_alphabet_generic_string_to_labels(olabels, ostr, ovec, warn_on_undef, att_mode);
+    if (npairs == ivecs->len) {
+      g_ptr_array_add(ivecs, g_ptr_array_new());
+      g_ptr_array_add(ovecs, g_ptr_array_new());
+    }
+    gfsm_tokenizer_string_to_labels(itokenizer, istr, (gfsmLabelVector*)g_ptr_array_index(ivecs,npairs), warn_on_undef);
+    gfsm_tokenizer_string_to_labels(otokenizer, ostr, (gfsmLabelVector*)g_ptr_array_index(ovecs,npairs), warn_on_undef);
 
     //-- training guts
-    gfsm_trainer_train(trainer, ivec, ovec);
+    if (++npairs == train_batch_size) {
+      train_batch(ivecs, ovecs, npairs);
+      npairs = 0;
+    }
   }
+  train_batch(ivecs, ovecs, npairs);
 
   //-- cleanup
   if (str)  free(str);
-  if (ivec) g_ptr_array_free(ivec,TRUE);
-  if (ovec) g_ptr_array_free(ovec,TRUE);
 
   return;
 }
@@ -181,10 +219,13 @@ void train_pairfile(FILE *pairfile)
  *--------------------------------------------------------------------------*/
 int main (int argc, char **argv)
 {
+  GPtrArray *ivecs, *ovecs;
   int i;
 
   GFSM_INIT
   get_my_options(argc,argv);
+  ivecs = g_ptr_array_new();
+  ovecs = g_ptr_array_new();
 
   //-- churn pair files
   for (i=0; i < args.inputs_num; i++) {
@@ -194,7 +235,7 @@ int main (int argc, char **argv)
       g_printerr("%s: open failed for input file '%s': %s\n", progname, pairfile, strerror(errno));
       exit(255);
     }
-    train_pairfile(pairfh);
+    train_pairfile(pairfh, ivecs, ovecs);
     if (pairfh != stdin) fclose(pairfh);
   }
 
@@ -206,8 +247,13 @@ int main (int argc, char **argv)
   }
 
   //-- cleanup
+  train_batch(ivecs, ovecs, 0);
+  g_ptr_array_free(ivecs,TRUE);
+  g_ptr_array_free(ovecs,TRUE);
   if (trainer) gfsm_trainer_free(trainer,TRUE);
   if (fst)     gfsm_automaton_free(fst);
+  if (otokenizer) gfsm_tokenizer_free(otokenizer);
+  if (itokenizer) gfsm_tokenizer_free(itokenizer);
   if (olabels) gfsm_alphabet_free(olabels);
   if (ilabels) gfsm_alphabet_free(ilabels);
 
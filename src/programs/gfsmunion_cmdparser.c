@@ -86,6 +86,7 @@ cmdline_parser_print_help (void)
   printf("   -h       --help            Print help and exit.\n");
   printf("   -V       --version         Print version and exit.\n");
   printf("   -zLEVEL  --compress=LEVEL  Specify compression level of output file.\n");
+  printf("   -T       --trie            Merge inputs into a shared prefix tree rather than an epsilon union.\n");
   printf("   -FFILE   --output=FILE     Specifiy output file (default=stdout).\n");
 }
 
@@ -110,6 +111,7 @@ static void
 clear_args(struct gengetopt_args_info *args_info)
 {
   args_info->compress_arg = -1; 
+  args_info->trie_flag = 0; 
   args_info->output_arg = gog_strdup("-"); 
 }
 
@@ -123,6 +125,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
   args_info->help_given = 0;
   args_info->version_given = 0;
   args_info->compress_given = 0;
+  args_info->trie_given = 0;
   args_info->output_given = 0;
 
   clear_args(args_info);
@@ -143,6 +146,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	{ "help", 0, NULL, 'h' },
 	{ "version", 0, NULL, 'V' },
 	{ "compress", 1, NULL, 'z' },
+	{ "trie", 0, NULL, 'T' },
 	{ "output", 1, NULL, 'F' },
         { NULL,	0, NULL, 0 }
       };
@@ -150,6 +154,7 @@ cmdline_parser (int argc, char * const *argv, struct gengetopt_args_info *args_i
 	'h',
 	'V',
 	'z', ':',
+	'T',
 	'F', ':',
 	'\0'
       };
@@ -222,6 +227,15 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
           args_info->compress_arg = (int)atoi(val);
           break;
         
+        case 'T':	 /* Merge inputs into a shared prefix tree rather than an epsilon union. */
+          if (args_info->trie_given) {
+            fprintf(stderr, "%s: `--trie' (`-T') option given more than once\n", PROGRAM);
+          }
+          args_info->trie_given++;
+         if (args_info->trie_given <= 1)
+           args_info->trie_flag = !(args_info->trie_flag);
+          break;
+        
         case 'F':	 /* Specifiy output file (default=stdout). */
           if (args_info->output_given) {
             fprintf(stderr, "%s: `--output' (`-F') option given more than once\n", PROGRAM);
@@ -263,6 +277,16 @@ cmdline_parser_parse_option(char oshort, const char *olong, const char *val,
             args_info->compress_arg = (int)atoi(val);
           }
           
+          /* Merge inputs into a shared prefix tree rather than an epsilon union. */
+          else if (strcmp(olong, "trie") == 0) {
+            if (args_info->trie_given) {
+              fprintf(stderr, "%s: `--trie' (`-T') option given more than once\n", PROGRAM);
+            }
+            args_info->trie_given++;
+           if (args_info->trie_given <= 1)
+             args_info->trie_flag = !(args_info->trie_flag);
+          }
+          
           /* Specifiy output file (default=stdout). */
           else if (strcmp(olong, "output") == 0) {
             if (args_info->output_given) {
@@ -20,11 +20,13 @@ extern "C" {
 
 struct gengetopt_args_info {
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
+  int trie_flag;	 /* Merge inputs into a shared prefix tree rather than an epsilon union. (default=0). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
   int compress_given;	 /* Whether compress was given */
+  int trie_given;	 /* Whether trie was given */
   int output_given;	 /* Whether output was given */
   
   char **inputs;         /* unnamed arguments */
@@ -44,7 +44,8 @@ const char *outfilename = "-";
 
 //-- global structs etc.
 gfsmError *err = NULL;
-gfsmAutomaton *fsmUnion=NULL, *fsmIn=NULL;
+gfsmAutomaton *fsmUnion=NULL;
+GPtrArray     *fsmsIn=NULL;
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -66,29 +67,22 @@ void get_my_options(int argc, char **argv)
   //-- load environmental defaults
   //cmdline_parser_envdefaults(&args);
 
-  //-- initialize automaton
-  fsmIn = gfsm_automaton_new();
+  //-- initialize input array
+  fsmsIn = g_ptr_array_sized_new(args.inputs_num+1);
 }
 
 /*--------------------------------------------------------------------------
- * compute_union()
+ * load_input()
  *  + utility routine
  */
-void compute_union(const char *infilename)
+void load_input(const char *infilename)
 {
-  //-- load automaton
+  gfsmAutomaton *fsmIn = gfsm_automaton_new();
   if (!gfsm_automaton_load_bin_filename(fsmIn,infilename,&err)) {
     g_printerr("%s: load failed for '%s': %s\n", progname, infilename, err->message);
     exit(255);
   }
-
-  //-- compute union
-  if (fsmUnion == NULL) {
-    fsmUnion = fsmIn;
-    fsmIn    = gfsm_automaton_new();
-  } else {
-    gfsm_automaton_union(fsmUnion,fsmIn);
-  }
+  g_ptr_array_add(fsmsIn, fsmIn);
 }
 
 /*--------------------------------------------------------------------------
@@ -103,9 +97,19 @@ int main (int argc, char **argv)
   get_my_options(argc,argv);
 
   for (i = 0; i < args.inputs_num; i++) {
-    compute_union(args.inputs[i]);
+    load_input(args.inputs[i]);
+  }
+  if (args.inputs_num == 1) load_input("-");
+
+  //-- compute union
+  if (args.trie_flag) {
+    fsmUnion = gfsm_automaton_shadow((gfsmAutomaton*)g_ptr_array_index(fsmsIn,0));
+    gfsm_automaton_union_trie_n(fsmUnion, (gfsmAutomaton**)fsmsIn->pdata, fsmsIn->len);
+  } else {
+    fsmUnion = (gfsmAutomaton*)g_ptr_array_index(fsmsIn,0);
+    g_ptr_array_index(fsmsIn,0) = NULL;
+    gfsm_automaton_union_n(fsmUnion, ((gfsmAutomaton**)fsmsIn->pdata)+1, fsmsIn->len-1);
   }
-  if (args.inputs_num == 1) compute_union("-");
 
   //-- spew automaton
   if (!gfsm_automaton_save_bin_filename(fsmUnion,outfilename,args.compress_arg,&err)) {
@@ -114,7 +118,10 @@ int main (int argc, char **argv)
   }
 
   //-- cleanup
-  if (fsmIn) gfsm_automaton_free(fsmIn);
+  for (i = 0; i < fsmsIn->len; i++) {
+    if (g_ptr_array_index(fsmsIn,i)) gfsm_automaton_free((gfsmAutomaton*)g_ptr_array_index(fsmsIn,i));
+  }
+  g_ptr_array_free(fsmsIn,TRUE);
   if (fsmUnion) gfsm_automaton_free(fsmUnion);
 
   GFSM_FINISH
@@ -20,12 +20,14 @@ extern "C" {
 
 struct gengetopt_args_info {
   char * fst_arg;	 /* Weighted transducer to apply (default=stdin). (default=-). */
+  int compact_flag;	 /* FSTFILE is a packed automaton (see gfsmindex --compact) (default=0). */
   int compress_arg;	 /* Specify compression level of output file. (default=-1). */
   char * output_arg;	 /* Specifiy output file (default=stdout). (default=-). */
 
   int help_given;	 /* Whether help was given */
   int version_given;	 /* Whether version was given */
   int fst_given;	 /* Whether fst was given */
+  int compact_given;	 /* Whether compact was given */
   int compress_given;	 /* Whether compress was given */
   int output_given;	 /* Whether output was given */
   
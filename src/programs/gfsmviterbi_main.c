@@ -44,8 +44,9 @@ const char *fstfilename = "-";
 const char *outfilename = "-";
 
 //-- global structs
-gfsmAutomaton *fst = NULL;
-gfsmError     *err = NULL;
+gfsmAutomaton       *fst = NULL;
+gfsmPackedAutomaton *pfst = NULL;
+gfsmError           *err = NULL;
 
 /*--------------------------------------------------------------------------
  * Option Processing
@@ -63,6 +64,14 @@ void get_my_options(int argc, char **argv)
   outfilename = args.output_arg;
 
   //-- load FST
+  if (args.compact_flag) {
+    pfst = gfsm_packed_automaton_new();
+    if (!gfsm_packed_automaton_load_bin_filename(pfst, fstfilename, &err)) {
+      g_printerr("%s: load failed for packed FST file '%s': %s\n", progname, fstfilename, err->message);
+      exit(255);
+    }
+    return;
+  }
   fst = gfsm_automaton_new();
   if (!gfsm_automaton_load_bin_filename(fst, fstfilename, &err)) {
     g_printerr("%s: load failed for FST file '%s': %s\n", progname, fstfilename, err->message);
@@ -89,7 +98,10 @@ gfsmAutomaton *viterbi_labels(gfsmAutomaton *fst, int argc, char **argv)
   }
 
   //-- actual viterbi lookup
-  trellis = gfsm_automaton_lookup_viterbi(fst, vec, trellis);
+  if (pfst)
+    trellis = gfsm_packed_lookup_viterbi(pfst, vec, trellis);
+  else
+    trellis = gfsm_automaton_lookup_viterbi(fst, vec, trellis);
 
   //-- cleanup
   g_ptr_array_free(vec,TRUE);
@@ -118,6 +130,7 @@ int main (int argc, char **argv)
 
   //-- cleanup
   if (fst)     gfsm_automaton_free(fst);
+  if (pfst)    gfsm_packed_automaton_free(pfst);
   if (trellis) gfsm_automaton_free(trellis);
 
   GFSM_FINISH
@@ -0,0 +1,78 @@
+/*=============================================================================*\
+ * File: alphatest.c
+ * Description: finite state machine library: test driver for text and binary alphabets
+ *=============================================================================*/
+
+#include <gfsmAlphabet.h>
+#include <gfsmMappedAlphabet.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------
+ * dump(): print alphabet a in label-file format
+ */
+static
+void dump(const char *what, gfsmAlphabet *a)
+{
+  gfsmError *err = NULL;
+  printf("--%s: size=%u\n", what, gfsm_alphabet_size(a));
+  fflush(stdout);
+  if (!gfsm_alphabet_save_file(a, stdout, &err)) {
+    printf("save failed: %s\n", err ? err->message : "?");
+  }
+  fflush(stdout);
+}
+
+/*--------------------------------------------------------------
+ * main
+ */
+int main(int argc, char **argv)
+{
+  gfsmAlphabet *a, *b;
+  gfsmMappedAlphabet *ma;
+  gfsmError *err = NULL;
+  gfsmLabelVal lab;
+  const gchar *key;
+
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s LABFILE BINFILE\n", argv[0]);
+    return 1;
+  }
+
+  //-- text loader
+  a = gfsm_string_alphabet_new();
+  if (!gfsm_alphabet_load_filename(a, argv[1], &err)) {
+    fprintf(stderr, "%s: load failed for '%s': %s\n", argv[0], argv[1], err ? err->message : "?");
+    return 1;
+  }
+  dump("text", a);
+
+  //-- binary save + mapped lookup
+  if (!gfsm_alphabet_save_bin_filename(a, argv[2], &err)) {
+    fprintf(stderr, "%s: save failed for '%s': %s\n", argv[0], argv[2], err ? err->message : "?");
+    return 1;
+  }
+  if (!(ma = gfsm_mapped_alphabet_open(argv[2], &err))) {
+    fprintf(stderr, "%s: open failed for '%s': %s\n", argv[0], argv[2], err ? err->message : "?");
+    return 1;
+  }
+  printf("--mapped: n_labels=%u n_keys=%u\n", gfsm_mapped_alphabet_n_labels(ma), gfsm_mapped_alphabet_n_keys(ma));
+  for (lab=0; lab < gfsm_mapped_alphabet_n_labels(ma); lab++) {
+    if (!(key = gfsm_mapped_alphabet_find_key(ma,lab))) continue;
+    printf("%u\t%s\t%s\n", lab, key, (gfsm_mapped_alphabet_find_label(ma,key) == gfsm_alphabet_find_label(a,(gpointer)key)
+				       ? "ok" : "NOT OK"));
+  }
+  printf("undefined\t%s\n", gfsm_mapped_alphabet_find_label(ma,"__undefined__") == gfsmNoLabel ? "ok" : "NOT OK");
+  gfsm_mapped_alphabet_close(ma);
+
+  //-- binary loader
+  b = gfsm_string_alphabet_new();
+  if (!gfsm_alphabet_load_filename(b, argv[2], &err)) {
+    fprintf(stderr, "%s: load failed for '%s': %s\n", argv[0], argv[2], err ? err->message : "?");
+    return 1;
+  }
+  dump("binary", b);
+
+  gfsm_alphabet_free(a);
+  gfsm_alphabet_free(b);
+  return 0;
+}
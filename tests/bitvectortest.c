@@ -0,0 +1,128 @@
+/*=============================================================================*\
+ * File: bitvectortest.c
+ * Description: finite state machine library: test driver for gfsmBitVector bulk operations
+ *=============================================================================*/
+
+#include <gfsmBitVector.h>
+#include <stdio.h>
+
+static guint32 lcg = 12345;
+
+/*--------------------------------------------------------------
+ * random_bv(): new bit-vector for nbits bits with pseudo-random contents
+ */
+static
+gfsmBitVector *random_bv(guint nbits)
+{
+  gfsmBitVector *bv = gfsm_bitvector_sized_new(nbits);
+  guint i;
+  for (i=0; i < gfsm_bitvector_size(bv); i++) {
+    lcg = lcg*1103515245 + 12345;
+    gfsm_bitvector_set(bv, i, (lcg>>16) % 3 == 0);
+  }
+  return bv;
+}
+
+/*--------------------------------------------------------------
+ * copy_bv(): new bit-vector with the same size and contents as src
+ */
+static
+gfsmBitVector *copy_bv(gfsmBitVector *src)
+{
+  gfsmBitVector *bv = gfsm_bitvector_new();
+  g_array_append_vals(bv, src->data, src->len);
+  return bv;
+}
+
+/*--------------------------------------------------------------
+ * main
+ */
+int main(int argc, char **argv)
+{
+  static const guint lengths[] = {1, 7, 8, 9, 55, 56, 63, 64, 65, 71, 127, 128, 129, 200, 517};
+  const guint n_lengths = sizeof(lengths)/sizeof(lengths[0]);
+  guint l, i;
+
+  for (l=0; l < n_lengths; l++) {
+    guint          nbits = lengths[l];
+    gfsmBitVector *a = random_bv(nbits);
+    gfsmBitVector *b = random_bv(nbits*2/3 + 5);  //-- shorter or longer than a
+    gfsmBitVector *r;
+    guint          size_a = gfsm_bitvector_size(a), size_b = gfsm_bitvector_size(b), size_r;
+    guint          count;
+    gboolean       ok_and = TRUE, ok_or = TRUE, ok_andnot = TRUE, ok_not = TRUE;
+    gboolean       ok_pop = TRUE, ok_set = TRUE, ok_unset = TRUE;
+
+    //-- and(): bits of a beyond the end of b are cleared
+    r = gfsm_bitvector_and(copy_bv(a), b);
+    if (gfsm_bitvector_size(r) != size_a) ok_and = FALSE;
+    for (i=0; i < size_a; i++)
+      if (gfsm_bitvector_get(r,i) != (gfsm_bitvector_get(a,i) && gfsm_bitvector_get(b,i))) ok_and = FALSE;
+    gfsm_bitvector_free(r);
+
+    //-- or(): grows to the larger size
+    r = gfsm_bitvector_or(copy_bv(a), b);
+    if (gfsm_bitvector_size(r) != MAX(size_a,size_b)) ok_or = FALSE;
+    for (i=0; i < gfsm_bitvector_size(r); i++)
+      if (gfsm_bitvector_get(r,i) != (gfsm_bitvector_get(a,i) || gfsm_bitvector_get(b,i))) ok_or = FALSE;
+    gfsm_bitvector_free(r);
+
+    //-- andnot(): bits of a beyond the end of b are kept
+    r = gfsm_bitvector_andnot(copy_bv(a), b);
+    if (gfsm_bitvector_size(r) != size_a) ok_andnot = FALSE;
+    for (i=0; i < size_a; i++)
+      if (gfsm_bitvector_get(r,i) != (gfsm_bitvector_get(a,i) && !gfsm_bitvector_get(b,i))) ok_andnot = FALSE;
+    gfsm_bitvector_free(r);
+
+    //-- not(), popcount(), find_next_set(), find_next_unset()
+    r      = gfsm_bitvector_not(copy_bv(a));
+    size_r = gfsm_bitvector_size(r);
+    if (size_r != size_a) ok_not = FALSE;
+    for (i=0, count=0; i < size_r; i++) {
+      if (gfsm_bitvector_get(r,i) == gfsm_bitvector_get(a,i)) ok_not = FALSE;
+      if (gfsm_bitvector_get(r,i)) count++;
+    }
+    if (gfsm_bitvector_popcount(r) != count || gfsm_bitvector_popcount(a) != size_a - count) ok_pop = FALSE;
+    for (i=0; i <= size_r+1; i++) {
+      guint j, want_set = gfsmBitVectorNone, want_unset = i;
+      for (j=i; j < size_r; j++) { if (gfsm_bitvector_get(r,j)) { want_set = j; break; } }
+      for (j=i; j < size_r; j++) { if (!gfsm_bitvector_get(r,j)) break; }
+      if (i < size_r) want_unset = j;
+      if (gfsm_bitvector_find_next_set(r,i) != want_set) ok_set = FALSE;
+      if (gfsm_bitvector_find_next_unset(r,i) != want_unset) ok_unset = FALSE;
+    }
+    gfsm_bitvector_free(r);
+
+    printf("bits=%u size=%u/%u: and=%s or=%s andnot=%s not=%s popcount=%s next_set=%s next_unset=%s\n",
+	   nbits, size_a, size_b,
+	   ok_and ? "ok" : "NOT OK",
+	   ok_or ? "ok" : "NOT OK",
+	   ok_andnot ? "ok" : "NOT OK",
+	   ok_not ? "ok" : "NOT OK",
+	   ok_pop ? "ok" : "NOT OK",
+	   ok_set ? "ok" : "NOT OK",
+	   ok_unset ? "ok" : "NOT OK");
+
+    gfsm_bitvector_free(a);
+    gfsm_bitvector_free(b);
+  }
+
+  //-- all-zero and all-one vectors: word-skipping loops run to the tail
+  for (l=0; l < n_lengths; l++) {
+    gfsmBitVector *z = gfsm_bitvector_zero(gfsm_bitvector_sized_new(lengths[l]));
+    gfsmBitVector *o = gfsm_bitvector_one(gfsm_bitvector_sized_new(lengths[l]));
+    guint          size = gfsm_bitvector_size(z);
+    printf("bits=%u size=%u: zero: popcount=%u next_set=%s next_unset=%u one: popcount=%u next_set=%u next_unset=%u\n",
+	   lengths[l], size,
+	   gfsm_bitvector_popcount(z),
+	   gfsm_bitvector_find_next_set(z,0) == gfsmBitVectorNone ? "none" : "SOME",
+	   gfsm_bitvector_find_next_unset(z,size-1),
+	   gfsm_bitvector_popcount(o),
+	   gfsm_bitvector_find_next_set(o,size-1),
+	   gfsm_bitvector_find_next_unset(o,0));
+    gfsm_bitvector_free(z);
+    gfsm_bitvector_free(o);
+  }
+
+  return 0;
+}
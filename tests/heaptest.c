@@ -0,0 +1,85 @@
+/*=============================================================================*\
+ * File: heaptest.c
+ * Description: finite state machine library: test driver for gfsmHeap
+ *=============================================================================*/
+
+#include <gfsmHeap.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------
+ * drain(): pop all elements from h, print their keys, check order and ids
+ */
+static
+void drain(gfsmHeap *h, guint n_ids)
+{
+  gfsmHeapKey prev = -1.0;
+  guint       n_popped = 0, id;
+  gboolean    ordered = TRUE;
+  gboolean   *seen = g_new0(gboolean, n_ids);
+  while ((id = gfsm_heap_pop(h)) != gfsmHeapNone) {
+    gfsmHeapKey key = g_array_index(h->keys,gfsmHeapKey,id);
+    if (n_ids <= 16) printf(" %g", key);
+    if (key < prev || id >= n_ids || seen[id] || gfsm_heap_contains(h,id)) ordered = FALSE;
+    if (id < n_ids) seen[id] = TRUE;
+    prev = key;
+    ++n_popped;
+  }
+  printf("%s%u popped, %s\n", (n_ids <= 16 ? " : " : ""), n_popped, (ordered ? "ok" : "NOT OK"));
+  g_free(seen);
+}
+
+/*--------------------------------------------------------------
+ * main
+ */
+int main(int argc, char **argv)
+{
+  static const gfsmHeapKey keys[] = {5,3,8,1,9,2,7,3,5,1};
+  const guint n_keys = sizeof(keys)/sizeof(keys[0]);
+  guint arity, i;
+
+  for (arity=2; arity <= 4; arity++) {
+    gfsmHeap *h = gfsm_heap_new(arity);
+
+    //-- push / pop with duplicate keys
+    for (i=0; i < n_keys; i++) gfsm_heap_push(h,i,keys[i]);
+    printf("arity=%u push: size=%u peek-key=%g", arity, gfsm_heap_size(h), gfsm_heap_key(h,gfsm_heap_peek(h)));
+    drain(h,n_keys);
+
+    //-- key updates: push() of an enqueued id re-keys it, decrease() only lowers keys
+    for (i=0; i < n_keys; i++) gfsm_heap_push(h,i,keys[i]);
+    printf("arity=%u update: %d %d %d %d",
+	   arity,
+	   gfsm_heap_push(h,4,0.5),      //-- 9 -> 0.5 : FALSE (update)
+	   gfsm_heap_push(h,3,6),        //-- 1 -> 6   : FALSE (update)
+	   gfsm_heap_decrease(h,2,9),    //-- 8 -/-> 9 : FALSE (no change)
+	   gfsm_heap_decrease(h,6,4));   //-- 7 -> 4   : TRUE
+    drain(h,n_keys);
+
+    //-- pop on empty heap, clear()
+    printf("arity=%u empty: pop=%s", arity, gfsm_heap_pop(h)==gfsmHeapNone ? "none" : "SOME");
+    for (i=0; i < n_keys; i++) gfsm_heap_push(h,i,keys[i]);
+    gfsm_heap_clear(h);
+    printf(" cleared: size=%u contains(0)=%d\n", gfsm_heap_size(h), gfsm_heap_contains(h,0));
+
+    //-- many elements with many duplicate keys (deterministic LCG)
+    {
+      guint32 x = 12345;
+      const guint n_big = 10000;
+      printf("arity=%u big:", arity);
+      for (i=0; i < n_big; i++) {
+	x = x*1103515245 + 12345;
+	gfsm_heap_push(h, i, (gfsmHeapKey)((x>>16) % 100));
+      }
+      for (i=0; i < n_big; i += 3) {
+	x = x*1103515245 + 12345;
+	gfsm_heap_push(h, i, (gfsmHeapKey)((x>>16) % 100));
+      }
+      printf(" ");
+      drain(h,n_big);
+    }
+
+    gfsm_heap_free(h);
+  }
+
+  return 0;
+}
@@ -0,0 +1,89 @@
+/*=============================================================================*\
+ * File: indexedtest.c
+ * Description: finite state machine library: test driver for binary algebra on indexed second operands
+ *=============================================================================*/
+
+#include <gfsm.h>
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------
+ * binop(): compute OP(fsm1,fsm2) or OP(fsm1,xfsm2) into a new automaton
+ */
+static
+gfsmAutomaton *binop(const gchar *op, gfsmAutomaton *fsm1, gfsmAutomaton *fsm2, gfsmIndexedAutomaton *xfsm2)
+{
+  if (strcmp(op,"compose")==0) {
+    return (xfsm2
+	    ? gfsm_automaton_compose_indexed_full(fsm1, xfsm2, NULL, NULL)
+	    : gfsm_automaton_compose_full(fsm1, fsm2, NULL, NULL));
+  }
+  else if (strcmp(op,"intersect")==0) {
+    return (xfsm2
+	    ? gfsm_automaton_intersect_indexed_full(fsm1, xfsm2, NULL, NULL)
+	    : gfsm_automaton_intersect_full(fsm1, fsm2, NULL, NULL));
+  }
+  else if (strcmp(op,"difference")==0) {
+    return (xfsm2
+	    ? gfsm_automaton_difference_indexed_full(fsm1, xfsm2, NULL)
+	    : gfsm_automaton_difference_full(fsm1, fsm2, NULL));
+  }
+  fprintf(stderr, "indexedtest: unknown operation '%s'\n", op);
+  exit(1);
+  return NULL;
+}
+
+/*--------------------------------------------------------------
+ * main
+ *  + computes OP(FSM1,FSM2) on a vanilla FSM2, then on FSM2 indexed and sorted
+ *    on lower labels (arcs used in place) and on upper labels (temporary sorted copy),
+ *    and compares the printed results
+ */
+int main(int argc, char **argv)
+{
+  gfsmAutomaton *fsm1 = gfsm_automaton_new();
+  gfsmAutomaton *fsm2 = gfsm_automaton_new();
+  gfsmAutomaton *want, *got;
+  gfsmIndexedAutomaton *xfsm2;
+  gfsmError *err = NULL;
+  GString *swant = g_string_new(""), *sgot = g_string_new("");
+  gfsmArcCompMask masks[] = { gfsmASMLower, gfsmASMUpper };
+  const gchar *mask_names[] = { "lower", "upper" };
+  guint i;
+
+  if (argc < 4) {
+    fprintf(stderr, "Usage: %s OP FSM1.tfst FSM2.tfst\n", argv[0]);
+    return 1;
+  }
+  for (i=2; i < 4; i++) {
+    if (!gfsm_automaton_compile_filename((i==2 ? fsm1 : fsm2), argv[i], &err)) {
+      fprintf(stderr, "%s: compile failed for '%s': %s\n", argv[0], argv[i], err ? err->message : "?");
+      return 1;
+    }
+  }
+
+  //-- vanilla
+  want = binop(argv[1], fsm1, fsm2, NULL);
+  gfsm_automaton_print_gstring_full(want, swant, NULL, NULL, NULL, &err);
+  printf("%s: states=%u arcs=%u\n", argv[1], gfsm_automaton_n_states(want), gfsm_automaton_n_arcs(want));
+
+  //-- indexed
+  for (i=0; i < sizeof(masks)/sizeof(masks[0]); i++) {
+    xfsm2 = gfsm_automaton_to_indexed(fsm2, NULL);
+    gfsm_indexed_automaton_sort(xfsm2, masks[i]);
+    got = binop(argv[1], fsm1, NULL, xfsm2);
+    g_string_truncate(sgot, 0);
+    gfsm_automaton_print_gstring_full(got, sgot, NULL, NULL, NULL, &err);
+    printf("  indexed (%s-sorted): %s\n", mask_names[i], (strcmp(swant->str,sgot->str)==0 ? "ok" : "NOT OK"));
+    gfsm_automaton_free(got);
+    gfsm_indexed_automaton_free(xfsm2);
+  }
+
+  //-- cleanup
+  g_string_free(swant, TRUE);
+  g_string_free(sgot, TRUE);
+  gfsm_automaton_free(want);
+  gfsm_automaton_free(fsm1);
+  gfsm_automaton_free(fsm2);
+  return 0;
+}
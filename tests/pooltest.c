@@ -0,0 +1,110 @@
+/*=============================================================================*\
+ * File: pooltest.c
+ * Description: finite state machine library: test driver for pooled arc allocation
+ *=============================================================================*/
+
+#include <gfsmAutomaton.h>
+#include <gfsmAutomatonIO.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------
+ * n_free(): count released nodes on the free list of pool
+ */
+static
+guint n_free(gfsmArcPool *pool)
+{
+  gfsmArcList *al;
+  guint        n = 0;
+  if (!pool) return 0;
+  for (al=pool->free_nodes; al != NULL; al=al->next) n++;
+  return n;
+}
+
+/*--------------------------------------------------------------
+ * dump(): print fsm with a header line
+ */
+static
+void dump(const char *what, gfsmAutomaton *fsm)
+{
+  gfsmError *err = NULL;
+  printf("--%s: pooled=%d states=%u arcs=%u free=%u\n",
+	 what, fsm->arc_pool != NULL, gfsm_automaton_n_states(fsm), gfsm_automaton_n_arcs(fsm), n_free(fsm->arc_pool));
+  fflush(stdout);
+  if (!gfsm_automaton_print_file(fsm, stdout, &err)) {
+    printf("print failed: %s\n", err ? err->message : "?");
+  }
+  fflush(stdout);
+}
+
+/*--------------------------------------------------------------
+ * main
+ */
+int main(int argc, char **argv)
+{
+  gfsmAutomaton *fsm  = gfsm_automaton_new();
+  gfsmAutomaton *pcopy, *ucopy;
+  gfsmState     *s;
+
+  //-- build a pooled automaton with duplicate arcs
+  gfsm_automaton_use_arc_pool(fsm, TRUE);
+  fsm->flags.sort_mode = gfsmASMLower;
+  gfsm_automaton_set_root(fsm, 0);
+  gfsm_automaton_add_arc(fsm, 0, 1, 1, 1, 0);
+  gfsm_automaton_add_arc(fsm, 0, 1, 1, 1, 0);
+  gfsm_automaton_add_arc(fsm, 0, 2, 2, 2, 0);
+  gfsm_automaton_add_arc(fsm, 1, 3, 3, 3, 0);
+  gfsm_automaton_add_arc(fsm, 1, 3, 3, 3, 0);
+  gfsm_automaton_add_arc(fsm, 1, 3, 3, 3, 0);
+  gfsm_automaton_add_arc(fsm, 2, 3, 4, 4, 0);
+  gfsm_automaton_add_arc(fsm, 2, 1, 5, 5, 0);
+  gfsm_automaton_set_final_state(fsm, 3, TRUE);
+  dump("built", fsm);
+
+  //-- arcuniq(): duplicate nodes go back to the pool
+  gfsm_automaton_arcuniq(fsm);
+  dump("arcuniq", fsm);
+
+  //-- remove_state(): arcs of the removed state go back to the pool, and are re-used
+  gfsm_automaton_remove_state(fsm, 2);
+  dump("remove_state", fsm);
+  gfsm_automaton_add_arc(fsm, 3, 0, 6, 6, 0);
+  dump("add_arc", fsm);
+
+  //-- copy(): into pooled and unpooled automata
+  pcopy = gfsm_automaton_new();
+  gfsm_automaton_use_arc_pool(pcopy, TRUE);
+  gfsm_automaton_copy(pcopy, fsm);
+  gfsm_automaton_add_arc(pcopy, 1, 0, 7, 7, 0);
+  dump("copy-pooled", pcopy);
+  ucopy = gfsm_automaton_new();
+  gfsm_automaton_copy(ucopy, fsm);
+  gfsm_automaton_add_arc(ucopy, 1, 0, 8, 8, 0);
+  dump("copy-unpooled", ucopy);
+
+  //-- copy() onto a non-empty pooled automaton releases its old arcs to its own pool
+  gfsm_automaton_copy(pcopy, ucopy);
+  dump("copy-over-pooled", pcopy);
+
+  //-- stand-alone states holding pool nodes
+  s = gfsm_state_new();
+  s->arcs = gfsm_arc_pool_node_new(fsm->arc_pool, 0, 1, 9, 9, 0,
+				   gfsm_arc_pool_node_new(fsm->arc_pool, 0, 3, 9, 9, 0, NULL));
+  gfsm_state_free_full(s, TRUE, fsm->arc_pool);
+  printf("--state_free_full: free=%u\n", n_free(fsm->arc_pool));
+
+  s = gfsm_state_new();
+  s->is_temp       = TRUE;
+  s->arc_list_temp = TRUE;
+  s->arc_data_temp = TRUE;
+  s->arcs = gfsm_arc_pool_node_new(fsm->arc_pool, 0, 1, 9, 9, 0, NULL);
+  gfsm_state_close_full(s, fsm->arc_pool);
+  printf("--state_close_full: free=%u\n", n_free(fsm->arc_pool));
+
+  //-- free()
+  gfsm_automaton_free(fsm);
+  gfsm_automaton_free(pcopy);
+  gfsm_automaton_free(ucopy);
+  printf("--free: ok\n");
+
+  return 0;
+}
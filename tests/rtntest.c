@@ -0,0 +1,140 @@
+/*=============================================================================*\
+ * File: rtntest.c
+ * Description: finite state machine library: test driver for delayed replacement (gfsmRTN)
+ *=============================================================================*/
+
+#include <gfsm.h>
+#include <stdio.h>
+
+/*--------------------------------------------------------------
+ * print_paths(): print each path in paths as "LABELS <WEIGHT>", in set order
+ */
+static
+void print_paths(const char *what, gfsmSet *paths, gfsmLabelSide which)
+{
+  GPtrArray *a = g_ptr_array_new();
+  guint i, j;
+  gfsm_set_to_ptr_array(paths, a);
+  printf("  %s: %u path(s)\n", what, a->len);
+  for (i=0; i < a->len; i++) {
+    gfsmPath *p = (gfsmPath*)g_ptr_array_index(a,i);
+    gfsmLabelVector *v = (which==gfsmLSUpper ? p->hi : p->lo);
+    printf("   ");
+    for (j=0; j < v->len; j++) printf(" %u", GPOINTER_TO_UINT(g_ptr_array_index(v,j)));
+    printf(" <%g>\n", (double)p->w);
+  }
+  g_ptr_array_free(a,TRUE);
+}
+
+/*--------------------------------------------------------------
+ * print_error(): print the expansion error of rtn
+ */
+static
+void print_error(gfsmRTN *rtn)
+{
+  printf("  error: %s\n", rtn->error ? rtn->error->message : "none");
+}
+
+/*--------------------------------------------------------------
+ * test(): expand, paths, lookup and compose over root with rule fsm for call label 9
+ */
+static
+void test(const char *what, gfsmAutomaton *root, gfsmAutomaton *rule, guint32 depth,
+	  gfsmLabelVector *input, gfsmAutomaton *fsm2)
+{
+  gfsmRTN *rtn = gfsm_rtn_new(root, depth);
+  gfsmAutomaton *result;
+  gfsmSet *paths;
+
+  gfsm_rtn_add_rule(rtn, 9, 9, rule);
+  printf("--%s: depth=%u\n", what, depth);
+
+  //-- expand
+  result = gfsm_rtn_expand(rtn, NULL);
+  printf("  expand: states=%u arcs=%u\n", gfsm_automaton_n_states(result), gfsm_automaton_n_arcs(result));
+  print_error(rtn);
+  gfsm_automaton_free(result);
+
+  //-- paths (on a fresh cache)
+  gfsm_rtn_clear_cache(rtn);
+  paths = gfsm_rtn_paths_full(rtn, NULL, gfsmLSLower);
+  print_paths("paths", paths, gfsmLSLower);
+  print_error(rtn);
+  gfsm_set_free(paths);
+
+  //-- lookup
+  gfsm_rtn_clear_cache(rtn);
+  result = gfsm_rtn_lookup_full(rtn, input, NULL, gfsmLookupMaxResultStates);
+  paths  = gfsm_automaton_paths_full(result, NULL, gfsmLSUpper);
+  print_paths("lookup", paths, gfsmLSUpper);
+  print_error(rtn);
+  gfsm_set_free(paths);
+  gfsm_automaton_free(result);
+
+  //-- compose
+  gfsm_rtn_clear_cache(rtn);
+  result = gfsm_rtn_compose_full(rtn, fsm2, NULL);
+  gfsm_automaton_connect(result);
+  paths  = gfsm_automaton_paths_full(result, NULL, gfsmLSUpper);
+  print_paths("compose", paths, gfsmLSUpper);
+  print_error(rtn);
+  gfsm_set_free(paths);
+  gfsm_automaton_free(result);
+
+  gfsm_rtn_free(rtn);
+}
+
+/*--------------------------------------------------------------
+ * main
+ */
+int main(int argc, char **argv)
+{
+  gfsmAutomaton *root = gfsm_automaton_new();
+  gfsmAutomaton *rec  = gfsm_automaton_new();
+  gfsmAutomaton *flat = gfsm_automaton_new();
+  gfsmAutomaton *fsm2 = gfsm_automaton_new();
+  gfsmLabelVector *input = g_ptr_array_new();
+  guint32 inlabs[] = { 1, 3, 4, 2 };
+  gfsmLabelVal lab;
+  guint i;
+
+  //-- root: 1 <9> 2
+  gfsm_automaton_set_root(root, 0);
+  gfsm_automaton_add_arc(root, 0, 1, 1, 1, 0);
+  gfsm_automaton_add_arc(root, 1, 2, 9, 9, 0);
+  gfsm_automaton_add_arc(root, 2, 3, 2, 2, 0);
+  gfsm_automaton_set_final_state(root, 3, TRUE);
+
+  //-- recursive rule: 3 <9> 4 | epsilon
+  gfsm_automaton_set_root(rec, 0);
+  gfsm_automaton_add_arc(rec, 0, 1, 3, 3, 1);
+  gfsm_automaton_add_arc(rec, 1, 2, 9, 9, 0);
+  gfsm_automaton_add_arc(rec, 2, 3, 4, 4, 0);
+  gfsm_automaton_set_final_state(rec, 0, TRUE);
+  gfsm_automaton_set_final_state(rec, 3, TRUE);
+
+  //-- non-recursive rule: 3 4
+  gfsm_automaton_set_root(flat, 0);
+  gfsm_automaton_add_arc(flat, 0, 1, 3, 3, 1);
+  gfsm_automaton_add_arc(flat, 1, 2, 4, 4, 0);
+  gfsm_automaton_set_final_state(flat, 2, TRUE);
+
+  //-- fsm2: identity on 1..9, except 3:5
+  gfsm_automaton_set_root(fsm2, 0);
+  for (lab=1; lab <= 9; lab++) gfsm_automaton_add_arc(fsm2, 0, 0, lab, (lab==3 ? 5 : lab), 0);
+  gfsm_automaton_set_final_state(fsm2, 0, TRUE);
+
+  for (i=0; i < sizeof(inlabs)/sizeof(inlabs[0]); i++) g_ptr_array_add(input, GUINT_TO_POINTER(inlabs[i]));
+
+  test("recursive", root, rec, 1, input, fsm2);
+  test("recursive", root, rec, 2, input, fsm2);
+  test("recursive", root, rec, 0, input, fsm2);
+  test("flat", root, flat, 0, input, fsm2);
+
+  g_ptr_array_free(input, TRUE);
+  gfsm_automaton_free(root);
+  gfsm_automaton_free(rec);
+  gfsm_automaton_free(flat);
+  gfsm_automaton_free(fsm2);
+  return 0;
+}
@@ -0,0 +1,105 @@
+/*=============================================================================*\
+ * File: tokenizertest.c
+ * Description: finite state machine library: test driver for gfsmTokenizer
+ *=============================================================================*/
+
+#include <gfsmAlphabet.h>
+#include <gfsmTokenizer.h>
+#include <stdio.h>
+#include <string.h>
+
+/*--------------------------------------------------------------
+ * labels2str(): space-separated labels of vec, or "-" if vec is empty
+ */
+static
+const gchar *labels2str(gfsmLabelVector *vec, GString *gs)
+{
+  guint i;
+  g_string_truncate(gs, 0);
+  for (i=0; i < vec->len; i++) {
+    g_string_append_printf(gs, "%s%u", (i ? " " : ""), GPOINTER_TO_UINT(g_ptr_array_index(vec,i)));
+  }
+  if (vec->len == 0) g_string_append(gs, "-");
+  return gs->str;
+}
+
+/*--------------------------------------------------------------
+ * main
+ *  + for each UTF-8 and AT&T mode, compares tokenizer output against the
+ *    gfsm_alphabet_*string_to_labels() functions on each line of STRFILE
+ *  + then prints longest-match tokenizer output for the same lines
+ */
+int main(int argc, char **argv)
+{
+  gfsmAlphabet *abet;
+  gfsmTokenizer *tok;
+  gfsmError *err = NULL;
+  GPtrArray *lines = g_ptr_array_new();
+  gfsmLabelVector *vold = g_ptr_array_new(), *vtok = g_ptr_array_new();
+  GString *sold = g_string_new(""), *stok = g_string_new("");
+  gchar buf[256];
+  FILE *f;
+  guint i, utf8, att;
+
+  if (argc < 3) {
+    fprintf(stderr, "Usage: %s LABFILE STRFILE\n", argv[0]);
+    return 1;
+  }
+
+  //-- load strings
+  if (!(f = fopen(argv[2], "r"))) {
+    fprintf(stderr, "%s: open failed for '%s'\n", argv[0], argv[2]);
+    return 1;
+  }
+  while (fgets(buf, sizeof(buf), f)) {
+    buf[strcspn(buf,"\n")] = '\0';
+    g_ptr_array_add(lines, g_strdup(buf));
+  }
+  fclose(f);
+
+  for (utf8=0; utf8 < 2; utf8++) {
+    abet = gfsm_string_alphabet_new();
+    abet->utf8 = utf8;
+    if (!gfsm_alphabet_load_filename(abet, argv[1], &err)) {
+      fprintf(stderr, "%s: load failed for '%s': %s\n", argv[0], argv[1], err ? err->message : "?");
+      return 1;
+    }
+
+    //-- compare against gfsm_alphabet_*string_to_labels()
+    for (att=0; att < 2; att++) {
+      tok = gfsm_tokenizer_new(abet, att ? gfsmTFAtt : gfsmTFChars);
+      for (i=0; i < lines->len; i++) {
+	const gchar *str = (const gchar*)g_ptr_array_index(lines,i);
+	g_ptr_array_set_size(vold, 0);
+	gfsm_alphabet_generic_string_to_labels(abet, str, vold, FALSE, att);
+	gfsm_tokenizer_string_to_labels(tok, str, vtok, FALSE);
+	labels2str(vold, sold);
+	labels2str(vtok, stok);
+	printf("utf8=%u att=%u line=%u: %s : %s\n", utf8, att, i+1, stok->str,
+	       (strcmp(sold->str,stok->str)==0 ? "ok" : "NOT OK"));
+      }
+      gfsm_tokenizer_free(tok);
+    }
+
+    //-- longest match
+    for (att=0; att < 2; att++) {
+      tok = gfsm_tokenizer_new(abet, (att ? gfsmTFAtt : gfsmTFChars) | gfsmTFLongest);
+      for (i=0; i < lines->len; i++) {
+	gfsm_tokenizer_string_to_labels(tok, (const gchar*)g_ptr_array_index(lines,i), vtok, FALSE);
+	printf("utf8=%u att=%u longest line=%u: %s\n", utf8, att, i+1, labels2str(vtok, stok));
+      }
+      gfsm_tokenizer_free(tok);
+    }
+
+    gfsm_alphabet_free(abet);
+  }
+
+  //-- cleanup
+  for (i=0; i < lines->len; i++) g_free(g_ptr_array_index(lines,i));
+  g_ptr_array_free(lines, TRUE);
+  g_ptr_array_free(vold, TRUE);
+  g_ptr_array_free(vtok, TRUE);
+  g_string_free(sold, TRUE);
+  g_string_free(stok, TRUE);
+  return 0;
+}